@@ -0,0 +1,51 @@
+// ============================================================================
+//  BENCH - minimal harness shared by the smjene_bench cases
+// ============================================================================
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+inline double NowSeconds() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Keeps the optimizer from dropping a computed value
+template <class T> inline void DoNotOptimize(const T& v) {
+#if defined(_MSC_VER)
+    static volatile const void* sink; sink = &v;
+#else
+    asm volatile("" : : "r,m"(v) : "memory");
+#endif
+}
+
+// Fails the run loudly when a benchmark detects a wrong result
+#define BENCH_CHECK(cond) \
+    do { if (!(cond)) { fprintf(stderr, "CHECK FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); exit(2); } } while (0)
+
+// Heap allocations made through operator new so far (bench_alloc.cpp)
+size_t BenchAllocCount();
+
+int BenchCalendar(int argc, char** argv);
+int BenchExport(int argc, char** argv);
+int BenchHistory(int argc, char** argv);
+int BenchHolidays(int argc, char** argv);
+int BenchImport(int argc, char** argv);
+int BenchKernels(int argc, char** argv);
+int BenchLayout(int argc, char** argv);
+int BenchLoad(int argc, char** argv);
+int BenchOps(int argc, char** argv);
+int BenchOverview(int argc, char** argv);
+int BenchPayroll(int argc, char** argv);
+int BenchPersist(int argc, char** argv);
+int BenchRange(int argc, char** argv);
+int BenchRender(int argc, char** argv);
+int BenchRoster(int argc, char** argv);
+int BenchRules(int argc, char** argv);
+int BenchSchedule(int argc, char** argv);
+int BenchSearch(int argc, char** argv);
+int BenchStats(int argc, char** argv);
+int BenchTrace(int argc, char** argv);
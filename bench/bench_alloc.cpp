@@ -0,0 +1,28 @@
+// ============================================================================
+//  BENCH ALLOC - global operator new replacement that counts allocations
+// ============================================================================
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "bench.h"
+
+static std::atomic<size_t> s_allocs(0);
+
+size_t BenchAllocCount() { return s_allocs.load(std::memory_order_relaxed); }
+
+void* operator new(size_t n) {
+    s_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t n) { return operator new(n); }
+void* operator new(size_t n, const std::nothrow_t&) noexcept {
+    s_allocs.fetch_add(1, std::memory_order_relaxed);
+    return malloc(n ? n : 1);
+}
+void* operator new[](size_t n, const std::nothrow_t& t) noexcept { return operator new(n, t); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
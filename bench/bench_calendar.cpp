@@ -0,0 +1,80 @@
+// ============================================================================
+//  BENCH CALENDAR - exhaustive check of the calendar engine (1600-2400)
+//  against a day-by-day reference walk, then DayOfWeek() vs mktime().
+// ============================================================================
+
+#include <ctime>
+#include "bench.h"
+#include "core/calendar.h"
+
+// The pre-engine DayOfWeek(), Monday-based
+static int MktimeDayOfWeek(int d, int m, int y) {
+    struct tm t = {};
+    t.tm_year = y - 1900; t.tm_mon = m - 1; t.tm_mday = d;
+    mktime(&t);
+    return (t.tm_wday + 6) % 7;
+}
+
+static void CheckExhaustive() {
+    static const int mdays[] = {31,28,31,30,31,30,31,31,30,31,30,31};
+    // 1600-01-01: JDN 2305448 (1970-01-01 is 2440588), a Saturday
+    int32_t z = 2305448 - 2440588;
+    int wd = 5, isoYear = 1599, isoWeek = 52, doy = 0;
+    long checked = 0;
+
+    for (int y = 1600; y <= 2400; y++) {
+        bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+        doy = 0;
+        for (int m = 1; m <= 12; m++) {
+            int dim = mdays[m - 1] + (m == 2 && leap ? 1 : 0);
+            BENCH_CHECK(DaysInMonth(m, y) == dim);
+            MonthGrid g = MakeMonthGrid(m, y);
+            BENCH_CHECK(g.first == z && g.firstDow == wd && g.days == dim && g.rows == (wd + dim + 6) / 7);
+            for (int d = 1; d <= dim; d++, z++, doy++, wd = (wd + 1) % 7) {
+                if (wd == 0) {
+                    bool weekOne = (m == 12 && d >= 29) || (m == 1 && d <= 4);
+                    if (weekOne) { isoWeek = 1; isoYear = (m == 12) ? y + 1 : y; }
+                    else isoWeek++;
+                }
+                BENCH_CHECK(DaysFromCivil(y, m, d) == z);
+                CivilDate c = CivilFromDays(z);
+                BENCH_CHECK(c.y == y && c.m == m && c.d == d);
+                BENCH_CHECK(WeekdayFromDays(z) == wd && DayOfWeek(d, m, y) == wd);
+                BENCH_CHECK(DayOfYear(d, m, y) == doy);
+                if (y > 1600) {
+                    IsoWeekDate iw = IsoWeek(z);
+                    BENCH_CHECK(iw.year == isoYear && iw.week == isoWeek && iw.weekday == wd);
+                }
+                BENCH_CHECK(g.DayAt(g.Row(d), g.Col(d)) == d && g.Col(d) == wd);
+                CivilDate next = AddMonths(c, 1);
+                int nm = m == 12 ? 1 : m + 1, ny = m == 12 ? y + 1 : y;
+                int ndim = mdays[nm - 1] + (nm == 2 && ((ny % 4 == 0 && ny % 100 != 0) || ny % 400 == 0) ? 1 : 0);
+                BENCH_CHECK(next.y == ny && next.m == nm && next.d == (d < ndim ? d : ndim));
+                checked++;
+            }
+        }
+        BENCH_CHECK(doy == DaysInYear(y));
+    }
+    printf("checked %ld days (1600-01-01 .. 2400-12-31): OK\n", checked);
+}
+
+int BenchCalendar(int argc, char** argv) {
+    long n = argc > 0 ? atol(argv[0]) : 1000000L;
+    CheckExhaustive();
+
+    double t0 = NowSeconds();
+    int acc = 0;
+    for (long i = 0; i < n; i++) acc += MktimeDayOfWeek(1, (int)(i % 12) + 1, 1990 + (int)(i % 40));
+    double tOld = NowSeconds() - t0;
+    DoNotOptimize(acc);
+
+    t0 = NowSeconds();
+    acc = 0;
+    for (long i = 0; i < n; i++) acc += DayOfWeek(1, (int)(i % 12) + 1, 1990 + (int)(i % 40));
+    double tNew = NowSeconds() - t0;
+    DoNotOptimize(acc);
+
+    printf("%-22s %8.1f ns/op\n", "mktime DayOfWeek", tOld * 1e9 / n);
+    printf("%-22s %8.1f ns/op   x%.0f\n", "constexpr DayOfWeek", tNew * 1e9 / n, tOld / tNew);
+    return 0;
+}
@@ -0,0 +1,158 @@
+// ============================================================================
+//  BENCH EXPORT - iCalendar / CSV export of a team: MB/s against the plain
+//  text writer and a raw fwrite of the same size, allocations per export,
+//  and the format rules (CRLF, folding, escaping, quoting, ranges)
+// ============================================================================
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "core/export_format.h"
+#include "core/rotation.h"
+#include "core/text_format.h"
+
+static const int FIRST_YEAR = 2020;
+
+static std::string ReadAll(FILE* f) {
+    std::string data;
+    fseek(f, 0, SEEK_END);
+    data.resize((size_t)ftell(f));
+    rewind(f);
+    if (!data.empty() && fread(&data[0], 1, data.size(), f) != data.size()) data.clear();
+    return data;
+}
+
+template <class Fn> static std::string Exported(Fn&& write) {
+    FILE* f = tmpfile();
+    BENCH_CHECK(f && write(f));
+    std::string s = ReadAll(f);
+    fclose(f);
+    return s;
+}
+
+static size_t Occurrences(const std::string& s, const char* what) {
+    size_t n = 0;
+    for (size_t p = s.find(what); p != std::string::npos; p = s.find(what, p + 1)) n++;
+    return n;
+}
+
+static void CheckFormats() {
+    Roster team;
+    const std::string longName = "Dragana \"Gaga\" Petrovic-Jovanovic, smjena B; sektor \xc4\x8c" "ajetina / odjeljenje 12";
+    team.Add(Roster::DEFAULT_ID);
+    int k = team.Add(42, longName.c_str());
+    const int32_t d = DaysFromCivil(2026, 3, 14);
+    team.Default().Set(d, SHIFT_DAY);
+    team.Shifts((size_t)k).Set(d, SHIFT_NIGHT);
+    team.Shifts((size_t)k).Set(d + 1, SHIFT_FREE);
+    team.Shifts((size_t)k).Set(d + 400, SHIFT_DAY);
+
+    ExportOptions opt;
+    opt.stamp = 1773446400;   // 2026-03-14 00:00:00 UTC
+    BENCH_CHECK(ParseShiftTimes("D=06:30-14:30,N=22:00-06:00", opt.times) == nullptr);
+    BENCH_CHECK(ParseShiftTimes("D=24:00-06:00", opt.times) != nullptr && opt.times[SHIFT_DAY].start == 6 * 60 + 30);
+    BENCH_CHECK(ParseShiftTimes("N=22:00-06:00;S=dan", opt.times) != nullptr);
+
+    ExportStats st;
+    std::string ics = Exported([&](FILE* f) { return ExportIcs(f, team, opt, &st); });
+    BENCH_CHECK(st.events == 4 && st.bytes == ics.size());
+    BENCH_CHECK(ics.find("BEGIN:VEVENT\r\nUID:20260314-0@smjene\r\nDTSTAMP:20260314T000000Z\r\n"
+                         "DTSTART:20260314T063000\r\nDTEND:20260314T143000\r\n"
+                         "SUMMARY:Dnevna smjena - radnik 0\r\nEND:VEVENT\r\n") != std::string::npos);
+    BENCH_CHECK(ics.find("DTSTART:20260314T220000\r\nDTEND:20260315T060000\r\n") != std::string::npos);
+    BENCH_CHECK(ics.find("DTSTART;VALUE=DATE:20260315\r\nDTEND;VALUE=DATE:20260316\r\n") != std::string::npos);
+    BENCH_CHECK(Occurrences(ics, "TRANSP:TRANSPARENT") == 1);
+    // Lines end in CRLF and stay within 75 octets; unfolded, the summary is whole
+    size_t lineStart = 0;
+    for (size_t p = ics.find("\r\n"); p != std::string::npos; p = ics.find("\r\n", lineStart)) {
+        BENCH_CHECK(p - lineStart <= 75 && ics.find('\n', lineStart) == p + 1);
+        lineStart = p + 2;
+    }
+    BENCH_CHECK(lineStart == ics.size());
+    std::string unfolded;
+    for (size_t i = 0; i < ics.size(); i++) {
+        if (ics.compare(i, 3, "\r\n ") == 0) { i += 2; continue; }
+        unfolded += ics[i];
+    }
+    BENCH_CHECK(unfolded.find("SUMMARY:Nocna smjena - Dragana \"Gaga\" Petrovic-Jovanovic\\, smjena B\\; sektor \xc4\x8c"
+                              "ajetina / odjeljenje 12\r\n") != std::string::npos);
+
+    // CSV: quoted name, empty times for whole days, range and one employee
+    opt.from = d;
+    opt.to = d + 1;
+    std::string csv = Exported([&](FILE* f) { return ExportCsv(f, team, opt, &st); });
+    BENCH_CHECK(st.events == 3);
+    BENCH_CHECK(csv == "datum,radnik,ime,smjena,pocetak,kraj\r\n"
+                       "2026-03-14,0,,D,2026-03-14 06:30,2026-03-14 14:30\r\n"
+                       "2026-03-14,42,\"Dragana \"\"Gaga\"\" Petrovic-Jovanovic, smjena B; sektor \xc4\x8c"
+                       "ajetina / odjeljenje 12\",N,2026-03-14 22:00,2026-03-15 06:00\r\n"
+                       "2026-03-15,42,\"Dragana \"\"Gaga\"\" Petrovic-Jovanovic, smjena B; sektor \xc4\x8c"
+                       "ajetina / odjeljenje 12\",S,,\r\n");
+    opt.from = ExportOptions().from;
+    opt.to = ExportOptions().to;
+    opt.employee = k;
+    csv = Exported([&](FILE* f) { return ExportCsv(f, team, opt, &st); });
+    BENCH_CHECK(st.events == 3 && Occurrences(csv, "\r\n") == 4);
+}
+
+int BenchExport(int argc, char** argv) {
+    int employees = argc > 0 ? atoi(argv[0]) : 100;
+    int years = argc > 1 ? atoi(argv[1]) : 10;
+    if (employees <= 0) employees = 100;
+    if (years <= 0) years = 10;
+
+    CheckFormats();
+
+    Roster team;
+    for (int e = 0; e < employees; e++) {
+        Rotation rot;
+        ParseRotation("DDNN-SSS", DaysFromCivil(FIRST_YEAR, 1, 1) + e, rot);
+        int i = team.Add((uint32_t)e, e ? ("Radnik " + std::to_string(e)).c_str() : nullptr);
+        ApplyRotation(team.Shifts((size_t)i), rot, DaysFromCivil(FIRST_YEAR, 1, 1),
+                      DaysFromCivil(FIRST_YEAR + years, 1, 1) - 1, MERGE_OVERWRITE);
+    }
+    printf("team: %d employees x %d years, %zu shifts\n", employees, years, team.Count());
+
+    // Each writer into its own temporary file, timed with the final flush
+    struct Writer { const char* name; bool ics, csv; };
+    static const Writer WRITERS[] = { { "text", false, false }, { "ics", true, false }, { "csv", false, true } };
+    ExportOptions opt;
+    opt.stamp = 1773446400;
+    uint64_t largest = 0;
+    for (const Writer& w : WRITERS) {
+        FILE* f = tmpfile();
+        BENCH_CHECK(f);
+        ExportStats st;
+        size_t a0 = BenchAllocCount();
+        double t0 = NowSeconds();
+        bool ok = w.ics ? ExportIcs(f, team, opt, &st) : w.csv ? ExportCsv(f, team, opt, &st) : WriteShiftText(f, team);
+        ok = fflush(f) == 0 && ok;
+        double secs = NowSeconds() - t0;
+        size_t allocs = BenchAllocCount() - a0;
+        long size = ftell(f);
+        fclose(f);
+        BENCH_CHECK(ok);
+        if (w.ics || w.csv) {
+            BENCH_CHECK(st.events == team.Count() && st.bytes == (uint64_t)size);
+            // A few reused strings, nothing per employee or event
+            BENCH_CHECK(allocs <= 16);
+        }
+        if ((uint64_t)size > largest) largest = (uint64_t)size;
+        printf("%-5s %8.1f MB  %7.1f ms  %7.0f MB/s  %6.1f ns/shift  %zu allocs\n", w.name, size / 1e6, secs * 1e3,
+               size / 1e6 / secs, secs * 1e9 / team.Count(), allocs);
+    }
+
+    // Ceiling: the same number of bytes in 64 KB fwrite calls
+    std::vector<char> block(1 << 16, 'x');
+    FILE* f = tmpfile();
+    BENCH_CHECK(f);
+    double t0 = NowSeconds();
+    for (uint64_t done = 0; done < largest; done += block.size()) fwrite(block.data(), 1, block.size(), f);
+    fflush(f);
+    double secs = NowSeconds() - t0;
+    fclose(f);
+    printf("fwrite %7.1f MB  %7.1f ms  %7.0f MB/s  (64 KB blocks, no formatting)\n", largest / 1e6, secs * 1e3,
+           largest / 1e6 / secs);
+    return 0;
+}
@@ -0,0 +1,120 @@
+// ============================================================================
+//  BENCH HISTORY - undo/redo checked against store copies after random
+//  transactions, then diff size and undo time of a 12-month copy and a reset
+// ============================================================================
+
+#include <random>
+#include <vector>
+#include "bench.h"
+#include "core/rotation.h"
+#include "core/shift_history.h"
+#include "core/shift_ops.h"
+
+static bool SameCodes(const ShiftStore& a, const ShiftStore& b, int32_t from, int32_t to) {
+    for (int32_t z = from; z <= to; z++)
+        if (a.Get(z) != b.Get(z)) return false;
+    return true;
+}
+
+static void CheckUndoRedo(std::mt19937& rng) {
+    const int32_t lo = DaysFromCivil(2020, 1, 1), hi = DaysFromCivil(2026, 1, 1) - 1;
+    std::uniform_int_distribution<int32_t> anyDay(lo, hi);
+    ShiftStore s;
+    ShiftHistory h;
+    h.Attach(s);
+
+    std::vector<ShiftStore> states(1, s);   // states[i] = store after step i
+    for (int step = 0; step < 60; step++) {
+        int kind = (int)(rng() % 5);
+        ShiftTransaction tx(h);
+        if (kind == 0) {
+            for (int i = 0; i < 50; i++) s.Set(anyDay(rng), (ShiftType)(rng() % 4));
+        } else if (kind == 1) {
+            CivilDate c = CivilFromDays(anyDay(rng));
+            for (int m = 1; m <= 12; m++) CopyMonthPattern(s, c.m, c.y, m, c.y + 1, (rng() & 1) != 0);
+        } else if (kind == 2) {
+            CivilDate c = CivilFromDays(anyDay(rng));
+            ClearMonth(s, c.m, c.y);
+        } else if (kind == 3) {
+            Rotation rot;
+            ParseRotation("DDNN-SSS", anyDay(rng), rot);
+            int32_t a = anyDay(rng);
+            ApplyRotation(s, rot, a, a + (int32_t)(rng() % 900), (rng() & 1) ? MERGE_KEEP : MERGE_OVERWRITE);
+        } else if (step % 20 == 19) {
+            ClearAll(s);
+        }
+        if (tx.Commit()) states.push_back(s);
+    }
+
+    // Walk all the way back and forward again
+    const int32_t all0 = lo - 400, all1 = hi + 800;
+    size_t steps = states.size() - 1;
+    BENCH_CHECK(h.UndoSteps() == steps);
+    for (size_t i = steps; i > 0; i--) {
+        BENCH_CHECK(h.Undo());
+        BENCH_CHECK(SameCodes(s, states[i - 1], all0, all1) && s.Count() == states[i - 1].Count());
+    }
+    BENCH_CHECK(!h.Undo());
+    for (size_t i = 1; i <= steps; i++) {
+        BENCH_CHECK(h.Redo());
+        BENCH_CHECK(SameCodes(s, states[i], all0, all1) && s.Count() == states[i].Count());
+    }
+    BENCH_CHECK(!h.Redo());
+
+    // A rolled back transaction leaves no trace
+    {
+        ShiftTransaction tx(h);
+        ClearAll(s);
+        BENCH_CHECK(s.Empty() || states.back().Empty());
+    }
+    BENCH_CHECK(SameCodes(s, states.back(), all0, all1) && h.UndoSteps() == steps);
+
+    // Lone mutations are steps of their own
+    ShiftType before = s.Get(lo);
+    s.Set(lo, before == SHIFT_DAY ? SHIFT_NIGHT : SHIFT_DAY);
+    BENCH_CHECK(h.UndoSteps() == steps + 1 && h.Undo() && s.Get(lo) == before);
+    printf("undo/redo over %d transactions: OK\n", (int)steps);
+}
+
+int BenchHistory(int argc, char** argv) {
+    int years = argc > 0 ? atoi(argv[0]) : 50;
+    if (years < 1 || years > 100) years = 50;
+
+    std::mt19937 rng(9);
+    CheckUndoRedo(rng);
+
+    ShiftStore s;
+    const int32_t lo = DaysFromCivil(2000, 1, 1), hi = DaysFromCivil(2000 + years, 1, 1) - 1;
+    Rotation rot;
+    ParseRotation("DDNNSSSS", lo, rot);
+    ApplyRotation(s, rot, lo, hi, MERGE_OVERWRITE);
+    ShiftHistory h;
+    h.Attach(s);
+    size_t storeBytes = s.MemoryUsage();
+
+    size_t a0 = BenchAllocCount();
+    double t0 = NowSeconds();
+    {
+        ShiftTransaction tx(h);
+        for (int m = 1; m <= 12; m++) CopyMonthPattern(s, 2, 2000, m, 2000 + years / 2, true);
+        tx.Commit();
+    }
+    double t1 = NowSeconds();
+    size_t copyBytes = h.MemoryUsage();
+    h.Undo();
+    double t2 = NowSeconds();
+    { ShiftTransaction tx(h); ClearAll(s); tx.Commit(); }
+    double t3 = NowSeconds();
+    size_t resetBytes = h.MemoryUsage();
+    h.Undo();
+    double t4 = NowSeconds();
+    BENCH_CHECK((size_t)s.CountByType(lo, hi).Total() == (size_t)(hi - lo + 1));
+
+    printf("store (%d years)        %8zu bytes\n", years, storeBytes);
+    printf("copy-12: record %8.1f us   undo %8.1f us   history %8zu bytes\n",
+           (t1 - t0) * 1e6, (t2 - t1) * 1e6, copyBytes);
+    printf("reset:   record %8.1f us   undo %8.1f us   history %8zu bytes\n",
+           (t3 - t2) * 1e6, (t4 - t3) * 1e6, resetBytes);
+    printf("allocations: %zu\n", BenchAllocCount() - a0);
+    return 0;
+}
@@ -0,0 +1,132 @@
+// ============================================================================
+//  BENCH HOLIDAYS - Easter dates of both computus algorithms, the built-in
+//  and file rules, cached bits against computing the year again, and the
+//  lookup cost: a bit test vs the sorted day list payroll used before
+// ============================================================================
+
+#include <algorithm>
+#include <cstring>
+#include "bench.h"
+#include "core/holidays.h"
+#include "core/payroll.h"
+
+static bool Rule(const char* line, HolidayRule& rule) {
+    return ParseHolidayRule(line, line + strlen(line), rule) == nullptr;
+}
+
+static void CheckEaster() {
+    struct Known { int y, m, d; };
+    static const Known CATHOLIC[] = { { 1818, 3, 22 }, { 1943, 4, 25 }, { 2000, 4, 23 }, { 2024, 3, 31 },
+                                      { 2025, 4, 20 }, { 2026, 4, 5 }, { 2038, 4, 25 } };
+    static const Known ORTHODOX[] = { { 2000, 4, 30 }, { 2023, 4, 16 }, { 2024, 5, 5 }, { 2025, 4, 20 },
+                                      { 2026, 4, 12 }, { 2027, 5, 2 } };
+    for (const Known& k : CATHOLIC) BENCH_CHECK(CatholicEaster(k.y) == DaysFromCivil(k.y, k.m, k.d));
+    for (const Known& k : ORTHODOX) BENCH_CHECK(OrthodoxEaster(k.y) == DaysFromCivil(k.y, k.m, k.d));
+    // Always a Sunday, the Catholic one between 22 March and 25 April
+    for (int y = 1583; y <= 4099; y++) {
+        int32_t c = CatholicEaster(y), o = OrthodoxEaster(y);
+        BENCH_CHECK(WeekdayFromDays(c) == 6 && WeekdayFromDays(o) == 6 && o >= c);
+        BENCH_CHECK(c >= DaysFromCivil(y, 3, 22) && c <= DaysFromCivil(y, 4, 25));
+    }
+}
+
+static int CountYear(const HolidayCalendar& h, int y) {
+    int n = 0;
+    for (int32_t z = DaysFromCivil(y, 1, 1); z < DaysFromCivil(y + 1, 1, 1); z++) n += h.IsHoliday(z);
+    return n;
+}
+
+static void CheckRules() {
+    HolidayCalendar h;
+    // 6 fixed days, Good Friday to Easter Monday twice; both Easters on 20 April 2025
+    BENCH_CHECK(CountYear(h, 2026) == 12 && CountYear(h, 2025) == 9);
+    BENCH_CHECK(h.IsHoliday(DaysFromCivil(2026, 1, 7)) && h.IsHoliday(DaysFromCivil(2026, 4, 10)));
+    BENCH_CHECK(!h.IsHoliday(DaysFromCivil(2026, 4, 11)) && !h.IsHoliday(DaysFromCivil(2026, 12, 25)));
+    BENCH_CHECK(strcmp(h.Name(DaysFromCivil(2026, 4, 13)), "Vaskrsnji ponedjeljak") == 0);
+    BENCH_CHECK(h.Name(DaysFromCivil(2026, 4, 11)) == nullptr);
+    BENCH_CHECK(h.MonthMask(4, 2026) == (1u << 2 | 1u << 4 | 1u << 5 | 1u << 9 | 1u << 11 | 1u << 12));
+
+    HolidayRule rule;
+    BENCH_CHECK(Rule("  U+39  Spasovdan ", rule) && rule.kind == HolidayRule::EASTER && rule.offset == 39 &&
+                rule.name == "Spasovdan");
+    BENCH_CHECK(Rule("-P-2", rule) && rule.remove && rule.kind == HolidayRule::ORTHODOX_EASTER && rule.offset == -2);
+    BENCH_CHECK(Rule("02-29", rule) && rule.DayIn(2025) == INT32_MIN && rule.DayIn(2028) == DaysFromCivil(2028, 2, 29));
+    BENCH_CHECK(ParseHolidayRule("# komentar", "# komentar" + 10, rule)[0] == 0);
+    static const char* const BAD[] = { "13-01", "02-30", "2026-02-29", "U+", "U+-1", "P+61", "X", "1-1" };
+    for (const char* line : BAD) BENCH_CHECK(!Rule(line, rule));
+
+    // A holiday file: additions, a one-off date, a removal, malformed lines
+    FILE* f = tmpfile();
+    BENCH_CHECK(f != nullptr);
+    if (!f) return;
+    fputs("# praznici firme\n12-25 Bozic\n\n2026-03-02 Kolektivni odmor\n-11-11\nU+39\nP+70\n13-13 los\n", f);
+    rewind(f);
+    TextParseReport r;
+    BENCH_CHECK(h.Load(f, &r) == 4);
+    fclose(f);
+    BENCH_CHECK(r.lines == 8 && r.records == 4 && r.errorCount == 2 && r.errors[0].line == 7);
+    BENCH_CHECK(h.IsHoliday(DaysFromCivil(2026, 12, 25)) && h.IsHoliday(DaysFromCivil(2026, 3, 2)));
+    BENCH_CHECK(!h.IsHoliday(DaysFromCivil(2027, 3, 2)) && !h.IsHoliday(DaysFromCivil(2026, 11, 11)));
+    BENCH_CHECK(h.IsHoliday(CatholicEaster(2026) + 39) && h.Name(CatholicEaster(2026) + 39)[0] == 0);
+    BENCH_CHECK(CountYear(h, 2026) == 14);
+
+    // Years outside the cache give the same answers as cached ones
+    HolidayCalendar wide = h;
+    wide.Prepare(1700, 2500);
+    for (int y : { 1700, 1899, 2200, 2500 }) {
+        for (int32_t z = DaysFromCivil(y, 1, 1); z < DaysFromCivil(y + 1, 1, 1); z++)
+            BENCH_CHECK(h.IsHoliday(z) == wide.IsHoliday(z));
+    }
+    h.Clear();
+    BENCH_CHECK(CountYear(h, 2026) == 0);
+}
+
+int BenchHolidays(int argc, char** argv) {
+    int lookups = argc > 0 ? atoi(argv[0]) : 10000000;
+    if (lookups <= 0) lookups = 10000000;
+
+    CheckEaster();
+    CheckRules();
+
+    // The same days as the sorted list PayrollModel used to hold
+    HolidayCalendar h;
+    std::vector<int32_t> sorted;
+    const int32_t from = DaysFromCivil(1990, 1, 1), to = DaysFromCivil(2089, 12, 31);
+    for (int32_t z = from; z <= to; z++)
+        if (h.IsHoliday(z)) sorted.push_back(z);
+
+    const int32_t span = to - from + 1;
+    int64_t sink = 0;
+    double t0 = NowSeconds();
+    for (int i = 0; i < lookups; i++) sink += h.IsHoliday(from + (int32_t)((uint32_t)i * 7919u % (uint32_t)span));
+    double t1 = NowSeconds();
+    for (int i = 0; i < lookups; i++) {
+        int32_t z = from + (int32_t)((uint32_t)i * 7919u % (uint32_t)span);
+        sink += std::binary_search(sorted.begin(), sorted.end(), z);
+    }
+    double t2 = NowSeconds();
+    // Out of the cache: the year computed per call
+    const int slow = lookups / 100 + 1;
+    for (int i = 0; i < slow; i++) sink += h.IsHoliday(DaysFromCivil(2300, 1, 1) + i % 365);
+    double t3 = NowSeconds();
+    const int rebuilds = 20;
+    for (int i = 0; i < rebuilds; i++) {
+        HolidayCalendar fresh;
+        sink += fresh.IsHoliday(from);
+    }
+    double t4 = NowSeconds();
+    uint32_t masks = 0;
+    for (int i = 0; i < lookups / 100; i++) masks ^= h.MonthMask(i % 12 + 1, 2000 + i % 50);
+    double t5 = NowSeconds();
+    DoNotOptimize(sink);
+    DoNotOptimize(masks);
+    BENCH_CHECK(sink > 0);
+
+    printf("%zu holidays in 1990-2089\n", sorted.size());
+    printf("lookup: bit test %6.2f ns  sorted list %6.2f ns  uncached year %8.1f ns\n",
+           (t1 - t0) / lookups * 1e9, (t2 - t1) / lookups * 1e9, (t3 - t2) / slow * 1e9);
+    printf("cache of %d years: %7.1f us  month mask: %6.1f ns\n",
+           HolidayCalendar::CACHE_LAST - HolidayCalendar::CACHE_FIRST + 1, (t4 - t3) / rebuilds * 1e6,
+           (t5 - t4) / (lookups / 100) * 1e9);
+    return 0;
+}
@@ -0,0 +1,176 @@
+// ============================================================================
+//  BENCH IMPORT - CSV / iCalendar import of exported files: rows/s of parse
+//  and apply, the round trip against the source roster, merge policies,
+//  rejected rows and one notification / undo step per import
+// ============================================================================
+
+#include <cstring>
+#include <string>
+#include "bench.h"
+#include "core/export_format.h"
+#include "core/import_format.h"
+#include "core/rotation.h"
+#include "core/shift_history.h"
+
+static const int FIRST_YEAR = 2020;
+
+struct CountingObserver : ShiftObserver {
+    int calls = 0;
+    void OnShiftsChanged(int32_t, int32_t) override { calls++; }
+};
+
+static ImportReport Parsed(const char* text, ImportFormat format, std::vector<ShiftRecord>& out,
+                           const ImportOptions& opt = ImportOptions()) {
+    ImportReport r;
+    out.clear();
+    ParseImport(text, strlen(text), format, opt, out, r);
+    return r;
+}
+
+static void CheckFormats() {
+    std::vector<ShiftRecord> recs;
+    const int32_t d = DaysFromCivil(2026, 3, 14);
+
+    // Spreadsheet: ';', DD.MM.YYYY, words, quotes, columns in any order
+    ImportReport r = Parsed("Smjena;Datum;Radnik\r\n"
+                            "Dnevna;14.03.2026;5\r\n"
+                            "\"Nocna\";15.3.2026.;\r\n"
+                            "-;16.03.2026;5\r\n"
+                            "X;17.03.2026;5\r\n"
+                            "D;31.02.2026;5\r\n"
+                            "\r\n"
+                            "3;2026-03-18;abc\r\n", IMPORT_CSV, recs);
+    BENCH_CHECK(r.rows == 6 && recs.size() == 2 && r.skipped == 1 && r.rejected == 3);
+    BENCH_CHECK(recs[0].day == d && recs[0].type == SHIFT_DAY && recs[0].employee == 5);
+    BENCH_CHECK(recs[1].day == d + 1 && recs[1].type == SHIFT_NIGHT && recs[1].employee == Roster::DEFAULT_ID);
+    BENCH_CHECK(r.parse.errorCount == 3 && r.parse.errors[0].line == 5 && r.parse.errors[1].line == 6 &&
+                r.parse.errors[2].line == 8);
+
+    // No header: date, shift[, employee]; --emp style override
+    ImportOptions opt;
+    opt.fileEmployees = false;
+    opt.employee = 9;
+    r = Parsed("2026-03-14,S,3\n2026-03-15,1\n", IMPORT_CSV, recs, opt);
+    BENCH_CHECK(r.rows == 2 && recs.size() == 2 && recs[0].type == SHIFT_FREE && recs[0].employee == 9 &&
+                recs[1].type == SHIFT_DAY && recs[1].employee == 9);
+    r = Parsed("datum,ime\n2026-03-14,Ana\n", IMPORT_CSV, recs);
+    BENCH_CHECK(recs.empty() && r.rejected == 2);
+
+    // iCalendar: folded and escaped titles, keywords, start times, UIDs
+    r = Parsed("BEGIN:VCALENDAR\r\n"
+               "BEGIN:VEVENT\r\nUID:20260314-7@smjene\r\nDTSTART:20260314T190000\r\n"
+               "SUMMARY:Sastanak\r\nEND:VEVENT\r\n"
+               "BEGIN:VEVENT\r\nUID:abc@example.com\r\nDTSTART;VALUE=DATE:20260315\r\n"
+               "SUMMARY:Dn\r\n evna smjena\\, Ana\r\nEND:VEVENT\r\n"
+               "BEGIN:VEVENT\r\nDTSTART;TZID=Europe/Sarajevo:20260316T070000\r\nEND:VEVENT\r\n"
+               "BEGIN:VEVENT\r\nDTSTART:20260317T120000Z\r\nEND:VEVENT\r\n"
+               "BEGIN:VEVENT\r\nSUMMARY:Slobodan dan\r\nEND:VEVENT\r\n"
+               "BEGIN:VEVENT\r\nDTSTART:2026\r\nEND:VEVENT\r\n"
+               "END:VCALENDAR\r\n", IMPORT_ICS, recs);
+    BENCH_CHECK(r.rows == 6 && recs.size() == 3 && r.rejected == 3);
+    BENCH_CHECK(recs[0].day == d && recs[0].type == SHIFT_NIGHT && recs[0].employee == 7);
+    BENCH_CHECK(recs[1].day == d + 1 && recs[1].type == SHIFT_DAY && recs[1].employee == Roster::DEFAULT_ID);
+    BENCH_CHECK(recs[2].day == d + 2 && recs[2].type == SHIFT_DAY);
+    BENCH_CHECK(r.parse.errors[0].line == 16 && r.parse.errors[1].line == 19 && r.parse.errors[2].line == 22);
+}
+
+// Merge counters, last row of a day wins, one notification and undo step
+static void CheckMerge() {
+    const int32_t d = DaysFromCivil(2026, 3, 1);
+    for (int keep = 0; keep < 2; keep++) {
+        Roster team;
+        ShiftStore& s = team.Default();
+        s.Set(d, SHIFT_DAY);
+        s.Set(d + 1, SHIFT_NIGHT);
+        ShiftHistory history;
+        history.Attach(s);
+        CountingObserver obs;
+        s.AddObserver(&obs);
+
+        std::vector<ShiftRecord> recs;
+        ImportOptions opt;
+        opt.mode = keep ? MERGE_KEEP : MERGE_OVERWRITE;
+        ImportReport r = Parsed("datum,smjena\n2026-03-01,D\n2026-03-02,S\n2026-03-05,N\n"
+                                "2026-03-05,D\n2027-01-01,S\n", IMPORT_CSV, recs, opt);
+        history.Begin();
+        ApplyImport(team, recs, opt, r);
+        history.Commit();
+        BENCH_CHECK(obs.calls == 1 && history.UndoSteps() == 1);
+        BENCH_CHECK(r.added == 2 && r.overwritten == (keep ? 0u : 1u) && r.skipped == (keep ? 3u : 2u));
+        BENCH_CHECK(s.Get(d + 1) == (keep ? SHIFT_NIGHT : SHIFT_FREE) && s.Get(d + 4) == SHIFT_DAY &&
+                    s.Get(d + 2) == SHIFT_NONE && s.Get(DaysFromCivil(2027, 1, 1)) == SHIFT_FREE && s.Count() == 4);
+        BENCH_CHECK(history.Undo() && s.Count() == 2 && s.Get(d + 1) == SHIFT_NIGHT);
+        s.RemoveObserver(&obs);
+    }
+}
+
+// Every shift of a in b and nothing else
+static bool SameRoster(const Roster& a, const Roster& b) {
+    if (a.Count() != b.Count()) return false;
+    for (size_t i = 0; i < a.Size(); i++) {
+        int j = b.Find(a.At(i).id);
+        if (a.Shifts(i).Count() == 0) continue;
+        if (j < 0 || b.Shifts((size_t)j).Count() != a.Shifts(i).Count()) return false;
+        bool same = true;
+        const ShiftStore& other = b.Shifts((size_t)j);
+        a.Shifts(i).ForEach(DaysFromCivil(ShiftStore::MIN_YEAR, 1, 1), DaysFromCivil(ShiftStore::MAX_YEAR, 12, 31),
+                            [&](int32_t day, ShiftType st) { same = same && other.Get(day) == st; });
+        if (!same) return false;
+    }
+    return true;
+}
+
+int BenchImport(int argc, char** argv) {
+    int rows = argc > 0 ? atoi(argv[0]) : 100000;
+    if (rows <= 0) rows = 100000;
+
+    CheckFormats();
+    CheckMerge();
+
+    // A team with rows shifts, 10 years per employee
+    Roster team;
+    const int32_t first = DaysFromCivil(FIRST_YEAR, 1, 1), last = DaysFromCivil(FIRST_YEAR + 10, 1, 1) - 1;
+    for (uint32_t e = 0; team.Count() < (size_t)rows; e++) {
+        Rotation rot;
+        ParseRotation("DDNNSSSS", first + (int32_t)e, rot);
+        int i = team.Add(e);
+        int32_t to = first + (int32_t)((size_t)rows - team.Count()) - 1;
+        ApplyRotation(team.Shifts((size_t)i), rot, first, to < last ? to : last, MERGE_OVERWRITE);
+    }
+    printf("team: %zu employees, %zu shifts\n", team.Size(), team.Count());
+
+    struct Source { const char* name; ImportFormat format; };
+    static const Source SOURCES[] = { { "csv", IMPORT_CSV }, { "ics", IMPORT_ICS } };
+    for (const Source& src : SOURCES) {
+        FILE* f = tmpfile();
+        BENCH_CHECK(f);
+        ExportOptions eo;
+        BENCH_CHECK(src.format == IMPORT_ICS ? ExportIcs(f, team, eo) : ExportCsv(f, team, eo));
+        long size = ftell(f);
+        rewind(f);
+
+        std::vector<ShiftRecord> recs;
+        ImportReport r;
+        ImportOptions opt;
+        double t0 = NowSeconds();
+        ReadImport(f, src.format, opt, recs, r);
+        double t1 = NowSeconds();
+        fclose(f);
+        Roster copy;
+        ApplyImport(copy, recs, opt, r);
+        double t2 = NowSeconds();
+        BENCH_CHECK(r.rows == team.Count() && r.added == team.Count() && r.rejected == 0 && SameRoster(team, copy));
+
+        // Again with KEEP: nothing changes, every row skipped
+        ImportReport again;
+        opt.mode = MERGE_KEEP;
+        ApplyImport(copy, recs, opt, again);
+        BENCH_CHECK(again.added == 0 && again.overwritten == 0 && again.skipped == team.Count());
+
+        double secs = t2 - t0;
+        if (rows <= 100000) BENCH_CHECK(secs < 1.0);
+        printf("%-4s %6.1f MB  parse %7.1f ms  apply %6.1f ms  %6.2f M rows/s  %6.0f MB/s\n", src.name, size / 1e6,
+               (t1 - t0) * 1e3, (t2 - t1) * 1e3, r.rows / secs / 1e6, size / 1e6 / (t1 - t0));
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+// ============================================================================
+//  BENCH KERNELS - scalar/SSE2/AVX2 count kernels checked for exact agreement
+//  with the scalar path, then timed over 1..50 year ranges against counting
+//  one day at a time
+// ============================================================================
+
+#include <random>
+#include <vector>
+#include "bench.h"
+#include "core/count_kernels.h"
+#include "core/rotation.h"
+
+static bool Same(const ShiftCounts& a, const ShiftCounts& b) {
+    return a.day == b.day && a.night == b.night && a.free == b.free;
+}
+
+static ShiftCounts SlotBySlot(const uint64_t* words, int from, int to) {
+    ShiftCounts c;
+    for (int i = from; i < to; i++)
+        c.Add((ShiftType)((words[i / ShiftStore::SLOTS_PER_WORD] >> (2 * (i % ShiftStore::SLOTS_PER_WORD))) & 3), 1);
+    return c;
+}
+
+static void CheckKernels(std::mt19937_64& rng) {
+    // Random words, some runs of a single code so the byte sums saturate
+    std::vector<uint64_t> words(4096 + 3);
+    for (size_t i = 0; i < words.size(); i++) {
+        int kind = (int)(i / 512 % 5);
+        words[i] = kind == 0 ? rng() : kind == 1 ? SLOT_LOW_BITS : kind == 2 ? ~0ull
+                 : kind == 3 ? SLOT_LOW_BITS << 1 : (rng() & rng());
+    }
+    int checked = 0;
+    for (int k = COUNT_SCALAR + 1; k < COUNT_KERNELS; k++) {
+        if (!CountKernelSupported((CountKernel)k)) continue;
+        for (int t = 0; t < 3000; t++) {
+            size_t start = rng() % 4, n = t < 100 ? (size_t)t : (size_t)(rng() % 4096);
+            ShiftCounts ref = CountPackedWordsWith(COUNT_SCALAR, words.data() + start, n);
+            BENCH_CHECK(Same(CountPackedWordsWith((CountKernel)k, words.data() + start, n), ref));
+        }
+        checked++;
+    }
+    // Slot ranges with masked edges around the kernel part
+    for (int t = 0; t < 3000; t++) {
+        int a = (int)(rng() % 20000), b = a + (int)(rng() % 2000);
+        BENCH_CHECK(Same(CountPackedSlots(words.data(), a, b), SlotBySlot(words.data(), a, b)));
+    }
+    printf("count kernels: %d wide kernel(s) agree with scalar, active: %s\n",
+           checked, CountKernelName(ActiveCountKernel()));
+}
+
+int BenchKernels(int argc, char** argv) {
+    long reps = argc > 0 ? atol(argv[0]) : 20000;
+    if (reps <= 0) reps = 20000;
+
+    std::mt19937_64 rng(12);
+    CheckKernels(rng);
+
+    static const int YEARS[] = { 1, 10, 50 };
+    for (int years : YEARS) {
+        ShiftStore s;
+        const int32_t lo = DaysFromCivil(2000, 1, 1), hi = DaysFromCivil(2000 + years, 1, 1) - 1;
+        Rotation rot;
+        ParseRotation("DDNN-SSS", lo, rot);
+        ApplyRotation(s, rot, lo, hi, MERGE_OVERWRITE);
+        const uint64_t* w = s.YearWords(2000);
+        size_t n = (size_t)years * ShiftStore::WORDS_PER_YEAR;
+        ShiftCounts expect = s.CountByType(lo, hi);
+
+        // One day at a time, as the old stats loop did
+        long dayReps = reps / years / 10 > 0 ? reps / years / 10 : 1;
+        long sink = 0;
+        double t0 = NowSeconds();
+        for (long r = 0; r < dayReps; r++) {
+            ShiftCounts c;
+            for (int32_t z = lo; z <= hi; z++) c.Add(s.Get(z), 1);
+            sink += c.Working();
+        }
+        double perDay = (NowSeconds() - t0) * 1e9 / dayReps;
+        printf("%2dy  per-day Get %12.1f ns/scan\n", years, perDay);
+
+        for (int k = 0; k < COUNT_KERNELS; k++) {
+            if (!CountKernelSupported((CountKernel)k)) continue;
+            BENCH_CHECK(Same(CountPackedWordsWith((CountKernel)k, w, n), expect));
+            t0 = NowSeconds();
+            for (long r = 0; r < reps; r++) {
+                DoNotOptimize(w);
+                sink += CountPackedWordsWith((CountKernel)k, w, n).Working();
+            }
+            double ns = (NowSeconds() - t0) * 1e9 / reps;
+            printf("%2dy  %-11s %12.1f ns/scan  %6.2f GB/s  x%.0f vs per-day\n",
+                   years, CountKernelName((CountKernel)k), ns, n * 8 / ns, perDay / ns);
+        }
+        DoNotOptimize(sink);
+    }
+    return 0;
+}
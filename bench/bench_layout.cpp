@@ -0,0 +1,111 @@
+// ============================================================================
+//  BENCH LAYOUT - hit tests against the computed rects for every month of a
+//  few window sizes, the dirty rects of typical UI changes and how much of
+//  the window they repaint
+// ============================================================================
+
+#include <initializer_list>
+#include "bench.h"
+#include "core/layout.h"
+
+static const int SIZES[][2] = { { 934, 701 }, { 700, 520 }, { 1920, 1040 } };
+
+static LayoutRect Center(const LayoutRect& r) {
+    int x = (r.left + r.right) / 2, y = (r.top + r.bottom) / 2;
+    return MakeRect(x, y, 1, 1);
+}
+
+static void CheckGeometry(const CalendarLayout& l) {
+    for (int i = 0; i < BTN_COUNT; i++) {
+        BENCH_CHECK(!l.buttons[i].Empty());
+        BENCH_CHECK(l.buttons[i].Intersects(l.header));
+        LayoutRect c = Center(l.buttons[i]);
+        BENCH_CHECK(l.HitButton(c.left, c.top) == i);
+        BENCH_CHECK(l.HitDay(c.left, c.top) == -1);
+        for (int j = i + 1; j < BTN_COUNT; j++) BENCH_CHECK(!l.buttons[i].Intersects(l.buttons[j]));
+    }
+    for (int day = 1; day <= l.grid.days; day++) {
+        LayoutRect cell = l.Cell(day);
+        BENCH_CHECK(cell.bottom <= l.gridBottom);
+        LayoutRect c = Center(cell);
+        BENCH_CHECK(l.HitDay(c.left, c.top) == day);
+        BENCH_CHECK(l.HitDay(cell.left, cell.top) == day && l.HitDay(cell.right - 1, cell.bottom - 1) == day);
+        BENCH_CHECK(l.HitButton(c.left, c.top) == -1);
+    }
+    BENCH_CHECK(l.HitDay(l.gridLeft - 1, l.gridTop) == -1);
+    BENCH_CHECK(!l.stats.Intersects(l.legend) && l.legend.bottom == l.height);
+}
+
+int BenchLayout(int argc, char** argv) {
+    long moves = argc > 0 ? atol(argv[0]) : 1000000;
+    if (moves <= 0) moves = 1000000;
+
+    int layouts = 0;
+    for (const auto& sz : SIZES)
+        for (int y = 2024; y <= 2027; y++)
+            for (int m = 1; m <= 12; m++, layouts++) CheckGeometry(ComputeLayout(sz[0], sz[1], m, y));
+    printf("geometry: %d layouts, every button and day hit at its rect\n", layouts);
+
+    const int W = SIZES[0][0], H = SIZES[0][1];
+    CalendarLayout l = ComputeLayout(W, H, 3, 2026);
+    UiState a;
+    a.width = W; a.height = H; a.viewMonth = 3; a.viewYear = 2026;
+    a.today = DaysFromCivil(2026, 3, 14);
+    BENCH_CHECK(DiffUi(l, a, a).None());
+
+    struct Change { const char* name; UiState to; };
+    Change changes[5] = { { "hover day -> next day", a }, { "hover day -> button", a },
+                          { "hover leave", a }, { "next month", a }, { "resize", a } };
+    a.hoverDay = 10;
+    for (Change& c : changes) c.to.hoverDay = 10;
+    changes[0].to.hoverDay = 11;
+    changes[1].to.hoverDay = -1; changes[1].to.hoverBtn = BTN_TODAY;
+    changes[2].to.hoverDay = -1;
+    changes[3].to.viewMonth = 4;
+    changes[4].to.width = W + 1;
+
+    for (const Change& c : changes) {
+        DirtyRects d = DiffUi(l, a, c.to);
+        printf("%-22s %s %d rect(s)  %5.1f%% of the window\n", c.name, d.full ? "full" : "    ",
+               d.count, 100.0 * d.Area(W, H) / (W * H));
+    }
+    // Neighbouring cells share an edge and merge into one rect, distant ones do not
+    DirtyRects hover = DiffUi(l, a, changes[0].to);
+    BENCH_CHECK(!hover.full && hover.count == 1);
+    BENCH_CHECK(hover.rects[0].Intersects(l.Cell(10)) && hover.rects[0].Intersects(l.Cell(11)));
+    BENCH_CHECK(hover.Area(W, H) <= 2 * MakeRect(0, 0, l.cellW + 2, l.cellH + 2).Area());
+    UiState far = a;
+    far.hoverDay = 25;
+    BENCH_CHECK(DiffUi(l, a, far).count == 2);
+    BENCH_CHECK(DiffUi(l, a, changes[1].to).count == 2);
+    BENCH_CHECK(DiffUi(l, a, changes[2].to).count == 1);
+    BENCH_CHECK(DiffUi(l, a, changes[3].to).full && DiffUi(l, a, changes[4].to).full);
+
+    // Edits: one day, a week, the whole month, and days outside the view
+    const int32_t first = l.grid.first;
+    DirtyRects one = DirtyForDays(l, first + 4, first + 4);
+    BENCH_CHECK(!one.full && one.count == 2);
+    DirtyRects week = DirtyForDays(l, first, first + 6), month = DirtyForDays(l, first - 40, first + 80);
+    BENCH_CHECK(!week.full && !month.full);
+    for (const DirtyRects* d : { &one, &week, &month }) {
+        bool stats = false;
+        for (int i = 0; i < d->count; i++) stats |= d->rects[i].Intersects(l.stats);
+        BENCH_CHECK(stats);
+    }
+    BENCH_CHECK(DirtyForDays(l, first - 10, first - 1).None());
+    printf("%-22s      %d rect(s)  %5.1f%% of the window\n", "edit one day", one.count, 100.0 * one.Area(W, H) / (W * H));
+    printf("%-22s      %d rect(s)  %5.1f%% of the window\n", "edit month", month.count, 100.0 * month.Area(W, H) / (W * H));
+
+    // What a mouse move costs before any painting
+    double t0 = NowSeconds();
+    long sink = 0;
+    for (long r = 0; r < moves; r++) {
+        UiState b = a;
+        b.hoverDay = l.HitDay(l.gridLeft + (int)(r % 7) * l.cellW + 5, l.gridTop + (int)(r % 5) * l.cellH + 5);
+        DirtyRects d = DiffUi(l, a, b);
+        sink += d.count;
+    }
+    DoNotOptimize(sink);
+    printf("hit test + diff        %.1f ns/move\n", (NowSeconds() - t0) * 1e9 / moves);
+    return 0;
+}
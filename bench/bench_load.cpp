@@ -0,0 +1,81 @@
+// ============================================================================
+//  BENCH LOAD - smjene_data.txt parsing throughput
+//  Compares the original LoadData() loop (fgets into 64 bytes, atoi,
+//  widening each key, std::map<std::wstring,int>) with ReadShiftText().
+// ============================================================================
+
+#include <cstring>
+#include <cwchar>
+#include <map>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "core/text_format.h"
+
+static void GenerateFile(const char* path, long lines) {
+    FILE* f = fopen(path, "wb");
+    BENCH_CHECK(f != nullptr);
+    std::vector<char> buf(1 << 20);
+    size_t used = 0;
+    int32_t first = DaysFromCivil(1970, 1, 1);
+    for (long i = 0; i < lines; i++) {
+        if (used + 16 > buf.size()) { fwrite(buf.data(), 1, used, f); used = 0; }
+        // ~200 years of distinct days, then repeats (later lines overwrite)
+        used += (size_t)FormatShiftLine(&buf[used], first + (int32_t)(i % 73000), (ShiftType)(1 + i % 3));
+    }
+    fwrite(buf.data(), 1, used, f);
+    fclose(f);
+}
+
+// The pre-ShiftStore LoadData(), with mbstowcs standing in for MultiByteToWideChar
+static size_t LegacyLoad(const char* path, std::map<std::wstring, int>& shifts) {
+    shifts.clear();
+    FILE* f = fopen(path, "r");
+    if (!f) return 0;
+    char buf[64];
+    while (fgets(buf, sizeof(buf), f)) {
+        if (strlen(buf) < 12) continue;
+        buf[10] = 0;
+        int val = atoi(buf + 11);
+        if (val >= 1 && val <= 3) {
+            wchar_t wkey[16];
+            mbstowcs(wkey, buf, 16);
+            wkey[10] = 0;
+            shifts[wkey] = val;
+        }
+    }
+    fclose(f);
+    return shifts.size();
+}
+
+int BenchLoad(int argc, char** argv) {
+    long lines = argc > 0 ? atol(argv[0]) : 10000000L;
+    const char* path = argc > 1 ? argv[1] : "smjene_bench_load.txt";
+
+    double t0 = NowSeconds();
+    GenerateFile(path, lines);
+    printf("generated %ld lines in %.2f s (%s)\n", lines, NowSeconds() - t0, path);
+
+    std::map<std::wstring, int> legacy;
+    t0 = NowSeconds();
+    size_t legacyCount = LegacyLoad(path, legacy);
+    double tLegacy = NowSeconds() - t0;
+
+    ShiftStore store;
+    TextParseReport report;
+    FILE* f = fopen(path, "rb");
+    BENCH_CHECK(f != nullptr);
+    t0 = NowSeconds();
+    ReadShiftText(f, store, false, &report);
+    double tNew = NowSeconds() - t0;
+    fclose(f);
+
+    BENCH_CHECK(report.errorCount == 0 && report.records == (size_t)lines);
+    BENCH_CHECK(store.Count() == legacyCount);
+
+    printf("%-22s %8.3f s %12.0f lines/s\n", "legacy fgets+map", tLegacy, lines / tLegacy);
+    printf("%-22s %8.3f s %12.0f lines/s   x%.1f\n", "streaming parser", tNew, lines / tNew, tLegacy / tNew);
+    printf("entries %zu, ShiftStore %zu bytes\n", store.Count(), store.MemoryUsage());
+    remove(path);
+    return 0;
+}
@@ -0,0 +1,53 @@
+// ============================================================================
+//  SMJENE BENCH - portable benchmarks for the core library
+//  Usage: smjene_bench [case] [case args...]   (no case = all with defaults)
+// ============================================================================
+
+#include <cstring>
+#include "bench.h"
+
+struct BenchCase {
+    const char* name;
+    const char* usage;
+    int (*run)(int argc, char** argv);
+};
+
+static const BenchCase CASES[] = {
+    { "calendar", "[calls=1000000]  exhaustive 1600-2400 engine check, DayOfWeek vs mktime", BenchCalendar },
+    { "export", "[employees=100] [years=10]  iCalendar/CSV export MB/s vs text writer and raw fwrite, format rules", BenchExport },
+    { "history", "[years=50]  undo/redo check, diff size of a 12-month copy and a reset", BenchHistory },
+    { "holidays", "[lookups=10000000]  Easter computus, built-in/file rules, cached bit test vs sorted list", BenchHolidays },
+    { "import", "[rows=100000]  CSV/iCalendar import rows/s, round trip, merge policies, rejected rows", BenchImport },
+    { "kernels", "[reps=20000]  SIMD count kernels vs scalar, 1-50 year scans", BenchKernels },
+    { "layout", "[moves=1000000]  month view rects, hit tests, dirty rects of hover/edit/navigation", BenchLayout },
+    { "load", "[lines=10000000] [file]  text load: legacy fgets/map vs streaming parser", BenchLoad },
+    { "ops", "[years employees [ops=1000000]]  ns/op + allocs/op of get/set/stats/copy/load/save", BenchOps },
+    { "overview", "[reps=200] [out.ppm]  month/week summaries vs per-day, hit tests, 5-year switch time", BenchOverview },
+    { "payroll", "[employees=1000] [edits=100000]  shift hours/premiums/overtime, incremental month totals, team year on all cores", BenchPayroll },
+    { "persist", "[edits=2000] [delay_ms=250] [base]  Commit() latency: fsynced journal vs write-behind thread", BenchPersist },
+    { "range", "[years=10] [reps=1000]  word-parallel fill/copy/move/swap vs day by day, 10-year spans", BenchRange },
+    { "render", "[reps=2000] [out.ppm]  month view display list: build, cache, raster, dirty repaints", BenchRender },
+    { "roster", "[employees=1000] [years=10]  team memory, per-day/per-person queries, formats", BenchRoster },
+    { "rules", "[edits=100000] [employees=1000]  labour rules per edit (window) vs whole history, team check on all cores", BenchRules },
+    { "schedule", "[employees=30] [days=91] [moves=5000]  annealing scheduler: rules/coverage met, same seed same plan, quality vs rounds and workers", BenchSchedule },
+    { "search", "[years=50]  per-type/weekday bitsets vs Get, expressions vs day loops, query time vs per-day scan", BenchSearch },
+    { "stats", "[queries=200000]  month/range counters vs rescan", BenchStats },
+    { "trace", "[scopes=1000000]  TRACE_SCOPE cost off/on, ring wraparound, threads, p50/p99, Chrome JSON", BenchTrace },
+};
+
+int main(int argc, char** argv) {
+    if (argc > 1 && (!strcmp(argv[1], "-h") || !strcmp(argv[1], "--help"))) {
+        printf("usage: smjene_bench [case] [args...]\n");
+        for (const BenchCase& c : CASES) printf("  %-10s %s\n", c.name, c.usage);
+        return 0;
+    }
+    for (const BenchCase& c : CASES) {
+        if (argc > 1 && strcmp(argv[1], c.name) != 0) continue;
+        printf("== %s\n", c.name);
+        int rc = c.run(argc > 1 ? argc - 2 : 0, argc > 1 ? argv + 2 : argv + argc);
+        if (rc) return rc;
+        if (argc > 1) return 0;
+    }
+    if (argc > 1) { fprintf(stderr, "unknown case '%s'\n", argv[1]); return 1; }
+    return 0;
+}
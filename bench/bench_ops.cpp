@@ -0,0 +1,160 @@
+// ============================================================================
+//  BENCH OPS - ns/op and allocations/op of the everyday shift operations
+//  (get, set, month stats, copy to 12 months, rotation, load, save) for datasets from
+//  one year x one employee up to 50 years x 1000 employees.
+//  Each employee is a separate ShiftStore; load/save run on a sample of them.
+// ============================================================================
+
+#include <random>
+#include <vector>
+#include "bench.h"
+#include "core/binary_format.h"
+#include "core/rotation.h"
+#include "core/shift_ops.h"
+#include "core/text_format.h"
+
+static const int FIRST_YEAR = 2000;
+static const int FILE_SAMPLE = 20;
+
+struct OpResult { double ns, allocs; };
+
+template <class Fn> static OpResult Measure(long ops, Fn&& fn) {
+    size_t a0 = BenchAllocCount();
+    double t0 = NowSeconds();
+    fn();
+    double t1 = NowSeconds();
+    return OpResult{ (t1 - t0) * 1e9 / ops, (double)(BenchAllocCount() - a0) / ops };
+}
+
+static void Report(const char* op, int years, int employees, const OpResult& r) {
+    printf("%-14s %3dy x %4d   %12.1f ns/op   %8.2f allocs/op\n", op, years, employees, r.ns, r.allocs);
+}
+
+static std::vector<uint8_t> ReadAll(FILE* f) {
+    std::vector<uint8_t> data;
+    fseek(f, 0, SEEK_END);
+    data.resize((size_t)ftell(f));
+    rewind(f);
+    if (!data.empty() && fread(data.data(), 1, data.size(), f) != data.size()) data.clear();
+    return data;
+}
+
+static int RunSize(int years, int employees, long ops) {
+    // Every employee on the DAY/NIGHT/FREE/FREE rotation, shifted by index
+    std::vector<ShiftStore> staff((size_t)employees);
+    const int32_t lo = DaysFromCivil(FIRST_YEAR, 1, 1);
+    const int32_t hi = DaysFromCivil(FIRST_YEAR + years, 1, 1) - 1;
+    static const ShiftType cycle[] = { SHIFT_DAY, SHIFT_NIGHT, SHIFT_FREE, SHIFT_FREE };
+    for (int e = 0; e < employees; e++)
+        for (int32_t z = lo; z <= hi; z++) staff[(size_t)e].Set(z, cycle[(z - lo + e) % 4]);
+
+    std::mt19937 rng((unsigned)(years * 7919 + employees));
+    std::uniform_int_distribution<int> anyEmp(0, employees - 1);
+    std::uniform_int_distribution<int32_t> anyDay(lo, hi);
+    std::uniform_int_distribution<int> anyMonth(0, years * 12 - 1);
+    std::vector<int> emp((size_t)ops);
+    std::vector<int32_t> day((size_t)ops);
+    std::vector<int> month((size_t)ops);
+    for (long i = 0; i < ops; i++) {
+        emp[(size_t)i] = anyEmp(rng); day[(size_t)i] = anyDay(rng); month[(size_t)i] = anyMonth(rng);
+    }
+
+    long sink = 0;
+    Report("get", years, employees, Measure(ops, [&] {
+        for (long i = 0; i < ops; i++) sink += staff[(size_t)emp[(size_t)i]].Get(day[(size_t)i]);
+    }));
+    Report("set", years, employees, Measure(ops, [&] {
+        for (long i = 0; i < ops; i++)
+            staff[(size_t)emp[(size_t)i]].Set(day[(size_t)i], cycle[i % 4]);
+    }));
+    Report("month stats", years, employees, Measure(ops, [&] {
+        for (long i = 0; i < ops; i++) {
+            int mi = month[(size_t)i];
+            sink += staff[(size_t)emp[(size_t)i]].CountMonth(mi % 12 + 1, FIRST_YEAR + mi / 12).Working();
+        }
+    }));
+
+    // January of the first year onto every month of the last one
+    int lastYear = FIRST_YEAR + years - 1;
+    Report("copy-12", years, employees, Measure(employees, [&] {
+        for (ShiftStore& s : staff)
+            for (int m = 1; m <= 12; m++) sink += CopyMonthPattern(s, 1, FIRST_YEAR, m, lastYear, true);
+    }));
+    for (int m = 1; m <= 12; m++)
+        BENCH_CHECK(staff[0].Get(1, m, lastYear) == staff[0].Get(1, 1, FIRST_YEAR));
+
+    // D-D-N-N-S-S-S-S over the whole range: per-day Set vs word-at-a-time fill
+    Rotation rot;
+    BENCH_CHECK(ParseRotation("DDNNSSSS", lo, rot));
+    Report("rotation/day", years, employees, Measure(employees, [&] {
+        for (ShiftStore& s : staff)
+            for (int32_t z = lo; z <= hi; z++) s.Set(z, rot.At(z));
+    }));
+    Report("rotation", years, employees, Measure(employees, [&] {
+        for (ShiftStore& s : staff) sink += (long)ApplyRotation(s, rot, lo, hi, MERGE_OVERWRITE);
+    }));
+    BENCH_CHECK(ApplyRotation(staff[0], rot, lo, hi, MERGE_OVERWRITE) == 0);
+    for (int32_t z = lo; z <= hi; z++) BENCH_CHECK(staff[0].Get(z) == rot.At(z));
+
+    // Load/save per employee file, on up to FILE_SAMPLE employees
+    int sample = employees < FILE_SAMPLE ? employees : FILE_SAMPLE;
+    FILE* f = tmpfile();
+    if (!f) { fprintf(stderr, "tmpfile() failed\n"); return 1; }
+
+    std::vector<uint8_t> text, bin;
+    Report("save text", years, sample, Measure(sample, [&] {
+        for (int e = 0; e < sample; e++) { rewind(f); WriteShiftText(f, staff[(size_t)e]); fflush(f); }
+    }));
+    text = ReadAll(f);
+    Report("load text", years, sample, Measure(sample, [&] {
+        for (int e = 0; e < sample; e++) {
+            ShiftStore s;
+            ParseShiftText((const char*)text.data(), text.size(), s, false);
+            BENCH_CHECK(s.Count() == staff[(size_t)sample - 1].Count());
+        }
+    }));
+
+    fclose(f);
+    f = tmpfile();
+    if (!f) { fprintf(stderr, "tmpfile() failed\n"); return 1; }
+    Report("save binary", years, sample, Measure(sample, [&] {
+        for (int e = 0; e < sample; e++) { rewind(f); WriteBinarySnapshot(f, staff[(size_t)e], 1); fflush(f); }
+    }));
+    bin = ReadAll(f);
+    fclose(f);
+    Report("load binary", years, sample, Measure(sample, [&] {
+        for (int e = 0; e < sample; e++) {
+            ShiftStore s;
+            BENCH_CHECK(ReadBinarySnapshot(bin.data(), bin.size(), s, nullptr));
+            BENCH_CHECK(s.Count() == staff[(size_t)sample - 1].Count());
+        }
+    }));
+
+    // ClearMonth/ClearAll semantics: counts returned match what was stored
+    size_t before = staff[0].Count();
+    int janCount = staff[0].CountMonth(1, FIRST_YEAR).Total();
+    BENCH_CHECK(ClearMonth(staff[0], 1, FIRST_YEAR) == janCount && ClearMonth(staff[0], 1, FIRST_YEAR) == 0);
+    BENCH_CHECK(ClearAll(staff[0]) == before - (size_t)janCount && staff[0].Empty());
+
+    DoNotOptimize(sink);
+    return 0;
+}
+
+int BenchOps(int argc, char** argv) {
+    long ops = 1000000;
+    if (argc >= 2) {
+        int years = atoi(argv[0]), employees = atoi(argv[1]);
+        if (argc > 2) ops = atol(argv[2]);
+        if (years < 1 || years > 100 || employees < 1 || ops < 1) {
+            fprintf(stderr, "ops: years 1..100, employees >= 1\n");
+            return 1;
+        }
+        return RunSize(years, employees, ops);
+    }
+    static const int SIZES[][2] = { {1, 1}, {10, 1}, {50, 1}, {1, 1000}, {10, 1000}, {50, 1000} };
+    for (const auto& sz : SIZES) {
+        int rc = RunSize(sz[0], sz[1], ops);
+        if (rc) return rc;
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+// ============================================================================
+//  BENCH OVERVIEW - month/week summaries against per-day lookups, overview
+//  hit tests and pixel probes, and the time of a switch to the 5-year view
+// ============================================================================
+
+#include "bench.h"
+#include "core/calendar_view.h"
+#include "core/month_view.h"
+#include "core/overview_view.h"
+#include "core/raster.h"
+#include "core/rotation.h"
+#include "core/shift_summary.h"
+
+static const int W = 934, H = 701, YEAR = 2026;
+
+int BenchOverview(int argc, char** argv) {
+    long reps = argc > 0 ? atol(argv[0]) : 200;
+    if (reps <= 0) reps = 200;
+    const char* ppm = argc > 1 ? argv[1] : nullptr;
+
+    ShiftStore s;
+    Rotation rot;
+    ParseRotation("DDNN-SSS", DaysFromCivil(YEAR - 2, 1, 1), rot);
+    ApplyRotation(s, rot, DaysFromCivil(YEAR - 2, 1, 1), DaysFromCivil(YEAR + 2, 12, 31), MERGE_OVERWRITE);
+    s.Set(14, 3, YEAR, SHIFT_NONE);
+
+    // Summaries equal per-day lookups and the counters
+    MonthSummary months[60];
+    SummarizeMonths(s, 1, YEAR - 2, 60, months);
+    for (const MonthSummary& ms : months) {
+        ShiftCounts c;
+        for (int d = 1; d <= ms.days; d++) {
+            BENCH_CHECK(ms.Day(d) == s.Get(ms.first + d - 1));
+            c.Add(ms.Day(d), 1);
+        }
+        BENCH_CHECK(c.day == ms.counts.day && c.night == ms.counts.night && c.free == ms.counts.free);
+    }
+    WeekSummary weeks[270];
+    SummarizeWeeks(s, DaysFromCivil(YEAR - 2, 1, 3), 270, weeks);
+    for (const WeekSummary& ws : weeks) {
+        ShiftCounts c;
+        BENCH_CHECK(WeekdayFromDays(ws.monday) == 0);
+        for (int i = 0; i < 7; i++) {
+            BENCH_CHECK(ws.Day(i) == s.Get(ws.monday + i));
+            c.Add(ws.Day(i), 1);
+        }
+        BENCH_CHECK(c.day == ws.counts.day && c.night == ws.counts.night && c.free == ws.counts.free);
+    }
+
+    // Five years of squares and totals: per-day lookups vs summaries
+    const int32_t first = DaysFromCivil(YEAR - 2, 1, 1), last = DaysFromCivil(YEAR + 3, 1, 1) - 1;
+    long sink = 0;
+    double t0 = NowSeconds();
+    for (long r = 0; r < reps; r++)
+        for (int32_t z = first; z <= last; z++) sink += s.Get(z);
+    double naiveUs = (NowSeconds() - t0) * 1e6 / reps;
+    t0 = NowSeconds();
+    for (long r = 0; r < reps; r++) {
+        SummarizeMonths(s, 1, YEAR - 2, 60, months);
+        sink += months[r % 60].codes;
+    }
+    double summaryUs = (NowSeconds() - t0) * 1e6 / reps;
+    DoNotOptimize(sink);
+    printf("5 years   per-day Get %8.1f us   month summaries %6.1f us\n", naiveUs, summaryUs);
+
+    // Hit tests land on the square's day, in both modes
+    for (int mode = VIEW_YEAR; mode <= VIEW_YEARS5; mode++) {
+        OverviewLayout ol = ComputeOverviewLayout(W, H, mode, YEAR);
+        for (int32_t z = ol.FirstDay(); z <= ol.LastDay(); z++) {
+            LayoutRect r = ol.DayRect(z);
+            BENCH_CHECK(!r.Empty() && r.Intersects(ol.area));
+            BENCH_CHECK(ol.HitDay((r.left + r.right) / 2, (r.top + r.bottom) / 2) == z);
+        }
+        BENCH_CHECK(ol.HitDay(0, 0) == -1);
+    }
+
+    // Switch from the month view to 5 years: layout + build, then raster
+    UiState ui;
+    ui.width = W; ui.height = H; ui.viewMode = VIEW_YEARS5; ui.viewMonth = 3; ui.viewYear = YEAR;
+    ui.today = DaysFromCivil(YEAR, 3, 14);
+    RasterMetrics metrics;
+    CalendarLayout l = ComputeLayout(W, H, 3, YEAR);
+    CalendarView view;
+    s.AddObserver(&view);
+    t0 = NowSeconds();
+    for (long r = 0; r < reps; r++) {
+        view.Invalidate();
+        DoNotOptimize(ComputeOverviewLayout(W, H, VIEW_YEARS5, YEAR).square);
+        view.Get(l, ui, s, metrics);
+    }
+    double switchMs = (NowSeconds() - t0) * 1e3 / reps;
+    const DisplayList& dl = view.Get(l, ui, s, metrics);
+    RasterImage frame(W, H);
+    long rasterReps = reps / 20 > 0 ? reps / 20 : 1;
+    t0 = NowSeconds();
+    for (long r = 0; r < rasterReps; r++) RasterizeDisplayList(dl, frame, MakeRect(0, 0, W, H));
+    double rasterMs = (NowSeconds() - t0) * 1e3 / rasterReps;
+    printf("switch    %8.3f ms layout+build  %zu commands   raster %.2f ms (software)\n", switchMs, dl.Size(), rasterMs);
+    BENCH_CHECK(switchMs < 16.0);
+
+    // Square colors, and the cache only drops edits inside the shown years
+    static const DlColor SQUARE[4] = { CLR_CELL_BG, CLR_DAY_SHIFT, CLR_NIGHT_SHIFT, CLR_FREE_DAY };
+    OverviewLayout ol = ComputeOverviewLayout(W, H, VIEW_YEARS5, YEAR);
+    for (int32_t z = ol.FirstDay(); z <= ol.LastDay(); z += 5) {
+        if (z == ui.today) continue;
+        LayoutRect r = ol.DayRect(z);
+        BENCH_CHECK(frame.Pixel((r.left + r.right) / 2, (r.top + r.bottom) / 2) == SQUARE[s.Get(z)]);
+    }
+    size_t builds = view.Builds();
+    s.Set(1, 1, YEAR + 4, SHIFT_DAY);
+    view.Get(l, ui, s, metrics);
+    BENCH_CHECK(view.Builds() == builds);
+    s.Set(1, 1, YEAR + 2, SHIFT_NONE);
+    view.Get(l, ui, s, metrics);
+    BENCH_CHECK(view.Builds() == builds + 1);
+    s.RemoveObserver(&view);
+
+    if (ppm) {
+        RasterizeDisplayList(view.Get(l, ui, s, metrics), frame, MakeRect(0, 0, W, H));
+        FILE* f = fopen(ppm, "wb");
+        BENCH_CHECK(f && WritePpm(f, frame));
+        fclose(f);
+        printf("wrote %s\n", ppm);
+    }
+    return 0;
+}
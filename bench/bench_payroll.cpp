@@ -0,0 +1,151 @@
+// ============================================================================
+//  BENCH PAYROLL - hours of single shifts (midnight, weekend, holiday,
+//  breaks), weekly overtime, the ledger's incremental month totals against
+//  summing the month again, and a team's year on one thread vs all cores
+// ============================================================================
+
+#include <thread>
+#include "bench.h"
+#include "core/payroll.h"
+#include "core/rotation.h"
+
+static const int YEAR = 2026;
+
+static PayTotals Totals(int worked, int night, int weekend, int holiday, int overtime = 0) {
+    PayTotals t;
+    t.worked = worked; t.night = night; t.weekend = weekend; t.holiday = holiday; t.overtime = overtime;
+    return t;
+}
+
+static void CheckModel() {
+    const int32_t fri = DaysFromCivil(YEAR, 3, 6), sat = fri + 1, mon = DaysFromCivil(YEAR, 3, 9);
+    PayTable t;
+    BENCH_CHECK(t.Day(SHIFT_DAY, mon) == Totals(720, 0, 0, 0));
+    BENCH_CHECK(t.Day(SHIFT_FREE, mon) == PayTotals());
+    // 19:00 Friday to 07:00 Saturday: 22-06 is night, the 7 hours after midnight weekend
+    BENCH_CHECK(t.Day(SHIFT_NIGHT, fri) == Totals(720, 480, 420, 0));
+    BENCH_CHECK(t.Day(SHIFT_NIGHT, mon) == Totals(720, 480, 0, 0));
+    // Built-in holidays: 1 May, Orthodox Easter Monday (13 April 2026)
+    BENCH_CHECK(t.Day(SHIFT_DAY, DaysFromCivil(YEAR, 5, 1)).holiday == 720);
+    BENCH_CHECK(t.Day(SHIFT_NIGHT, DaysFromCivil(YEAR, 4, 12)).holiday == 720);
+
+    PayrollModel m;
+    m.breaks[SHIFT_DAY] = 30;
+    HolidayRule rule;
+    BENCH_CHECK(ParseHolidayRule("2026-03-07", "2026-03-07" + 10, rule) == nullptr);
+    m.holidays.Add(rule);
+    BENCH_CHECK(ParseShiftTimes("N=22:00-06:00", m.times) == nullptr);
+    PayTable h(m);
+    BENCH_CHECK(h.Day(SHIFT_DAY, sat) == Totals(690, 0, 720, 720));
+    BENCH_CHECK(h.Day(SHIFT_NIGHT, fri) == Totals(480, 480, 360, 360));
+    BENCH_CHECK(h.Day(SHIFT_NIGHT, sat) == Totals(480, 480, 480, 120));
+
+    // Four 12-hour day shifts in the week of 9 March: 8 hours over 40
+    ShiftStore s;
+    for (int i = 0; i < 4; i++) s.Set(mon + i, SHIFT_DAY);
+    s.Set(mon - 1, SHIFT_NIGHT);   // Sunday before: previous week
+    PayrollLedger ledger;
+    ledger.Attach(s);
+    BENCH_CHECK(ledger.Week(mon + 6) == Totals(2880, 0, 0, 0, 480));
+    BENCH_CHECK(ledger.Month(3, YEAR) == Totals(3600, 480, 300, 0, 480));
+    BENCH_CHECK(t.Sum(s, MonthStart(3, YEAR), MonthStart(4, YEAR) - 1) == ledger.Month(3, YEAR));
+}
+
+// Edits through every store path; the cached months always match a fresh sum
+static void CheckLedger(int edits) {
+    ShiftStore s;
+    Rotation rot;
+    ParseRotation("DDNNSSSS", DaysFromCivil(YEAR - 1, 1, 1), rot);
+    ApplyRotation(s, rot, DaysFromCivil(YEAR - 1, 1, 1), DaysFromCivil(YEAR + 1, 12, 31), MERGE_OVERWRITE);
+    PayrollLedger ledger;
+    ledger.Attach(s);
+    PayTable t;
+    for (int m = 1; m <= 12; m++) ledger.Month(m, YEAR);
+    size_t warm = ledger.Recomputes();
+
+    const int32_t jan1 = DaysFromCivil(YEAR, 1, 1);
+    uint32_t rng = 12345;
+    for (int i = 0; i < edits; i++) {
+        rng = rng * 1103515245u + 12345u;
+        int32_t day = jan1 - 10 + (int32_t)((rng >> 8) % 385);
+        s.Set(day, (ShiftType)((rng >> 4) & 3));
+        if (i % 97 == 0) {
+            ParseRotation("NN-S", day, rot);
+            ApplyRotation(s, rot, day, day + 20, i % 2 ? MERGE_KEEP : MERGE_OVERWRITE);
+            ApplyRotation(s, rot, day, day + 20, MERGE_KEEP);   // changes nothing
+        }
+    }
+    BENCH_CHECK(ledger.Recomputes() == warm);
+    for (int m = 1; m <= 12; m++)
+        BENCH_CHECK(ledger.Month(m, YEAR) == t.Sum(s, MonthStart(m, YEAR), MonthStart(m, YEAR) + DaysInMonth(m, YEAR) - 1));
+
+    // A long edit drops the months it covers, the rest stay cached
+    ParseRotation("DDNNSSSS", jan1, rot);
+    ApplyRotation(s, rot, jan1, jan1 + 89, MERGE_OVERWRITE);
+    for (int m = 1; m <= 12; m++)
+        BENCH_CHECK(ledger.Month(m, YEAR) == t.Sum(s, MonthStart(m, YEAR), MonthStart(m, YEAR) + DaysInMonth(m, YEAR) - 1));
+    BENCH_CHECK(ledger.Recomputes() - warm < 30);
+    s.Clear();
+    BENCH_CHECK(ledger.Year(YEAR) == PayTotals());
+}
+
+int BenchPayroll(int argc, char** argv) {
+    int employees = argc > 0 ? atoi(argv[0]) : 1000;
+    int edits = argc > 1 ? atoi(argv[1]) : 100000;
+    if (employees <= 0) employees = 1000;
+    if (edits <= 0) edits = 100000;
+
+    CheckModel();
+    CheckLedger(edits / 10);
+
+    // One edit and the month's hours, as a click in the GUI: ledger vs a new sum
+    ShiftStore s;
+    Rotation rot;
+    ParseRotation("DDNNSSSS", DaysFromCivil(YEAR, 1, 1), rot);
+    ApplyRotation(s, rot, DaysFromCivil(YEAR, 1, 1), DaysFromCivil(YEAR, 12, 31), MERGE_OVERWRITE);
+    PayrollLedger ledger;
+    ledger.Attach(s);
+    PayTable t;
+    const int32_t first = MonthStart(3, YEAR);
+    int64_t sink = 0;
+    double t0 = NowSeconds();
+    for (int i = 0; i < edits; i++) {
+        s.Set(first + i % 31, (ShiftType)(1 + i % 3));
+        sink += ledger.Month(3, YEAR).worked;
+    }
+    double t1 = NowSeconds();
+    for (int i = 0; i < edits; i++) {
+        s.Set(first + i % 31, (ShiftType)(1 + i % 3));
+        sink += t.Sum(s, first, first + 30).worked;
+    }
+    double t2 = NowSeconds();
+    DoNotOptimize(sink);
+    BENCH_CHECK(ledger.Recomputes() <= 8);
+    printf("edit + month hours: ledger %7.1f ns  sum again %7.1f ns\n", (t1 - t0) / edits * 1e9, (t2 - t1) / edits * 1e9);
+
+    // A team's year, 1 thread vs all cores, same totals
+    Roster team;
+    for (int e = 0; e < employees; e++) {
+        int i = team.Add((uint32_t)e);
+        ParseRotation(e % 2 ? "DDNNSSSS" : "DNS-", DaysFromCivil(YEAR - 1, 1, 1) + e, rot);
+        ApplyRotation(team.Shifts((size_t)i), rot, DaysFromCivil(YEAR - 1, 1, 1), DaysFromCivil(YEAR + 1, 12, 31),
+                      MERGE_OVERWRITE);
+    }
+    std::vector<PayTotals> one, all;
+    t0 = NowSeconds();
+    PayrollYear(team, YEAR, t, one, 1);
+    t1 = NowSeconds();
+    PayrollYear(team, YEAR, t, all);
+    t2 = NowSeconds();
+    BENCH_CHECK(one.size() == (size_t)employees && all.size() == one.size());
+    for (size_t i = 0; i < one.size(); i++) BENCH_CHECK(one[i] == all[i]);
+    for (size_t i = 0; i < one.size(); i += one.size() / 8 + 1) {
+        PayrollLedger l;
+        l.Attach(team.Shifts(i));
+        BENCH_CHECK(l.Year(YEAR) == one[i]);
+    }
+    if (employees <= 1000) BENCH_CHECK(t2 - t1 < 0.1);
+    printf("year of %d employees: 1 thread %7.2f ms  %u threads %7.2f ms\n", employees, (t1 - t0) * 1e3,
+           std::thread::hardware_concurrency(), (t2 - t1) * 1e3);
+    return 0;
+}
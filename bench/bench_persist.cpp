@@ -0,0 +1,139 @@
+// ============================================================================
+//  BENCH PERSIST - Commit() latency seen by the UI thread: synchronous
+//  journal appends (each fsynced) vs the write-behind thread, disk writes
+//  per burst of edits, the files reloaded after each mode, and failed
+//  writes reported by Close()
+// ============================================================================
+
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "core/data_file.h"
+
+static void RemoveFiles(const PathString& base) {
+    static const char* const EXTS[] = { ".bin", ".bin.tmp", ".journal", ".txt" };
+    for (const char* ext : EXTS) RemovePath(base + PathFromUtf8(ext));
+}
+
+// The stored roster matches the expected default column
+static bool Reloaded(const PathString& base, const ShiftStore& expected) {
+    Roster roster;
+    ShiftDataFile data;
+    data.Open(base, roster, true);
+    const ShiftStore& s = roster.Default();
+    if (s.Count() != expected.Count() || data.JournalReport().errorCount) return false;
+    bool same = true;
+    expected.ForEach([&](int32_t day, ShiftType st) { same = same && s.Get(day) == st; });
+    return same;
+}
+
+struct Latency {
+    double total = 0, worst = 0;
+    void Add(double secs) { total += secs; if (secs > worst) worst = secs; }
+};
+
+// edits single-day edits, each followed by a Commit() as SaveData() does
+static Latency Edit(const PathString& base, int edits, int delayMs, size_t& writes, double& flushSecs) {
+    RemoveFiles(base);
+    Roster roster;
+    ShiftDataFile data;
+    data.Open(base, roster);
+    if (delayMs >= 0) data.StartWriter(delayMs);
+    ShiftStore& s = roster.Default();
+    const int32_t first = DaysFromCivil(2026, 1, 1);
+    Latency lat;
+    for (int i = 0; i < edits; i++) {
+        s.Set(first + (i * 7) % 3000, (ShiftType)(1 + i % 3));
+        double t0 = NowSeconds();
+        BENCH_CHECK(data.Commit());
+        lat.Add(NowSeconds() - t0);
+    }
+    double t0 = NowSeconds();
+    BENCH_CHECK(data.Flush());
+    flushSecs = NowSeconds() - t0;
+    writes = data.Writes();
+    ShiftStore expected = s;
+    data.Close();
+    BENCH_CHECK(Reloaded(base, expected));
+    BENCH_CHECK(!PathExists(base + PATH_TEXT(".bin.tmp")));
+    return lat;
+}
+
+// A burst is written once after it pauses, Flush() does not wait for the delay
+static void CheckCoalescing(const PathString& base) {
+    RemoveFiles(base);
+    Roster roster;
+    ShiftDataFile data;
+    data.Open(base, roster);
+    data.StartWriter(50);
+    ShiftStore& s = roster.Default();
+    const int32_t first = DaysFromCivil(2026, 3, 1);
+    for (int burst = 0; burst < 3; burst++) {
+        for (int i = 0; i < 20; i++) {
+            s.Set(first + burst * 20 + i, SHIFT_DAY);
+            BENCH_CHECK(data.Commit());
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    BENCH_CHECK(data.Writes() == 3);
+    ShiftStore expected = s;
+    data.Close();
+    BENCH_CHECK(Reloaded(base, expected));
+
+    // A 10 s delay: Flush() (as Close() on WM_DESTROY) writes at once
+    data.Open(base, roster);
+    data.StartWriter(10000);
+    roster.Default().Set(first + 100, SHIFT_NIGHT);
+    BENCH_CHECK(data.Commit());
+    double t0 = NowSeconds();
+    BENCH_CHECK(data.Flush() && data.Writes() == 1);
+    BENCH_CHECK(NowSeconds() - t0 < 1.0);
+    expected = roster.Default();
+    data.Close();
+    BENCH_CHECK(Reloaded(base, expected));
+}
+
+// A write that keeps failing is reported by Close(), with or without the
+// writer thread, instead of being lost on the way out
+static void CheckFailure() {
+    const PathString base = PathFromUtf8("smjene_bench_persist_missing_dir/smjene");
+    for (int delayMs : { -1, 0 }) {
+        Roster roster;
+        ShiftDataFile data;
+        data.Open(base, roster);
+        if (delayMs >= 0) data.StartWriter(delayMs);
+        roster.Default().Set(DaysFromCivil(2026, 5, 1), SHIFT_DAY);
+        BENCH_CHECK(data.Commit() == (delayMs >= 0));   // queued: the writer fails later
+        roster.Default().Set(DaysFromCivil(2026, 5, 2), SHIFT_NIGHT);
+        BENCH_CHECK(!data.Close());
+        BENCH_CHECK(data.Close());   // nothing open any more
+    }
+}
+
+int BenchPersist(int argc, char** argv) {
+    int edits = argc > 0 ? atoi(argv[0]) : 2000;
+    int delayMs = argc > 1 ? atoi(argv[1]) : 250;
+    if (edits <= 0) edits = 2000;
+    if (delayMs < 0) delayMs = 250;
+    const PathString base = PathFromUtf8(argc > 2 ? argv[2] : "smjene_bench_persist");
+
+    CheckCoalescing(base);
+    CheckFailure();
+
+    struct Mode { const char* name; int delay; };
+    const Mode modes[] = { { "sync", -1 }, { "write-behind", delayMs } };
+    size_t syncWrites = 0;
+    for (const Mode& m : modes) {
+        size_t writes = 0;
+        double flushSecs = 0;
+        Latency lat = Edit(base, edits, m.delay, writes, flushSecs);
+        printf("%-13s commit avg %8.2f us  max %8.2f us  %6zu disk writes  flush %7.2f ms\n", m.name,
+               lat.total / edits * 1e6, lat.worst * 1e6, writes, flushSecs * 1e3);
+        if (m.delay < 0) syncWrites = writes;
+        // Bursts coalesce: a few journal appends plus the compactions
+        else BENCH_CHECK(writes * 10 <= syncWrites);
+    }
+    RemoveFiles(base);
+    return 0;
+}
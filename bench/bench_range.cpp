@@ -0,0 +1,159 @@
+// ============================================================================
+//  BENCH RANGE - word-parallel fill, copy, move and swap against day-by-day
+//  Get/Set on random spans (across years, overlapping, both directions),
+//  one notification per store, and the time to clear, copy, move and swap
+//  10 years
+// ============================================================================
+
+#include <algorithm>
+#include "bench.h"
+#include "core/rotation.h"
+#include "core/shift_ops.h"
+
+static const int YEAR = 2020;
+
+// Day by day, the way the buttons used to work
+static void RefCopy(const ShiftStore& src, int32_t from, int32_t to, ShiftStore& dst, int32_t dstFrom, MergeMode mode) {
+    std::vector<ShiftType> codes;
+    for (int32_t z = from; z <= to; z++) codes.push_back(src.Get(z));
+    for (int32_t i = 0; i <= to - from; i++) {
+        ShiftType st = codes[(size_t)i], old = dst.Get(dstFrom + i);
+        if (st == SHIFT_NONE && mode != MERGE_REPLACE) continue;
+        if (mode == MERGE_KEEP && old != SHIFT_NONE) continue;
+        dst.Set(dstFrom + i, st);
+    }
+}
+
+static void RefShift(ShiftStore& s, int32_t from, int32_t to, int32_t days) {
+    std::vector<ShiftType> codes;
+    for (int32_t z = from; z <= to; z++) { codes.push_back(s.Get(z)); s.Set(z, SHIFT_NONE); }
+    for (int32_t i = 0; i <= to - from; i++) s.Set(from + days + i, codes[(size_t)i]);
+}
+
+static bool Same(const ShiftStore& a, const ShiftStore& b, int32_t from, int32_t to) {
+    for (int32_t z = from; z <= to; z++)
+        if (a.Get(z) != b.Get(z)) return false;
+    return true;
+}
+
+static void Randomize(ShiftStore& s, uint32_t seed, int32_t from, int32_t to) {
+    for (int32_t z = from; z <= to; z++) {
+        seed = seed * 1103515245u + 12345u;
+        s.Set(z, (ShiftType)((seed >> 16) & 3));
+    }
+}
+
+struct CountingObserver : ShiftObserver {
+    int calls = 0;
+    void OnShiftsChanged(int32_t, int32_t) override { calls++; }
+};
+
+static void CheckOps(int rounds) {
+    const int32_t lo = DaysFromCivil(YEAR, 1, 1), hi = DaysFromCivil(YEAR + 3, 12, 31);
+    uint32_t rng = 99;
+    auto next = [&](int n) { rng = rng * 1103515245u + 12345u; return (int32_t)((rng >> 8) % (uint32_t)n); };
+    for (int r = 0; r < rounds; r++) {
+        ShiftStore a, ref, b, refB;
+        Randomize(a, (uint32_t)r, lo, hi);
+        Randomize(ref, (uint32_t)r, lo, hi);
+        Randomize(b, (uint32_t)r + 1000, lo, hi);
+        Randomize(refB, (uint32_t)r + 1000, lo, hi);
+        int32_t from = lo + 30 + next(900), to = from + next(400);
+        int32_t dst = from + next(600) - 300;
+        MergeMode mode = (MergeMode)(r % 3);
+
+        CountingObserver seen;
+        a.AddObserver(&seen);
+        size_t changed = CopyRange(a, from, to, a, dst, mode);
+        RefCopy(ref, from, to, ref, dst, mode);
+        BENCH_CHECK(Same(a, ref, lo - 40, hi + 40));
+        BENCH_CHECK(seen.calls == (changed ? 1 : 0));
+
+        int32_t days = next(800) - 400;
+        ShiftRange(a, from, to, days);
+        RefShift(ref, from, to, days);
+        BENCH_CHECK(Same(a, ref, lo - 40, hi + 40));
+
+        ShiftType st = (ShiftType)next(4);
+        FillRange(a, from, to, st, r % 2 ? MERGE_KEEP : MERGE_OVERWRITE);
+        for (int32_t z = from; z <= to; z++)
+            if (!(r % 2 && ref.Get(z) != SHIFT_NONE)) ref.Set(z, st);
+        BENCH_CHECK(Same(a, ref, lo - 40, hi + 40));
+
+        int32_t swapTo = std::max(dst, from + 10);
+        SwapRanges(a, b, from, swapTo);
+        for (int32_t z = from; z <= swapTo; z++) {
+            ShiftType x = ref.Get(z);
+            ref.Set(z, refB.Get(z));
+            refB.Set(z, x);
+        }
+        BENCH_CHECK(Same(a, ref, lo - 40, hi + 40) && Same(b, refB, lo - 40, hi + 40));
+        a.RemoveObserver(&seen);
+
+        // Copy into another store, month pattern as the button does
+        CopyRange(a, from, to, b, from + 5, MERGE_KEEP);
+        RefCopy(ref, from, to, refB, from + 5, MERGE_KEEP);
+        BENCH_CHECK(Same(b, refB, lo - 40, hi + 40));
+        BENCH_CHECK(CopyMonthPattern(a, 1, YEAR + 1, 2, YEAR + 2, r % 2 == 0) >= 0);
+        RefCopy(ref, MonthStart(1, YEAR + 1), MonthStart(1, YEAR + 1) + DaysInMonth(2, YEAR + 2) - 1, ref,
+                MonthStart(2, YEAR + 2), r % 2 == 0 ? MERGE_OVERWRITE : MERGE_KEEP);
+        BENCH_CHECK(Same(a, ref, lo - 40, hi + 40));
+    }
+
+    // Nothing to move or copy: the store does not grow
+    ShiftStore empty;
+    BENCH_CHECK(ShiftRange(empty, lo, hi, 7) == 0 && CopyRange(empty, lo, hi, empty, hi + 1) == 0);
+    BENCH_CHECK(empty.YearCount() == 0);
+}
+
+int BenchRange(int argc, char** argv) {
+    int years = argc > 0 ? atoi(argv[0]) : 10;
+    int reps = argc > 1 ? atoi(argv[1]) : 1000;
+    if (years <= 0 || years > 100) years = 10;
+    if (reps <= 0) reps = 1000;
+
+    CheckOps(60);
+
+    ShiftStore s, other;
+    Rotation rot;
+    const int32_t from = DaysFromCivil(YEAR, 1, 1), to = DaysFromCivil(YEAR + years, 1, 1) - 1;
+    ParseRotation("DDNNSSSS", from, rot);
+    ApplyRotation(s, rot, from - 10, to + 3700, MERGE_OVERWRITE);
+    ParseRotation("DNS-", from, rot);
+    ApplyRotation(other, rot, from, to, MERGE_OVERWRITE);
+    const int32_t span = to - from + 1, later = to + 1;
+
+    // Each pair of calls restores the data, so every rep does the same work
+    double t0 = NowSeconds();
+    for (int i = 0; i < reps; i++) {
+        FillRange(s, from, to, SHIFT_FREE);
+        FillRange(s, from, to, SHIFT_DAY);
+    }
+    double t1 = NowSeconds();
+    for (int i = 0; i < reps; i++) {
+        CopyRange(s, from, to, s, later, i % 2 ? MERGE_REPLACE : MERGE_OVERWRITE);
+    }
+    double t2 = NowSeconds();
+    for (int i = 0; i < reps; i++) ShiftRange(s, from, to, i % 2 ? -7 : 7);
+    double t3 = NowSeconds();
+    for (int i = 0; i < reps; i++) SwapRanges(s, other, from, to);
+    double t4 = NowSeconds();
+    for (int i = 0; i < reps; i++) {
+        ClearRange(s, later, later + span - 1);
+        FillRange(s, later, later + span - 1, SHIFT_NIGHT);
+    }
+    double t5 = NowSeconds();
+
+    // The day-by-day copy the buttons used before, once
+    ShiftStore slow;
+    double t6 = NowSeconds();
+    RefCopy(s, from, to, slow, from, MERGE_OVERWRITE);
+    double t7 = NowSeconds();
+    BENCH_CHECK(Same(s, slow, from, to));
+    printf("%d years (%d days): fill x2 %7.1f us  copy %7.1f us  move 7 days %7.1f us  swap %7.1f us  clear+fill %7.1f us\n",
+           years, span, (t1 - t0) / reps * 1e6, (t2 - t1) / reps * 1e6, (t3 - t2) / reps * 1e6,
+           (t4 - t3) / reps * 1e6, (t5 - t4) / reps * 1e6);
+    printf("day-by-day copy: %9.1f us\n", (t7 - t6) * 1e6);
+    if (years <= 10) BENCH_CHECK((t2 - t1) / reps < 100e-6);
+    return 0;
+}
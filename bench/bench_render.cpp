@@ -0,0 +1,138 @@
+// ============================================================================
+//  BENCH RENDER - month view display list: build time and allocations, cache
+//  hits, software raster time, pixel probes, and dirty-rect repaints checked
+//  pixel for pixel against full redraws
+// ============================================================================
+
+#include "bench.h"
+#include "core/calendar_view.h"
+#include "core/month_view.h"
+#include "core/raster.h"
+#include "core/rotation.h"
+
+static const int W = 934, H = 701, MONTH = 3, YEAR = 2026;
+
+// FNV-1a over the pixels, to compare runs by eye
+static uint64_t Checksum(const RasterImage& img) {
+    uint64_t h = 1469598103934665603ull;
+    for (int y = 0; y < img.Height(); y++)
+        for (int x = 0; x < img.Width(); x++) { h ^= img.Pixel(x, y); h *= 1099511628211ull; }
+    return h;
+}
+
+static RasterImage FullFrame(const DisplayList& dl) {
+    RasterImage img(W, H);
+    RasterizeDisplayList(dl, img, MakeRect(0, 0, W, H));
+    return img;
+}
+
+// Repaints only the dirty rects of `before` with the new list; must equal a full redraw
+static bool RepaintMatches(const RasterImage& before, const DisplayList& after, const DirtyRects& d) {
+    RasterImage img = before;
+    if (d.full) RasterizeDisplayList(after, img, MakeRect(0, 0, W, H));
+    for (int i = 0; i < d.count; i++) RasterizeDisplayList(after, img, d.rects[i]);
+    return img == FullFrame(after);
+}
+
+// A pixel inside the cell below its text, where only the cell background shows
+static uint32_t CellPixel(const RasterImage& img, const CalendarLayout& l, int day) {
+    LayoutRect c = l.Cell(day);
+    return img.Pixel((c.left + c.right) / 2, c.bottom - CELL_PAD - 4);
+}
+
+int BenchRender(int argc, char** argv) {
+    long reps = argc > 0 ? atol(argv[0]) : 2000;
+    if (reps <= 0) reps = 2000;
+    const char* ppm = argc > 1 ? argv[1] : nullptr;
+
+    ShiftStore s;
+    Rotation rot;
+    ParseRotation("DDNN-SSS", DaysFromCivil(YEAR, 1, 1), rot);
+    ApplyRotation(s, rot, DaysFromCivil(YEAR, 1, 1), DaysFromCivil(YEAR, 12, 31), MERGE_OVERWRITE);
+    s.Set(14, MONTH, YEAR, SHIFT_NONE);
+    s.Set(20, MONTH, YEAR, SHIFT_NONE);
+
+    CalendarLayout l = ComputeLayout(W, H, MONTH, YEAR);
+    UiState ui;
+    ui.width = W; ui.height = H; ui.viewMonth = MONTH; ui.viewYear = YEAR;
+    ui.today = DaysFromCivil(YEAR, MONTH, 14);
+    RasterMetrics metrics;
+
+    // Build: the list keeps its capacity, so steady-state rebuilds allocate nothing
+    DisplayList dl;
+    BuildMonthView(l, ui, s, metrics, dl);
+    size_t a0 = BenchAllocCount();
+    double t0 = NowSeconds();
+    for (long r = 0; r < reps; r++) {
+        ui.hoverDay = (int)(r % 31) + 1;
+        BuildMonthView(l, ui, s, metrics, dl);
+    }
+    double buildNs = (NowSeconds() - t0) * 1e9 / reps;
+    size_t allocs = BenchAllocCount() - a0;
+    BENCH_CHECK(allocs == 0);
+    printf("build     %8.0f ns/frame  %zu commands  %zu bytes  %zu allocs\n", buildNs, dl.Size(), dl.MemoryUsage(), allocs);
+
+    // Cache: rebuilt for the viewed month's shifts and UI changes only
+    CalendarView view;
+    s.AddObserver(&view);
+    ui.hoverDay = -1;
+    view.Get(l, ui, s, metrics);
+    view.Get(l, ui, s, metrics);
+    BENCH_CHECK(view.Builds() == 1);
+    s.Set(5, MONTH + 1, YEAR, SHIFT_NONE);
+    view.Get(l, ui, s, metrics);
+    BENCH_CHECK(view.Builds() == 1);
+    s.Set(5, MONTH, YEAR, SHIFT_NONE);
+    view.Get(l, ui, s, metrics);
+    BENCH_CHECK(view.Builds() == 2);
+
+    // Raster time and probes
+    RasterImage frame(W, H);
+    long rasterReps = reps / 20 > 0 ? reps / 20 : 1;
+    t0 = NowSeconds();
+    for (long r = 0; r < rasterReps; r++) RasterizeDisplayList(view.Get(l, ui, s, metrics), frame, MakeRect(0, 0, W, H));
+    printf("raster    %8.2f ms/frame  (%dx%d, software)\n", (NowSeconds() - t0) * 1e3 / rasterReps, W, H);
+    for (int day = 1; day <= l.grid.days; day++)
+        BENCH_CHECK(CellPixel(frame, l, day) == ShiftBackground(s.Get(day, MONTH, YEAR), false));
+    LayoutRect today = l.Cell(14);
+    BENCH_CHECK(frame.Pixel((today.left + today.right) / 2, today.top + CELL_PAD) == CLR_CELL_TODAY_BORDER);
+    BENCH_CHECK(frame.Pixel(2, 2) == CLR_HEADER && frame.Pixel(2, H - 1) != CLR_BG_TOP);
+
+    // Dirty rects repaint exactly what a full redraw would
+    struct Step { const char* name; int hoverDay, hoverBtn; int editDay; };
+    static const Step STEPS[] = {
+        { "hover empty day",   20, -1, 0 },
+        { "hover next day",    21, -1, 0 },
+        { "hover button",      -1, BTN_NEXT, 0 },
+        { "hover leave",       -1, -1, 0 },
+        { "edit hovered day",  -1, -1, 20 },
+        { "edit today",        -1, -1, 14 },
+    };
+    int steps = 0;
+    for (const Step& st : STEPS) {
+        UiState next = ui;
+        next.hoverDay = st.hoverDay; next.hoverBtn = st.hoverBtn;
+        DirtyRects d = DiffUi(l, ui, next);
+        if (st.editDay) {
+            s.Set(st.editDay, MONTH, YEAR, s.Get(st.editDay, MONTH, YEAR) == SHIFT_NONE ? SHIFT_NIGHT : SHIFT_NONE);
+            int32_t z = DaysFromCivil(YEAR, MONTH, st.editDay);
+            d = DirtyForDays(l, z, z);
+        }
+        BENCH_CHECK(RepaintMatches(frame, view.Get(l, next, s, metrics), d));
+        printf("repaint   %-18s %5.1f%% of the window, matches full redraw\n", st.name, 100.0 * d.Area(W, H) / (W * H));
+        frame = FullFrame(view.Get(l, next, s, metrics));
+        ui = next;
+        steps++;
+    }
+    BENCH_CHECK(CellPixel(frame, l, 20) == CLR_NIGHT_SHIFT_BG);
+    s.RemoveObserver(&view);
+    printf("builds: %zu for %d steps, checksum %016llx\n", view.Builds(), steps, (unsigned long long)Checksum(frame));
+
+    if (ppm) {
+        FILE* f = fopen(ppm, "wb");
+        BENCH_CHECK(f && WritePpm(f, frame));
+        fclose(f);
+        printf("wrote %s\n", ppm);
+    }
+    return 0;
+}
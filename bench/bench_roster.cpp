@@ -0,0 +1,194 @@
+// ============================================================================
+//  BENCH ROSTER - a team of employees x years: memory, per-day and
+//  per-person queries, binary/text round trips and legacy single-user files
+// ============================================================================
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "core/binary_format.h"
+#include "core/rotation.h"
+#include "core/text_format.h"
+
+static const int FIRST_YEAR = 2020;
+
+static bool SameRoster(const Roster& a, const Roster& b, int32_t from, int32_t to) {
+    if (a.Size() != b.Size()) return false;
+    for (size_t i = 0; i < a.Size(); i++) {
+        if (a.At(i).id != b.At(i).id || a.At(i).name != b.At(i).name) return false;
+        if (a.Shifts(i).Count() != b.Shifts(i).Count()) return false;
+        for (int32_t z = from; z <= to; z++)
+            if (a.Shifts(i).Get(z) != b.Shifts(i).Get(z)) return false;
+    }
+    return true;
+}
+
+static std::vector<uint8_t> ReadAll(FILE* f) {
+    std::vector<uint8_t> data;
+    fseek(f, 0, SEEK_END);
+    data.resize((size_t)ftell(f));
+    rewind(f);
+    if (!data.empty() && fread(data.data(), 1, data.size(), f) != data.size()) data.clear();
+    return data;
+}
+
+// A version 1 snapshot of one store, as written before the roster
+static std::vector<uint8_t> VersionOneSnapshot(const ShiftStore& s) {
+    const int wpy = ShiftStore::WORDS_PER_YEAR;
+    std::vector<uint8_t> out(BIN_HEADER_V1_SIZE + (size_t)s.YearCount() * (sizeof(BinYearEntry) + wpy * 8) + 8, 0);
+    BinHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, "SMJB", 4);
+    h.version = 1;
+    h.headerSize = BIN_HEADER_V1_SIZE;
+    h.employeeCount = 1;
+    h.yearCount = (uint32_t)s.YearCount();
+    h.dirOffset = BIN_HEADER_V1_SIZE;
+    h.dataOffset = (BIN_HEADER_V1_SIZE + (uint64_t)s.YearCount() * sizeof(BinYearEntry) + 7) & ~7ull;
+    memcpy(out.data(), &h, BIN_HEADER_V1_SIZE);
+    for (int i = 0; i < s.YearCount(); i++) {
+        BinYearEntry e = { (int16_t)(s.FirstYear() + i), 0, (uint32_t)(i * wpy) };
+        memcpy(out.data() + h.dirOffset + (size_t)i * sizeof(e), &e, sizeof(e));
+    }
+    memcpy(out.data() + h.dataOffset, s.YearWords(s.FirstYear()), (size_t)s.YearCount() * wpy * 8);
+    out.resize((size_t)h.dataOffset + (size_t)s.YearCount() * wpy * 8);
+    return out;
+}
+
+static void CheckFormats(const Roster& team, int32_t lo, int32_t hi) {
+    // Binary round trip, mapped in place
+    FILE* f = tmpfile();
+    BENCH_CHECK(f && WriteBinarySnapshot(f, team, 7));
+    std::vector<uint8_t> bin = ReadAll(f);
+    fclose(f);
+    Roster back;
+    uint32_t gen = 0;
+    BENCH_CHECK(ReadBinarySnapshot(bin.data(), bin.size(), back, &gen) && gen == 7);
+    BENCH_CHECK(SameRoster(team, back, lo - 40, hi + 40));
+
+    // A single store reads the default employee only
+    ShiftStore one;
+    BENCH_CHECK(ReadBinarySnapshot(bin.data(), bin.size(), one, nullptr));
+    BENCH_CHECK(one.Count() == team.Shifts((size_t)team.Find(Roster::DEFAULT_ID)).Count());
+
+    // Text round trip, names and ids included
+    f = tmpfile();
+    BENCH_CHECK(f && WriteShiftText(f, team));
+    std::vector<uint8_t> text = ReadAll(f);
+    fclose(f);
+    Roster fromText;
+    TextParseReport rep;
+    ParseShiftText((const char*)text.data(), text.size(), fromText, false, &rep);
+    BENCH_CHECK(rep.errorCount == 0 && SameRoster(team, fromText, lo - 40, hi + 40));
+
+    // Legacy single-user text and version 1 binary load as the default employee
+    const ShiftStore& def = team.Shifts((size_t)team.Find(Roster::DEFAULT_ID));
+    f = tmpfile();
+    BENCH_CHECK(f && WriteShiftText(f, def));
+    text = ReadAll(f);
+    fclose(f);
+    Roster legacy;
+    ParseShiftText((const char*)text.data(), text.size(), legacy, false);
+    BENCH_CHECK(legacy.Size() == 1 && legacy.At(0).id == Roster::DEFAULT_ID && legacy.Shifts(0).Count() == def.Count());
+    std::vector<uint8_t> v1 = VersionOneSnapshot(def);
+    Roster old;
+    BENCH_CHECK(ReadBinarySnapshot(v1.data(), v1.size(), old, nullptr));
+    BENCH_CHECK(old.Size() == 1 && old.At(0).id == Roster::DEFAULT_ID);
+    for (int32_t z = lo; z <= hi; z++) BENCH_CHECK(old.Shifts(0).Get(z) == def.Get(z));
+
+    // Journal records with the employee field, all-or-nothing batches
+    const char* journal =
+        "#employee 42 Ana Anic\n"
+        "#begin\n2024-03-01 1 @42\n2024-03-02 0 @42\n2024-03-03 2\n#end\n"
+        "2024-03-04 3 @43\n"
+        "#begin\n2024-03-05 1 @42\n";
+    Roster j;
+    rep = TextParseReport();
+    ParseShiftText(journal, strlen(journal), j, true, &rep);
+    BENCH_CHECK(rep.records == 4 && rep.errorCount == 1);
+    BENCH_CHECK(j.Size() == 3 && j.At((size_t)j.Find(42)).name == "Ana Anic");
+    BENCH_CHECK(j.Shifts((size_t)j.Find(42)).Get(1, 3, 2024) == SHIFT_DAY && j.Shifts((size_t)j.Find(42)).Count() == 1);
+    BENCH_CHECK(j.Shifts((size_t)j.Find(Roster::DEFAULT_ID)).Get(3, 3, 2024) == SHIFT_NIGHT);
+    BENCH_CHECK(j.Shifts((size_t)j.Find(43)).Get(4, 3, 2024) == SHIFT_FREE);
+    ShiftStore single;
+    ParseShiftText(journal, strlen(journal), single, true);
+    BENCH_CHECK(single.Count() == 1 && single.Get(3, 3, 2024) == SHIFT_NIGHT);
+    printf("binary v1/v2, text and journal round trips: OK\n");
+}
+
+int BenchRoster(int argc, char** argv) {
+    int employees = argc > 0 ? atoi(argv[0]) : 1000;
+    int years = argc > 1 ? atoi(argv[1]) : 10;
+    if (employees < 1 || employees > (int)Roster::MAX_EMPLOYEES || years < 1 || years > 100) {
+        fprintf(stderr, "roster: employees 1..%d, years 1..100\n", (int)Roster::MAX_EMPLOYEES);
+        return 1;
+    }
+    const int32_t lo = DaysFromCivil(FIRST_YEAR, 1, 1), hi = DaysFromCivil(FIRST_YEAR + years, 1, 1) - 1;
+
+    // Everyone on D-D-N-N-S-S-S-S, shifted by employee; ids are sparse
+    Roster team;
+    Rotation rot;
+    double t0 = NowSeconds();
+    for (int e = 0; e < employees; e++) {
+        std::string name = "Radnik " + std::to_string(e);
+        int i = team.Add(e == 0 ? Roster::DEFAULT_ID : (uint32_t)(1000 + 7 * e), name.c_str());
+        BENCH_CHECK(i == e && ParseRotation("DDNNSSSS", lo + e, rot));
+        ApplyRotation(team.Shifts((size_t)i), rot, lo, hi, MERGE_OVERWRITE);
+    }
+    double t1 = NowSeconds();
+    size_t bytes = team.MemoryUsage();
+    printf("%d employees x %d years: fill %.1f ms, %zu set days, %.2f MB (%zu bytes/employee)\n",
+           employees, years, (t1 - t0) * 1e3, team.Count(), bytes / 1048576.0, bytes / (size_t)employees);
+
+    // Per day across the team, against per-employee Get
+    long sink = 0;
+    int32_t days = hi - lo + 1;
+    t0 = NowSeconds();
+    for (int32_t z = lo; z <= hi; z++) sink += team.CountDay(z).Working();
+    t1 = NowSeconds();
+    for (int32_t z = lo; z <= hi; z += 16) {
+        ShiftCounts c;
+        for (size_t i = 0; i < team.Size(); i++) c.Add(team.Shifts(i).Get(z), 1);
+        BENCH_CHECK(c.day == team.CountDay(z).day && c.Total() == employees);
+    }
+    double t2 = NowSeconds();
+    BENCH_CHECK(team.CountByType(lo, hi).Total() == (int32_t)team.Count());
+    printf("day across team    %10.1f us/day  (%.2f ns/employee; per-employee Get %.2f ns)\n",
+           (t1 - t0) * 1e6 / days, (t1 - t0) * 1e9 / days / employees,
+           (t2 - t1) * 1e9 / ((days + 15) / 16) / employees);
+
+    // Per person: a year of month counts for everyone
+    t0 = NowSeconds();
+    for (size_t i = 0; i < team.Size(); i++)
+        for (int m = 1; m <= 12; m++) sink += team.Shifts(i).CountMonth(m, FIRST_YEAR + years / 2).Working();
+    t1 = NowSeconds();
+    printf("person month stats %10.1f ns/month\n", (t1 - t0) * 1e9 / (12.0 * employees));
+
+    // Snapshot size and load of the whole team
+    FILE* f = tmpfile();
+    if (!f) { fprintf(stderr, "tmpfile() failed\n"); return 1; }
+    t0 = NowSeconds();
+    WriteBinarySnapshot(f, team, 1);
+    fflush(f);
+    t1 = NowSeconds();
+    std::vector<uint8_t> bin = ReadAll(f);
+    fclose(f);
+    Roster back;
+    t2 = NowSeconds();
+    BENCH_CHECK(ReadBinarySnapshot(bin.data(), bin.size(), back, nullptr));
+    double t3 = NowSeconds();
+    BENCH_CHECK(back.Count() == team.Count());
+    printf("binary snapshot    %10zu bytes  save %.2f ms  load %.2f ms\n",
+           bin.size(), (t1 - t0) * 1e3, (t3 - t2) * 1e3);
+    DoNotOptimize(sink);
+
+    Roster small;
+    for (size_t i = 0; i < team.Size() && i < 20; i++) {
+        int k = small.Add(team.At(i).id, team.At(i).name.c_str());
+        small.Shifts((size_t)k) = team.Shifts(i);
+    }
+    CheckFormats(small, lo, hi);
+    return 0;
+}
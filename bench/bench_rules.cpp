@@ -0,0 +1,186 @@
+// ============================================================================
+//  BENCH RULES - each labour rule on hand-made weeks, the validator's marks
+//  after random edits against checking the whole history again, the cost of
+//  an edit's window vs a full check, and a team's history on all cores
+// ============================================================================
+
+#include <cstring>
+#include <thread>
+#include "bench.h"
+#include "core/rotation.h"
+#include "core/shift_rules.h"
+
+static const int YEAR = 2026;
+
+// One pass of cycle from day from
+static void SetRun(ShiftStore& s, int32_t from, const char* cycle) {
+    Rotation rot;
+    ParseRotation(cycle, from, rot);
+    ApplyRotation(s, rot, from, from + (int32_t)strlen(cycle) - 1, MERGE_OVERWRITE);
+}
+
+static uint8_t MarkOf(const std::vector<RuleViolation>& v, int32_t day) {
+    for (const RuleViolation& r : v) if (r.day == day) return r.rules;
+    return 0;
+}
+
+static int32_t HistoryStart(const ShiftStore& s) { return DaysFromCivil(s.FirstYear(), 1, 1); }
+static int32_t HistoryEnd(const ShiftStore& s) { return DaysFromCivil(s.FirstYear() + s.YearCount(), 1, 1) - 1; }
+
+static void CheckCases() {
+    const int32_t mon = DaysFromCivil(YEAR, 3, 9), wed = mon + 2;
+    ShiftRules rules;
+    std::vector<RuleViolation> v;
+
+    // Day right after a night, and nothing else
+    ShiftStore s;
+    SetRun(s, mon, "NDS");
+    CheckRules(s, rules, mon, mon + 6, v);
+    BENCH_CHECK(v.size() == 1 && MarkOf(v, mon + 1) == RULE_REST);
+
+    // Seven working days from Wednesday: only the seventh breaks the run limit
+    ShiftStore w;
+    SetRun(w, wed, "DDDDDDD");
+    CheckRules(w, rules, wed, wed + 10, v);
+    BENCH_CHECK(v.size() == 1 && MarkOf(v, wed + 6) == RULE_WORK_RUN);
+    // A range that starts inside the run still sees the days before it
+    CheckRules(w, rules, wed + 6, wed + 6, v);
+    BENCH_CHECK(v.size() == 1 && v[0].rules == RULE_WORK_RUN);
+
+    // Five nights: the fifth is one too many
+    ShiftStore n;
+    SetRun(n, mon, "NNNNNSS");
+    CheckRules(n, rules, mon, mon + 6, v);
+    BENCH_CHECK(v.size() == 1 && MarkOf(v, mon + 4) == RULE_NIGHT_RUN);
+
+    // Two free days a week: Sunday's shift leaves only Saturday
+    ShiftStore f;
+    SetRun(f, mon, "DDDDDSDD");
+    ShiftRules two;
+    two.minFreePerWeek = 2;
+    CheckRules(f, two, mon, mon + 7, v);
+    BENCH_CHECK(v.size() == 1 && MarkOf(v, mon + 6) == RULE_WEEK_FREE);
+    CheckRules(f, rules, mon, mon + 7, v);
+    BENCH_CHECK(v.empty());
+
+    // Rules switched off
+    ShiftRules none;
+    none.rest = false; none.maxWorkRun = 0; none.maxNightRun = 0; none.minFreePerWeek = 0;
+    CheckRules(w, none, wed, wed + 10, v);
+    BENCH_CHECK(v.empty());
+}
+
+// Random edits through every store path; the marks always match a full check
+static void CheckValidator(int edits) {
+    ShiftStore s;
+    Rotation rot;
+    ParseRotation("DDNNSSSS", DaysFromCivil(YEAR - 1, 1, 1), rot);
+    ApplyRotation(s, rot, DaysFromCivil(YEAR - 1, 1, 1), DaysFromCivil(YEAR + 1, 12, 31), MERGE_OVERWRITE);
+    RuleValidator val;
+    val.Attach(s);
+
+    const int32_t jan1 = DaysFromCivil(YEAR, 1, 1);
+    uint32_t rng = 777;
+    for (int i = 0; i < edits; i++) {
+        rng = rng * 1103515245u + 12345u;
+        int32_t day = jan1 - 40 + (int32_t)((rng >> 8) % 450);
+        s.Set(day, (ShiftType)((rng >> 4) & 3));
+        if (i % 53 == 0) {
+            ParseRotation(i % 2 ? "DDDDDDDDN" : "NNNNND", day, rot);
+            ApplyRotation(s, rot, day, day + 30, i % 3 ? MERGE_KEEP : MERGE_OVERWRITE);
+        }
+    }
+    std::vector<RuleViolation> full;
+    CheckRules(s, val.Rules(), HistoryStart(s), HistoryEnd(s), full);
+    BENCH_CHECK(val.Count() == full.size() && !full.empty());
+    for (const RuleViolation& v : full) BENCH_CHECK(val.At(v.day) == v.rules);
+
+    // A single edit rechecks its window only
+    size_t before = val.Checked();
+    if (s.Set(jan1 + 100, s.Get(jan1 + 100) == SHIFT_DAY ? SHIFT_NIGHT : SHIFT_DAY))
+        BENCH_CHECK(val.Checked() - before == (size_t)(1 + val.Rules().Reach()));
+
+    // The month mask agrees with the marks
+    uint32_t mask = val.MonthMask(3, YEAR);
+    for (int d = 1; d <= 31; d++) BENCH_CHECK((mask >> (d - 1) & 1) == (val.At(MonthStart(3, YEAR) + d - 1) != 0));
+
+    // Other rules check everything again; clearing leaves nothing
+    ShiftRules strict;
+    strict.maxWorkRun = 3;
+    val.SetRules(strict);
+    CheckRules(s, strict, HistoryStart(s), HistoryEnd(s), full);
+    BENCH_CHECK(val.Count() == full.size());
+    s.Clear();
+    BENCH_CHECK(val.Count() == 0);
+}
+
+int BenchRules(int argc, char** argv) {
+    int edits = argc > 0 ? atoi(argv[0]) : 100000;
+    int employees = argc > 1 ? atoi(argv[1]) : 1000;
+    if (edits <= 0) edits = 100000;
+    if (employees <= 0) employees = 1000;
+
+    CheckCases();
+    CheckValidator(edits / 10);
+
+    // One edit as a click in the GUI: the validator's window vs the whole
+    // history of 10 years
+    ShiftStore s;
+    Rotation rot;
+    ParseRotation("DDNNSSSS", DaysFromCivil(YEAR - 5, 1, 1), rot);
+    ApplyRotation(s, rot, DaysFromCivil(YEAR - 5, 1, 1), DaysFromCivil(YEAR + 4, 12, 31), MERGE_OVERWRITE);
+    RuleValidator val;
+    val.Attach(s);
+    std::vector<RuleViolation> full;
+    const int32_t first = MonthStart(3, YEAR);
+    int fullEdits = edits / 100 + 1;
+    size_t sink = 0;
+    double t0 = NowSeconds();
+    for (int i = 0; i < edits; i++) {
+        s.Set(first + i % 31, (ShiftType)(1 + i % 3));
+        sink += val.Count();
+    }
+    double t1 = NowSeconds();
+    for (int i = 0; i < fullEdits; i++) {
+        s.Set(first + i % 31, (ShiftType)(1 + i % 3));
+        CheckRules(s, val.Rules(), HistoryStart(s), HistoryEnd(s), full);
+        sink += full.size();
+    }
+    double t2 = NowSeconds();
+    DoNotOptimize(sink);
+    BENCH_CHECK(val.Count() == full.size());
+    printf("edit + rule marks: window %7.1f ns  whole history %9.1f ns\n", (t1 - t0) / edits * 1e9,
+           (t2 - t1) / fullEdits * 1e9);
+
+    // A team's history, 1 thread vs all cores, same violations
+    Roster team;
+    for (int e = 0; e < employees; e++) {
+        int i = team.Add((uint32_t)e);
+        ParseRotation(e % 3 ? "DDNNSSSS" : "DDDDDDDNNNNNSS", DaysFromCivil(YEAR - 1, 1, 1) + e, rot);
+        ApplyRotation(team.Shifts((size_t)i), rot, DaysFromCivil(YEAR - 1, 1, 1), DaysFromCivil(YEAR + 1, 12, 31),
+                      MERGE_OVERWRITE);
+    }
+    std::vector<std::vector<RuleViolation>> one, all;
+    t0 = NowSeconds();
+    ValidateRoster(team, ShiftRules(), one, 1);
+    t1 = NowSeconds();
+    ValidateRoster(team, ShiftRules(), all);
+    t2 = NowSeconds();
+    BENCH_CHECK(one.size() == (size_t)employees && all.size() == one.size());
+    size_t count = 0;
+    for (size_t i = 0; i < one.size(); i++) {
+        BENCH_CHECK(one[i].size() == all[i].size());
+        for (size_t k = 0; k < one[i].size() && k < all[i].size(); k++)
+            BENCH_CHECK(one[i][k].day == all[i][k].day && one[i][k].rules == all[i][k].rules);
+        count += one[i].size();
+    }
+    for (size_t i = 0; i < one.size(); i += one.size() / 8 + 1) {
+        std::vector<RuleViolation> h;
+        ValidateHistory(team.Shifts(i), ShiftRules(), h);
+        BENCH_CHECK(h.size() == one[i].size());
+    }
+    BENCH_CHECK(count > 0);
+    printf("history of %d employees (%zu violations): 1 thread %7.2f ms  %u threads %7.2f ms\n", employees, count,
+           (t1 - t0) * 1e3, std::thread::hardware_concurrency(), (t2 - t1) * 1e3);
+    return 0;
+}
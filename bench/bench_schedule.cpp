@@ -0,0 +1,166 @@
+// ============================================================================
+//  BENCH SCHEDULE - the annealing scheduler on a team's month: coverage and
+//  rules met, nights shared out, the same plan for the same seed on any
+//  number of cores, a timed run replayed from its result, the cost kept
+//  edit by edit against scoring from scratch, and plan quality against
+//  rounds and workers
+// ============================================================================
+
+#include <algorithm>
+#include <thread>
+#include "bench.h"
+#include "core/scheduler.h"
+
+static const int YEAR = 2026;
+
+static void MakeTeam(Roster& team, int employees) {
+    for (int e = 0; e < employees; e++) team.Add((uint32_t)e);
+    // Some history before the plan: the rules must see it
+    team.Shifts(0).Set(MonthStart(3, YEAR) - 1, SHIFT_NIGHT);
+    for (int i = 1; i <= 5; i++) team.Shifts(1).Set(MonthStart(3, YEAR) - i, SHIFT_DAY);
+}
+
+static std::vector<size_t> AllOf(const Roster& team) {
+    std::vector<size_t> v(team.Size());
+    for (size_t i = 0; i < v.size(); i++) v[i] = i;
+    return v;
+}
+
+static void CheckPlan(int employees) {
+    Roster team;
+    MakeTeam(team, employees);
+    ScheduleOptions opt;
+    for (CoverTarget& c : opt.cover) { c.day = 3; c.night = 2; }
+    opt.cover[5].day = opt.cover[6].day = 2;   // fewer on weekend days
+    opt.rounds = 24;
+    opt.movesPerRound = 5000;
+    opt.budgetMs = 0;
+    opt.workers = 4;
+    opt.threads = 4;
+    const int32_t from = MonthStart(3, YEAR), to = from + 30;
+    // All but two work days right after the plan: the last night is theirs
+    for (size_t e = 2; e < (size_t)employees; e++)
+        for (int i = 1; i <= 2; i++) team.Shifts(e).Set(to + i, SHIFT_DAY);
+
+    SchedulePlan plan, again;
+    ScheduleResult r, r2;
+    BENCH_CHECK(SolveSchedule(team, AllOf(team), from, to, opt, plan, r));
+    BENCH_CHECK(r.roundsRun == opt.rounds && r.rounds == opt.rounds && r.seed == opt.seed && r.workers == opt.workers);
+    // The running cost matches a fresh score; a feasible team gets no penalties
+    ScheduleCost fresh = ScoreSchedule(team, plan, opt);
+    BENCH_CHECK(fresh.cover == r.cost.cover && fresh.rules == r.cost.rules && fresh.fairness == r.cost.fairness);
+    BENCH_CHECK(r.cost.cover == 0 && r.cost.rules == 0);
+
+    // Nights are shared out evenly
+    int least = 1 << 30, most = 0;
+    for (size_t e = 0; e < plan.employees.size(); e++) {
+        int n = 0;
+        for (int d = 0; d < plan.Days(); d++) n += plan.At(e, d) == SHIFT_NIGHT;
+        least = std::min(least, n);
+        most = std::max(most, n);
+    }
+    BENCH_CHECK(most - least <= 2);
+
+    // Same seed, same plan, on any number of cores; another seed, another plan
+    BENCH_CHECK(SolveSchedule(team, AllOf(team), from, to, opt, again, r2));
+    BENCH_CHECK(again.codes == plan.codes);
+    for (unsigned threads : { 1u, 3u, 0u }) {
+        opt.threads = threads;
+        BENCH_CHECK(SolveSchedule(team, AllOf(team), from, to, opt, again, r2));
+        BENCH_CHECK(again.codes == plan.codes);
+    }
+    opt.seed = 2;
+    BENCH_CHECK(SolveSchedule(team, AllOf(team), from, to, opt, again, r2));
+    BENCH_CHECK(again.codes != plan.codes);
+
+    // A timed run stops early; its result replays it without the clock
+    const SchedulePlan first = plan;
+    opt.rounds = 48;
+    opt.movesPerRound = 50000;
+    opt.budgetMs = 30;
+    BENCH_CHECK(SolveSchedule(team, AllOf(team), from, to, opt, plan, r));
+    BENCH_CHECK(r.roundsRun >= 1 && r.roundsRun <= r.rounds);
+    ScheduleOptions replay = opt;
+    replay.seed = r.seed;
+    replay.workers = r.workers;
+    replay.rounds = r.rounds;
+    replay.maxRounds = r.roundsRun;
+    replay.budgetMs = 0;
+    replay.threads = 1;
+    BENCH_CHECK(SolveSchedule(team, AllOf(team), from, to, replay, again, r2));
+    BENCH_CHECK(r2.roundsRun == r.roundsRun && again.codes == plan.codes);
+    // The cap alone does not change the cooling: two rounds of 48 are not a
+    // 2-round schedule
+    replay.maxRounds = 2;
+    BENCH_CHECK(SolveSchedule(team, AllOf(team), from, to, replay, plan, r));
+    replay.rounds = 2;
+    replay.maxRounds = 0;
+    BENCH_CHECK(SolveSchedule(team, AllOf(team), from, to, replay, again, r2));
+    BENCH_CHECK(r.roundsRun == 2 && r2.roundsRun == 2 && again.codes != plan.codes);
+    plan = first;
+
+    // Written once per employee: the store has the plan and breaks no rule
+    BENCH_CHECK(WriteSchedule(team, plan) == (size_t)employees * (size_t)plan.Days());
+    for (int32_t z = from; z <= to; z++) {
+        ShiftCounts c = team.CountDay(z);
+        BENCH_CHECK(c.day == opt.cover[WeekdayFromDays(z)].day && c.night == 2);
+    }
+    std::vector<RuleViolation> v;
+    for (size_t e = 0; e < team.Size(); e++) {
+        CheckRules(team.Shifts(e), opt.rules, from, to + opt.rules.Reach(), v);
+        BENCH_CHECK(v.empty());
+    }
+
+    // Unusable input
+    BENCH_CHECK(!SolveSchedule(team, AllOf(team), from, from + MAX_SCHEDULE_DAYS, opt, plan, r));
+    BENCH_CHECK(!SolveSchedule(team, std::vector<size_t>(), from, to, opt, plan, r));
+}
+
+int BenchSchedule(int argc, char** argv) {
+    int employees = argc > 0 ? atoi(argv[0]) : 30;
+    int days = argc > 1 ? atoi(argv[1]) : 91;
+    int moves = argc > 2 ? atoi(argv[2]) : 5000;
+    if (employees <= 0) employees = 30;
+    if (days <= 0 || days > MAX_SCHEDULE_DAYS) days = 91;
+    if (moves <= 0) moves = 5000;
+
+    CheckPlan(20);
+
+    // A quarter: quality against rounds and workers (no time limit, so
+    // every run is reproducible), the workers on all cores
+    Roster team;
+    MakeTeam(team, employees);
+    ScheduleOptions opt;
+    // Over half the team at work every day, weekends included
+    for (CoverTarget& c : opt.cover) { c.day = employees * 3 / 10; c.night = employees / 4; }
+    opt.budgetMs = 0;
+    opt.movesPerRound = moves;
+    const int32_t from = MonthStart(3, YEAR), to = from + days - 1;
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    printf("%d employees x %d days, %d moves per worker and round, %u cores\n", employees, days, opt.movesPerRound, cores);
+    printf("workers  rounds  cover  rules  fairness      ms\n");
+    for (unsigned workers : { 1u, 2u, 4u, 8u }) {
+        for (int rounds : { 4, 16, 64 }) {
+            opt.workers = workers;
+            opt.rounds = rounds;
+            SchedulePlan plan;
+            ScheduleResult r;
+            BENCH_CHECK(SolveSchedule(team, AllOf(team), from, to, opt, plan, r));
+            printf("%7u  %6d  %5lld  %5lld  %8lld  %6.0f\n", workers, rounds, (long long)r.cost.cover,
+                   (long long)r.cost.rules, (long long)r.cost.fairness, r.seconds * 1e3);
+        }
+    }
+
+    // The time budget ends the run between rounds, long before the schedule
+    opt.workers = 8;
+    opt.rounds = 1000;
+    opt.movesPerRound = 25000;
+    opt.budgetMs = 200;
+    SchedulePlan plan;
+    ScheduleResult r;
+    BENCH_CHECK(SolveSchedule(team, AllOf(team), from, to, opt, plan, r));
+    BENCH_CHECK(r.roundsRun < opt.rounds && r.seconds < 1.0);
+    printf("200 ms budget: %d rounds, %.1f M moves/s, cost %lld\n", r.roundsRun, r.moves / r.seconds / 1e6,
+           (long long)r.cost.Total());
+    return 0;
+}
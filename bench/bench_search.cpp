@@ -0,0 +1,212 @@
+// ============================================================================
+//  BENCH SEARCH - the per-type/weekday/holiday bitsets against Get() per day,
+//  fixed expressions against hand-written day loops, malformed expressions,
+//  and the time of a query over 50 years: bitsets vs a per-day loop
+// ============================================================================
+
+#include <cstring>
+#include "bench.h"
+#include "core/shift_search.h"
+
+static void Randomize(ShiftStore& s, uint32_t seed, int32_t from, int32_t to) {
+    for (int32_t z = from; z <= to; z++) {
+        seed = seed * 1103515245u + 12345u;
+        s.Set(z, (ShiftType)((seed >> 16) & 3));
+    }
+}
+
+static bool Bit(const std::vector<uint64_t>& bits, int64_t i) {
+    return (bits[(size_t)(i / 64)] >> (i % 64) & 1) != 0;
+}
+
+static int Count(const std::vector<uint64_t>& bits) {
+    int n = 0;
+    for (uint64_t w : bits) n += PopCount64(w);
+    return n;
+}
+
+static int MonthNights(const ShiftStore& s, int32_t z) {
+    CivilDate c = CivilFromDays(z);
+    int n = 0;
+    for (int d = 1; d <= DaysInMonth(c.m, c.y); d++) n += s.Get(d, c.m, c.y) == SHIFT_NIGHT;
+    return n;
+}
+
+// The answer of each expression written as a day loop
+struct Query {
+    const char* text;
+    bool (*match)(const ShiftStore& s, const HolidayCalendar& h, int32_t z);
+};
+
+static const Query QUERIES[] = {
+    { "N sub 2025", [](const ShiftStore& s, const HolidayCalendar&, int32_t z) {
+        return s.Get(z) == SHIFT_NIGHT && WeekdayFromDays(z) == 5 && CivilFromDays(z).y == 2025; } },
+    { "S (prije(praznik) ili poslije(praznik))", [](const ShiftStore& s, const HolidayCalendar& h, int32_t z) {
+        return s.Get(z) == SHIFT_FREE && (h.IsHoliday(z + 1) || h.IsHoliday(z - 1)); } },
+    { "mjesec(N) > 12", [](const ShiftStore& s, const HolidayCalendar&, int32_t z) {
+        return MonthNights(s, z) > 12; } },
+    { "!(D | N) vikend 2024-03..2024-06", [](const ShiftStore& s, const HolidayCalendar&, int32_t z) {
+        ShiftType st = s.Get(z);
+        return st != SHIFT_DAY && st != SHIFT_NIGHT && WeekdayFromDays(z) >= 5 &&
+               z >= DaysFromCivil(2024, 3, 1) && z <= DaysFromCivil(2024, 6, 30); } },
+    { "radni ne praznik jan", [](const ShiftStore& s, const HolidayCalendar& h, int32_t z) {
+        ShiftType st = s.Get(z);
+        return (st == SHIFT_DAY || st == SHIFT_NIGHT) && !h.IsHoliday(z) && CivilFromDays(z).m == 1; } },
+    { "prazan i 2026-02-28 | Pet & ne (dnevna ili s)", [](const ShiftStore& s, const HolidayCalendar&, int32_t z) {
+        ShiftType st = s.Get(z);
+        return (st == SHIFT_NONE && z == DaysFromCivil(2026, 2, 28)) ||
+               (WeekdayFromDays(z) == 4 && st != SHIFT_DAY && st != SHIFT_FREE); } },
+};
+
+static void CheckIndex(const ShiftStore& s, const HolidayCalendar& h, int32_t from, int32_t to) {
+    ShiftIndex index;
+    index.Build(s, from, to, &h);
+    BENCH_CHECK(index.Words() == (size_t)(to - from) / 64 + 1);
+    for (int32_t z = from; z <= to; z++) {
+        int64_t i = z - from;
+        for (int st = 0; st < 4; st++)
+            BENCH_CHECK(((index.Type((ShiftType)st)[i / 64] >> (i % 64) & 1) != 0) == (s.Get(z) == st));
+        for (int wd = 0; wd < 7; wd++)
+            BENCH_CHECK(((index.Weekday(wd)[i / 64] >> (i % 64) & 1) != 0) == (WeekdayFromDays(z) == wd));
+        BENCH_CHECK(((index.Holidays()[i / 64] >> (i % 64) & 1) != 0) == h.IsHoliday(z));
+    }
+    // Nothing past the last day
+    for (int k = 0; k < 12; k++) BENCH_CHECK((index.Type(SHIFT_NONE)[k * index.Words() + index.Words() - 1] & ~index.TailMask()) == 0);
+}
+
+static void CheckQueries(const ShiftStore& s, const HolidayCalendar& h) {
+    for (const Query& q : QUERIES) {
+        ShiftSearch search;
+        BENCH_CHECK(search.Compile(q.text) == nullptr);
+        int32_t from = DaysFromCivil(2026, 5, 10), to = from;
+        search.Span(s, from, to);
+        ShiftIndex index;
+        index.Build(s, from, to, &h);
+        std::vector<uint64_t> hits;
+        search.Evaluate(index, hits);
+        int wrong = 0, matches = 0;
+        for (int32_t z = from; z <= to; z++) {
+            bool want = q.match(s, h, z);
+            wrong += Bit(hits, z - from) != want;
+            matches += want;
+        }
+        BENCH_CHECK(wrong == 0 && Count(hits) == matches);
+        if (wrong) printf("  '%s': %d wrong days\n", q.text, wrong);
+        // The grid's month mask is the same answer
+        for (int m = 1; m <= 12; m++) {
+            uint32_t mask = SearchMonth(search, s, &h, m, 2025), want = 0;
+            for (int d = 1; d <= DaysInMonth(m, 2025); d++)
+                if (q.match(s, h, DaysFromCivil(2025, m, d))) want |= 1u << (d - 1);
+            BENCH_CHECK(mask == want);
+        }
+    }
+
+    struct Bad { const char* text; size_t at; };
+    static const Bad BAD[] = { { "", 0 }, { "   ", 3 }, { "N ili", 5 }, { "(N sub", 6 }, { "N)", 1 }, { "nocne", 0 },
+                               { "N 2025-13", 2 }, { "2025-02-29", 0 }, { "2026..2025", 0 }, { "mjesec(N) 12", 10 },
+                               { "mjesec(N) > 40", 12 }, { "N # sub", 2 }, { "prije N", 6 } };
+    for (const Bad& b : BAD) {
+        ShiftSearch search;
+        size_t at = 99;
+        const char* err = search.Compile(b.text, &at);
+        BENCH_CHECK(err != nullptr && at == b.at && search.Empty());
+        if (!err || at != b.at) printf("  '%s': %s at %zu\n", b.text, err ? err : "accepted", at);
+    }
+    std::string deep(40, '(');
+    deep += "N" + std::string(40, ')');
+    ShiftSearch search;
+    BENCH_CHECK(search.Compile(deep.c_str()) != nullptr);
+}
+
+// Matches of text over the whole store
+static int Find(const ShiftStore& s, const HolidayCalendar& h, const char* text, int32_t& first) {
+    ShiftSearch search;
+    BENCH_CHECK(search.Compile(text) == nullptr);
+    int32_t from = INT32_MAX, to = INT32_MIN;
+    search.Span(s, from, to);
+    ShiftIndex index;
+    index.Build(s, from, to, &h);
+    std::vector<uint64_t> hits;
+    search.Evaluate(index, hits);
+    first = INT32_MIN;
+    for (int64_t i = (int64_t)hits.size() * 64 - 1; i >= 0; i--)
+        if (Bit(hits, i)) first = from + (int32_t)i;
+    return Count(hits);
+}
+
+// prije/poslije at the ends of the stored years read the day outside them
+static void CheckEdges(const HolidayCalendar& h) {
+    ShiftStore s;
+    for (int32_t z = DaysFromCivil(2026, 12, 20); z <= DaysFromCivil(2026, 12, 31); z++) s.Set(z, SHIFT_FREE);
+    s.Set(DaysFromCivil(2026, 1, 1), SHIFT_FREE);
+    int32_t first;
+    // 1-2 January 2027 are holidays, 31 December 2025 is not
+    BENCH_CHECK(Find(s, h, "S prije(praznik) dec", first) == 1 && first == DaysFromCivil(2026, 12, 31));
+    BENCH_CHECK(Find(s, h, "S poslije(ne praznik) jan", first) == 1 && first == DaysFromCivil(2026, 1, 1));
+    BENCH_CHECK(Find(s, h, "S prije(prije(praznik)) dec", first) == 2 && first == DaysFromCivil(2026, 12, 30));
+    ShiftSearch search;
+    search.Compile("S prije(praznik)");
+    BENCH_CHECK(SearchMonth(search, s, &h, 12, 2026) == 1u << 30);
+}
+
+int BenchSearch(int argc, char** argv) {
+    int years = argc > 0 ? atoi(argv[0]) : 50;
+    if (years <= 0) years = 50;
+
+    HolidayCalendar h;
+    {
+        ShiftStore s;
+        Randomize(s, 7, DaysFromCivil(2023, 3, 5), DaysFromCivil(2027, 10, 20));
+        CheckIndex(s, h, DaysFromCivil(2023, 1, 1), DaysFromCivil(2027, 12, 31));
+        CheckIndex(s, h, DaysFromCivil(2024, 2, 29), DaysFromCivil(2024, 2, 29));
+        CheckQueries(s, h);
+    }
+    CheckEdges(h);
+
+    const int32_t from = DaysFromCivil(2000, 1, 1), to = DaysFromCivil(2000 + years, 1, 1) - 1;
+    ShiftStore s;
+    Randomize(s, 11, from, to);
+    ShiftSearch search;
+    BENCH_CHECK(search.Compile("N sub ne praznik") == nullptr);
+
+    const int reps = 20;
+    int64_t sink = 0;
+    double t0 = NowSeconds();
+    for (int r = 0; r < reps; r++) {
+        ShiftIndex index;
+        index.Build(s, from, to, &h);
+        std::vector<uint64_t> hits;
+        search.Evaluate(index, hits);
+        sink += Count(hits);
+    }
+    double t1 = NowSeconds();
+    ShiftIndex index;
+    index.Build(s, from, to, &h);
+    std::vector<uint64_t> hits;
+    for (int r = 0; r < reps; r++) {
+        search.Evaluate(index, hits);
+        sink += Count(hits);
+    }
+    double t2 = NowSeconds();
+    for (int r = 0; r < reps; r++) {
+        for (int32_t z = from; z <= to; z++)
+            sink += s.Get(z) == SHIFT_NIGHT && WeekdayFromDays(z) == 5 && !h.IsHoliday(z);
+    }
+    double t3 = NowSeconds();
+    BENCH_CHECK(sink % 3 == 0);   // the three ways count the same days
+    DoNotOptimize(sink);
+
+    ShiftSearch nights;
+    nights.Compile("mjesec(N) > 12");
+    double t4 = NowSeconds();
+    uint32_t masks = 0;
+    for (int r = 0; r < reps * 10; r++) masks ^= SearchMonth(nights, s, &h, r % 12 + 1, 2000 + r % years);
+    double t5 = NowSeconds();
+    DoNotOptimize(masks);
+
+    printf("%d years, '%s': %lld days\n", years, "N sub ne praznik", (long long)(sink / 3 / reps));
+    printf("index + query %7.1f us  query %7.1f us  day loop %8.1f us\n",
+           (t1 - t0) / reps * 1e6, (t2 - t1) / reps * 1e6, (t3 - t2) / reps * 1e6);
+    printf("grid month mask ('mjesec(N) > 12'): %7.1f us\n", (t5 - t4) / (reps * 10) * 1e6);
+    return 0;
+}
@@ -0,0 +1,130 @@
+// ============================================================================
+//  BENCH STATS - incremental month/range counters checked against a plain
+//  rescan after random edits, then timed against that rescan.
+// ============================================================================
+
+#include <random>
+#include <vector>
+#include "bench.h"
+#include "core/rotation.h"
+#include "core/shift_store.h"
+
+static ShiftCounts Rescan(const ShiftStore& s, int32_t from, int32_t to) {
+    ShiftCounts c;
+    for (int32_t z = from; z <= to; z++) c.Add(s.Get(z), 1);
+    return c;
+}
+
+static bool Same(const ShiftCounts& a, const ShiftCounts& b) {
+    return a.day == b.day && a.night == b.night && a.free == b.free;
+}
+
+static void CheckAgainstRescan(std::mt19937& rng) {
+    ShiftStore s;
+    const int firstYear = 2015, years = 12;
+    const int32_t lo = DaysFromCivil(firstYear, 1, 1);
+    const int32_t hi = DaysFromCivil(firstYear + years, 1, 1) - 1;
+    std::uniform_int_distribution<int32_t> anyDay(lo, hi);
+    std::uniform_int_distribution<int> anyType(0, 3);
+
+    // Grow from the middle outwards so both ends of the index get rebuilt
+    for (int i = 0; i < 40000; i++) {
+        int32_t z = i < 100 ? DaysFromCivil(firstYear + years / 2, 6, 1) + i : anyDay(rng);
+        s.Set(z, (ShiftType)anyType(rng));
+    }
+    for (int y = firstYear - 1; y <= firstYear + years; y++) {
+        ShiftCounts year;
+        for (int m = 1; m <= 12; m++) {
+            ShiftCounts mc = s.CountMonth(m, y);
+            BENCH_CHECK(Same(mc, Rescan(s, MonthStart(m, y), MonthStart(m, y) + DaysInMonth(m, y) - 1)));
+            year += mc;
+        }
+        BENCH_CHECK(Same(year, s.CountYear(y)));
+    }
+    for (int i = 0; i < 2000; i++) {
+        int32_t a = anyDay(rng) - 400, b = anyDay(rng) + 400;
+        if (a > b) std::swap(a, b);
+        BENCH_CHECK(Same(s.CountByType(a, b), Rescan(s, a, b)));
+    }
+    BENCH_CHECK((size_t)s.CountByType(lo, hi).Total() == s.Count());
+
+    // Bulk rotation writes against a per-day reference, both merge modes,
+    // ranges crossing the stored years so the store grows as well
+    Rotation rot;
+    BENCH_CHECK(ParseRotation("D D N - S S", lo + 3, rot) && rot.period == 6);
+    for (int i = 0; i < 200; i++) {
+        int32_t a = anyDay(rng) - 800, b = a + (int32_t)(rng() % 1500);
+        MergeMode mode = (i & 1) ? MERGE_KEEP : MERGE_OVERWRITE;
+        std::vector<ShiftType> expect;
+        size_t expectChanged = 0;
+        for (int32_t z = a; z <= b; z++) {
+            ShiftType cur = s.Get(z), st = rot.At(z);
+            bool put = st != SHIFT_NONE && (mode == MERGE_OVERWRITE || cur == SHIFT_NONE);
+            expect.push_back(put ? st : cur);
+            expectChanged += put && st != cur;
+        }
+        BENCH_CHECK(ApplyRotation(s, rot, a, b, mode) == expectChanged);
+        for (int32_t z = a; z <= b; z++) BENCH_CHECK(s.Get(z) == expect[(size_t)(z - a)]);
+        BENCH_CHECK(Same(s.CountByType(a - 40, b + 40), Rescan(s, a - 40, b + 40)));
+    }
+    int32_t all0 = DaysFromCivil(s.FirstYear(), 1, 1), all1 = DaysFromCivil(s.FirstYear() + s.YearCount(), 1, 1) - 1;
+    BENCH_CHECK((size_t)Rescan(s, all0, all1).Total() == s.Count());
+
+    // Counts rebuilt from a view must match the incrementally kept ones
+    ShiftStore v;
+    v.AttachView(s.FirstYear(), s.YearCount(), s.YearWords(s.FirstYear()));
+    for (int i = 0; i < 500; i++) {
+        int32_t a = anyDay(rng), b = anyDay(rng);
+        if (a > b) std::swap(a, b);
+        BENCH_CHECK(Same(v.CountByType(a, b), s.CountByType(a, b)));
+    }
+    BENCH_CHECK(v.Count() == s.Count());
+    printf("counters vs rescan after 40000 random edits and 200 rotation fills: OK\n");
+}
+
+int BenchStats(int argc, char** argv) {
+    long queries = argc > 0 ? atol(argv[0]) : 200000;
+    if (queries <= 0) queries = 200000;
+
+    std::mt19937 rng(6);
+    CheckAgainstRescan(rng);
+
+    // Ten years of a DAY/NIGHT/FREE/FREE rotation
+    ShiftStore s;
+    const int32_t lo = DaysFromCivil(2020, 1, 1), hi = DaysFromCivil(2030, 1, 1) - 1;
+    for (int32_t z = lo; z <= hi; z++) {
+        static const ShiftType cycle[] = { SHIFT_DAY, SHIFT_NIGHT, SHIFT_FREE, SHIFT_FREE };
+        s.Set(z, cycle[(z - lo) % 4]);
+    }
+    std::uniform_int_distribution<int32_t> anyDay(lo, hi);
+    std::vector<int32_t> from((size_t)queries), to((size_t)queries);
+    for (long i = 0; i < queries; i++) {
+        int32_t a = anyDay(rng), b = anyDay(rng);
+        from[(size_t)i] = a < b ? a : b; to[(size_t)i] = a < b ? b : a;
+    }
+
+    long sink = 0;
+    double t0 = NowSeconds();
+    for (long i = 0; i < queries; i++) {
+        CivilDate c = CivilFromDays(from[(size_t)i]);
+        sink += Rescan(s, MonthStart(c.m, c.y), MonthStart(c.m, c.y) + DaysInMonth(c.m, c.y) - 1).Working();
+    }
+    double t1 = NowSeconds();
+    for (long i = 0; i < queries; i++) {
+        CivilDate c = CivilFromDays(from[(size_t)i]);
+        sink += s.CountMonth(c.m, c.y).Working();
+    }
+    double t2 = NowSeconds();
+    long rangeN = queries / 100 > 0 ? queries / 100 : 1;
+    for (long i = 0; i < rangeN; i++) sink += Rescan(s, from[(size_t)i], to[(size_t)i]).Working();
+    double t3 = NowSeconds();
+    for (long i = 0; i < queries; i++) sink += s.CountByType(from[(size_t)i], to[(size_t)i]).Working();
+    double t4 = NowSeconds();
+    DoNotOptimize(sink);
+
+    printf("month rescan       %8.1f ns/query\n", (t1 - t0) * 1e9 / queries);
+    printf("CountMonth         %8.1f ns/query\n", (t2 - t1) * 1e9 / queries);
+    printf("range rescan       %8.1f ns/query  (avg %.0f days)\n", (t3 - t2) * 1e9 / rangeN, (hi - lo) / 3.0);
+    printf("CountByType        %8.1f ns/query\n", (t4 - t3) * 1e9 / queries);
+    return 0;
+}
@@ -0,0 +1,138 @@
+// ============================================================================
+//  BENCH TRACE - cost of a TRACE_SCOPE with tracing off and on, ring
+//  wraparound, concurrent writers (no torn events), p50/p99 and the Chrome
+//  trace JSON shape
+// ============================================================================
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "core/trace.h"
+
+static const size_t CAPACITY = 1 << 16;
+static const int    THREADS = 4;
+
+// ns per loop iteration, with or without a trace point in the body
+static double LoopNs(int scopes, bool traced) {
+    double t0 = NowSeconds();
+    for (int i = 0; i < scopes; i++) {
+        if (traced) {
+            TRACE_SCOPE("bench", "scope");
+            DoNotOptimize(i);
+        } else {
+            DoNotOptimize(i);
+        }
+    }
+    return (NowSeconds() - t0) / scopes * 1e9;
+}
+
+// Synthetic durations 1..100 us in a scrambled order
+static void CheckPercentiles() {
+    for (int i = 0; i < 100; i++) {
+        uint64_t us = (uint64_t)(i * 37 % 100 + 1);
+        TraceRecord("bench", "pct", 1000, 1000 + us * 1000);
+    }
+    bool found = false;
+    for (const TraceStat& s : TraceSummary()) {
+        if (strcmp(s.name, "pct") != 0) continue;
+        found = true;
+        BENCH_CHECK(s.count == 100 && s.p50 == 50000 && s.p99 == 99000 && s.max == 100000);
+    }
+    BENCH_CHECK(found);
+}
+
+// Thread t writes name NAMES[t], dur t + 1 and start t << 32 | i: a field
+// from another writer's event shows as a mismatch
+static bool Whole(const TraceEvent& e, const char* const* names, int perThread) {
+    uint64_t t = e.dur - 1;
+    return e.dur >= 1 && e.dur <= THREADS && e.name == names[t] && strcmp(e.cat, "bench") == 0 &&
+           e.start >> 32 == t && (e.start & 0xffffffffu) < (uint64_t)perThread;
+}
+
+// Threads overwrite each other's slots; every event read back is whole
+static void CheckThreads(int perThread) {
+    static const char* const NAMES[THREADS] = { "t1", "t2", "t3", "t4" };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++)
+        threads.emplace_back([t, perThread] {
+            for (int i = 0; i < perThread; i++) {
+                uint64_t start = (uint64_t)t << 32 | (uint64_t)i;
+                TraceRecord("bench", NAMES[t], start, start + t + 1);
+            }
+        });
+    std::vector<TraceEvent> events;
+    TraceEvents(events);   // while they write: only whole events come back
+    for (const TraceEvent& e : events)
+        if (e.name[0] == 't') BENCH_CHECK(Whole(e, NAMES, perThread));
+    for (std::thread& th : threads) th.join();
+
+    // A writer claims its slot before it writes and drops the event if
+    // another writer still owns it. A slot of the last lap is only missing
+    // when a writer that fell a whole lap behind held it, once per thread
+    // at most.
+    TraceEvents(events);
+    BENCH_CHECK(events.size() <= CAPACITY && events.size() + THREADS >= CAPACITY);
+    uint32_t threadOf[THREADS] = {};
+    for (const TraceEvent& e : events) {
+        BENCH_CHECK(Whole(e, NAMES, perThread));
+        if (e.dur < 1 || e.dur > THREADS) continue;
+        uint32_t& id = threadOf[e.dur - 1];
+        BENCH_CHECK(e.thread != 0 && (id == 0 || id == e.thread));
+        id = e.thread;
+    }
+    for (int a = 0; a < THREADS; a++)
+        for (int b = a + 1; b < THREADS; b++) BENCH_CHECK(!threadOf[a] || threadOf[a] != threadOf[b]);
+}
+
+static void CheckJson() {
+    std::vector<TraceEvent> events;
+    TraceEvents(events);
+    FILE* f = tmpfile();
+    BENCH_CHECK(f && WriteChromeTrace(f));
+    std::string json((size_t)ftell(f), '\0');
+    rewind(f);
+    BENCH_CHECK(fread(&json[0], 1, json.size(), f) == json.size());
+    fclose(f);
+    BENCH_CHECK(json.compare(0, 16, "{\"traceEvents\":[") == 0);
+    BENCH_CHECK(json.size() > 30 && json.compare(json.size() - 26, 26, "],\"displayTimeUnit\":\"ms\"}\n") == 0);
+    size_t complete = 0, depth = 0, maxDepth = 0;
+    for (size_t p = json.find("\"ph\":\"X\""); p != std::string::npos; p = json.find("\"ph\":\"X\"", p + 1)) complete++;
+    for (char c : json) {
+        if (c == '{' || c == '[') maxDepth = ++depth > maxDepth ? depth : maxDepth;
+        if (c == '}' || c == ']') { BENCH_CHECK(depth > 0); depth--; }
+    }
+    BENCH_CHECK(complete == events.size() && depth == 0 && maxDepth == 3);
+}
+
+int BenchTrace(int argc, char** argv) {
+    int scopes = argc > 0 ? atoi(argv[0]) : 1000000;
+    if (scopes <= 0) scopes = 1000000;
+
+    // Off: nothing recorded, a relaxed load and a branch per scope
+    std::vector<TraceEvent> events;
+    BENCH_CHECK(!TraceEnabled() && TraceEvents(events) == 0);
+    double plain = LoopNs(scopes, false), off = LoopNs(scopes, true);
+    BENCH_CHECK(TraceEvents(events) == 0);
+
+    TraceStart(CAPACITY);
+    CheckPercentiles();
+    double on = LoopNs(scopes, true);
+    uint64_t total = TraceEvents(events);
+    BENCH_CHECK(total == 100 + (uint64_t)scopes);
+    BENCH_CHECK(events.size() == ((size_t)total < CAPACITY ? (size_t)total : CAPACITY));
+    // Oldest first: the scopes of one thread come back in start order
+    for (size_t i = 1; i < events.size(); i++)
+        if (!strcmp(events[i].name, "scope") && !strcmp(events[i - 1].name, "scope"))
+            BENCH_CHECK(events[i].start >= events[i - 1].start);
+    CheckThreads(scopes / 4 > (int)CAPACITY ? scopes / 4 : (int)CAPACITY);
+    CheckJson();
+    TraceStop();
+
+    double offNs = off - plain, onNs = on - plain;
+    printf("trace scope: off %6.2f ns  on %6.2f ns  (loop %5.2f ns)  ring %zu events\n",
+           offNs > 0 ? offNs : 0, onNs, plain, CAPACITY);
+    if (scopes >= 1000000) BENCH_CHECK(offNs < 5);
+    return 0;
+}
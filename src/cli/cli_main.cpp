@@ -0,0 +1,827 @@
+// ============================================================================
+//  SMJENE CLI - headless access to the shift data (no GUI, builds on Linux)
+//  Usage: smjene_cli <command> <data> [args...]   (smjene_cli --help)
+//  <data> is the base path of the data files (smjene_data) or any of
+//  smjene_data.bin / .txt / .journal; the journal is replayed as in the GUI.
+//  Commands work on the default employee unless --emp <id> picks another one.
+// ============================================================================
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include "core/binary_format.h"
+#include "core/data_file.h"
+#include "core/export_format.h"
+#include "core/holidays.h"
+#include "core/import_format.h"
+#include "core/month_view.h"
+#include "core/overview_view.h"
+#include "core/payroll.h"
+#include "core/raster.h"
+#include "core/rotation.h"
+#include "core/scheduler.h"
+#include "core/shift_ops.h"
+#include "core/shift_rules.h"
+#include "core/shift_search.h"
+#include "core/text_format.h"
+#include "core/trace.h"
+
+// ============================================================================
+//  OUTPUT - large buffered writes to stdout
+// ============================================================================
+
+class OutBuffer {
+public:
+    ~OutBuffer() { Flush(); }
+    char* Reserve(size_t n) {
+        if (m_used + n > sizeof(m_buf)) Flush();
+        return m_buf + m_used;
+    }
+    void Commit(size_t n) { m_used += n; }
+    void Write(const char* s) {
+        size_t n = strlen(s);
+        memcpy(Reserve(n), s, n);
+        Commit(n);
+    }
+    void Flush() { if (m_used) fwrite(m_buf, 1, m_used, stdout); m_used = 0; }
+
+private:
+    char   m_buf[1 << 16];
+    size_t m_used = 0;
+};
+
+// ============================================================================
+//  ARGUMENTS
+// ============================================================================
+
+static PathString DataBase(const char* arg) {
+    size_t n = strlen(arg);
+    static const char* const EXTS[] = { ".bin", ".txt", ".journal" };
+    for (const char* ext : EXTS) {
+        size_t e = strlen(ext);
+        if (n > e && strcmp(arg + n - e, ext) == 0) return PathFromUtf8(std::string(arg, n - e).c_str());
+    }
+    return PathFromUtf8(arg);
+}
+
+static bool ArgDate(const char* arg, int32_t& day) {
+    const char* err = ParseDate(arg, arg + strlen(arg), day);
+    if (!err && strlen(arg) == 10) return true;
+    fprintf(stderr, "'%s': %s\n", arg, err ? err : "neispravan datum (ocekivano YYYY-MM-DD)");
+    return false;
+}
+
+// "YYYY-MM"
+static bool ArgMonth(const char* arg, int& m, int& y) {
+    char* end = nullptr;
+    y = (int)strtol(arg, &end, 10);
+    if (end == arg + 4 && *end == '-') {
+        m = (int)strtol(end + 1, &end, 10);
+        if (*end == 0 && m >= 1 && m <= 12 && y >= ShiftStore::MIN_YEAR && y <= ShiftStore::MAX_YEAR)
+            return true;
+    }
+    fprintf(stderr, "'%s': neispravan mjesec (ocekivano YYYY-MM)\n", arg);
+    return false;
+}
+
+static bool ArgYear(const char* arg, int& y) {
+    char* end = nullptr;
+    y = (int)strtol(arg, &end, 10);
+    return end != arg && *end == 0 && y >= ShiftStore::MIN_YEAR && y <= ShiftStore::MAX_YEAR;
+}
+
+static bool ArgEmployee(const char* arg, uint32_t& id) {
+    char* end = nullptr;
+    unsigned long v = strtoul(arg, &end, 10);
+    if (end != arg && *end == 0 && *arg != '-' && v <= 0xFFFFFFFFul) { id = (uint32_t)v; return true; }
+    fprintf(stderr, "'%s': neispravan broj radnika\n", arg);
+    return false;
+}
+
+// "D=2,N=1": people on the day and the night shift, every day
+static bool ArgCover(const char* arg, CoverTarget& cover) {
+    for (const char* p = arg; *p; ) {
+        char* end = nullptr;
+        long n = (p[0] == 'D' || p[0] == 'N') && p[1] == '=' ? strtol(p + 2, &end, 10) : -1;
+        if (n < 0 || n > 1000 || end == p + 2 || (*end != ',' && *end != 0)) {
+            fprintf(stderr, "'%s': neispravna popuna (ocekivano D=2,N=1)\n", arg);
+            return false;
+        }
+        (p[0] == 'D' ? cover.day : cover.night) = (int)n;
+        p = *end ? end + 1 : end;
+    }
+    return true;
+}
+
+// Positional arguments with the "--flag" options taken out
+struct Args {
+    std::vector<const char*> pos;
+    bool keep = false, all = false, five = false, months = false;
+    uint32_t employee = Roster::DEFAULT_ID;
+    bool hasEmployee = false;
+    const char* times = nullptr;
+    const char* trace = nullptr;
+    uint64_t seed = 1;
+    int ms = 2000;
+    int rounds = 0;          // plan: rounds run at most (0: the whole schedule)
+    unsigned threads = 0;    // plan: cores (0: all)
+
+    bool Parse(int argc, char** argv) {
+        for (int i = 0; i < argc; i++) {
+            if (strcmp(argv[i], "--keep") == 0) keep = true;
+            else if (strcmp(argv[i], "--all") == 0) all = true;
+            else if (strcmp(argv[i], "--five") == 0) five = true;
+            else if (strcmp(argv[i], "--months") == 0) months = true;
+            else if (strcmp(argv[i], "--emp") == 0) {
+                if (i + 1 == argc) { fprintf(stderr, "--emp: nedostaje broj radnika\n"); return false; }
+                if (!ArgEmployee(argv[++i], employee)) return false;
+                hasEmployee = true;
+            } else if (strcmp(argv[i], "--times") == 0) {
+                if (i + 1 == argc) { fprintf(stderr, "--times: nedostaju vremena smjena\n"); return false; }
+                times = argv[++i];
+            } else if (strcmp(argv[i], "--trace") == 0) {
+                if (i + 1 == argc) { fprintf(stderr, "--trace: nedostaje izlazna datoteka\n"); return false; }
+                trace = argv[++i];
+            } else if (strcmp(argv[i], "--seed") == 0 || strcmp(argv[i], "--ms") == 0 ||
+                       strcmp(argv[i], "--rounds") == 0 || strcmp(argv[i], "--threads") == 0) {
+                const char o = argv[i][2];
+                const unsigned long long max = o == 's' ? ~0ull : o == 'm' ? 3600000 : o == 'r' ? 1000000 : 1024;
+                char* end = nullptr;
+                unsigned long long v = i + 1 < argc ? strtoull(argv[i + 1], &end, 10) : 0;
+                if (!end || end == argv[i + 1] || *end || argv[i + 1][0] == '-' || v > max) {
+                    fprintf(stderr, "%s: nedostaje ili neispravan broj\n", argv[i]);
+                    return false;
+                }
+                if (o == 's') seed = v;
+                else if (o == 'm') ms = (int)v;
+                else if (o == 'r') rounds = (int)v;
+                else threads = (unsigned)v;
+                i++;
+            } else if (argv[i][0] == '-' && argv[i][1] == '-') {
+                fprintf(stderr, "nepoznata opcija '%s'\n", argv[i]);
+                return false;
+            } else pos.push_back(argv[i]);
+        }
+        return true;
+    }
+};
+
+// ============================================================================
+//  DATA
+// ============================================================================
+
+static void PrintReport(const char* file, const TextParseReport& r) {
+    for (size_t i = 0; i < r.errorCount && i < (size_t)TextParseReport::MAX_ERRORS; i++)
+        fprintf(stderr, "%s, linija %zu: %s\n", file, r.errors[i].line, r.errors[i].reason);
+    if (r.errorCount > (size_t)TextParseReport::MAX_ERRORS)
+        fprintf(stderr, "%s: ukupno %zu neispravnih linija\n", file, r.errorCount);
+}
+
+static void OpenRoster(ShiftDataFile& data, const char* arg, Roster& roster, bool readOnly) {
+    data.Open(DataBase(arg), roster, readOnly);
+    PrintReport("smjene_data.txt", data.LegacyReport());
+    PrintReport("smjene_data.journal", data.JournalReport());
+}
+
+// Opens the data and returns the column of the selected employee
+static ShiftStore& OpenData(ShiftDataFile& data, const Args& a, Roster& roster, bool readOnly) {
+    OpenRoster(data, a.pos[0], roster, readOnly);
+    int i = roster.Add(a.employee);
+    if (i < 0) {
+        fprintf(stderr, "previse radnika\n");
+        exit(2);
+    }
+    return roster.Shifts((size_t)i);
+}
+
+// The holiday file beside the data (smjene_praznici.txt), when there is one
+static void LoadHolidays(const char* arg, HolidayCalendar& holidays) {
+    PathString path = DataBase(arg);
+    size_t slash = path.find_last_of(PATH_TEXT("/\\"));
+    path = (slash == PathString::npos ? PathString() : path.substr(0, slash + 1)) + PATH_TEXT("smjene_praznici.txt");
+    FILE* f = OpenPath(path, "rb");
+    if (!f) return;
+    TextParseReport r;
+    holidays.Load(f, &r);
+    fclose(f);
+    PrintReport("smjene_praznici.txt", r);
+}
+
+static int Saved(ShiftDataFile& data, size_t changed) {
+    if (!data.Close()) { fprintf(stderr, "greska pri snimanju podataka\n"); return 2; }
+    printf("promijenjeno: %zu\n", changed);
+    return 0;
+}
+
+// ============================================================================
+//  COMMANDS
+// ============================================================================
+
+static int CmdQuery(const Args& a) {
+    int32_t from, to;
+    if (a.pos.size() != 3 || !ArgDate(a.pos[1], from) || !ArgDate(a.pos[2], to)) return 1;
+    Roster roster;
+    ShiftDataFile data;
+    ShiftStore& store = OpenData(data, a, roster, true);
+
+    OutBuffer out;
+    if (a.all) {
+        for (int32_t z = from; z <= to; z++) out.Commit((size_t)FormatShiftLine(out.Reserve(16), z, store.Get(z)));
+    } else {
+        store.ForEach(from, to, [&](int32_t z, ShiftType st) {
+            out.Commit((size_t)FormatShiftLine(out.Reserve(16), z, st));
+        });
+    }
+    return 0;
+}
+
+static void StatsLine(OutBuffer& out, const char* period, const ShiftCounts& c) {
+    char* p = out.Reserve(128);
+    out.Commit((size_t)snprintf(p, 128, "%s\t%d\t%d\t%d\t%d\t%d\n",
+                                period, c.day, c.night, c.free, c.Working(), c.Total()));
+}
+
+static int CmdStats(const Args& a) {
+    if (a.pos.size() != 2 && a.pos.size() != 3) return 1;
+    int y = 0, m = 0;
+    int32_t from = 0, to = 0;
+    bool range = a.pos.size() == 3, year = !range && ArgYear(a.pos[1], y);
+    if (range && (!ArgDate(a.pos[1], from) || !ArgDate(a.pos[2], to))) return 1;
+    if (!range && !year && !ArgMonth(a.pos[1], m, y)) return 1;
+
+    Roster roster;
+    ShiftDataFile data;
+    ShiftStore& store = OpenData(data, a, roster, true);
+
+    OutBuffer out;
+    out.Write("period\tdnevne\tnocne\tslobodne\tradne\tukupno\n");
+    char label[32];
+    if (range) {
+        FormatDate(label, from);
+        label[10] = '.'; label[11] = '.';
+        FormatDate(label + 12, to);
+        label[22] = 0;
+        StatsLine(out, label, store.CountByType(from, to));
+    } else if (year) {
+        for (m = 1; m <= 12; m++) {
+            snprintf(label, sizeof(label), "%04d-%02d", y, m);
+            StatsLine(out, label, store.CountMonth(m, y));
+        }
+        snprintf(label, sizeof(label), "%04d", y);
+        StatsLine(out, label, store.CountYear(y));
+    } else {
+        snprintf(label, sizeof(label), "%04d-%02d", y, m);
+        StatsLine(out, label, store.CountMonth(m, y));
+    }
+    return 0;
+}
+
+static void HoursLine(OutBuffer& out, const char* period, const PayTotals& t) {
+    char* p = out.Reserve(160);
+    out.Commit((size_t)snprintf(p, 160, "%s\t%d:%02d\t%d:%02d\t%d:%02d\t%d:%02d\t%d:%02d\n", period,
+                                t.worked / 60, t.worked % 60, t.night / 60, t.night % 60, t.weekend / 60, t.weekend % 60,
+                                t.holiday / 60, t.holiday % 60, t.overtime / 60, t.overtime % 60));
+}
+
+// Working hours per month (and ISO week) of one employee, or the year of
+// every employee with --all
+static int CmdHours(const Args& a) {
+    if (a.pos.size() != 2) return 1;
+    int y = 0, m = 0;
+    bool year = ArgYear(a.pos[1], y);
+    if (!year && !ArgMonth(a.pos[1], m, y)) return 1;
+    if (a.all && !year) { fprintf(stderr, "--all: samo za cijelu godinu (YYYY)\n"); return 1; }
+    PayrollModel model;
+    if (a.times)
+        if (const char* err = ParseShiftTimes(a.times, model.times)) { fprintf(stderr, "'%s': %s\n", a.times, err); return 1; }
+    LoadHolidays(a.pos[0], model.holidays);
+
+    Roster roster;
+    ShiftDataFile data;
+    OutBuffer out;
+    char label[32];
+    if (a.all) {
+        OpenRoster(data, a.pos[0], roster, true);
+        std::vector<PayTotals> totals;
+        PayrollYear(roster, y, PayTable(model), totals);
+        out.Write("radnik\tsati\tnocni\tvikend\tpraznik\tprekovremeno\n");
+        for (size_t i = 0; i < roster.Size(); i++) {
+            snprintf(label, sizeof(label), "%u", roster.At(i).id);
+            HoursLine(out, label, totals[i]);
+        }
+        return 0;
+    }
+
+    ShiftStore& store = OpenData(data, a, roster, true);
+    PayrollLedger ledger(model);
+    ledger.Attach(store);
+    out.Write("period\tsati\tnocni\tvikend\tpraznik\tprekovremeno\n");
+    if (year) {
+        for (m = 1; m <= 12; m++) {
+            snprintf(label, sizeof(label), "%04d-%02d", y, m);
+            HoursLine(out, label, ledger.Month(m, y));
+        }
+        snprintf(label, sizeof(label), "%04d", y);
+        HoursLine(out, label, ledger.Year(y));
+    } else {
+        // The ISO weeks whose Thursday is in the month carry its overtime
+        int32_t first = MonthStart(m, y), last = first + DaysInMonth(m, y) - 1;
+        for (int32_t thu = first + (3 - WeekdayFromDays(first) + 7) % 7; thu <= last; thu += 7) {
+            IsoWeekDate w = IsoWeek(thu);
+            snprintf(label, sizeof(label), "%04d-W%02d", w.year, w.week);
+            HoursLine(out, label, ledger.Week(thu));
+        }
+        snprintf(label, sizeof(label), "%04d-%02d", y, m);
+        HoursLine(out, label, ledger.Month(m, y));
+    }
+    return 0;
+}
+
+// Public holidays of a year and the employee's shift on each
+static int CmdHolidays(const Args& a) {
+    int y = 0;
+    if (a.pos.size() != 2 || !ArgYear(a.pos[1], y)) return 1;
+    HolidayCalendar holidays;
+    LoadHolidays(a.pos[0], holidays);
+
+    Roster roster;
+    ShiftDataFile data;
+    ShiftStore& store = OpenData(data, a, roster, true);
+    OutBuffer out;
+    out.Write("datum\tpraznik\tsmjena\n");
+    int count = 0, worked = 0;
+    for (int32_t z = DaysFromCivil(y, 1, 1); z < DaysFromCivil(y + 1, 1, 1); z++) {
+        if (!holidays.IsHoliday(z)) continue;
+        ShiftType st = store.Get(z);
+        const char* name = holidays.Name(z);
+        char* p = out.Reserve(160);
+        char* e = p + FormatDate(p, z);
+        e += snprintf(e, 140, "\t%.120s\t%c\n", name ? name : "", "-DNS"[st]);
+        out.Commit((size_t)(e - p));
+        count++;
+        worked += st == SHIFT_DAY || st == SHIFT_NIGHT;
+    }
+    out.Flush();
+    fprintf(stderr, "praznika: %d, radnih: %d\n", count, worked);
+    return 0;
+}
+
+// Days (--months: months with matching days) of a shift_search.h expression,
+// e.g. "N sub 2025" or "S (prije(praznik) ili poslije(praznik))"
+static int CmdFind(const Args& a) {
+    if (a.pos.size() < 2) return 1;
+    std::string text;
+    for (size_t i = 1; i < a.pos.size(); i++) (text += i > 1 ? " " : "") += a.pos[i];
+    ShiftSearch search;
+    size_t at = 0;
+    if (const char* err = search.Compile(text.c_str(), &at)) {
+        fprintf(stderr, "neispravan upit: %s\n  %s\n  %*s^\n", err, text.c_str(), (int)at, "");
+        return 2;
+    }
+    HolidayCalendar holidays;
+    LoadHolidays(a.pos[0], holidays);
+
+    Roster roster;
+    ShiftDataFile data;
+    ShiftStore& store = OpenData(data, a, roster, true);
+    int32_t from = INT32_MAX, to = INT32_MIN;
+    search.Span(store, from, to);
+    ShiftIndex index;
+    index.Build(store, from, to, &holidays);
+    std::vector<uint64_t> hits;
+    search.Evaluate(index, hits);
+
+    static const char* const DAYS[7] = { "pon", "uto", "sri", "cet", "pet", "sub", "ned" };
+    OutBuffer out;
+    out.Write(a.months ? "mjesec\tdana\n" : "datum\tdan\tsmjena\n");
+    int count = 0, monthCount = 0;
+    CivilDate month = {};
+    for (size_t k = 0; k < hits.size(); k++) {
+        for (uint64_t w = hits[k]; w; w &= w - 1) {
+            const int32_t z = from + (int32_t)(k * 64) + CountTrailingZeros64(w);
+            count++;
+            if (!a.months) {
+                char* p = out.Reserve(32);
+                char* e = p + FormatDate(p, z);
+                e += snprintf(e, 16, "\t%s\t%c\n", DAYS[WeekdayFromDays(z)], "-DNS"[store.Get(z)]);
+                out.Commit((size_t)(e - p));
+                continue;
+            }
+            CivilDate c = CivilFromDays(z);
+            if (monthCount && (c.y != month.y || c.m != month.m)) {
+                char* p = out.Reserve(32);
+                out.Commit((size_t)snprintf(p, 32, "%04d-%02d\t%d\n", month.y, month.m, monthCount));
+                monthCount = 0;
+            }
+            month = c;
+            monthCount++;
+        }
+    }
+    if (monthCount) {
+        char* p = out.Reserve(32);
+        out.Commit((size_t)snprintf(p, 32, "%04d-%02d\t%d\n", month.y, month.m, monthCount));
+    }
+    out.Flush();
+    fprintf(stderr, "dana: %d\n", count);
+    return 0;
+}
+
+static void RuleLine(OutBuffer& out, const char* who, const RuleViolation& v) {
+    static const char* const NAMES[4] = { "odmor", "uzastopni radni dani", "uzastopne noci", "slobodni u sedmici" };
+    char* p = out.Reserve(128);
+    char* e = p + snprintf(p, 32, "%s%s", who, *who ? "\t" : "");
+    e += FormatDate(e, v.day);
+    *e++ = '\t';
+    const char* sep = "";
+    for (int r = 0; r < 4; r++) {
+        if (!(v.rules >> r & 1)) continue;
+        e += snprintf(e, 32, "%s%s", sep, NAMES[r]);
+        sep = ", ";
+    }
+    *e++ = '\n';
+    out.Commit((size_t)(e - p));
+}
+
+// Labour rule violations of the whole history, checked in parallel
+static int CmdCheck(const Args& a) {
+    if (a.pos.size() != 1) return 1;
+    ShiftRules rules;
+    Roster roster;
+    ShiftDataFile data;
+    OutBuffer out;
+    size_t count = 0;
+    if (a.all) {
+        OpenRoster(data, a.pos[0], roster, true);
+        std::vector<std::vector<RuleViolation>> found;
+        ValidateRoster(roster, rules, found);
+        out.Write("radnik\tdatum\tpravila\n");
+        char who[16];
+        for (size_t i = 0; i < roster.Size(); i++) {
+            snprintf(who, sizeof(who), "%u", roster.At(i).id);
+            for (const RuleViolation& v : found[i]) RuleLine(out, who, v);
+            count += found[i].size();
+        }
+    } else {
+        std::vector<RuleViolation> found;
+        ValidateHistory(OpenData(data, a, roster, true), rules, found);
+        out.Write("datum\tpravila\n");
+        for (const RuleViolation& v : found) RuleLine(out, "", v);
+        count = found.size();
+    }
+    fprintf(stderr, "dana sa prekrsajem: %zu\n", count);
+    return 0;
+}
+
+// Fills a month or a quarter for every employee with the annealing
+// scheduler, as one journal batch
+static int CmdPlan(const Args& a) {
+    if (a.pos.size() < 2 || a.pos.size() > 4) return 1;
+    int y = 0, m = 0, months = 1;
+    if (!ArgMonth(a.pos[1], m, y)) return 1;
+    ScheduleOptions opt;
+    CoverTarget cover;
+    for (size_t i = 2; i < a.pos.size(); i++) {
+        if (a.pos[i][0] == 'D' || a.pos[i][0] == 'N') {
+            if (!ArgCover(a.pos[i], cover)) return 1;
+        } else if ((months = atoi(a.pos[i])) < 1 || months > 3) {
+            fprintf(stderr, "'%s': broj mjeseci 1-3\n", a.pos[i]);
+            return 1;
+        }
+    }
+    for (CoverTarget& c : opt.cover) c = cover;
+    opt.seed = a.seed;
+    opt.budgetMs = a.ms;
+    opt.maxRounds = a.rounds;
+    opt.threads = a.threads;
+
+    Roster roster;
+    ShiftDataFile data;
+    OpenRoster(data, a.pos[0], roster, false);
+    if (roster.Size() == 0) roster.Default();
+    std::vector<size_t> team(roster.Size());
+    for (size_t i = 0; i < team.size(); i++) team[i] = i;
+    const int32_t from = MonthStart(m, y);
+    int m2 = m + months - 1, y2 = y + (m2 - 1) / 12;
+    m2 = (m2 - 1) % 12 + 1;
+    const int32_t to = MonthStart(m2, y2) + DaysInMonth(m2, y2) - 1;
+
+    SchedulePlan plan;
+    ScheduleResult r;
+    if (!SolveSchedule(roster, team, from, to, opt, plan, r)) return 1;
+    printf("radnika: %zu, dana: %d, krugova: %d od %d, pokusaja: %llu, %.2f s\n", team.size(), plan.Days(), r.roundsRun,
+           r.rounds, (unsigned long long)r.moves, r.seconds);
+    // The same plan on any machine, without the clock
+    printf("ponovo isti raspored: --seed %llu --rounds %d --ms 0\n", (unsigned long long)r.seed, r.roundsRun);
+    printf("kazne: popuna %lld, pravila %lld, raspodjela %lld\n", (long long)r.cost.cover, (long long)r.cost.rules,
+           (long long)r.cost.fairness);
+    return Saved(data, WriteSchedule(roster, plan));
+}
+
+static int CmdSet(const Args& a) {
+    int32_t from, to;
+    if (a.pos.size() != 4 || !ArgDate(a.pos[1], from) || !ArgDate(a.pos[2], to)) return 1;
+    Rotation rot;
+    if (!ParseRotation(a.pos[3], from, rot)) {
+        fprintf(stderr, "'%s': neispravna smjena/ciklus (D, N, S, -)\n", a.pos[3]);
+        return 1;
+    }
+    Roster roster;
+    ShiftDataFile data;
+    ShiftStore& store = OpenData(data, a, roster, false);
+    return Saved(data, ApplyRotation(store, rot, from, to, a.keep ? MERGE_KEEP : MERGE_OVERWRITE));
+}
+
+static int CmdClear(const Args& a) {
+    int32_t from, to;
+    if (a.pos.size() != 3 || !ArgDate(a.pos[1], from) || !ArgDate(a.pos[2], to)) return 1;
+    Roster roster;
+    ShiftDataFile data;
+    ShiftStore& store = OpenData(data, a, roster, false);
+    return Saved(data, ClearRange(store, from, to));
+}
+
+// Whole months, or a span of days to another start: copy <od> <do> <na>
+static int CmdCopy(const Args& a) {
+    if (a.pos.size() == 4 && strlen(a.pos[1]) == 10) {
+        int32_t from, to, dst;
+        if (!ArgDate(a.pos[1], from) || !ArgDate(a.pos[2], to) || !ArgDate(a.pos[3], dst)) return 1;
+        Roster roster;
+        ShiftDataFile data;
+        ShiftStore& store = OpenData(data, a, roster, false);
+        return Saved(data, CopyRange(store, from, to, store, dst, a.keep ? MERGE_KEEP : MERGE_OVERWRITE));
+    }
+    int srcM, srcY;
+    if (a.pos.size() < 3 || !ArgMonth(a.pos[1], srcM, srcY)) return 1;
+    std::vector<std::pair<int, int>> targets;
+    for (size_t i = 2; i < a.pos.size(); i++) {
+        int m, y;
+        if (!ArgMonth(a.pos[i], m, y)) return 1;
+        targets.push_back(std::make_pair(m, y));
+    }
+    Roster roster;
+    ShiftDataFile data;
+    ShiftStore& store = OpenData(data, a, roster, false);
+    size_t changed = 0;
+    for (const std::pair<int, int>& t : targets)
+        changed += (size_t)CopyMonthPattern(store, srcM, srcY, t.first, t.second, !a.keep);
+    return Saved(data, changed);
+}
+
+// Moves the schedule of a span by whole days
+static int CmdMove(const Args& a) {
+    int32_t from, to;
+    if (a.pos.size() != 4 || !ArgDate(a.pos[1], from) || !ArgDate(a.pos[2], to)) return 1;
+    char* end = nullptr;
+    long days = strtol(a.pos[3], &end, 10);
+    if (end == a.pos[3] || *end || days < -36600 || days > 36600) {
+        fprintf(stderr, "'%s': neispravan broj dana\n", a.pos[3]);
+        return 1;
+    }
+    Roster roster;
+    ShiftDataFile data;
+    ShiftStore& store = OpenData(data, a, roster, false);
+    return Saved(data, ShiftRange(store, from, to, (int32_t)days));
+}
+
+// Exchanges a span between the --emp employee and another one
+static int CmdSwap(const Args& a) {
+    int32_t from, to;
+    uint32_t other;
+    if (a.pos.size() != 4 || !ArgDate(a.pos[1], from) || !ArgDate(a.pos[2], to) || !ArgEmployee(a.pos[3], other)) return 1;
+    Roster roster;
+    ShiftDataFile data;
+    ShiftStore& store = OpenData(data, a, roster, false);
+    int i = roster.Add(other);
+    if (i < 0) { fprintf(stderr, "previse radnika\n"); return 2; }
+    return Saved(data, SwapRanges(store, roster.Shifts((size_t)i), from, to));
+}
+
+static int CmdConvert(const Args& a) {
+    if (a.pos.size() != 2) return 1;
+    const char* out = a.pos[1];
+    size_t n = strlen(out);
+    bool toBin = n > 4 && strcmp(out + n - 4, ".bin") == 0;
+    bool toTxt = n > 4 && strcmp(out + n - 4, ".txt") == 0;
+    if (!toBin && !toTxt) { fprintf(stderr, "'%s': izlaz mora biti .txt ili .bin\n", out); return 1; }
+
+    // The whole roster, --emp does not apply
+    Roster roster;
+    ShiftDataFile data;
+    OpenRoster(data, a.pos[0], roster, true);
+    FILE* f = OpenPath(PathFromUtf8(out), "wb");
+    if (!f) { fprintf(stderr, "'%s': ne mogu otvoriti za pisanje\n", out); return 2; }
+    setvbuf(f, nullptr, _IOFBF, 1 << 16);
+    bool ok = toBin ? WriteBinarySnapshot(f, roster, 1) : WriteShiftText(f, roster);
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) { fprintf(stderr, "'%s': greska pri pisanju\n", out); return 2; }
+    printf("zapisano: %zu smjena, %zu radnika\n", roster.Count(), roster.Size());
+    return 0;
+}
+
+// iCalendar or CSV by the extension of the output, --all: every employee
+static int CmdExport(const Args& a) {
+    if (a.pos.size() != 2 && a.pos.size() != 4) return 1;
+    const char* out = a.pos[1];
+    size_t n = strlen(out);
+    bool ics = n > 4 && strcmp(out + n - 4, ".ics") == 0;
+    bool csv = n > 4 && strcmp(out + n - 4, ".csv") == 0;
+    if (!ics && !csv) { fprintf(stderr, "'%s': izlaz mora biti .ics ili .csv\n", out); return 1; }
+    ExportOptions opt;
+    if (a.pos.size() == 4 && (!ArgDate(a.pos[2], opt.from) || !ArgDate(a.pos[3], opt.to))) return 1;
+    if (a.times) {
+        if (const char* err = ParseShiftTimes(a.times, opt.times)) { fprintf(stderr, "'%s': %s\n", a.times, err); return 1; }
+    }
+    opt.stamp = (int64_t)time(nullptr);
+
+    Roster roster;
+    ShiftDataFile data;
+    OpenRoster(data, a.pos[0], roster, true);
+    if (!a.all) {
+        opt.employee = roster.Find(a.employee);
+        if (opt.employee < 0) { fprintf(stderr, "nepoznat radnik %u\n", a.employee); return 1; }
+    }
+    FILE* f = OpenPath(PathFromUtf8(out), "wb");
+    if (!f) { fprintf(stderr, "'%s': ne mogu otvoriti za pisanje\n", out); return 2; }
+    ExportStats stats;
+    bool ok = ics ? ExportIcs(f, roster, opt, &stats) : ExportCsv(f, roster, opt, &stats);
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) { fprintf(stderr, "'%s': greska pri pisanju\n", out); return 2; }
+    printf("zapisano: %zu smjena, %llu bajtova\n", stats.events, (unsigned long long)stats.bytes);
+    return 0;
+}
+
+// CSV or iCalendar by the extension of the input, applied as one batch and
+// one save; --emp puts every row on that employee
+static int CmdImport(const Args& a) {
+    if (a.pos.size() != 2) return 1;
+    const char* in = a.pos[1];
+    size_t n = strlen(in);
+    bool ics = n > 4 && strcmp(in + n - 4, ".ics") == 0;
+    bool csv = n > 4 && strcmp(in + n - 4, ".csv") == 0;
+    if (!ics && !csv) { fprintf(stderr, "'%s': ulaz mora biti .ics ili .csv\n", in); return 1; }
+    ImportOptions opt;
+    opt.mode = a.keep ? MERGE_KEEP : MERGE_OVERWRITE;
+    opt.employee = a.employee;
+    opt.fileEmployees = !a.hasEmployee;
+    if (a.times) {
+        if (const char* err = ParseShiftTimes(a.times, opt.times)) { fprintf(stderr, "'%s': %s\n", a.times, err); return 1; }
+    }
+
+    FILE* f = OpenPath(PathFromUtf8(in), "rb");
+    if (!f) { fprintf(stderr, "'%s': ne mogu otvoriti\n", in); return 2; }
+    std::vector<ShiftRecord> records;
+    ImportReport report;
+    ReadImport(f, ics ? IMPORT_ICS : IMPORT_CSV, opt, records, report);
+    bool ok = ferror(f) == 0;
+    fclose(f);
+    if (!ok) { fprintf(stderr, "'%s': greska pri citanju\n", in); return 2; }
+    PrintReport(in, report.parse);
+
+    Roster roster;
+    ShiftDataFile data;
+    OpenRoster(data, a.pos[0], roster, false);
+    ApplyImport(roster, records, opt, report);
+    if (!data.Close()) { fprintf(stderr, "greska pri snimanju podataka\n"); return 2; }
+    printf("redova: %zu, dodano: %zu, prepisano: %zu, preskoceno: %zu, odbijeno: %zu\n",
+           report.rows, report.added, report.overwritten, report.skipped, report.rejected);
+    return 0;
+}
+
+// Lists the employees, or adds/renames the --emp one
+static int CmdEmployees(const Args& a) {
+    if (a.pos.size() != 1 && a.pos.size() != 2) return 1;
+    Roster roster;
+    ShiftDataFile data;
+    if (a.pos.size() == 2) {
+        OpenData(data, a, roster, false);
+        roster.Add(a.employee, a.pos[1]);
+        return Saved(data, 1);
+    }
+    OpenRoster(data, a.pos[0], roster, true);
+    printf("radnik\tsmjena\time\n");
+    for (size_t i = 0; i < roster.Size(); i++)
+        printf("%u\t%zu\t%s\n", roster.At(i).id, roster.Shifts(i).Count(), roster.At(i).name.c_str());
+    return 0;
+}
+
+// The month, or the year overview (--five: five years), as the GUI draws
+// it, through the software rasterizer
+static int CmdRender(const Args& a) {
+    int m = 1, y = 0, w = 934, h = 701;
+    if (a.pos.size() != 3 && a.pos.size() != 4) return 1;
+    const bool overview = strchr(a.pos[1], '-') == nullptr;
+    if (overview && !ArgYear(a.pos[1], y)) {
+        fprintf(stderr, "'%s': neispravna godina (ocekivano YYYY ili YYYY-MM)\n", a.pos[1]);
+        return 1;
+    }
+    if (!overview && !ArgMonth(a.pos[1], m, y)) return 1;
+    if (a.pos.size() == 4 && (sscanf(a.pos[3], "%dx%d", &w, &h) != 2 || w < 200 || h < 200 || w > 8192 || h > 8192)) {
+        fprintf(stderr, "'%s': velicina mora biti SxV, npr. 934x701\n", a.pos[3]);
+        return 1;
+    }
+
+    Roster roster;
+    ShiftDataFile data;
+    ShiftStore& store = OpenData(data, a, roster, true);
+    UiState ui;
+    ui.width = w; ui.height = h; ui.viewMonth = m; ui.viewYear = y;
+    ui.viewMode = !overview ? VIEW_MONTH : a.five ? VIEW_YEARS5 : VIEW_YEAR;
+    time_t now = time(nullptr);
+    struct tm* t = localtime(&now);
+    ui.today = DaysFromCivil(t->tm_year + 1900, t->tm_mon + 1, t->tm_mday);
+
+    DisplayList dl;
+    {
+        TRACE_SCOPE("view", "build");
+        if (overview) BuildOverview(ComputeOverviewLayout(w, h, ui.viewMode, y), ui, store, RasterMetrics(), dl);
+        else {
+            HolidayCalendar holidays;
+            LoadHolidays(a.pos[0], holidays);
+            MonthOverlay overlay;
+            overlay.holidays = holidays.MonthMask(m, y);
+            BuildMonthView(ComputeLayout(w, h, m, y), ui, store, RasterMetrics(), dl, &overlay);
+        }
+    }
+    RasterImage img(w, h);
+    RasterizeDisplayList(dl, img, MakeRect(0, 0, w, h));
+    FILE* f = OpenPath(PathFromUtf8(a.pos[2]), "wb");
+    if (!f) { fprintf(stderr, "'%s': ne mogu otvoriti za pisanje\n", a.pos[2]); return 2; }
+    bool ok = WritePpm(f, img);
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) { fprintf(stderr, "'%s': greska pri pisanju\n", a.pos[2]); return 2; }
+    return 0;
+}
+
+struct Command {
+    const char* name;
+    const char* args;
+    const char* help;
+    int (*run)(const Args& a);
+};
+
+static const Command COMMANDS[] = {
+    { "query",    "<podaci> <od> <do> [--all]",               "smjene od..do kao \"YYYY-MM-DD V\" (--all: i prazni dani)", CmdQuery },
+    { "stats",    "<podaci> <YYYY | YYYY-MM | od do>",        "broj smjena po mjesecima / za period",                      CmdStats },
+    { "hours",    "<podaci> <YYYY | YYYY-MM> [--all]",        "radni sati, nocni, vikend, praznik, prekovremeno (--all: svi radnici)", CmdHours },
+    { "holidays", "<podaci> <YYYY>",                          "praznici godine (ugradjeni + smjene_praznici.txt) i smjena na njih", CmdHolidays },
+    { "find",     "<podaci> <upit...> [--months]",            "dani koji odgovaraju upitu, npr. \"N sub 2025\" (--months: broj po mjesecima)", CmdFind },
+    { "check",    "<podaci> [--all]",                         "pravila rada: odmor posle noci, uzastopni dani, slobodni u sedmici", CmdCheck },
+    { "plan",     "<podaci> <YYYY-MM> [1-3] [D=1,N=1]",       "raspored svih radnika za 1-3 mjeseca (popuna smjena, pravila, jednako noci/vikenda)", CmdPlan },
+    { "set",      "<podaci> <od> <do> <ciklus> [--keep]",     "upis smjene ili ciklusa (D, N, S, -) od <od>",              CmdSet },
+    { "clear",    "<podaci> <od> <do>",                       "brisanje perioda",                                          CmdClear },
+    { "copy",     "<podaci> <YYYY-MM> <YYYY-MM>... [--keep]", "kao dugme Kopiraj (dan-po-dan); ili <od> <do> <na>: period na drugi datum", CmdCopy },
+    { "move",     "<podaci> <od> <do> <dana>",                "pomjeranje rasporeda perioda za +/- dana",                  CmdMove },
+    { "swap",     "<podaci> <od> <do> <radnik>",              "zamjena smjena perioda izmedju --emp radnika i <radnik>",   CmdSwap },
+    { "convert",  "<podaci> <izlaz.txt | izlaz.bin>",         "zapis podataka (svi radnici) u drugi format",               CmdConvert },
+    { "export",   "<podaci> <izlaz.ics|izlaz.csv> [od do]",  "kalendar (.ics) / tabela (.csv) smjena; --all: svi radnici", CmdExport },
+    { "import",   "<podaci> <ulaz.ics|ulaz.csv> [--keep]",    "uvoz smjena iz kalendara / tabele, jedna izmjena",          CmdImport },
+    { "employees", "<podaci> [ime]",                          "spisak radnika; sa imenom dodaje/preimenuje --emp radnika", CmdEmployees },
+    { "render",   "<podaci> <YYYY[-MM]> <izlaz.ppm> [SxV]",   "mjesec / godina (--five: 5 godina) kao u programu, slika PPM", CmdRender },
+};
+
+// The Chrome trace to path, p50/p99 per trace point to stderr
+static bool WriteTrace(const char* path) {
+    TraceStop();
+    FILE* f = OpenPath(PathFromUtf8(path), "wb");
+    bool ok = f && WriteChromeTrace(f);
+    if (f) ok = fclose(f) == 0 && ok;
+    if (!ok) fprintf(stderr, "'%s': greska pri pisanju\n", path);
+    WriteTraceSummary(stderr);
+    return ok;
+}
+
+static void Usage(FILE* f) {
+    fprintf(f, "upotreba: smjene_cli <naredba> <podaci> [argumenti]\n"
+               "  <podaci>: smjene_data (ili smjene_data.bin/.txt/.journal), datumi YYYY-MM-DD\n");
+    for (const Command& c : COMMANDS) fprintf(f, "  %-9s %-40s %s\n", c.name, c.args, c.help);
+    fprintf(f, "  --keep: postojece smjene se ne prepisuju\n"
+               "  --emp <id>: radnik (bez opcije: osnovni radnik 0)\n"
+               "  --times D=07:00-19:00,N=19:00-07:00,S=dan: vrijeme smjena za export/import/hours (S=dan: cijeli dan)\n"
+               "  --seed <n>, --ms <n>: plan: isti seed daje isti raspored (za isti broj krugova), vrijeme u ms (2000, 0: bez ogranicenja)\n"
+               "  --rounds <n>, --threads <n>: plan: najvise n krugova (od 48), broj jezgara (ne mijenja raspored)\n"
+               "  --trace <izlaz.json>: trajanje ucitavanja/snimanja/crtanja kao Chrome trace, p50/p99 na stderr\n"
+               "                        (ili varijabla okruzenja SMJENE_TRACE=<izlaz.json>)\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || !strcmp(argv[1], "-h") || !strcmp(argv[1], "--help")) {
+        Usage(argc < 2 ? stderr : stdout);
+        return argc < 2 ? 1 : 0;
+    }
+    for (const Command& c : COMMANDS) {
+        if (strcmp(argv[1], c.name) != 0) continue;
+        Args a;
+        if (!a.Parse(argc - 2, argv + 2)) return 1;
+        if (a.trace) TraceStart();
+        else a.trace = TraceStartFromEnv();
+        int rc = c.run(a);
+        if (rc == 1) fprintf(stderr, "upotreba: smjene_cli %s %s\n", c.name, c.args);
+        if (a.trace) rc = WriteTrace(a.trace) ? rc : 2;
+        return rc;
+    }
+    fprintf(stderr, "nepoznata naredba '%s'\n", argv[1]);
+    Usage(stderr);
+    return 1;
+}
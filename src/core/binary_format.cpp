@@ -0,0 +1,211 @@
+// ============================================================================
+//  BINARY FORMAT
+// ============================================================================
+
+#include "binary_format.h"
+#include <cstring>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+#include "text_format.h"
+
+static const char BIN_MAGIC[4] = {'S', 'M', 'J', 'B'};
+static const int  WPY = ShiftStore::WORDS_PER_YEAR;
+
+// Slots past the last day of the year must stay empty
+static bool YearPaddingClear(int y, const uint64_t* w) {
+    int days = DaysInYear(y);
+    uint64_t used = ~0ull >> (2 * (WPY * ShiftStore::SLOTS_PER_WORD - days));
+    return (w[WPY - 1] & ~used) == 0;
+}
+
+// One employee's column while writing or reading a snapshot
+struct SnapshotColumn {
+    uint32_t        id = Roster::DEFAULT_ID;
+    const char*     name = "";
+    uint32_t        nameLength = 0;
+    int             firstYear = 0, years = 0;
+    uint32_t        firstWord = 0;
+    const ShiftStore* store = nullptr;   // writing only
+};
+
+static bool WriteColumns(FILE* f, const std::vector<SnapshotColumn>& cols, uint32_t generation) {
+    uint32_t entries = 0, names = 0;
+    for (const SnapshotColumn& c : cols) { entries += (uint32_t)c.years; names += c.nameLength; }
+
+    BinHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, BIN_MAGIC, 4);
+    h.version = BIN_VERSION;
+    h.headerSize = (uint16_t)sizeof(BinHeader);
+    h.generation = generation;
+    h.employeeCount = (uint32_t)cols.size();
+    h.yearCount = entries;
+    h.dirOffset = (uint32_t)sizeof(BinHeader);
+    h.employeeOffset = h.dirOffset + entries * (uint32_t)sizeof(BinYearEntry);
+    h.namesSize = names;
+    uint64_t namesOffset = h.employeeOffset + (uint64_t)cols.size() * sizeof(BinEmployee);
+    h.dataOffset = (namesOffset + names + 7) & ~7ull;
+    fwrite(&h, sizeof(h), 1, f);
+
+    std::vector<BinYearEntry> dir;
+    dir.reserve(entries);
+    uint32_t word = 0;
+    for (size_t i = 0; i < cols.size(); i++) {
+        for (int y = 0; y < cols[i].years; y++, word += WPY) {
+            BinYearEntry e;
+            e.year = (int16_t)(cols[i].firstYear + y);
+            e.employee = (uint16_t)i;
+            e.wordIndex = word;
+            dir.push_back(e);
+        }
+    }
+    if (!dir.empty()) fwrite(dir.data(), sizeof(BinYearEntry), dir.size(), f);
+
+    uint32_t nameOffset = (uint32_t)namesOffset;
+    for (const SnapshotColumn& c : cols) {
+        BinEmployee e = { c.id, nameOffset, c.nameLength };
+        fwrite(&e, sizeof(e), 1, f);
+        nameOffset += c.nameLength;
+    }
+    for (const SnapshotColumn& c : cols) fwrite(c.name, 1, c.nameLength, f);
+
+    static const char pad[8] = {0};
+    fwrite(pad, 1, (size_t)(h.dataOffset - namesOffset - names), f);
+    for (const SnapshotColumn& c : cols)
+        if (c.years) fwrite(c.store->YearWords(c.firstYear), sizeof(uint64_t), (size_t)c.years * WPY, f);
+    return ferror(f) == 0;
+}
+
+static SnapshotColumn ColumnOf(const ShiftStore& store) {
+    SnapshotColumn c;
+    c.firstYear = store.FirstYear();
+    c.years = store.YearCount();
+    c.store = &store;
+    return c;
+}
+
+bool WriteBinarySnapshot(FILE* f, const ShiftStore& store, uint32_t generation) {
+    return WriteColumns(f, std::vector<SnapshotColumn>(1, ColumnOf(store)), generation);
+}
+
+bool WriteBinarySnapshot(FILE* f, const Roster& roster, uint32_t generation) {
+    std::vector<SnapshotColumn> cols;
+    cols.reserve(roster.Size());
+    for (size_t i = 0; i < roster.Size(); i++) {
+        SnapshotColumn c = ColumnOf(roster.Shifts(i));
+        c.id = roster.At(i).id;
+        c.name = roster.At(i).name.c_str();
+        c.nameLength = (uint32_t)roster.At(i).name.size();
+        cols.push_back(c);
+    }
+    return WriteColumns(f, cols, generation);
+}
+
+// Validates the snapshot and collects the columns; words stay in the mapping
+static bool ParseSnapshot(const uint8_t* data, size_t size, std::vector<SnapshotColumn>& cols,
+                          const uint64_t*& words, uint32_t* generation) {
+    BinHeader h;
+    memset(&h, 0, sizeof(h));
+    if (size < BIN_HEADER_V1_SIZE) return false;
+    memcpy(&h, data, BIN_HEADER_V1_SIZE);
+    if (memcmp(h.magic, BIN_MAGIC, 4) != 0 || h.version < 1 || h.version > BIN_VERSION) return false;
+    size_t known = h.version >= 2 ? sizeof(BinHeader) : BIN_HEADER_V1_SIZE;
+    if (h.headerSize < known || h.headerSize > size || (h.dataOffset & 7) != 0) return false;
+    memcpy(&h, data, known);
+    if ((uint64_t)h.dirOffset + (uint64_t)h.yearCount * sizeof(BinYearEntry) > size) return false;
+    if (h.dataOffset > size) return false;
+    uint64_t totalWords = (size - h.dataOffset) / sizeof(uint64_t);
+    words = (const uint64_t*)(data + h.dataOffset);
+
+    cols.clear();
+    if (h.version >= 2) {
+        if (h.employeeCount > Roster::MAX_EMPLOYEES) return false;
+        if ((uint64_t)h.employeeOffset + (uint64_t)h.employeeCount * sizeof(BinEmployee) > size) return false;
+        cols.resize(h.employeeCount);
+        for (uint32_t i = 0; i < h.employeeCount; i++) {
+            BinEmployee e;
+            memcpy(&e, data + h.employeeOffset + (size_t)i * sizeof(BinEmployee), sizeof(e));
+            if ((uint64_t)e.nameOffset + e.nameLength > size) return false;
+            cols[i].id = e.id;
+            cols[i].name = (const char*)data + e.nameOffset;
+            cols[i].nameLength = e.nameLength;
+        }
+    } else {
+        cols.resize(1);   // everything belongs to the default employee
+    }
+
+    // Each employee's years must be ascending and contiguous to be used in place
+    const BinYearEntry* dir = (const BinYearEntry*)(data + h.dirOffset);
+    for (uint32_t i = 0; i < h.yearCount; i++) {
+        BinYearEntry e;
+        memcpy(&e, dir + i, sizeof(e));
+        if (h.version < 2 && e.employee != 0) continue;
+        if (e.employee >= cols.size()) return false;
+        SnapshotColumn& c = cols[e.employee];
+        if ((uint64_t)e.wordIndex + WPY > totalWords) return false;
+        if (c.years == 0) { c.firstYear = e.year; c.firstWord = e.wordIndex; }
+        else if (e.year != c.firstYear + c.years || e.wordIndex != c.firstWord + (uint32_t)(c.years * WPY)) return false;
+        if (e.year < ShiftStore::MIN_YEAR || e.year > ShiftStore::MAX_YEAR) return false;
+        if (!YearPaddingClear(e.year, words + e.wordIndex)) return false;
+        c.years++;
+    }
+    if (generation) *generation = h.generation;
+    return true;
+}
+
+static void AttachColumn(const SnapshotColumn& c, const uint64_t* words, ShiftStore& store) {
+    if (c.years) store.AttachView(c.firstYear, c.years, words + c.firstWord);
+    else store.Clear();
+}
+
+bool ReadBinarySnapshot(const uint8_t* data, size_t size, ShiftStore& store, uint32_t* generation) {
+    std::vector<SnapshotColumn> cols;
+    const uint64_t* words = nullptr;
+    if (!ParseSnapshot(data, size, cols, words, generation)) return false;
+    store.Clear();
+    for (const SnapshotColumn& c : cols)
+        if (c.id == Roster::DEFAULT_ID) AttachColumn(c, words, store);
+    return true;
+}
+
+bool ReadBinarySnapshot(const uint8_t* data, size_t size, Roster& roster, uint32_t* generation) {
+    std::vector<SnapshotColumn> cols;
+    const uint64_t* words = nullptr;
+    if (!ParseSnapshot(data, size, cols, words, generation)) return false;
+    roster.Clear();
+    for (size_t k = 0; k < cols.size(); k++) {
+        const SnapshotColumn& c = cols[k];
+        if (roster.Add(c.id, std::string(c.name, c.nameLength).c_str()) != (int)k) {
+            roster.Clear();   // duplicate id
+            return false;
+        }
+        AttachColumn(c, words, roster.Shifts(k));
+    }
+    return true;
+}
+
+bool ConvertTextToBinary(const PathString& txtPath, const PathString& binPath) {
+    Roster roster;
+    FILE* f = OpenPath(txtPath, "r");
+    if (!f) return false;
+    uint32_t gen = ReadTextGeneration(f);
+    ReadShiftText(f, roster, false);
+    fclose(f);
+
+    if (!(f = OpenPath(binPath, "wb"))) return false;
+    bool ok = WriteBinarySnapshot(f, roster, gen);
+    return (fclose(f) == 0) && ok;
+}
+
+bool ConvertBinaryToText(const PathString& binPath, const PathString& txtPath) {
+    MappedFile map;
+    Roster roster;
+    uint32_t gen = 0;
+    if (!map.Open(binPath) || !ReadBinarySnapshot(map.Data(), map.Size(), roster, &gen)) return false;
+
+    FILE* f = OpenPath(txtPath, "w");
+    if (!f) return false;
+    bool ok = WriteShiftText(f, roster, gen);
+    return (fclose(f) == 0) && ok;
+}
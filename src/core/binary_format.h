@@ -0,0 +1,63 @@
+// ============================================================================
+//  BINARY FORMAT - versioned, memory-mappable snapshot (smjene_data.bin)
+//  [BinHeader][BinYearEntry x yearCount][BinEmployee x employeeCount]
+//  [names][12 x uint64 per entry]
+//  Little-endian. Shift words use the ShiftStore year layout, so a mapped
+//  file is attached to a store in place, without parsing or copying; each
+//  employee's years are contiguous. Version 1 has no employee table and
+//  all of its years belong to the default employee.
+// ============================================================================
+
+#pragma once
+
+#include <cstdio>
+#include "file_util.h"
+#include "roster.h"
+#include "shift_store.h"
+
+static const uint16_t BIN_VERSION = 2;
+
+struct BinHeader {
+    char     magic[4];       // "SMJB"
+    uint16_t version;        // BIN_VERSION of the writer
+    uint16_t headerSize;     // sizeof(BinHeader), newer versions may append fields
+    uint32_t generation;     // matches the journal's "#gen N"
+    uint32_t employeeCount;
+    uint32_t yearCount;      // directory entries
+    uint32_t dirOffset;      // bytes from file start
+    uint64_t dataOffset;     // bytes from file start, 8-byte aligned
+    // version 2
+    uint32_t employeeOffset; // BinEmployee table, bytes from file start
+    uint32_t namesSize;      // bytes of UTF-8 names behind the table
+};
+
+struct BinYearEntry {
+    int16_t  year;
+    uint16_t employee;       // index into the employee table
+    uint32_t wordIndex;      // first of WORDS_PER_YEAR words, counted from dataOffset
+};
+
+struct BinEmployee {
+    uint32_t id;
+    uint32_t nameOffset;     // bytes from file start
+    uint32_t nameLength;
+};
+
+static const uint16_t BIN_HEADER_V1_SIZE = 32;
+static_assert(sizeof(BinHeader) == 40, "BinHeader layout");
+static_assert(sizeof(BinYearEntry) == 8, "BinYearEntry layout");
+static_assert(sizeof(BinEmployee) == 12, "BinEmployee layout");
+
+// A single store is written as the default employee
+bool WriteBinarySnapshot(FILE* f, const ShiftStore& store, uint32_t generation);
+bool WriteBinarySnapshot(FILE* f, const Roster& roster, uint32_t generation);
+
+// Validates a mapped snapshot and attaches its years to the store(s) as
+// views; the mapping must outlive them (see ShiftStore::Materialize).
+// A single store gets the default employee's years.
+bool ReadBinarySnapshot(const uint8_t* data, size_t size, ShiftStore& store, uint32_t* generation);
+bool ReadBinarySnapshot(const uint8_t* data, size_t size, Roster& roster, uint32_t* generation);
+
+// Lossless conversion between the legacy text file and the binary snapshot
+bool ConvertTextToBinary(const PathString& txtPath, const PathString& binPath);
+bool ConvertBinaryToText(const PathString& binPath, const PathString& txtPath);
@@ -0,0 +1,76 @@
+// ============================================================================
+//  BITS - portable bit helpers for packed shift words and day bitsets
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+inline int CountTrailingZeros64(uint64_t v) {
+#if defined(_MSC_VER)
+    unsigned long i; _BitScanForward64(&i, v); return (int)i;
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+inline int PopCount64(uint64_t v) {
+#if defined(_MSC_VER)
+    return (int)__popcnt64(v);
+#else
+    return __builtin_popcountll(v);
+#endif
+}
+
+// Low bit of every 2-bit slot
+static const uint64_t SLOT_LOW_BITS = 0x5555555555555555ull;
+
+// One bit (the slot's low bit) per non-empty slot of a packed shift word
+inline uint64_t OccupiedSlots(uint64_t w) { return (w | (w >> 1)) & SLOT_LOW_BITS; }
+
+// Both bits of every slot whose low bit is set in lowBits
+inline uint64_t SpreadSlots(uint64_t lowBits) { return lowBits * 3; }
+
+// Both bits of the slots [first, last] of a word, clipped to 0..31
+inline uint64_t SlotRangeMask(int first, int last) {
+    if (first < 0) first = 0;
+    if (last > 31) last = 31;
+    if (first > last) return 0;
+    return (last == 31 ? ~0ull : (1ull << (2 * last + 2)) - 1) & ~((1ull << (2 * first)) - 1);
+}
+
+// Low bit of every slot of a packed word that holds code
+inline uint64_t SlotsEqual(uint64_t w, unsigned code) {
+    uint64_t x = w ^ (SLOT_LOW_BITS * code);
+    return ~(x | (x >> 1)) & SLOT_LOW_BITS;
+}
+
+// The slot low bits of a word packed together: bit i = slot i
+inline uint32_t CompactSlots(uint64_t lowBits) {
+    uint64_t x = lowBits & SLOT_LOW_BITS;
+    x = (x | (x >> 1)) & 0x3333333333333333ull;
+    x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x >> 4)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x >> 8)) & 0x0000FFFF0000FFFFull;
+    return (uint32_t)(x | (x >> 16));
+}
+
+// The 64 bits starting at bit (may be negative) of a buffer of count
+// words; bits outside the buffer read as 0
+inline uint64_t BitsAt(const uint64_t* words, size_t count, int64_t bit) {
+    int64_t i = bit >= 0 ? bit / 64 : -((-bit + 63) / 64);
+    int off = (int)(bit - i * 64);
+    uint64_t lo = (i >= 0 && (size_t)i < count) ? words[i] : 0;
+    uint64_t hi = (i + 1 >= 0 && (size_t)(i + 1) < count) ? words[i + 1] : 0;
+    return off ? (lo >> off) | (hi << (64 - off)) : lo;
+}
+
+// The 32 slots starting at slot (may be negative) of a packed buffer of
+// count words; slots outside the buffer read as 0
+inline uint64_t PackedSlotsAt(const uint64_t* words, size_t count, int64_t slot) {
+    return BitsAt(words, count, slot * 2);
+}
@@ -0,0 +1,126 @@
+// ============================================================================
+//  CALENDAR - constexpr civil calendar engine (no windows.h, no mktime)
+//  Day number = days since 1970-01-01 (proleptic Gregorian calendar).
+//  Weekdays are Monday-based (0 = PON ... 6 = NED), like the grid columns.
+// ============================================================================
+
+#pragma once
+
+#include <cstdint>
+
+constexpr bool IsLeapYear(int y) {
+    return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+// Days before the 1st of month m (index m-1), [leap][m]; [x][12] = year length
+constexpr int MONTH_START[2][13] = {
+    {0,31,59,90,120,151,181,212,243,273,304,334,365},
+    {0,31,60,91,121,152,182,213,244,274,305,335,366},
+};
+
+constexpr int DaysInMonth(int m, int y) {
+    if (m < 1 || m > 12) return 30;
+    return MONTH_START[IsLeapYear(y)][m] - MONTH_START[IsLeapYear(y)][m - 1];
+}
+
+constexpr int DaysInYear(int y) { return IsLeapYear(y) ? 366 : 365; }
+
+// 0-based day of the year (1. januar = 0)
+constexpr int DayOfYear(int d, int m, int y) {
+    return MONTH_START[IsLeapYear(y)][m - 1] + d - 1;
+}
+
+// Month (1..12) containing the 0-based day of the year
+constexpr int MonthFromDayOfYear(int doy, int y) {
+    int m = doy / 31 + 1;  // never past the real month, at most one short
+    return (m < 12 && doy >= MONTH_START[IsLeapYear(y)][m]) ? m + 1 : m;
+}
+
+// H. Hinnant, "chrono-Compatible Low-Level Date Algorithms"
+constexpr int32_t DaysFromCivil(int y, int m, int d) {
+    y -= m <= 2;
+    const int era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = (unsigned)(y - era * 400);
+    const unsigned doy = (153 * (unsigned)(m > 2 ? m - 3 : m + 9) + 2) / 5 + (unsigned)d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+struct CivilDate { int y, m, d; };
+
+constexpr CivilDate CivilFromDays(int32_t z) {
+    z += 719468;
+    const int era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = (unsigned)(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+    return CivilDate{ (int)yoe + era * 400 + (m <= 2), (int)m, (int)d };
+}
+
+constexpr int32_t MonthStart(int m, int y) { return DaysFromCivil(y, 1, 1) + MONTH_START[IsLeapYear(y)][m - 1]; }
+
+// 1970-01-01 was a Thursday (3)
+constexpr int WeekdayFromDays(int32_t z) { return (int)((z % 7 + 7 + 3) % 7); }
+constexpr int DayOfWeek(int d, int m, int y) { return WeekdayFromDays(DaysFromCivil(y, m, d)); }
+
+constexpr int32_t AddDays(int32_t z, int n) { return z + n; }
+
+// Moves by n months, clamping the day (31.01. + 1 = 28./29.02.)
+constexpr CivilDate AddMonths(CivilDate c, int n) {
+    int idx = c.y * 12 + (c.m - 1) + n;
+    int y = (idx >= 0 ? idx : idx - 11) / 12;
+    int m = idx - y * 12 + 1;
+    int dim = DaysInMonth(m, y);
+    return CivilDate{ y, m, c.d < dim ? c.d : dim };
+}
+
+// ISO 8601 week: weeks start on Monday, week 1 contains the year's first Thursday
+struct IsoWeekDate { int year, week, weekday; };
+
+constexpr IsoWeekDate IsoWeek(int32_t z) {
+    const int wd = WeekdayFromDays(z);
+    const int32_t thursday = z - wd + 3;
+    const int y = CivilFromDays(thursday).y;
+    return IsoWeekDate{ y, (int)((thursday - DaysFromCivil(y, 1, 1)) / 7) + 1, wd };
+}
+
+// Monday of ISO week 1 of year y
+constexpr int32_t IsoWeekOneStart(int y) {
+    const int32_t jan4 = DaysFromCivil(y, 1, 4);
+    return jan4 - WeekdayFromDays(jan4);
+}
+
+// Calendar grid of one month: 7 columns (PON..NED), up to 6 rows
+struct MonthGrid {
+    int32_t first;     // day number of the 1st
+    int     firstDow;  // column of the 1st
+    int     days;
+    int     rows;
+
+    constexpr int Index(int day) const { return day - 1 + firstDow; }
+    constexpr int Row(int day) const { return Index(day) / 7; }
+    constexpr int Col(int day) const { return Index(day) % 7; }
+    // Day of month in the cell, or 0 when the cell is outside the month
+    constexpr int DayAt(int row, int col) const {
+        int d = row * 7 + col - firstDow + 1;
+        return (col >= 0 && col < 7 && d >= 1 && d <= days) ? d : 0;
+    }
+};
+
+constexpr MonthGrid MakeMonthGrid(int m, int y) {
+    const int32_t first = MonthStart(m, y);
+    const int dow = WeekdayFromDays(first);
+    const int days = DaysInMonth(m, y);
+    return MonthGrid{ first, dow, days, (dow + days + 6) / 7 };
+}
+
+static_assert(DaysFromCivil(1970, 1, 1) == 0, "epoch");
+static_assert(DaysFromCivil(2000, 3, 1) == 11017, "leap era");
+static_assert(CivilFromDays(11016).d == 29, "2000-02-29");
+static_assert(DayOfWeek(1, 1, 2024) == 0, "2024-01-01 is a Monday");
+static_assert(IsoWeek(DaysFromCivil(2021, 1, 3)).week == 53, "2021-01-03 is in 2020-W53");
+static_assert(MonthFromDayOfYear(334, 2023) == 12 && MonthFromDayOfYear(59, 2024) == 2, "month of day");
+static_assert(MakeMonthGrid(2, 2021).rows == 4, "Feb 2021 fills exactly four rows");
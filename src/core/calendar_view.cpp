@@ -0,0 +1,42 @@
+// ============================================================================
+//  CALENDAR VIEW
+// ============================================================================
+
+#include "calendar_view.h"
+#include "month_view.h"
+#include "overview_view.h"
+
+const DisplayList& CalendarView::Get(const CalendarLayout& layout, const UiState& ui, const ShiftStore& shifts,
+                                     const TextMetrics& metrics) {
+    if (!m_valid || !SameUi(ui, m_ui)) {
+        TRACE_SCOPE("view", "build");
+        if (ui.viewMode == VIEW_MONTH) {
+            MonthOverlay overlay;
+            if (m_payroll) {
+                overlay.hasHours = true;
+                overlay.hours = m_payroll->Month(ui.viewMonth, ui.viewYear);
+            }
+            if (m_rules) overlay.violations = m_rules->MonthMask(ui.viewMonth, ui.viewYear);
+            if (m_holidays) overlay.holidays = m_holidays->MonthMask(ui.viewMonth, ui.viewYear);
+            if (m_search) overlay.matches = SearchMonth(*m_search, shifts, m_holidays, ui.viewMonth, ui.viewYear);
+            BuildMonthView(layout, ui, shifts, metrics, m_list, &overlay);
+            m_first = MonthStart(ui.viewMonth, ui.viewYear);
+            m_last = m_first + DaysInMonth(ui.viewMonth, ui.viewYear) - 1;
+        } else {
+            OverviewLayout ol = ComputeOverviewLayout(ui.width, ui.height, ui.viewMode, ui.viewYear);
+            BuildOverview(ol, ui, shifts, metrics, m_list);
+            m_first = ol.FirstDay();
+            m_last = ol.LastDay();
+        }
+        m_ui = ui;
+        m_valid = true;
+        m_builds++;
+    }
+    return m_list;
+}
+
+void CalendarView::OnShiftsChanged(int32_t from, int32_t to) {
+    // An edit can move rule marks up to Reach() days later
+    if (m_rules) to += m_rules->Rules().Reach();
+    if (m_valid && ((from <= m_last && to >= m_first) || (m_search && m_ui.viewMode == VIEW_MONTH))) m_valid = false;
+}
@@ -0,0 +1,52 @@
+// ============================================================================
+//  CALENDAR VIEW - the cached display list of the window: the month view or
+//  an overview, depending on UiState::viewMode. Rebuilt only when the UI
+//  state changes or a shift inside the shown days does.
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "display_list.h"
+#include "holidays.h"
+#include "layout.h"
+#include "payroll.h"
+#include "shift_rules.h"
+#include "shift_search.h"
+#include "shift_store.h"
+
+class CalendarView : public ShiftObserver {
+public:
+    // The list for ui (layout must be ComputeLayout() of ui's size and
+    // month; the overviews compute their own from ui)
+    const DisplayList& Get(const CalendarLayout& layout, const UiState& ui, const ShiftStore& shifts,
+                           const TextMetrics& metrics);
+    void   Invalidate() { m_valid = false; }
+    // Month hours in the totals line (nullptr: counts only); the ledger must
+    // watch the same store
+    void   SetPayroll(PayrollLedger* ledger) { m_payroll = ledger; m_valid = false; }
+    // Frames the month's days that break a labour rule (nullptr: none); the
+    // validator must watch the same store
+    void   SetRules(RuleValidator* rules) { m_rules = rules; m_valid = false; }
+    // Colors the day numbers of public holidays (nullptr: weekends only)
+    void   SetHolidays(const HolidayCalendar* holidays) { m_holidays = holidays; m_valid = false; }
+    // Marks the month's days that match the search (nullptr: none); any
+    // edit rebuilds the list while it is set (a match can depend on the
+    // whole month or the next day)
+    void   SetSearch(const ShiftSearch* search) { m_search = search; m_valid = false; }
+    size_t Builds() const { return m_builds; }
+
+    void OnShiftsChanged(int32_t from, int32_t to) override;
+
+private:
+    DisplayList    m_list;
+    PayrollLedger* m_payroll = nullptr;
+    RuleValidator* m_rules = nullptr;
+    const HolidayCalendar* m_holidays = nullptr;
+    const ShiftSearch*     m_search = nullptr;
+    UiState        m_ui;
+    int32_t        m_first = 0, m_last = -1;   // days the list shows
+    bool           m_valid = false;
+    size_t         m_builds = 0;
+};
@@ -0,0 +1,192 @@
+// ============================================================================
+//  COUNT KERNELS
+// ============================================================================
+
+#include "count_kernels.h"
+#include "bits.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define COUNT_X86 1
+#include <immintrin.h>
+#endif
+
+// Wider kernels are compiled for their instruction set only; the dispatch
+// below makes sure they run on CPUs that have it
+#if defined(_MSC_VER) && !defined(__clang__)
+#define COUNT_TARGET(isa)
+#else
+#define COUNT_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+static void CountWord(uint64_t w, ShiftCounts& c) {
+    uint64_t lo = w & SLOT_LOW_BITS, hi = (w >> 1) & SLOT_LOW_BITS;
+    c.day   += PopCount64(lo & ~hi);
+    c.night += PopCount64(hi & ~lo);
+    c.free  += PopCount64(lo & hi);
+}
+
+static ShiftCounts CountScalar(const uint64_t* words, size_t n) {
+    ShiftCounts c;
+    for (size_t i = 0; i < n; i++) CountWord(words[i], c);
+    return c;
+}
+
+#ifdef COUNT_X86
+
+// The masks have only the even bit of every 2-bit slot set, so the per-byte
+// popcount needs two SWAR steps instead of three; a byte then holds at most
+// 4 and byte sums may run for 63 vectors before they are widened with SAD.
+static const int BYTE_SUM_VECTORS = 63;
+
+COUNT_TARGET("sse2")
+static inline __m128i EvenBitsPerByte128(__m128i x) {
+    const __m128i m2 = _mm_set1_epi8(0x33), m4 = _mm_set1_epi8(0x0f);
+    x = _mm_add_epi64(_mm_and_si128(x, m2), _mm_and_si128(_mm_srli_epi64(x, 2), m2));
+    return _mm_and_si128(_mm_add_epi64(x, _mm_srli_epi64(x, 4)), m4);
+}
+
+COUNT_TARGET("sse2")
+static ShiftCounts CountSse2(const uint64_t* words, size_t n) {
+    const __m128i low = _mm_set1_epi8(0x55), zero = _mm_setzero_si128();
+    __m128i sumDay = zero, sumNight = zero, sumFree = zero;
+    size_t i = 0;
+    while (i + 2 <= n) {
+        __m128i bDay = zero, bNight = zero, bFree = zero;
+        for (int k = 0; k < BYTE_SUM_VECTORS && i + 2 <= n; k++, i += 2) {
+            __m128i w = _mm_loadu_si128((const __m128i*)(words + i));
+            __m128i lo = _mm_and_si128(w, low), hi = _mm_and_si128(_mm_srli_epi64(w, 1), low);
+            bDay   = _mm_add_epi8(bDay, EvenBitsPerByte128(_mm_andnot_si128(hi, lo)));
+            bNight = _mm_add_epi8(bNight, EvenBitsPerByte128(_mm_andnot_si128(lo, hi)));
+            bFree  = _mm_add_epi8(bFree, EvenBitsPerByte128(_mm_and_si128(lo, hi)));
+        }
+        sumDay   = _mm_add_epi64(sumDay, _mm_sad_epu8(bDay, zero));
+        sumNight = _mm_add_epi64(sumNight, _mm_sad_epu8(bNight, zero));
+        sumFree  = _mm_add_epi64(sumFree, _mm_sad_epu8(bFree, zero));
+    }
+    alignas(16) uint64_t d[2], nn[2], f[2];
+    _mm_store_si128((__m128i*)d, sumDay);
+    _mm_store_si128((__m128i*)nn, sumNight);
+    _mm_store_si128((__m128i*)f, sumFree);
+    ShiftCounts c;
+    c.day = (int32_t)(d[0] + d[1]);
+    c.night = (int32_t)(nn[0] + nn[1]);
+    c.free = (int32_t)(f[0] + f[1]);
+    for (; i < n; i++) CountWord(words[i], c);
+    return c;
+}
+
+COUNT_TARGET("avx2")
+static inline __m256i EvenBitsPerByte256(__m256i x) {
+    const __m256i m2 = _mm256_set1_epi8(0x33), m4 = _mm256_set1_epi8(0x0f);
+    x = _mm256_add_epi64(_mm256_and_si256(x, m2), _mm256_and_si256(_mm256_srli_epi64(x, 2), m2));
+    return _mm256_and_si256(_mm256_add_epi64(x, _mm256_srli_epi64(x, 4)), m4);
+}
+
+COUNT_TARGET("avx2")
+static ShiftCounts CountAvx2(const uint64_t* words, size_t n) {
+    const __m256i low = _mm256_set1_epi8(0x55), zero = _mm256_setzero_si256();
+    __m256i sumDay = zero, sumNight = zero, sumFree = zero;
+    size_t i = 0;
+    while (i + 4 <= n) {
+        __m256i bDay = zero, bNight = zero, bFree = zero;
+        for (int k = 0; k < BYTE_SUM_VECTORS && i + 4 <= n; k++, i += 4) {
+            __m256i w = _mm256_loadu_si256((const __m256i*)(words + i));
+            __m256i lo = _mm256_and_si256(w, low), hi = _mm256_and_si256(_mm256_srli_epi64(w, 1), low);
+            bDay   = _mm256_add_epi8(bDay, EvenBitsPerByte256(_mm256_andnot_si256(hi, lo)));
+            bNight = _mm256_add_epi8(bNight, EvenBitsPerByte256(_mm256_andnot_si256(lo, hi)));
+            bFree  = _mm256_add_epi8(bFree, EvenBitsPerByte256(_mm256_and_si256(lo, hi)));
+        }
+        sumDay   = _mm256_add_epi64(sumDay, _mm256_sad_epu8(bDay, zero));
+        sumNight = _mm256_add_epi64(sumNight, _mm256_sad_epu8(bNight, zero));
+        sumFree  = _mm256_add_epi64(sumFree, _mm256_sad_epu8(bFree, zero));
+    }
+    alignas(32) uint64_t d[4], nn[4], f[4];
+    _mm256_store_si256((__m256i*)d, sumDay);
+    _mm256_store_si256((__m256i*)nn, sumNight);
+    _mm256_store_si256((__m256i*)f, sumFree);
+    ShiftCounts c;
+    c.day = (int32_t)(d[0] + d[1] + d[2] + d[3]);
+    c.night = (int32_t)(nn[0] + nn[1] + nn[2] + nn[3]);
+    c.free = (int32_t)(f[0] + f[1] + f[2] + f[3]);
+    for (; i < n; i++) CountWord(words[i], c);
+    return c;
+}
+
+static bool CpuHasSse2() {
+#if defined(_M_X64) || defined(__x86_64__)
+    return true;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+static bool CpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;   // OSXSAVE + XMM/YMM state
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // COUNT_X86
+
+typedef ShiftCounts (*CountFn)(const uint64_t* words, size_t n);
+
+#ifdef COUNT_X86
+static const CountFn KERNELS[COUNT_KERNELS] = { CountScalar, CountSse2, CountAvx2 };
+#else
+static const CountFn KERNELS[COUNT_KERNELS] = { CountScalar, nullptr, nullptr };
+#endif
+
+bool CountKernelSupported(CountKernel k) {
+#ifdef COUNT_X86
+    static const bool sse2 = CpuHasSse2(), avx2 = sse2 && CpuHasAvx2();
+    return k == COUNT_SCALAR || (k == COUNT_SSE2 && sse2) || (k == COUNT_AVX2 && avx2);
+#else
+    return k == COUNT_SCALAR;
+#endif
+}
+
+const char* CountKernelName(CountKernel k) {
+    static const char* const NAMES[COUNT_KERNELS] = { "scalar", "sse2", "avx2" };
+    return (k >= 0 && k < COUNT_KERNELS) ? NAMES[k] : "?";
+}
+
+static CountKernel BestKernel() {
+    for (int k = COUNT_KERNELS - 1; k > COUNT_SCALAR; k--)
+        if (CountKernelSupported((CountKernel)k)) return (CountKernel)k;
+    return COUNT_SCALAR;
+}
+
+static CountKernel& Active() {
+    static CountKernel active = BestKernel();
+    return active;
+}
+
+CountKernel ActiveCountKernel() { return Active(); }
+
+bool SelectCountKernel(CountKernel k) {
+    if (k < 0 || k >= COUNT_KERNELS || !CountKernelSupported(k)) return false;
+    Active() = k;
+    return true;
+}
+
+ShiftCounts CountPackedWords(const uint64_t* words, size_t n) {
+    return KERNELS[Active()](words, n);
+}
+
+ShiftCounts CountPackedWordsWith(CountKernel k, const uint64_t* words, size_t n) {
+    return KERNELS[k](words, n);
+}
@@ -0,0 +1,26 @@
+// ============================================================================
+//  COUNT KERNELS - day/night/free counts over packed shift words
+//  A popcount reduction over 2-bit codes; SSE2 and AVX2 versions run next
+//  to the scalar one and the best one supported by the CPU is picked at
+//  runtime. All kernels give exactly the same counts.
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "shift_store.h"
+
+enum CountKernel { COUNT_SCALAR, COUNT_SSE2, COUNT_AVX2, COUNT_KERNELS };
+
+// Counts of every slot of n packed words (ShiftStore word layout)
+ShiftCounts CountPackedWords(const uint64_t* words, size_t n);
+
+// A given kernel, for checks and benchmarks; it must be supported
+ShiftCounts CountPackedWordsWith(CountKernel k, const uint64_t* words, size_t n);
+
+bool        CountKernelSupported(CountKernel k);
+const char* CountKernelName(CountKernel k);
+// The kernel CountPackedWords() uses; Select returns false for an unsupported one
+CountKernel ActiveCountKernel();
+bool        SelectCountKernel(CountKernel k);
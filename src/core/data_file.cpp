@@ -0,0 +1,285 @@
+// ============================================================================
+//  DATA FILE
+// ============================================================================
+
+#include "data_file.h"
+#include "binary_format.h"
+#include "text_format.h"
+#include "trace.h"
+
+void ShiftDataFile::Open(const PathString& basePath, Roster& roster, bool readOnly) {
+    TRACE_SCOPE("data", "open");
+    Close();
+    m_roster = &roster;
+    m_readOnly = readOnly;
+    m_snapshotPath = basePath + PATH_TEXT(".bin");
+    m_journalPath = basePath + PATH_TEXT(".journal");
+    PathString legacyPath = basePath + PATH_TEXT(".txt");
+    m_generation = 0;
+    m_journalRecords = 0;
+    m_journalValid = false;
+    m_snapshotStale = false;
+    m_writeFailed = false;
+    m_writes = 0;
+    m_legacyReport = TextParseReport();
+    m_journalReport = TextParseReport();
+
+    roster.Clear();
+    bool loaded = false;
+    if (m_map.Open(m_snapshotPath)) {
+        loaded = ReadBinarySnapshot(m_map.Data(), m_map.Size(), roster, &m_generation);
+        if (!loaded) {
+            // Keep the unreadable file aside instead of compacting over it
+            m_map.Close();
+            if (!readOnly) ReplacePath(m_snapshotPath, m_snapshotPath + PATH_TEXT(".bad"));
+        }
+    }
+    if (!loaded) {
+        if (FILE* f = OpenPath(legacyPath, "r")) {
+            // First start after the switch to smjene_data.bin
+            m_generation = ReadTextGeneration(f);
+            ReadShiftText(f, roster, false, &m_legacyReport);
+            fclose(f);
+            m_snapshotStale = true;
+        }
+    }
+    if (FILE* f = OpenPath(m_journalPath, "rb")) {
+        // A stale journal is already part of the snapshot; OpenJournal() truncates it
+        m_journalValid = (ReadTextGeneration(f) == m_generation);
+        if (m_journalValid) m_journalRecords = ReadShiftText(f, roster, true, &m_journalReport);
+        fclose(f);
+    }
+    if (readOnly) return;
+    roster.AddObserver(this);
+    for (size_t i = 0; i < roster.Size(); i++) OnEmployeeChanged(i);
+    m_pendingEmployees.clear();
+}
+
+bool ShiftDataFile::Close() {
+    if (!m_roster) return true;
+    bool ok = true;
+    if (!m_readOnly) {
+        ok = Commit() && Flush();
+        StopWriter();
+        if (!ok) ok = Compact();   // synchronous now
+    }
+    if (m_journal) { fclose(m_journal); m_journal = nullptr; }
+    m_roster->RemoveObserver(this);
+    for (ColumnObserver& c : m_columns) m_roster->Shifts(c.index).RemoveObserver(&c);
+    m_columns.clear();
+    for (size_t i = 0; i < m_roster->Size(); i++) m_roster->Shifts(i).Materialize();
+    m_map.Close();
+    m_roster = nullptr;
+    return ok;
+}
+
+void ShiftDataFile::OnEmployeeChanged(size_t index) {
+    while (m_columns.size() <= index) {
+        m_columns.emplace_back(this, m_columns.size());
+        m_roster->Shifts(m_columns.back().index).AddObserver(&m_columns.back());
+    }
+    for (size_t i : m_pendingEmployees)
+        if (i == index) return;
+    m_pendingEmployees.push_back(index);
+}
+
+void ShiftDataFile::OnColumnChanged(size_t index, int32_t from, int32_t to) {
+    if (!m_pending.empty()) {
+        PendingRange& last = m_pending.back();
+        if (last.index == index && from <= last.to + 1 && to >= last.from - 1) {
+            int32_t lo = from < last.from ? from : last.from;
+            int32_t hi = to > last.to ? to : last.to;
+            m_pendingDays += (size_t)((hi - lo) - (last.to - last.from));
+            last.from = lo; last.to = hi;
+            return;
+        }
+    }
+    m_pending.push_back(PendingRange{ index, from, to });
+    m_pendingDays += (size_t)(to - from + 1);
+}
+
+// "#employee <id> <name>\n", as WriteEmployeeLine()
+static void AppendEmployeeLine(std::string& out, const Employee& e) {
+    char id[16];
+    snprintf(id, sizeof(id), " %u ", e.id);
+    out += EMPLOYEE_TAG;
+    out += id;
+    out += e.name;
+    out += '\n';
+}
+
+bool ShiftDataFile::Commit() {
+    if (m_readOnly) return false;
+    // A write lost on the writer thread is recovered by a full snapshot
+    if (m_writeFailed.exchange(false)) m_snapshotStale = true;
+    if (!m_roster || (m_pending.empty() && m_pendingEmployees.empty() && !m_snapshotStale)) return true;
+    if (m_snapshotStale || m_journalRecords + m_pendingDays > COMPACT_RECORDS)
+        return Compact();
+
+    WriteJob job;
+    if (!m_journalValid) {
+        // A stale journal is started over
+        job.newJournal = true;
+        job.generation = m_generation;
+        m_journalValid = true;
+        m_journalRecords = 0;
+    }
+    for (size_t i : m_pendingEmployees) AppendEmployeeLine(job.records, m_roster->At(i));
+
+    // A multi-day edit replays all or nothing
+    bool batch = m_pendingDays > 1;
+    job.records.reserve(job.records.size() + m_pendingDays * 16 + 16);
+    if (batch) { job.records += BATCH_BEGIN; job.records += '\n'; }
+    char line[32];
+    for (const PendingRange& r : m_pending) {
+        const ShiftStore& store = m_roster->Shifts(r.index);
+        uint32_t id = m_roster->At(r.index).id;
+        for (int32_t day = r.from; day <= r.to; day++)
+            job.records.append(line, (size_t)FormatShiftLine(line, day, store.Get(day), id));
+    }
+    if (batch) { job.records += BATCH_END; job.records += '\n'; }
+    m_journalRecords += m_pendingDays + m_pendingEmployees.size();
+    m_pending.clear();
+    m_pendingDays = 0;
+    m_pendingEmployees.clear();
+    return Submit(std::move(job));
+}
+
+bool ShiftDataFile::Compact() {
+    TRACE_SCOPE("data", "compact");
+    if (!m_roster || m_readOnly) return false;
+    // The old snapshot cannot be replaced while it is mapped
+    for (size_t i = 0; i < m_roster->Size(); i++) m_roster->Shifts(i).Materialize();
+    m_map.Close();
+
+    WriteJob job;
+    if (m_writer.joinable()) {
+        // The writer thread gets a copy, the roster goes on changing
+        job.owned.reset(new Roster);
+        for (size_t i = 0; i < m_roster->Size(); i++) {
+            job.owned->Add(m_roster->At(i).id, m_roster->At(i).name.c_str());
+            job.owned->Shifts(i) = m_roster->Shifts(i);
+        }
+        job.snapshot = job.owned.get();
+    } else {
+        job.snapshot = m_roster;
+    }
+    // From here on the old journal no longer matches the snapshot generation
+    job.newJournal = true;
+    job.generation = ++m_generation;
+    m_snapshotStale = false;
+    m_journalValid = true;
+    m_journalRecords = 0;
+    m_pending.clear();
+    m_pendingDays = 0;
+    m_pendingEmployees.clear();
+    return Submit(std::move(job));
+}
+
+// ============================================================================
+//  WRITER
+// ============================================================================
+
+bool ShiftDataFile::Write(const WriteJob& job) {
+    TRACE_SCOPE("data", "write");
+    m_writes++;
+    if (job.snapshot) {
+        PathString tmp = m_snapshotPath + PATH_TEXT(".tmp");
+        FILE* f = OpenPath(tmp, "wb");
+        if (!f) return false;
+        bool ok = WriteBinarySnapshot(f, *job.snapshot, job.generation) && SyncFile(f);
+        ok = (fclose(f) == 0) && ok;
+        if (!ok || !ReplacePath(tmp, m_snapshotPath)) { RemovePath(tmp); return false; }
+    }
+    if (job.newJournal && m_journal) { fclose(m_journal); m_journal = nullptr; }
+    if (!m_journal) {
+        m_journal = OpenPath(m_journalPath, job.newJournal ? "wb" : "a+b");
+        if (!m_journal) return false;
+        if (job.newJournal) {
+            fprintf(m_journal, "#gen %u\n", job.generation);
+        } else if (fseek(m_journal, -1, SEEK_END) == 0 && fgetc(m_journal) != '\n') {
+            // A record torn by a crash must not swallow the next one
+            fseek(m_journal, 0, SEEK_END);
+            fputc('\n', m_journal);
+        }
+        fseek(m_journal, 0, SEEK_END);
+    }
+    bool ok = fwrite(job.records.data(), 1, job.records.size(), m_journal) == job.records.size();
+    return SyncFile(m_journal) && ok;
+}
+
+bool ShiftDataFile::Submit(WriteJob job) {
+    if (!m_writer.joinable()) {
+        bool ok = Write(job);
+        if (!ok) m_writeFailed = true;
+        return ok;
+    }
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_lastQueued = std::chrono::steady_clock::now();
+    if (m_queue.empty()) m_firstQueued = m_lastQueued;
+    m_queue.push_back(std::move(job));
+    m_wake.notify_one();
+    return true;
+}
+
+void ShiftDataFile::StartWriter(int delayMs) {
+    if (m_writer.joinable() || m_readOnly || !m_roster) return;
+    m_delay = std::chrono::milliseconds(delayMs);
+    m_stop = false;
+    m_writer = std::thread(&ShiftDataFile::WriterLoop, this);
+}
+
+void ShiftDataFile::WriterLoop() {
+    std::unique_lock<std::mutex> lock(m_lock);
+    for (;;) {
+        m_wake.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+        if (m_queue.empty()) return;
+        // Debounced: a burst of edits is written once it pauses
+        for (;;) {
+            auto due = m_lastQueued + m_delay;
+            auto latest = m_firstQueued + std::chrono::milliseconds(MAX_WRITE_DELAY_MS);
+            if (latest < due) due = latest;
+            if (m_stop || m_flush || std::chrono::steady_clock::now() >= due) break;
+            m_wake.wait_until(lock, due);
+        }
+        std::vector<WriteJob> jobs;
+        jobs.swap(m_queue);
+        m_busy = true;
+        lock.unlock();
+
+        // Records of consecutive commits go out in one append
+        bool ok = true;
+        for (size_t i = 0; i < jobs.size(); i++) {
+            WriteJob& job = jobs[i];
+            while (i + 1 < jobs.size() && !jobs[i + 1].snapshot && !jobs[i + 1].newJournal)
+                job.records += jobs[++i].records;
+            ok = ok && Write(job);   // after a failure the next Commit() compacts
+        }
+        if (!ok) m_writeFailed = true;
+
+        lock.lock();
+        m_busy = false;
+        if (m_queue.empty()) m_idle.notify_all();
+    }
+}
+
+bool ShiftDataFile::Flush() {
+    if (m_writer.joinable()) {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_flush = true;
+        m_wake.notify_one();
+        m_idle.wait(lock, [this] { return m_queue.empty() && !m_busy; });
+        m_flush = false;
+    }
+    return !m_writeFailed;
+}
+
+void ShiftDataFile::StopWriter() {
+    if (!m_writer.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_stop = true;
+        m_wake.notify_one();
+    }
+    m_writer.join();
+}
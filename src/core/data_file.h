@@ -0,0 +1,127 @@
+// ============================================================================
+//  DATA FILE - snapshot + append-only change journal
+//  <base>.bin      binary snapshot (binary_format.h), mapped at startup
+//  <base>.journal  one "YYYY-MM-DD V [@employee]" record per edit since the
+//                  snapshot, V = 0 clears the day; new or renamed employees
+//                  are declared by "#employee" lines. Replayed on top of the
+//                  snapshot; a multi-day commit is framed by #begin/#end lines.
+//  <base>.txt      legacy text snapshot, imported when there is no .bin yet
+//  Both carry a generation; a journal whose generation differs from the
+//  snapshot's is left over from an interrupted compaction and is ignored.
+//  Snapshots go through <base>.bin.tmp, fsync and a rename; journal appends
+//  are fsynced. With StartWriter() the disk work runs on a writer thread.
+// ============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "file_util.h"
+#include "mapped_file.h"
+#include "roster.h"
+#include "text_format.h"
+
+class ShiftDataFile : public RosterObserver {
+public:
+    // Journal records before Commit() folds them into a new snapshot.
+    static const size_t COMPACT_RECORDS = 4096;
+    // Write-behind: longest a commit waits for the writer thread
+    static const int MAX_WRITE_DELAY_MS = 2000;
+
+    ShiftDataFile() {}
+    ~ShiftDataFile() { Close(); }
+
+    // Loads snapshot + journal into roster and starts recording the changes
+    // of every column, employees added later included. The columns may keep
+    // viewing the mapped snapshot until Close().
+    // readOnly: nothing is ever written or renamed (queries, exports).
+    void Open(const PathString& basePath, Roster& roster, bool readOnly = false);
+    // Commits and waits for the writer thread; a write that failed there is
+    // retried once as a snapshot on this thread. False when the last changes
+    // are still not on the disk.
+    bool Close();
+
+    // Write-behind until Close(): Commit() only formats the changes (and
+    // copies the roster for a compaction) and queues them; a writer thread
+    // writes a burst of commits at once when none came for delayMs.
+    void StartWriter(int delayMs = 250);
+    // Blocks until every commit so far is on the disk; false when a write
+    // failed (the next Commit() then writes a whole new snapshot).
+    bool Flush();
+    // Disk writes since Open(): a snapshot or a journal append, however many commits
+    size_t Writes() const { return m_writes; }
+
+    // Appends the records changed since the last commit (constant per edit);
+    // compacts once the journal grows past COMPACT_RECORDS.
+    // With a writer thread, true once queued.
+    bool Commit();
+    bool Compact();
+
+    size_t JournalRecords() const { return m_journalRecords; }
+    // Malformed lines found by the last Open()
+    const TextParseReport& LegacyReport() const { return m_legacyReport; }
+    const TextParseReport& JournalReport() const { return m_journalReport; }
+
+    void OnEmployeeChanged(size_t index) override;
+
+private:
+    // Forwards the changes of one column along with its roster index
+    struct ColumnObserver : ShiftObserver {
+        ShiftDataFile* file;
+        size_t         index;
+        ColumnObserver(ShiftDataFile* f, size_t i) : file(f), index(i) {}
+        void OnShiftsChanged(int32_t from, int32_t to) override { file->OnColumnChanged(index, from, to); }
+    };
+    struct PendingRange { size_t index; int32_t from, to; };
+    // The disk work of a commit: a snapshot, then a new journal, then records
+    struct WriteJob {
+        const Roster*           snapshot = nullptr;   // m_roster, or owned
+        std::unique_ptr<Roster> owned;                // copy for the writer thread
+        bool                    newJournal = false;   // truncated to "#gen generation"
+        uint32_t                generation = 0;
+        std::string             records;
+    };
+
+    void OnColumnChanged(size_t index, int32_t from, int32_t to);
+    bool Submit(WriteJob job);
+    // Writer side: only the writer thread touches m_journal while one runs
+    bool Write(const WriteJob& job);
+    void WriterLoop();
+    void StopWriter();
+
+    Roster*     m_roster = nullptr;
+    std::deque<ColumnObserver> m_columns;
+    bool        m_readOnly = false;
+    PathString  m_snapshotPath, m_journalPath;
+    MappedFile  m_map;
+    bool        m_snapshotStale = false;
+    FILE*       m_journal = nullptr;
+    bool        m_journalValid = false;
+    uint32_t    m_generation = 0;
+    size_t      m_journalRecords = 0;
+    TextParseReport m_legacyReport, m_journalReport;
+    std::vector<PendingRange> m_pending;
+    size_t      m_pendingDays = 0;
+    std::vector<size_t> m_pendingEmployees;   // to declare in the journal
+
+    std::thread             m_writer;
+    std::mutex              m_lock;               // guards the fields below
+    std::condition_variable m_wake, m_idle;
+    std::vector<WriteJob>   m_queue;
+    bool                    m_stop = false, m_flush = false, m_busy = false;
+    std::chrono::milliseconds m_delay{ 0 };
+    std::chrono::steady_clock::time_point m_firstQueued, m_lastQueued;
+    std::atomic<bool>       m_writeFailed{ false };
+    std::atomic<size_t>     m_writes{ 0 };
+
+    ShiftDataFile(const ShiftDataFile&);
+    ShiftDataFile& operator=(const ShiftDataFile&);
+};
@@ -0,0 +1,77 @@
+// ============================================================================
+//  DISPLAY LIST
+// ============================================================================
+
+#include "display_list.h"
+#include <cmath>
+
+const DlFontSpec DL_FONTS[FONT_COUNT] = {
+    { 22, true,  false },   // FONT_TITLE
+    { 18, true,  false },   // FONT_BUTTON
+    { 11, true,  false },   // FONT_BUTTON_SMALL
+    { 12, true,  false },   // FONT_DAY_NAME
+    { 14, true,  false },   // FONT_CELL_DAY
+    { 11, false, false },   // FONT_CELL_SHIFT
+    {  9, true,  false },   // FONT_TODAY_TAG
+    { 12, false, false },   // FONT_LEGEND
+    { 13, false, false },   // FONT_STATS
+    { 10, false, true  },   // FONT_HINT
+};
+
+DlCmd& DisplayList::Push(DlOp op, float x, float y, float w, float h, DlColor c) {
+    m_cmds.emplace_back();
+    DlCmd& d = m_cmds.back();
+    d.op = (uint8_t)op; d.font = 0; d.hAlign = d.vAlign = DL_NEAR;
+    d.color = d.color2 = c;
+    d.x = x; d.y = y; d.w = w; d.h = h;
+    d.r = d.pen = 0;
+    d.text = d.textLen = 0;
+    return d;
+}
+
+void DisplayList::FillRect(float x, float y, float w, float h, DlColor c) {
+    Push(DL_FILL_RECT, x, y, w, h, c);
+}
+
+void DisplayList::GradientV(float x, float y, float w, float h, DlColor top, DlColor bottom) {
+    Push(DL_GRADIENT_V, x, y, w, h, top).color2 = bottom;
+}
+
+void DisplayList::FillRound(float x, float y, float w, float h, float r, DlColor c) {
+    Push(DL_FILL_ROUND, x, y, w, h, c).r = r;
+}
+
+void DisplayList::StrokeRound(float x, float y, float w, float h, float r, float pen, DlColor c) {
+    DlCmd& d = Push(DL_STROKE_ROUND, x, y, w, h, c);
+    d.r = r; d.pen = pen;
+}
+
+void DisplayList::FillRoundTop(float x, float y, float w, float h, float r, DlColor c) {
+    Push(DL_FILL_ROUND_TOP, x, y, w, h, c).r = r;
+}
+
+void DisplayList::Line(float x0, float y0, float x1, float y1, float pen, DlColor c) {
+    Push(DL_LINE, x0, y0, x1 - x0, y1 - y0, c).pen = pen;
+}
+
+void DisplayList::Text(DlFont font, const char16_t* text, float x, float y, float w, float h,
+                       DlAlign hAlign, DlAlign vAlign, DlColor c) {
+    DlCmd& d = Push(DL_TEXT, x, y, w, h, c);
+    d.font = (uint8_t)font; d.hAlign = (uint8_t)hAlign; d.vAlign = (uint8_t)vAlign;
+    d.text = (uint32_t)m_text.size();
+    while (*text) m_text.push_back(*text++);
+    d.textLen = (uint32_t)m_text.size() - d.text;
+    m_text.push_back(0);
+}
+
+LayoutRect DisplayList::Bounds(const DlCmd& c) const {
+    float x0 = c.w < 0 ? c.x + c.w : c.x, x1 = c.w < 0 ? c.x : c.x + c.w;
+    float y0 = c.h < 0 ? c.y + c.h : c.y, y1 = c.h < 0 ? c.y : c.y + c.h;
+    float grow = c.pen / 2 + 1;   // half the pen plus the anti-aliased edge
+    LayoutRect r;
+    r.left = (int)std::floor(x0 - grow);
+    r.top = (int)std::floor(y0 - grow);
+    r.right = (int)std::ceil(x1 + grow);
+    r.bottom = (int)std::ceil(y1 + grow);
+    return r;
+}
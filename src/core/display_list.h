@@ -0,0 +1,125 @@
+// ============================================================================
+//  DISPLAY LIST - retained drawing commands (rects, rounded rects, lines,
+//  gradients, text runs) built once per model change and replayed by a
+//  backend: GDI+ in the Windows GUI, raster.h on any platform
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "layout.h"
+#include "trace.h"
+
+// 0xAARRGGBB, the layout of a GDI+ ARGB value
+typedef uint32_t DlColor;
+
+inline DlColor MakeColor(int a, int r, int g, int b) {
+    return ((DlColor)a << 24) | ((DlColor)r << 16) | ((DlColor)g << 8) | (DlColor)b;
+}
+
+// Every font of the month view is Segoe UI at a pixel size
+enum DlFont {
+    FONT_TITLE, FONT_BUTTON, FONT_BUTTON_SMALL, FONT_DAY_NAME, FONT_CELL_DAY, FONT_CELL_SHIFT,
+    FONT_TODAY_TAG, FONT_LEGEND, FONT_STATS, FONT_HINT,
+    FONT_COUNT
+};
+
+struct DlFontSpec {
+    float size;
+    bool  bold, italic;
+};
+extern const DlFontSpec DL_FONTS[FONT_COUNT];
+
+enum DlAlign { DL_NEAR, DL_CENTER, DL_FAR };
+
+enum DlOp {
+    DL_FILL_RECT,       // x y w h, color
+    DL_GRADIENT_V,      // x y w h, color at the top to color2 at the bottom
+    DL_FILL_ROUND,      // x y w h, radius r
+    DL_STROKE_ROUND,    // x y w h, radius r, pen width pen
+    DL_FILL_ROUND_TOP,  // the top h pixels of a w x (2r) rounded rect (shift accent bar)
+    DL_LINE,            // (x, y) to (x + w, y + h), pen width pen
+    DL_TEXT             // text run clipped to x y w h, aligned in it
+};
+
+struct DlCmd {
+    uint8_t  op, font, hAlign, vAlign;
+    DlColor  color, color2;
+    float    x, y, w, h;
+    float    r, pen;
+    uint32_t text, textLen;    // UTF-16 code units in DisplayList::Text()
+};
+
+// Text widths come from the backend that will draw the list
+class TextMetrics {
+public:
+    virtual ~TextMetrics() {}
+    virtual float Width(DlFont font, const char16_t* text, int len) const = 0;
+};
+
+// A named run of commands (background, header, grid, ...) so a backend can
+// time the parts of a frame; name is a string literal
+struct DlSection {
+    const char* name;
+    uint32_t    first;
+};
+
+class DisplayList {
+public:
+    // Keeps the capacity, so rebuilding a list of the same size allocates nothing
+    void Clear() { m_cmds.clear(); m_text.clear(); m_sections.clear(); }
+
+    // The commands pushed from here on, up to the next Section(), belong to name
+    void Section(const char* name) { m_sections.push_back(DlSection{ name, (uint32_t)m_cmds.size() }); }
+
+    void FillRect(float x, float y, float w, float h, DlColor c);
+    void GradientV(float x, float y, float w, float h, DlColor top, DlColor bottom);
+    void FillRound(float x, float y, float w, float h, float r, DlColor c);
+    void StrokeRound(float x, float y, float w, float h, float r, float pen, DlColor c);
+    void FillRoundTop(float x, float y, float w, float h, float r, DlColor c);
+    void Line(float x0, float y0, float x1, float y1, float pen, DlColor c);
+    void Text(DlFont font, const char16_t* text, float x, float y, float w, float h,
+              DlAlign hAlign, DlAlign vAlign, DlColor c);
+
+    size_t         Size() const { return m_cmds.size(); }
+    const DlCmd&   operator[](size_t i) const { return m_cmds[i]; }
+    const char16_t* Text(const DlCmd& c) const { return m_text.data() + c.text; }
+
+    size_t           SectionCount() const { return m_sections.size(); }
+    const DlSection& SectionAt(size_t i) const { return m_sections[i]; }
+    // One past the last command of section i
+    size_t SectionEnd(size_t i) const { return i + 1 < m_sections.size() ? m_sections[i + 1].first : m_cmds.size(); }
+
+    // Pixels a command may touch (anti-aliasing and pen included); a backend
+    // skips the commands that miss its clip rect
+    LayoutRect Bounds(const DlCmd& c) const;
+
+    size_t MemoryUsage() const {
+        return sizeof(*this) + m_cmds.capacity() * sizeof(DlCmd) + m_text.capacity() * sizeof(char16_t) +
+               m_sections.capacity() * sizeof(DlSection);
+    }
+
+private:
+    DlCmd& Push(DlOp op, float x, float y, float w, float h, DlColor c);
+
+    std::vector<DlCmd>    m_cmds;
+    std::vector<char16_t> m_text;
+    std::vector<DlSection> m_sections;
+};
+
+// Calls replay(first, end) over every command: once when tracing is off, per
+// section with a cat/section trace point when it is on
+template <class Replay>
+void ReplaySections(const DisplayList& dl, const char* cat, Replay replay) {
+    if (!TraceEnabled() || dl.SectionCount() == 0) {
+        replay((size_t)0, dl.Size());
+        return;
+    }
+    replay((size_t)0, (size_t)dl.SectionAt(0).first);
+    for (size_t s = 0; s < dl.SectionCount(); s++) {
+        TraceScope scope(cat, dl.SectionAt(s).name);
+        replay((size_t)dl.SectionAt(s).first, dl.SectionEnd(s));
+    }
+}
@@ -0,0 +1,305 @@
+// ============================================================================
+//  EXPORT FORMAT
+// ============================================================================
+
+#include "export_format.h"
+#include <cstring>
+#include <string>
+
+static const char* const SHIFT_TITLES[4] = { "", "Dnevna smjena", "Nocna smjena", "Slobodan dan" };
+static const char SHIFT_LETTERS[4] = { '-', 'D', 'N', 'S' };
+
+// Buffered writes to f: records are formatted in place into the buffer,
+// which goes out in 64 KB blocks
+class ExportBuffer {
+public:
+    explicit ExportBuffer(FILE* f) : m_f(f) {}
+
+    char* Reserve(size_t n) {
+        if (m_used + n > sizeof(m_buf)) Flush();
+        return m_buf + m_used;
+    }
+    void Commit(size_t n) { m_used += n; }
+    void Put(const char* s, size_t n) {
+        if (n > sizeof(m_buf)) {
+            Flush();
+            m_ok = fwrite(s, 1, n, m_f) == n && m_ok;
+            m_bytes += n;
+            return;
+        }
+        memcpy(Reserve(n), s, n);
+        Commit(n);
+    }
+    void Put(const char* s) { Put(s, strlen(s)); }
+    void Put(const std::string& s) { Put(s.data(), s.size()); }
+
+    bool Finish(size_t events, ExportStats* stats) {
+        Flush();
+        if (stats) { stats->events = events; stats->bytes = m_bytes; }
+        return m_ok && ferror(m_f) == 0;
+    }
+
+private:
+    void Flush() {
+        if (m_used) m_ok = fwrite(m_buf, 1, m_used, m_f) == m_used && m_ok;
+        m_bytes += m_used;
+        m_used = 0;
+    }
+
+    FILE*    m_f;
+    char     m_buf[1 << 16];
+    size_t   m_used = 0;
+    uint64_t m_bytes = 0;
+    bool     m_ok = true;
+};
+
+// Fixed-width decimal, as in text_format.cpp
+static void PutDigits(char* p, int v, int width) {
+    for (int i = width - 1; i >= 0; i--) { p[i] = (char)('0' + v % 10); v /= 10; }
+}
+
+// ============================================================================
+//  SHIFT TIMES
+// ============================================================================
+
+// "HH:MM" at p, advances p
+static bool ParseClock(const char*& p, int16_t& minutes) {
+    if (!(p[0] >= '0' && p[0] <= '2' && p[1] >= '0' && p[1] <= '9' && p[2] == ':' &&
+          p[3] >= '0' && p[3] <= '5' && p[4] >= '0' && p[4] <= '9'))
+        return false;
+    int h = (p[0] - '0') * 10 + p[1] - '0';
+    if (h > 23) return false;
+    minutes = (int16_t)(h * 60 + (p[3] - '0') * 10 + p[4] - '0');
+    p += 5;
+    return true;
+}
+
+const char* ParseShiftTimes(const char* spec, ShiftTimes times[4]) {
+    ShiftTimes parsed[4];
+    memcpy(parsed, times, sizeof(parsed));
+    const char* p = spec;
+    for (;;) {
+        const char* letter = strchr("DNS", *p);
+        if (!*p || !letter || p[1] != '=') return "neispravno vrijeme smjene (ocekivano D=HH:MM-HH:MM ili S=dan)";
+        ShiftTimes& t = parsed[letter - "DNS" + 1];
+        p += 2;
+        if (strncmp(p, "dan", 3) == 0) {
+            t.start = t.end = ALL_DAY;
+            p += 3;
+        } else if (!ParseClock(p, t.start) || *p++ != '-' || !ParseClock(p, t.end)) {
+            return "neispravno vrijeme (ocekivano HH:MM-HH:MM, 00:00 do 23:59)";
+        }
+        if (*p == 0) break;
+        if (*p++ != ',') return "vremena smjena se odvajaju zarezom";
+    }
+    memcpy(times, parsed, sizeof(parsed));
+    return nullptr;
+}
+
+// ============================================================================
+//  ICALENDAR
+// ============================================================================
+
+// Appends a content line, folded to 75 octets (RFC 5545 3.1) without
+// splitting a UTF-8 sequence
+static void AppendFolded(std::string& out, const std::string& line) {
+    size_t width = 0;
+    for (size_t i = 0; i < line.size(); i++) {
+        bool continuation = ((unsigned char)line[i] & 0xc0) == 0x80;
+        if (width >= 74 && !continuation) { out += "\r\n "; width = 1; }
+        out += line[i];
+        width++;
+    }
+    out += "\r\n";
+}
+
+// TEXT value escaping (RFC 5545 3.3.11)
+static void AppendIcsText(std::string& out, const std::string& s) {
+    for (char c : s) {
+        if (c == '\\' || c == ';' || c == ',') { out += '\\'; out += c; }
+        else if (c == '\n') out += "\\n";
+        else if (c != '\r') out += c;
+    }
+}
+
+// "YYYYMMDD", 8 chars
+static char* PutCompactDate(char* p, int32_t day) {
+    CivilDate c = CivilFromDays(day);
+    PutDigits(p, c.y, 4);
+    PutDigits(p + 4, c.m, 2);
+    PutDigits(p + 6, c.d, 2);
+    return p + 8;
+}
+
+// "DTSTART:..." / "DTEND:..." line of a shift on day
+static char* PutEventTime(char* p, const char* name, int32_t day, int16_t minutes, bool allDay) {
+    size_t n = strlen(name);
+    memcpy(p, name, n);
+    p += n;
+    if (allDay) {
+        memcpy(p, ";VALUE=DATE:", 12);
+        p = PutCompactDate(p + 12, day);
+    } else {
+        *p++ = ':';
+        p = PutCompactDate(p, day);
+        *p++ = 'T';
+        PutDigits(p, minutes / 60, 2);
+        PutDigits(p + 2, minutes % 60, 2);
+        PutDigits(p + 4, 0, 2);
+        p += 6;
+    }
+    *p++ = '\r';
+    *p++ = '\n';
+    return p;
+}
+
+// " - <name>" added to the titles, "radnik <id>" when unnamed and the export mixes employees
+static void AppendEmployeeLabel(std::string& out, const Roster& roster, size_t i, const ExportOptions& opt) {
+    const Employee& e = roster.At(i);
+    if (!e.name.empty()) {
+        out += " - ";
+        AppendIcsText(out, e.name);
+    } else if (opt.employee < 0 && roster.Size() > 1) {
+        char buf[24];
+        snprintf(buf, sizeof(buf), " - radnik %u", e.id);
+        out += buf;
+    }
+}
+
+// Index range of the exported employees
+static void EmployeeRange(const Roster& roster, const ExportOptions& opt, size_t& first, size_t& last) {
+    first = opt.employee < 0 ? 0 : (size_t)opt.employee;
+    last = opt.employee < 0 ? roster.Size() : (size_t)opt.employee + 1;
+    if (last > roster.Size()) last = roster.Size();
+}
+
+bool ExportIcs(FILE* f, const Roster& roster, const ExportOptions& opt, ExportStats* stats) {
+    ExportBuffer out(f);
+    out.Put("BEGIN:VCALENDAR\r\nVERSION:2.0\r\nPRODID:-//kalendarnovo//Raspored smjena//BS\r\n"
+            "CALSCALE:GREGORIAN\r\nMETHOD:PUBLISH\r\nX-WR-CALNAME:Smjene\r\n");
+
+    char stamp[32];
+    int64_t secs = opt.stamp >= 0 ? opt.stamp : 0;
+    char* p = PutCompactDate(stamp, (int32_t)(secs / 86400));
+    int32_t t = (int32_t)(secs % 86400);
+    *p++ = 'T';
+    PutDigits(p, t / 3600, 2);
+    PutDigits(p + 2, t / 60 % 60, 2);
+    PutDigits(p + 4, t % 60, 2);
+    memcpy(p + 6, "Z\r\n", 3);
+    const size_t stampLen = (size_t)(p + 9 - stamp);
+
+    size_t first, last, events = 0;
+    EmployeeRange(roster, opt, first, last);
+    std::string line, summary[4];   // reused, so employees do not allocate
+    for (size_t i = first; i < last; i++) {
+        // The SUMMARY lines of the employee, escaped and folded once
+        for (int st = SHIFT_DAY; st <= SHIFT_FREE; st++) {
+            line = "SUMMARY:";
+            line += SHIFT_TITLES[st];
+            AppendEmployeeLabel(line, roster, i, opt);
+            summary[st].clear();
+            AppendFolded(summary[st], line);
+            if (opt.times[st].start == ALL_DAY) summary[st] += "TRANSP:TRANSPARENT\r\n";
+            summary[st] += "END:VEVENT\r\n";
+        }
+        char id[24];
+        int idLen = snprintf(id, sizeof(id), "-%u@smjene\r\n", roster.At(i).id);
+
+        roster.Shifts(i).ForEach(opt.from, opt.to, [&](int32_t day, ShiftType st) {
+            const ShiftTimes& tm = opt.times[st];
+            const bool allDay = tm.start == ALL_DAY;
+            char* b = out.Reserve(160);
+            char* q = b;
+            memcpy(q, "BEGIN:VEVENT\r\nUID:", 18);
+            q = PutCompactDate(q + 18, day);
+            memcpy(q, id, (size_t)idLen);
+            q += idLen;
+            memcpy(q, "DTSTAMP:", 8);
+            memcpy(q + 8, stamp, stampLen);
+            q += 8 + stampLen;
+            q = PutEventTime(q, "DTSTART", day, tm.start, allDay);
+            q = PutEventTime(q, "DTEND", allDay || tm.end <= tm.start ? day + 1 : day, tm.end, allDay);
+            out.Commit((size_t)(q - b));
+            out.Put(summary[st]);
+            events++;
+        });
+    }
+    out.Put("END:VCALENDAR\r\n");
+    return out.Finish(events, stats);
+}
+
+// ============================================================================
+//  CSV
+// ============================================================================
+
+// A field, quoted when it holds a separator, a quote or a line break
+static void AppendCsvField(std::string& out, const std::string& s) {
+    if (s.find_first_of(",\"\r\n") == std::string::npos) { out += s; return; }
+    out += '"';
+    for (char c : s) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+// "YYYY-MM-DD HH:MM"
+static char* PutCsvTime(char* p, int32_t day, int16_t minutes) {
+    CivilDate c = CivilFromDays(day);
+    PutDigits(p, c.y, 4);
+    p[4] = '-';
+    PutDigits(p + 5, c.m, 2);
+    p[7] = '-';
+    PutDigits(p + 8, c.d, 2);
+    p[10] = ' ';
+    PutDigits(p + 11, minutes / 60, 2);
+    p[13] = ':';
+    PutDigits(p + 14, minutes % 60, 2);
+    return p + 16;
+}
+
+bool ExportCsv(FILE* f, const Roster& roster, const ExportOptions& opt, ExportStats* stats) {
+    ExportBuffer out(f);
+    out.Put("datum,radnik,ime,smjena,pocetak,kraj\r\n");
+    size_t first, last, events = 0;
+    EmployeeRange(roster, opt, first, last);
+    std::string who;
+    for (size_t i = first; i < last; i++) {
+        // ",<id>,<name>," once per employee
+        char id[16];
+        snprintf(id, sizeof(id), ",%u,", roster.At(i).id);
+        who = id;
+        AppendCsvField(who, roster.At(i).name);
+        who += ',';
+
+        roster.Shifts(i).ForEach(opt.from, opt.to, [&](int32_t day, ShiftType st) {
+            const ShiftTimes& tm = opt.times[st];
+            char* b = out.Reserve(10);
+            CivilDate c = CivilFromDays(day);
+            PutDigits(b, c.y, 4);
+            b[4] = '-';
+            PutDigits(b + 5, c.m, 2);
+            b[7] = '-';
+            PutDigits(b + 8, c.d, 2);
+            out.Commit(10);
+            out.Put(who);
+            b = out.Reserve(48);
+            char* q = b;
+            *q++ = SHIFT_LETTERS[st];
+            *q++ = ',';
+            if (tm.start != ALL_DAY) {
+                q = PutCsvTime(q, day, tm.start);
+                *q++ = ',';
+                q = PutCsvTime(q, tm.end <= tm.start ? day + 1 : day, tm.end);
+            } else {
+                *q++ = ',';
+            }
+            *q++ = '\r';
+            *q++ = '\n';
+            out.Commit((size_t)(q - b));
+            events++;
+        });
+    }
+    return out.Finish(events, stats);
+}
@@ -0,0 +1,48 @@
+// ============================================================================
+//  EXPORT FORMAT - the schedule for phone calendars (iCalendar, RFC 5545)
+//  and spreadsheets (CSV, RFC 4180). Streamed straight from the packed
+//  words through one 64 KB buffer: nothing is kept per event, so memory
+//  does not grow with the years or the employees exported.
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "roster.h"
+#include "shift_store.h"
+
+// Start and end of a shift in minutes from midnight; an end at or before the
+// start falls on the next day. ALL_DAY makes a whole-day (date only) event.
+struct ShiftTimes {
+    int16_t start, end;
+};
+static const int16_t ALL_DAY = -1;
+
+struct ExportOptions {
+    // Inclusive day range, the whole history by default
+    int32_t    from = DaysFromCivil(ShiftStore::MIN_YEAR, 1, 1);
+    int32_t    to = DaysFromCivil(ShiftStore::MAX_YEAR, 12, 31);
+    // Roster index of the exported employee, -1 for everyone
+    int        employee = -1;
+    // Per ShiftType (SHIFT_NONE unused)
+    ShiftTimes times[4] = { { ALL_DAY, ALL_DAY }, { 7 * 60, 19 * 60 }, { 19 * 60, 7 * 60 }, { ALL_DAY, ALL_DAY } };
+    // DTSTAMP of the events, seconds since 1970 (UTC)
+    int64_t    stamp = 0;
+};
+
+struct ExportStats {
+    size_t   events = 0;
+    uint64_t bytes = 0;
+};
+
+// "D=06:00-14:00,N=22:00-06:00,S=dan" (any subset, "dan" = ALL_DAY) into
+// times. Returns nullptr on success or the reason the spec is malformed.
+const char* ParseShiftTimes(const char* spec, ShiftTimes times[4]);
+
+// One VEVENT per shift. UIDs are "<YYYYMMDD>-<employee id>@smjene", so a
+// calendar updates the events of an earlier import instead of doubling them.
+bool ExportIcs(FILE* f, const Roster& roster, const ExportOptions& opt, ExportStats* stats = nullptr);
+// "datum,radnik,ime,smjena,pocetak,kraj" header and one row per shift
+bool ExportCsv(FILE* f, const Roster& roster, const ExportOptions& opt, ExportStats* stats = nullptr);
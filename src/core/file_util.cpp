@@ -0,0 +1,75 @@
+// ============================================================================
+//  FILE UTIL
+// ============================================================================
+
+#include "file_util.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+PathString PathFromUtf8(const char* path) {
+    int n = MultiByteToWideChar(CP_UTF8, 0, path, -1, NULL, 0);
+    if (n <= 0) return PathString();
+    PathString w((size_t)n, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, &w[0], n);
+    w.resize((size_t)n - 1);
+    return w;
+}
+
+FILE* OpenPath(const PathString& path, const char* mode) {
+    wchar_t wmode[8] = {0};
+    for (int i = 0; i < 7 && mode[i]; i++) wmode[i] = (wchar_t)mode[i];
+    return _wfopen(path.c_str(), wmode);
+}
+
+bool PathExists(const PathString& path) {
+    return GetFileAttributesW(path.c_str()) != INVALID_FILE_ATTRIBUTES;
+}
+
+bool RemovePath(const PathString& path) {
+    return DeleteFileW(path.c_str()) != 0;
+}
+
+bool ReplacePath(const PathString& src, const PathString& dst) {
+    return MoveFileExW(src.c_str(), dst.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+bool SyncFile(FILE* f) {
+    return fflush(f) == 0 && _commit(_fileno(f)) == 0;
+}
+
+#else
+
+PathString PathFromUtf8(const char* path) {
+    return path;
+}
+
+FILE* OpenPath(const PathString& path, const char* mode) {
+    return fopen(path.c_str(), mode);
+}
+
+bool PathExists(const PathString& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+bool RemovePath(const PathString& path) {
+    return remove(path.c_str()) == 0;
+}
+
+bool ReplacePath(const PathString& src, const PathString& dst) {
+    return rename(src.c_str(), dst.c_str()) == 0;
+}
+
+bool SyncFile(FILE* f) {
+    return fflush(f) == 0 && fsync(fileno(f)) == 0;
+}
+
+#endif
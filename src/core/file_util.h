@@ -0,0 +1,28 @@
+// ============================================================================
+//  FILE UTIL - portable file helpers (wide paths on Windows)
+// ============================================================================
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+#ifdef _WIN32
+typedef std::wstring PathString;
+#define PATH_TEXT(s) L##s
+#else
+typedef std::string PathString;
+#define PATH_TEXT(s) s
+#endif
+
+// Command-line (UTF-8) path to PathString
+PathString PathFromUtf8(const char* path);
+
+// mode is a narrow fopen mode ("rb", "ab", ...)
+FILE* OpenPath(const PathString& path, const char* mode);
+bool  PathExists(const PathString& path);
+bool  RemovePath(const PathString& path);
+// Replaces dst with src in one rename (dst may exist).
+bool  ReplacePath(const PathString& src, const PathString& dst);
+// Flushes f and waits until its data is on the disk (fsync / _commit).
+bool  SyncFile(FILE* f);
@@ -0,0 +1,223 @@
+// ============================================================================
+//  HOLIDAYS
+// ============================================================================
+
+#include "holidays.h"
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include "bits.h"
+
+// Anonymous Gregorian algorithm (Meeus / Jones / Butcher)
+int32_t CatholicEaster(int y) {
+    int a = y % 19, b = y / 100, c = y % 100, d = b / 4, e = b % 4;
+    int f = (b + 8) / 25, g = (b - f + 1) / 3;
+    int h = (19 * a + b - d - g + 15) % 30;
+    int i = c / 4, k = c % 4;
+    int l = (32 + 2 * e + 2 * i - h - k) % 7;
+    int m = (a + 11 * h + 22 * l) / 451;
+    int n = h + l - 7 * m + 114;
+    return DaysFromCivil(y, n / 31, n % 31 + 1);
+}
+
+// Meeus' Julian algorithm; the calendars are y/100 - y/400 - 2 days apart
+// from March of y on (13 days in 1900-2099)
+int32_t OrthodoxEaster(int y) {
+    int a = y % 4, b = y % 7, c = y % 19;
+    int d = (19 * c + 15) % 30;
+    int e = (2 * a + 4 * b - d + 34) % 7;
+    int n = d + e + 114;
+    return DaysFromCivil(y, n / 31, n % 31 + 1) + y / 100 - y / 400 - 2;
+}
+
+int32_t HolidayRule::DayIn(int y) const {
+    switch (kind) {
+    case ONE_DATE:
+        if (y != year) return INT32_MIN;
+        // fall through
+    case EVERY_YEAR:
+        return day <= DaysInMonth(month, y) ? DaysFromCivil(y, month, day) : INT32_MIN;
+    case EASTER:          return CatholicEaster(y) + offset;
+    case ORTHODOX_EASTER: return OrthodoxEaster(y) + offset;
+    }
+    return INT32_MIN;
+}
+
+static bool IsBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+// Exactly `width` digits at p
+static bool ParseDigits(const char* p, int width, int& out) {
+    std::from_chars_result r = std::from_chars(p, p + width, out);
+    return r.ec == std::errc() && r.ptr == p + width && *p != '-' && *p != '+';
+}
+
+const char* ParseHolidayRule(const char* b, const char* e, HolidayRule& rule) {
+    while (e > b && IsBlank(e[-1])) e--;
+    while (b < e && IsBlank(*b)) b++;
+    if (b == e || *b == '#') return "";
+
+    rule = HolidayRule();
+    if (*b == '-') { rule.remove = true; b++; }
+    const char* p = b;
+    while (p < e && !IsBlank(*p)) p++;
+    const size_t n = (size_t)(p - b);
+    int m, d;
+    if (n > 0 && (*b == 'U' || *b == 'P')) {
+        // "U", "U+1", "P-2"
+        rule.kind = *b == 'U' ? HolidayRule::EASTER : HolidayRule::ORTHODOX_EASTER;
+        if (n > 1) {
+            int offset = 0;
+            const char* q = b[1] == '+' ? b + 2 : b + 1;
+            std::from_chars_result r = std::from_chars(q, p, offset);
+            if ((b[1] != '+' && b[1] != '-') || n < 3 || b[2] < '0' || b[2] > '9' || r.ec != std::errc() || r.ptr != p)
+                return "neispravan pomak od Uskrsa (ocekivano U+1 ili P-2)";
+            if (offset < -HolidayRule::MAX_OFFSET || offset > HolidayRule::MAX_OFFSET)
+                return "pomak od Uskrsa je veci od 60 dana";
+            rule.offset = (int16_t)offset;
+        }
+    } else if (n == 5 && b[2] == '-' && ParseDigits(b, 2, m) && ParseDigits(b + 3, 2, d)) {
+        // "MM-DD"; 29 Feb only counts in leap years
+        if (m < 1 || m > 12 || d < 1 || d > DaysInMonth(m, 2000)) return "nepostojeci datum";
+        rule.kind = HolidayRule::EVERY_YEAR;
+        rule.month = (int8_t)m;
+        rule.day = (int8_t)d;
+    } else if (n == 10) {
+        int32_t z;
+        if (const char* err = ParseDate(b, p, z)) return err;
+        CivilDate c = CivilFromDays(z);
+        rule.kind = HolidayRule::ONE_DATE;
+        rule.year = (int16_t)c.y;
+        rule.month = (int8_t)c.m;
+        rule.day = (int8_t)c.d;
+    } else {
+        return "neispravan praznik (ocekivano MM-DD, YYYY-MM-DD, U+n ili P+n)";
+    }
+
+    while (p < e && IsBlank(*p)) p++;
+    rule.name.assign(p, e);
+    return nullptr;
+}
+
+// ============================================================================
+//  CALENDAR
+// ============================================================================
+
+static const char* const BUILT_IN[] = {
+    "01-01 Nova godina",
+    "01-02 Nova godina",
+    "01-07 Bozic (pravoslavni)",
+    "05-01 Praznik rada",
+    "05-02 Praznik rada",
+    "11-11 Dan primirja",
+    "U-2 Veliki petak",
+    "U Uskrs",
+    "U+1 Uskrsnji ponedjeljak",
+    "P-2 Veliki petak (pravoslavni)",
+    "P Vaskrs",
+    "P+1 Vaskrsnji ponedjeljak",
+};
+
+HolidayCalendar::HolidayCalendar() {
+    for (const char* line : BUILT_IN) {
+        HolidayRule rule;
+        ParseHolidayRule(line, line + strlen(line), rule);
+        m_rules.push_back(rule);
+    }
+    Rebuild();
+}
+
+void HolidayCalendar::Clear() {
+    m_rules.clear();
+    Rebuild();
+}
+
+void HolidayCalendar::Add(const HolidayRule& rule) {
+    m_rules.push_back(rule);
+    Rebuild();
+}
+
+size_t HolidayCalendar::Load(FILE* f, TextParseReport* report) {
+    TextParseReport local;
+    TextParseReport& r = report ? *report : local;
+    size_t added = 0;
+    char buf[256];
+    bool tail = false;   // the rest of a line too long for buf
+    while (fgets(buf, sizeof(buf), f)) {
+        size_t n = strlen(buf);
+        bool whole = n > 0 && buf[n - 1] == '\n';
+        if (tail) { tail = !whole; continue; }
+        r.lines++;
+        HolidayRule rule;
+        const char* err = whole || feof(f) ? ParseHolidayRule(buf, buf + n - whole, rule) : "predugacka linija";
+        tail = !whole && !feof(f);
+        if (!err) {
+            m_rules.push_back(rule);
+            r.records++;
+            added++;
+        } else if (*err) {
+            if (r.errorCount < (size_t)TextParseReport::MAX_ERRORS)
+                r.errors[r.errorCount] = TextParseReport::Error{ r.lines, err };
+            r.errorCount++;
+        }
+    }
+    if (added) Rebuild();
+    return added;
+}
+
+void HolidayCalendar::Prepare(int firstYear, int lastYear) {
+    if (firstYear >= m_firstYear && lastYear <= m_lastYear) return;
+    m_firstYear = std::min(m_firstYear, firstYear);
+    m_lastYear = std::max(m_lastYear, lastYear);
+    Rebuild();
+}
+
+// Every rule's day lies in its own year (Easter +/- MAX_OFFSET days stays
+// between January and September), so a year's bits depend on it alone
+void HolidayCalendar::YearBits(int y, uint64_t* bits, int32_t first) const {
+    const int32_t jan1 = DaysFromCivil(y, 1, 1);
+    for (const HolidayRule& rule : m_rules) {
+        int32_t z = rule.DayIn(y);
+        if (z == INT32_MIN || z < jan1 || z - jan1 >= DaysInYear(y)) continue;
+        uint32_t i = (uint32_t)(z - first);
+        if (rule.remove) bits[i >> 6] &= ~(1ull << (i & 63));
+        else bits[i >> 6] |= 1ull << (i & 63);
+    }
+}
+
+void HolidayCalendar::Rebuild() {
+    m_firstDay = DaysFromCivil(m_firstYear, 1, 1);
+    m_days = (uint32_t)(DaysFromCivil(m_lastYear + 1, 1, 1) - m_firstDay);
+    m_bits.assign(m_days / 64 + 1, 0);
+    for (int y = m_firstYear; y <= m_lastYear; y++) YearBits(y, m_bits.data(), m_firstDay);
+}
+
+bool HolidayCalendar::YearHas(int32_t day) const {
+    CivilDate c = CivilFromDays(day);
+    const int32_t first = DaysFromCivil(c.y, 1, 1);
+    uint64_t bits[6] = {};
+    YearBits(c.y, bits, first);
+    uint32_t i = (uint32_t)(day - first);
+    return (bits[i >> 6] >> (i & 63) & 1) != 0;
+}
+
+uint64_t HolidayCalendar::Bits(int32_t from) const {
+    if (from >= m_firstDay && from + 63 < m_firstDay + (int32_t)m_days)
+        return BitsAt(m_bits.data(), m_bits.size(), from - m_firstDay);
+    uint64_t bits = 0;
+    for (int i = 0; i < 64; i++)
+        if (IsHoliday(from + i)) bits |= 1ull << i;
+    return bits;
+}
+
+uint32_t HolidayCalendar::MonthMask(int m, int y) const {
+    return (uint32_t)(Bits(MonthStart(m, y)) & ((1ull << DaysInMonth(m, y)) - 1));
+}
+
+const char* HolidayCalendar::Name(int32_t day) const {
+    if (!IsHoliday(day)) return nullptr;
+    const int y = CivilFromDays(day).y;
+    for (size_t i = m_rules.size(); i-- > 0; )
+        if (!m_rules[i].remove && m_rules[i].DayIn(y) == day) return m_rules[i].name.c_str();
+    return nullptr;
+}
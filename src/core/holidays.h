@@ -0,0 +1,92 @@
+// ============================================================================
+//  HOLIDAYS - public holidays as a day bitmap: fixed dates, days around the
+//  Catholic and the Orthodox Easter (computus) and custom dates from a text
+//  file. Each year's bits are computed once when the rules change, for the
+//  cached years; IsHoliday() there is a single bit test.
+//
+//  Holiday file (smjene_praznici.txt), one rule per line, # comments:
+//      01-06       Bogojavljenje        every year
+//      2026-03-02  Dan nezavisnosti     that year only
+//      U+1         Uskrsnji ponedjeljak Catholic Easter Sunday +/- days
+//      P-2         Veliki petak         Orthodox Easter Sunday +/- days
+//      -11-11                           a leading '-' takes a holiday out
+//  Rules apply in order, the built-in ones first.
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "calendar.h"
+#include "text_format.h"
+
+// Easter Sunday of year y: Gregorian computus / Julian computus given as a
+// Gregorian date
+int32_t CatholicEaster(int y);
+int32_t OrthodoxEaster(int y);
+
+struct HolidayRule {
+    enum Kind : uint8_t { EVERY_YEAR, ONE_DATE, EASTER, ORTHODOX_EASTER };
+
+    Kind        kind = EVERY_YEAR;
+    bool        remove = false;   // takes the day out instead of adding it
+    int16_t     year = 0;         // ONE_DATE
+    int8_t      month = 1, day = 1;   // EVERY_YEAR, ONE_DATE
+    int16_t     offset = 0;       // days from Easter Sunday (at most MAX_OFFSET)
+    std::string name;
+
+    static const int MAX_OFFSET = 60;
+
+    // The day in year y, or INT32_MIN when the rule has none (29 Feb, a
+    // one-off date of another year)
+    int32_t DayIn(int y) const;
+};
+
+// Parses one line (without the newline). Returns nullptr and fills rule, ""
+// for a blank/comment line, or the reason the line is malformed.
+const char* ParseHolidayRule(const char* b, const char* e, HolidayRule& rule);
+
+class HolidayCalendar {
+public:
+    // The built-in holidays: 1-2 Jan, 7 Jan, 1-2 May, 11 Nov, and Good
+    // Friday to Easter Monday of both Easters
+    HolidayCalendar();
+
+    // No holidays at all
+    void Clear();
+    void Add(const HolidayRule& rule);
+    // Adds the rules of a holiday file; returns the rules added
+    size_t Load(FILE* f, TextParseReport* report = nullptr);
+    const std::vector<HolidayRule>& Rules() const { return m_rules; }
+
+    bool IsHoliday(int32_t day) const {
+        uint32_t i = (uint32_t)(day - m_firstDay);
+        return i < m_days ? (m_bits[i >> 6] >> (i & 63) & 1) != 0 : YearHas(day);
+    }
+    // Bit i: day from + i is a holiday
+    uint64_t Bits(int32_t from) const;
+    // Bit d - 1: day d of the month is a holiday
+    uint32_t MonthMask(int m, int y) const;
+    // The name of the holiday on day (the last rule that adds it), nullptr
+    // when the day is none
+    const char* Name(int32_t day) const;
+
+    // Years with cached bits (CACHE_FIRST..CACHE_LAST unless widened); days
+    // outside them are computed on each call
+    static const int CACHE_FIRST = 1900, CACHE_LAST = 2199;
+    void Prepare(int firstYear, int lastYear);
+
+private:
+    void Rebuild();
+    void YearBits(int y, uint64_t* bits, int32_t first) const;
+    bool YearHas(int32_t day) const;
+
+    std::vector<HolidayRule> m_rules;
+    std::vector<uint64_t>    m_bits;   // bit i: day m_firstDay + i
+    int                      m_firstYear = CACHE_FIRST, m_lastYear = CACHE_LAST;
+    int32_t                  m_firstDay = 0;
+    uint32_t                 m_days = 0;
+};
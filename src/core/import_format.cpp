@@ -0,0 +1,439 @@
+// ============================================================================
+//  IMPORT FORMAT
+// ============================================================================
+
+#include "import_format.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string>
+
+static const size_t CHUNK_SIZE = 64 * 1024;
+static const size_t MAX_LINE   = 4096;
+static const int    MAX_FIELDS = 16;
+
+static bool IsBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+static char Lower(char c) { return c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c; }
+
+static void Trim(const char*& b, const char*& e) {
+    while (b < e && IsBlank(*b)) b++;
+    while (e > b && IsBlank(e[-1])) e--;
+}
+
+// Case-insensitive (ASCII) comparison of [b, e) with a lowercase word
+static bool SameWord(const char* b, const char* e, const char* word) {
+    size_t n = strlen(word);
+    if ((size_t)(e - b) != n) return false;
+    for (size_t i = 0; i < n; i++)
+        if (Lower(b[i]) != word[i]) return false;
+    return true;
+}
+
+namespace {
+
+struct ImportSink {
+    const ImportOptions&      opt;
+    std::vector<ShiftRecord>& out;
+    ImportReport&             report;
+
+    ImportSink(const ImportOptions& o, std::vector<ShiftRecord>& v, ImportReport& r) : opt(o), out(v), report(r) {}
+
+    void Reject(size_t line, const char* reason) {
+        TextParseReport& p = report.parse;
+        if (p.errorCount < (size_t)TextParseReport::MAX_ERRORS)
+            p.errors[p.errorCount] = TextParseReport::Error{ line, reason };
+        p.errorCount++;
+        report.rejected++;
+    }
+    void Emit(int32_t day, ShiftType st, uint32_t employee) {
+        if (st == SHIFT_NONE) { report.skipped++; return; }
+        ShiftRecord r;
+        r.day = day;
+        r.type = st;
+        r.employee = opt.fileEmployees ? employee : opt.employee;
+        out.push_back(r);
+        report.parse.records++;
+    }
+};
+
+// ============================================================================
+//  CSV
+// ============================================================================
+
+// "DD.MM.YYYY", one-digit day and month and a trailing dot allowed
+static const char* ParseLocalDate(const char* b, const char* e, int32_t& day) {
+    int v[3];
+    const char* p = b;
+    for (int i = 0; i < 3; i++) {
+        std::from_chars_result r = std::from_chars(p, e, v[i]);
+        if (r.ec != std::errc() || r.ptr == p || *p == '-') return "neispravan datum (ocekivano YYYY-MM-DD ili DD.MM.YYYY)";
+        p = r.ptr;
+        if (i < 2) {
+            if (p == e || *p != '.') return "neispravan datum (ocekivano YYYY-MM-DD ili DD.MM.YYYY)";
+            p++;
+        }
+    }
+    if (p < e && *p == '.') p++;
+    if (p != e) return "neispravan datum (ocekivano YYYY-MM-DD ili DD.MM.YYYY)";
+    int d = v[0], m = v[1], y = v[2];
+    if (m < 1 || m > 12 || y < ShiftStore::MIN_YEAR || y > ShiftStore::MAX_YEAR || d < 1 || d > DaysInMonth(m, y))
+        return "nepostojeci datum";
+    day = DaysFromCivil(y, m, d);
+    return nullptr;
+}
+
+static const char* ParseAnyDate(const char* b, const char* e, int32_t& day) {
+    if (e - b == 10 && b[4] == '-') return ParseDate(b, e, day);
+    return ParseLocalDate(b, e, day);
+}
+
+// D/N/S, 1-3 or a word starting with the letter; empty, "-" and "0" are no shift
+static bool ParseShiftCode(const char* b, const char* e, ShiftType& st) {
+    if (b == e || ((e - b == 1) && (*b == '-' || *b == '0'))) { st = SHIFT_NONE; return true; }
+    switch (Lower(*b)) {
+    case 'd': case '1': st = SHIFT_DAY; break;
+    case 'n': case '2': st = SHIFT_NIGHT; break;
+    case 's': case '3': st = SHIFT_FREE; break;
+    default: return false;
+    }
+    return e - b == 1 || (*b < '0' || *b > '9');
+}
+
+struct CsvSink : ImportSink {
+    using ImportSink::ImportSink;
+
+    char        sep = 0;        // decided by the first line
+    int         colDate = 0, colShift = 1, colEmployee = 2;
+    std::string scratch;        // unquoted fields of the current line
+    size_t      begin[MAX_FIELDS], end[MAX_FIELDS];
+
+    // Splits [b, e) into scratch; returns the number of fields, -1 on a broken quote
+    int Split(const char* b, const char* e) {
+        scratch.clear();
+        int n = 0;
+        const char* p = b;
+        for (;;) {
+            if (n == MAX_FIELDS) return n;
+            begin[n] = scratch.size();
+            if (p < e && *p == '"') {
+                for (p++;; p++) {
+                    if (p == e) return -1;
+                    if (*p == '"') {
+                        if (p + 1 < e && p[1] == '"') { scratch += '"'; p++; continue; }
+                        p++;
+                        break;
+                    }
+                    scratch += *p;
+                }
+                while (p < e && IsBlank(*p)) p++;
+                if (p < e && *p != sep) return -1;
+            } else {
+                const char* f = p;
+                while (p < e && *p != sep) p++;
+                scratch.append(f, p);
+            }
+            end[n++] = scratch.size();
+            if (p == e) return n;
+            p++;   // separator
+        }
+    }
+    const char* FieldBegin(int i) const { return scratch.data() + begin[i]; }
+    const char* FieldEnd(int i) const { return scratch.data() + end[i]; }
+
+    // A first line whose first field is no date names the columns
+    bool Header(int fields) {
+        const char* b = FieldBegin(0);
+        const char* e = FieldEnd(0);
+        Trim(b, e);
+        int32_t day;
+        if (ParseAnyDate(b, e, day) == nullptr) return false;
+        colDate = colShift = colEmployee = -1;
+        for (int i = 0; i < fields; i++) {
+            b = FieldBegin(i);
+            e = FieldEnd(i);
+            Trim(b, e);
+            if (SameWord(b, e, "datum") || SameWord(b, e, "date")) colDate = i;
+            else if (SameWord(b, e, "smjena") || SameWord(b, e, "shift")) colShift = i;
+            else if (SameWord(b, e, "radnik") || SameWord(b, e, "employee")) colEmployee = i;
+        }
+        return true;
+    }
+
+    void Line(const char* b, const char* e) {
+        size_t line = ++report.parse.lines;
+        if (e - b > (ptrdiff_t)MAX_LINE) { report.rows++; Reject(line, "predugacka linija"); return; }
+        Trim(b, e);
+        if (b == e) return;
+        if (!sep) {
+            const char* comma = (const char*)memchr(b, ',', (size_t)(e - b));
+            const char* semi = (const char*)memchr(b, ';', (size_t)(e - b));
+            sep = semi && (!comma || semi < comma) ? ';' : ',';
+            int fields = Split(b, e);
+            if (fields > 0 && Header(fields)) {
+                if (colDate < 0 || colShift < 0) Reject(line, "zaglavlje bez kolona datum i smjena");
+                return;
+            }
+        }
+        report.rows++;
+        if (colDate < 0 || colShift < 0) { Reject(line, "zaglavlje bez kolona datum i smjena"); return; }
+        int fields = Split(b, e);
+        if (fields < 0) { Reject(line, "neispravni navodnici"); return; }
+        if (colDate >= fields || colShift >= fields) { Reject(line, "premalo kolona"); return; }
+
+        const char* fb = FieldBegin(colDate);
+        const char* fe = FieldEnd(colDate);
+        Trim(fb, fe);
+        int32_t day;
+        if (const char* err = ParseAnyDate(fb, fe, day)) { Reject(line, err); return; }
+        fb = FieldBegin(colShift);
+        fe = FieldEnd(colShift);
+        Trim(fb, fe);
+        ShiftType st;
+        if (!ParseShiftCode(fb, fe, st)) { Reject(line, "nepoznata oznaka smjene"); return; }
+        uint32_t employee = opt.employee;
+        if (colEmployee >= 0 && colEmployee < fields) {
+            fb = FieldBegin(colEmployee);
+            fe = FieldEnd(colEmployee);
+            Trim(fb, fe);
+            if (fb < fe) {
+                std::from_chars_result r = std::from_chars(fb, fe, employee);
+                if (r.ec != std::errc() || r.ptr != fe) { Reject(line, "neispravna oznaka radnika"); return; }
+            }
+        }
+        Emit(day, st, employee);
+    }
+    void Finish() {}
+};
+
+// ============================================================================
+//  ICALENDAR
+// ============================================================================
+
+struct IcsSink : ImportSink {
+    using ImportSink::ImportSink;
+
+    std::string logical;        // current unfolded content line
+    size_t      logicalLine = 0;
+    bool        inEvent = false;
+    size_t      eventLine = 0;
+    std::string start, summary, uid;
+    bool        allDay = false;
+
+    void Line(const char* b, const char* e) {
+        size_t line = ++report.parse.lines;
+        if (e > b && e[-1] == '\r') e--;
+        // RFC 5545 3.1: a line starting with a blank continues the previous one
+        if (b < e && (*b == ' ' || *b == '\t')) {
+            if (logical.size() + (size_t)(e - b) <= MAX_LINE) logical.append(b + 1, e);
+            return;
+        }
+        Property();
+        logical.assign(b, e);
+        logicalLine = line;
+    }
+
+    void Property() {
+        if (logical.empty()) return;
+        const char* b = logical.data();
+        const char* e = b + logical.size();
+        const char* colon = (const char*)memchr(b, ':', (size_t)(e - b));
+        if (!colon) return;
+        const char* nameEnd = b;
+        while (nameEnd < colon && *nameEnd != ';') nameEnd++;
+        const char* v = colon + 1;
+
+        if (SameWord(b, nameEnd, "begin") && SameWord(v, e, "vevent")) {
+            inEvent = true;
+            eventLine = logicalLine;
+            start.clear(); summary.clear(); uid.clear();
+            allDay = false;
+            report.rows++;
+        } else if (!inEvent) {
+            return;
+        } else if (SameWord(b, nameEnd, "end") && SameWord(v, e, "vevent")) {
+            inEvent = false;
+            Event();
+        } else if (SameWord(b, nameEnd, "dtstart")) {
+            start.assign(v, e);
+            std::string params(nameEnd, colon);
+            for (char& c : params) c = Lower(c);
+            allDay = params.find("value=date") != std::string::npos && params.find("value=date-time") == std::string::npos;
+        } else if (SameWord(b, nameEnd, "summary")) {
+            // TEXT unescaping, lowercased: only keywords are looked for
+            for (const char* p = v; p < e; p++) {
+                if (*p == '\\' && p + 1 < e) p++;
+                summary += Lower(*p);
+            }
+        } else if (SameWord(b, nameEnd, "uid")) {
+            uid.assign(v, e);
+        }
+    }
+
+    void Event() {
+        // DTSTART: YYYYMMDD[THHMMSS[Z]]
+        const char* s = start.c_str();
+        int y, m, d, hh = 0, mm = 0;
+        bool timed = start.size() >= 15 && s[8] == 'T';
+        if (start.size() < 8 || sscanf(s, "%4d%2d%2d", &y, &m, &d) != 3 ||
+            (timed && sscanf(s + 9, "%2d%2d", &hh, &mm) != 2)) {
+            Reject(eventLine, start.empty() ? "dogadjaj bez DTSTART" : "neispravan DTSTART");
+            return;
+        }
+        if (m < 1 || m > 12 || y < ShiftStore::MIN_YEAR || y > ShiftStore::MAX_YEAR || d < 1 || d > DaysInMonth(m, y)) {
+            Reject(eventLine, "nepostojeci datum");
+            return;
+        }
+        ShiftType st = SHIFT_NONE;
+        if (summary.find("dnevn") != std::string::npos) st = SHIFT_DAY;
+        else if (summary.find("nocn") != std::string::npos || summary.find("no\xc4\x87n") != std::string::npos) st = SHIFT_NIGHT;
+        else if (summary.find("slobod") != std::string::npos) st = SHIFT_FREE;
+        else {
+            // By the start time of ImportOptions::times
+            int16_t at = timed && !allDay ? (int16_t)(hh * 60 + mm) : ALL_DAY;
+            for (int t = SHIFT_DAY; t <= SHIFT_FREE && st == SHIFT_NONE; t++)
+                if (opt.times[t].start == at) st = (ShiftType)t;
+        }
+        if (st == SHIFT_NONE) { Reject(eventLine, "nepoznata smjena (naslov ni vrijeme pocetka)"); return; }
+
+        // "<YYYYMMDD>-<id>@smjene" from ExportIcs
+        uint32_t employee = opt.employee;
+        size_t at = uid.find("@smjene");
+        if (at != std::string::npos && at > 9 && uid[8] == '-') {
+            uint32_t id;
+            std::from_chars_result r = std::from_chars(uid.data() + 9, uid.data() + at, id);
+            if (r.ec == std::errc() && r.ptr == uid.data() + at) employee = id;
+        }
+        Emit(DaysFromCivil(y, m, d), st, employee);
+    }
+
+    void Finish() {
+        Property();
+        logical.clear();
+        if (inEvent) Reject(eventLine, "dogadjaj bez END:VEVENT");
+        inEvent = false;
+    }
+};
+
+// Handles every complete line in [b, e); returns the start of the unfinished tail
+template <class Sink> static const char* Lines(Sink& sink, const char* b, const char* e) {
+    while (const char* nl = (const char*)memchr(b, '\n', (size_t)(e - b))) {
+        sink.Line(b, nl);
+        b = nl + 1;
+    }
+    return b;
+}
+
+// Chunked reading as in text_format.cpp: a line longer than MAX_LINE is
+// handed over cut (and rejected by the sink), the rest of it skipped
+template <class Sink> static void ReadLines(Sink& sink, FILE* f) {
+    std::vector<char> buf(CHUNK_SIZE + MAX_LINE + 1);
+    size_t carry = 0;
+    bool overlong = false;
+    for (;;) {
+        size_t n = fread(buf.data() + carry, 1, CHUNK_SIZE, f);
+        if (n == 0) break;
+        const char* b = buf.data();
+        const char* e = b + carry + n;
+        if (overlong) {
+            const char* nl = (const char*)memchr(b, '\n', (size_t)(e - b));
+            if (!nl) { carry = 0; continue; }
+            b = nl + 1;
+            overlong = false;
+        }
+        const char* tail = Lines(sink, b, e);
+        carry = (size_t)(e - tail);
+        if (carry > MAX_LINE) {
+            sink.Line(tail, tail + MAX_LINE + 1);
+            carry = 0;
+            overlong = true;
+        } else {
+            memmove(buf.data(), tail, carry);
+        }
+    }
+    if (carry && !overlong) sink.Line(buf.data(), buf.data() + carry);
+    sink.Finish();
+}
+
+template <class Sink> static void ParseLines(Sink& sink, const char* data, size_t len) {
+    const char* tail = Lines(sink, data, data + len);
+    if (tail < data + len) sink.Line(tail, data + len);
+    sink.Finish();
+}
+
+} // namespace
+
+size_t ReadImport(FILE* f, ImportFormat format, const ImportOptions& opt, std::vector<ShiftRecord>& out,
+                  ImportReport& report) {
+    size_t before = out.size();
+    if (format == IMPORT_ICS) {
+        IcsSink sink(opt, out, report);
+        ReadLines(sink, f);
+    } else {
+        CsvSink sink(opt, out, report);
+        ReadLines(sink, f);
+    }
+    return out.size() - before;
+}
+
+size_t ParseImport(const char* data, size_t len, ImportFormat format, const ImportOptions& opt,
+                   std::vector<ShiftRecord>& out, ImportReport& report) {
+    size_t before = out.size();
+    if (format == IMPORT_ICS) {
+        IcsSink sink(opt, out, report);
+        ParseLines(sink, data, len);
+    } else {
+        CsvSink sink(opt, out, report);
+        ParseLines(sink, data, len);
+    }
+    return out.size() - before;
+}
+
+// ============================================================================
+//  APPLY
+// ============================================================================
+
+// 32 staged codes starting at slot (may lie outside the staged words)
+static uint64_t StagedWord(const std::vector<uint64_t>& w, int64_t slot) {
+    const int64_t n = ShiftStore::SLOTS_PER_WORD;
+    int64_t k = slot >= 0 ? slot / n : -((-slot + n - 1) / n);
+    int off = (int)(slot - k * n);
+    auto at = [&](int64_t i) { return i >= 0 && i < (int64_t)w.size() ? w[(size_t)i] : 0ull; };
+    return off ? (at(k) >> (2 * off)) | (at(k + 1) << (64 - 2 * off)) : at(k);
+}
+
+void ApplyImport(Roster& roster, std::vector<ShiftRecord>& records, const ImportOptions& opt, ImportReport& report) {
+    std::stable_sort(records.begin(), records.end(), [](const ShiftRecord& a, const ShiftRecord& b) {
+        return a.employee != b.employee ? a.employee < b.employee : a.day < b.day;
+    });
+    std::vector<uint64_t> staged;
+    for (size_t g = 0; g < records.size(); ) {
+        size_t end = g;
+        while (end < records.size() && records[end].employee == records[g].employee) end++;
+        int index = roster.Add(records[g].employee);
+        if (index < 0) {
+            report.rejected += end - g;
+            g = end;
+            continue;
+        }
+        ShiftStore& store = roster.Shifts((size_t)index);
+
+        // Stage the codes of [from, to], count against the stored ones
+        const int32_t from = records[g].day, to = records[end - 1].day;
+        staged.assign((size_t)(to - from) / ShiftStore::SLOTS_PER_WORD + 1, 0);
+        size_t writes = 0;
+        for (size_t i = g; i < end; i++) {
+            const ShiftRecord& r = records[i];
+            if (i + 1 < end && records[i + 1].day == r.day) { report.skipped++; continue; }   // a later row wins
+            ShiftType old = store.Get(r.day);
+            if (old == r.type || (old != SHIFT_NONE && opt.mode == MERGE_KEEP)) { report.skipped++; continue; }
+            if (old == SHIFT_NONE) report.added++;
+            else report.overwritten++;
+            int slot = r.day - from;
+            staged[(size_t)slot / ShiftStore::SLOTS_PER_WORD] |= (uint64_t)r.type << (2 * (slot % ShiftStore::SLOTS_PER_WORD));
+            writes++;
+        }
+        if (writes)
+            store.FillWords(from, to, opt.mode, [&](int32_t day) { return StagedWord(staged, (int64_t)day - from); });
+        g = end;
+    }
+}
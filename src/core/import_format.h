@@ -0,0 +1,55 @@
+// ============================================================================
+//  IMPORT FORMAT - bulk import of a schedule from CSV (a spreadsheet, or
+//  export_format.h output) or iCalendar. Files are parsed in 64 KB chunks
+//  into records first, then applied with one FillWords() per employee: a
+//  whole file is one store notification, one undo step and one save.
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+#include "export_format.h"
+#include "roster.h"
+#include "text_format.h"
+
+enum ImportFormat { IMPORT_CSV, IMPORT_ICS };
+
+struct ImportOptions {
+    // MERGE_KEEP leaves days that already have a shift alone
+    MergeMode  mode = MERGE_OVERWRITE;
+    // Employee of the rows that do not name one (CSV "radnik" column, ICS
+    // UID of export_format.h); with fileEmployees off, of every row
+    uint32_t   employee = Roster::DEFAULT_ID;
+    bool       fileEmployees = true;
+    // ICS events whose title names no shift are matched by start time
+    // (same defaults as ExportOptions)
+    ShiftTimes times[4] = { { ALL_DAY, ALL_DAY }, { 7 * 60, 19 * 60 }, { 19 * 60, 7 * 60 }, { ALL_DAY, ALL_DAY } };
+};
+
+struct ImportReport {
+    size_t rows = 0;          // CSV rows / ICS events, header and blank lines excluded
+    size_t added = 0;         // empty days that got a shift
+    size_t overwritten = 0;   // shifts replaced by another one
+    size_t skipped = 0;       // kept days, unchanged days, rows without a shift, repeated days
+    size_t rejected = 0;      // malformed rows (first ones in parse.errors)
+    TextParseReport parse;
+};
+
+// CSV: a header names the columns (datum, smjena, radnik; export_format.h
+// adds ime, pocetak, kraj, which are ignored), without one they are date,
+// shift[, employee]. Separator ',' or ';', RFC 4180 quotes. Dates are
+// YYYY-MM-DD or DD.MM.YYYY, shifts D/N/S, 1-3 or a word starting with
+// them (Dnevna, Nocna, Slobodan); empty or "-" means no shift.
+// ICS: one record per VEVENT on its DTSTART day, the shift from SUMMARY
+// (dnevn / nocn / slobod) or else from the start time.
+// Appends the records to out; returns the number appended.
+size_t ReadImport(FILE* f, ImportFormat format, const ImportOptions& opt, std::vector<ShiftRecord>& out,
+                  ImportReport& report);
+size_t ParseImport(const char* data, size_t len, ImportFormat format, const ImportOptions& opt,
+                   std::vector<ShiftRecord>& out, ImportReport& report);
+
+// Writes the records with opt.mode; the last row of a day wins. Sorts
+// records. Fills the counters of report.
+void ApplyImport(Roster& roster, std::vector<ShiftRecord>& records, const ImportOptions& opt, ImportReport& report);
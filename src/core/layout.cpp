@@ -0,0 +1,138 @@
+// ============================================================================
+//  LAYOUT
+// ============================================================================
+
+#include "layout.h"
+
+// Header row: arrows on the left, the rest right-aligned
+static const int BTN_Y = 16, BTN_H = 42;
+
+CalendarLayout ComputeLayout(int width, int height, int viewMonth, int viewYear) {
+    CalendarLayout l;
+    l.width = width;
+    l.height = height;
+    l.header = MakeRect(0, 0, width, HEADER_H + 1);
+
+    int pX = 15, pW = 42;
+    l.buttons[BTN_PREV] = MakeRect(pX, BTN_Y, pW, BTN_H);
+    int nX = pX + pW + 6, nW = 42;
+    l.buttons[BTN_NEXT] = MakeRect(nX, BTN_Y, nW, BTN_H);
+    int rsW = 60, rsX = width - rsW - 15;
+    l.buttons[BTN_RESET] = MakeRect(rsX, BTN_Y, rsW, BTN_H);
+    int clW = 65, clX = rsX - clW - 6;
+    l.buttons[BTN_CLEAR_MONTH] = MakeRect(clX, BTN_Y, clW, BTN_H);
+    int cpW = 80, cpX = clX - cpW - 8;
+    l.buttons[BTN_COPY] = MakeRect(cpX, BTN_Y, cpW, BTN_H);
+    int roW = 80, roX = cpX - roW - 8;
+    l.buttons[BTN_ROTATION] = MakeRect(roX, BTN_Y, roW, BTN_H);
+    int dW = 72, dX = roX - dW - 8;
+    l.buttons[BTN_TODAY] = MakeRect(dX, BTN_Y, dW, BTN_H);
+    int ovW = 72, ovX = dX - ovW - 8;
+    l.buttons[BTN_OVERVIEW] = MakeRect(ovX, BTN_Y, ovW, BTN_H);
+    l.title = MakeRect(nX + nW + 10, BTN_Y, ovX - 10 - nX - nW - 10, BTN_H);
+
+    int dnTop = HEADER_H + 5;
+    l.cellW = (width - 20) / 7;
+    l.gridLeft = (width - l.cellW * 7) / 2;
+    l.dayNames = MakeRect(l.gridLeft, dnTop, l.cellW * 7, DAYNAMES_H + 1);
+
+    l.gridTop = dnTop + DAYNAMES_H + 4;
+    l.gridBottom = height - LEGEND_H - STATS_H;
+    l.cellH = (l.gridBottom - l.gridTop) / 6;
+    l.grid = MakeMonthGrid(viewMonth, viewYear);
+
+    int stTop = l.gridBottom + 2;
+    l.stats = MakeRect(l.gridLeft, stTop, l.cellW * 7, STATS_H + 1);
+    l.legend = MakeRect(0, stTop + STATS_H + 1, width, height - (stTop + STATS_H + 1));
+    return l;
+}
+
+int CalendarLayout::HitDay(int x, int y) const {
+    if (y < gridTop || x < gridLeft || cellW == 0 || cellH == 0) return -1;
+    int col = (x - gridLeft) / cellW, row = (y - gridTop) / cellH;
+    if (col < 0 || col > 6 || row < 0 || row > 5) return -1;
+    int day = grid.DayAt(row, col);
+    return day ? day : -1;
+}
+
+int CalendarLayout::HitButton(int x, int y, unsigned mask) const {
+    for (int i = 0; i < BTN_COUNT; i++)
+        if ((mask >> i & 1) && buttons[i].Contains(x, y)) return i;
+    return -1;
+}
+
+// Anti-aliased edges may touch the pixel next to a rect
+static LayoutRect Inflate(LayoutRect r, int n) {
+    r.left -= n; r.top -= n; r.right += n; r.bottom += n;
+    return r;
+}
+
+static LayoutRect Union(const LayoutRect& a, const LayoutRect& b) {
+    LayoutRect r;
+    r.left = a.left < b.left ? a.left : b.left;
+    r.top = a.top < b.top ? a.top : b.top;
+    r.right = a.right > b.right ? a.right : b.right;
+    r.bottom = a.bottom > b.bottom ? a.bottom : b.bottom;
+    return r;
+}
+
+void DirtyRects::Add(const LayoutRect& r) {
+    if (full || r.Empty()) return;
+    LayoutRect u = r;
+    // Absorb the rects whose union with the new one costs no extra area
+    // (contained or side by side), repeatedly, since the union grows
+    for (int i = 0; i < count; ) {
+        if (Union(u, rects[i]).Area() <= u.Area() + rects[i].Area()) {
+            u = Union(u, rects[i]);
+            rects[i] = rects[--count];
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+    if (count == MAX) { full = true; count = 0; return; }
+    rects[count++] = u;
+}
+
+int DirtyRects::Area(int width, int height) const {
+    if (full) return width * height;
+    int a = 0;
+    for (int i = 0; i < count; i++) a += rects[i].Area();
+    return a;
+}
+
+DirtyRects DiffUi(const CalendarLayout& layout, const UiState& before, const UiState& after) {
+    DirtyRects d;
+    if (before.width != after.width || before.height != after.height || before.viewMode != after.viewMode ||
+        before.viewMonth != after.viewMonth || before.viewYear != after.viewYear ||
+        before.today != after.today) {
+        d.full = true;
+        return d;
+    }
+    if (before.hoverDay != after.hoverDay) {
+        if (before.hoverDay > 0) d.Add(Inflate(layout.Cell(before.hoverDay), 1));
+        if (after.hoverDay > 0) d.Add(Inflate(layout.Cell(after.hoverDay), 1));
+    }
+    if (before.hoverBtn != after.hoverBtn) {
+        if (before.hoverBtn >= 0) d.Add(Inflate(layout.buttons[before.hoverBtn], 1));
+        if (after.hoverBtn >= 0) d.Add(Inflate(layout.buttons[after.hoverBtn], 1));
+    }
+    return d;
+}
+
+DirtyRects DirtyForDays(const CalendarLayout& layout, int32_t from, int32_t to) {
+    DirtyRects d;
+    int32_t first = layout.grid.first, last = layout.grid.first + layout.grid.days - 1;
+    if (from < first) from = first;
+    if (to > last) to = last;
+    if (from > to) return d;
+    if (to - from + 1 > DirtyRects::MAX - 2) {
+        // Many days: the rows they span
+        LayoutRect a = layout.Cell(from - first + 1), b = layout.Cell(to - first + 1);
+        d.Add(Inflate(MakeRect(layout.gridLeft, a.top, layout.cellW * 7, b.bottom - a.top), 1));
+    } else {
+        for (int32_t z = from; z <= to; z++) d.Add(Inflate(layout.Cell(z - first + 1), 1));
+    }
+    d.Add(layout.stats);
+    return d;
+}
@@ -0,0 +1,109 @@
+// ============================================================================
+//  LAYOUT - every rect of the month view, computed from the window size and
+//  the viewed month only (no windows.h), plus the dirty rects between two
+//  UI states so the window repaints just what changed
+// ============================================================================
+
+#pragma once
+
+#include <cstdint>
+#include "calendar.h"
+
+static const int HEADER_H    = 75;
+static const int DAYNAMES_H  = 38;
+static const int LEGEND_H    = 65;
+static const int STATS_H     = 38;
+static const int CELL_PAD    = 3;
+
+// Same fields and meaning as a Win32 RECT (right/bottom exclusive)
+struct LayoutRect {
+    int left = 0, top = 0, right = 0, bottom = 0;
+
+    bool Empty() const { return right <= left || bottom <= top; }
+    bool Contains(int x, int y) const { return x >= left && x < right && y >= top && y < bottom; }
+    bool Intersects(const LayoutRect& o) const {
+        return left < o.right && o.left < right && top < o.bottom && o.top < bottom;
+    }
+    int  Area() const { return Empty() ? 0 : (right - left) * (bottom - top); }
+};
+
+inline LayoutRect MakeRect(int x, int y, int w, int h) {
+    LayoutRect r;
+    r.left = x; r.top = y; r.right = x + w; r.bottom = y + h;
+    return r;
+}
+
+// Header buttons; the values are the hover/hit-test indices
+enum UiButton {
+    BTN_PREV, BTN_NEXT, BTN_TODAY, BTN_COPY, BTN_CLEAR_MONTH, BTN_RESET, BTN_ROTATION, BTN_OVERVIEW,
+    BTN_COUNT
+};
+
+// Month view, or the overview of one year / five years ("Pregled")
+enum ViewMode { VIEW_MONTH, VIEW_YEAR, VIEW_YEARS5, VIEW_MODES };
+
+struct CalendarLayout {
+    int        width = 0, height = 0;
+    LayoutRect buttons[BTN_COUNT];
+    LayoutRect header;        // background band behind the buttons
+    LayoutRect title;         // "Mjesec YYYY" between the arrows and Pregled
+    LayoutRect dayNames;
+    int        gridLeft = 0, gridTop = 0, cellW = 0, cellH = 0;
+    int        gridBottom = 0;
+    LayoutRect stats;         // month totals line, separator included
+    LayoutRect legend;        // legend and hint, to the bottom of the window
+    MonthGrid  grid = {};
+
+    // Whole cell of a day of the viewed month (the painted box is inset by CELL_PAD)
+    LayoutRect Cell(int day) const {
+        return MakeRect(gridLeft + grid.Col(day) * cellW, gridTop + grid.Row(day) * cellH, cellW, cellH);
+    }
+    // Day of month under the point, -1 when none
+    int HitDay(int x, int y) const;
+    // UiButton of mask (ModeButtons) under the point, -1 when none
+    int HitButton(int x, int y, unsigned mask = ~0u) const;
+};
+
+CalendarLayout ComputeLayout(int width, int height, int viewMonth, int viewYear);
+
+// What the month view depends on, besides the shift data
+struct UiState {
+    int width = 0, height = 0;
+    int viewMode = VIEW_MONTH;
+    int viewMonth = 0, viewYear = 0;
+    int32_t today = 0;
+    int hoverDay = -1, hoverBtn = -1;
+};
+
+inline bool SameUi(const UiState& a, const UiState& b) {
+    return a.width == b.width && a.height == b.height && a.viewMode == b.viewMode && a.viewMonth == b.viewMonth
+        && a.viewYear == b.viewYear && a.today == b.today && a.hoverDay == b.hoverDay && a.hoverBtn == b.hoverBtn;
+}
+
+// Bit mask (1 << UiButton) of the header buttons a mode shows and hit-tests
+inline unsigned ModeButtons(int viewMode) {
+    return viewMode == VIEW_MONTH ? (1u << BTN_COUNT) - 1
+         : (1u << BTN_PREV) | (1u << BTN_NEXT) | (1u << BTN_TODAY) | (1u << BTN_OVERVIEW);
+}
+
+// Rects to repaint; full = the whole client area
+struct DirtyRects {
+    static const int MAX = 8;
+    bool       full = false;
+    int        count = 0;
+    LayoutRect rects[MAX];
+
+    // Overlapping rects merge; past MAX everything collapses into full
+    void Add(const LayoutRect& r);
+    bool None() const { return !full && count == 0; }
+    int  Area(int width, int height) const;
+};
+
+// Minimal repaint between two UI states drawn with layout (the layout of
+// `after`): a hover change touches two cells or two buttons, a new size,
+// mode, month or today repaints everything.
+DirtyRects DiffUi(const CalendarLayout& layout, const UiState& before, const UiState& after);
+
+// Repaint after the shifts of the inclusive day range changed: their cells
+// in the viewed month and the month totals.
+DirtyRects DirtyForDays(const CalendarLayout& layout, int32_t from, int32_t to);
@@ -0,0 +1,33 @@
+// ============================================================================
+//  MAPPED FILE - read-only memory mapping (CreateFileMapping / mmap)
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "file_util.h"
+
+class MappedFile {
+public:
+    MappedFile() {}
+    ~MappedFile() { Close(); }
+
+    bool Open(const PathString& path);
+    void Close();
+
+    bool           IsOpen() const { return m_data != nullptr; }
+    const uint8_t* Data() const { return m_data; }
+    size_t         Size() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t         m_size = 0;
+#ifdef _WIN32
+    void*          m_file = nullptr;
+    void*          m_mapping = nullptr;
+#endif
+
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+};
@@ -0,0 +1,171 @@
+// ============================================================================
+//  MONTH VIEW
+// ============================================================================
+
+#include "month_view.h"
+#include <cstdio>
+
+const char16_t* const MONTH_NAMES[12] = {
+    u"Januar", u"Februar", u"Mart", u"April",
+    u"Maj", u"Juni", u"Juli", u"August",
+    u"Septembar", u"Oktobar", u"Novembar", u"Decembar"
+};
+const char16_t* const DAY_NAMES[7] = {
+    u"PON", u"UTO", u"SRI", u"CET", u"PET", u"SUB", u"NED"
+};
+
+static const char16_t* const SHIFT_LABELS[4] = {
+    u"", u"\x2600 DNEVNA", u"\x263E NOCNA", u"\x2714 SLOBODAN"
+};
+static const DlColor SHIFT_COLORS[4] = { CLR_TEXT, CLR_DAY_SHIFT, CLR_NIGHT_SHIFT, CLR_FREE_DAY };
+
+DlColor ShiftBackground(ShiftType st, bool hover) {
+    static const DlColor BG[4] = { CLR_CELL_BG, CLR_DAY_SHIFT_BG, CLR_NIGHT_SHIFT_BG, CLR_FREE_DAY_BG };
+    return st == SHIFT_NONE && hover ? CLR_CELL_HOVER : BG[st];
+}
+
+const char16_t* Widen(const char* s, char16_t* out, size_t n) {
+    size_t i = 0;
+    for (; s[i] && i + 1 < n; i++) out[i] = (char16_t)(unsigned char)s[i];
+    out[i] = 0;
+    return out;
+}
+
+static int Length(const char16_t* s) {
+    int n = 0;
+    while (s[n]) n++;
+    return n;
+}
+
+// Label of the overview button: the mode it switches to
+static const char16_t* const NEXT_MODE_LABELS[VIEW_MODES] = { u"Godina", u"5 godina", u"Mjesec" };
+
+void BuildHeader(const CalendarLayout& l, const UiState& ui, const char16_t* title, DisplayList& dl) {
+    const int W = l.width;
+    dl.Section("header");
+    dl.FillRect(0, 0, (float)W, (float)HEADER_H, CLR_HEADER);
+    dl.Line(0, (float)HEADER_H, (float)W, (float)HEADER_H, 1, CLR_SEPARATOR);
+
+    struct HeaderBtn { int id; const char16_t* text; DlFont font; DlColor normal, hover; };
+    static const HeaderBtn BUTTONS[] = {
+        { BTN_PREV,        u"\x25C0",  FONT_BUTTON,       CLR_BTN,            CLR_BTN_HOVER },
+        { BTN_NEXT,        u"\x25B6",  FONT_BUTTON,       CLR_BTN,            CLR_BTN_HOVER },
+        { BTN_RESET,       u"Reset",    FONT_BUTTON_SMALL, CLR_BTN_RESET,      CLR_BTN_RESET_HOVER },
+        { BTN_CLEAR_MONTH, u"Brisi",    FONT_BUTTON_SMALL, CLR_BTN_CLEARMONTH, CLR_BTN_CLEARMONTH_HOVER },
+        { BTN_COPY,        u"Kopiraj",  FONT_BUTTON_SMALL, CLR_BTN_COPY,       CLR_BTN_COPY_HOVER },
+        { BTN_ROTATION,    u"Rotacija", FONT_BUTTON_SMALL, CLR_BTN_ROTATION,   CLR_BTN_ROTATION_HOVER },
+        { BTN_TODAY,       u"DANAS",    FONT_BUTTON_SMALL, CLR_BTN,            CLR_BTN_HOVER },
+        { BTN_OVERVIEW,    nullptr,     FONT_BUTTON_SMALL, CLR_BTN_OVERVIEW,   CLR_BTN_OVERVIEW_HOVER },
+    };
+    const unsigned shown = ModeButtons(ui.viewMode);
+    for (const HeaderBtn& b : BUTTONS) {
+        if (!(shown >> b.id & 1)) continue;
+        const LayoutRect& r = l.buttons[b.id];
+        float x = (float)r.left, y = (float)r.top, w = (float)(r.right - r.left), h = (float)(r.bottom - r.top);
+        dl.FillRound(x, y, w, h, 8, ui.hoverBtn == b.id ? b.hover : b.normal);
+        dl.Text(b.font, b.text ? b.text : NEXT_MODE_LABELS[ui.viewMode], x, y, w, h, DL_CENTER, DL_CENTER, CLR_TEXT);
+    }
+    dl.Text(FONT_TITLE, title, (float)l.title.left, (float)l.title.top, (float)(l.title.right - l.title.left),
+            (float)(l.title.bottom - l.title.top), DL_CENTER, DL_CENTER, CLR_TEXT);
+}
+
+static void BuildCell(const CalendarLayout& l, const UiState& ui, int day, ShiftType st, bool violation, bool holiday,
+                      bool match, DisplayList& dl) {
+    LayoutRect cell = l.Cell(day);
+    float cx = (float)(cell.left + CELL_PAD), cy = (float)(cell.top + CELL_PAD);
+    float cw = (float)(l.cellW - CELL_PAD * 2), ch = (float)(l.cellH - CELL_PAD * 2);
+    bool isToday = l.grid.first + day - 1 == ui.today;
+    bool isWeekend = l.grid.Col(day) >= 5;
+
+    dl.FillRound(cx, cy, cw, ch, 8, ShiftBackground(st, day == ui.hoverDay));
+    if (isToday) dl.StrokeRound(cx, cy, cw, ch, 8, 2.5f, CLR_CELL_TODAY_BORDER);
+    if (violation) dl.StrokeRound(cx + 3, cy + 3, cw - 6, ch - 6, 6, 2, CLR_RULE_VIOLATION);
+    if (st != SHIFT_NONE) dl.FillRoundTop(cx, cy, cw, 5, 8, SHIFT_COLORS[st]);
+    if (match) dl.FillRound(cx + cw - 18, cy + ch - 18, 10, 10, 5, CLR_SEARCH_MATCH);
+
+    char buf[12];
+    char16_t num[12];
+    snprintf(buf, sizeof(buf), "%d", day);
+    DlColor numColor = isToday ? CLR_CELL_TODAY_BORDER : holiday ? CLR_TEXT_HOLIDAY : isWeekend ? CLR_TEXT_WEEKEND : CLR_TEXT;
+    dl.Text(FONT_CELL_DAY, Widen(buf, num, 12), cx + 8, cy + 8, cw - 16, 20, DL_NEAR, DL_NEAR, numColor);
+    if (isToday)
+        dl.Text(FONT_TODAY_TAG, u"DANAS", cx + 8, cy + 8, cw - 16, 18, DL_FAR, DL_NEAR, CLR_CELL_TODAY_BORDER);
+    if (st != SHIFT_NONE)
+        dl.Text(FONT_CELL_SHIFT, SHIFT_LABELS[st], cx, cy + ch * 0.35f, cw, ch * 0.55f, DL_CENTER, DL_CENTER,
+                SHIFT_COLORS[st]);
+}
+
+void BuildLegend(const CalendarLayout& l, const char16_t* hint, const TextMetrics& tm, DisplayList& dl) {
+    dl.Section("legend");
+    const int dotSz = 16, sp = 20;
+    int lCY = l.stats.bottom + 4 + (LEGEND_H - 10) / 2;
+    struct Item { DlColor c; const char16_t* t; };
+    static const Item ITEMS[] = { { CLR_DAY_SHIFT, u"Dnevna" }, { CLR_NIGHT_SHIFT, u"Nocna" }, { CLR_FREE_DAY, u"Slobodan" } };
+    float widths[3], total = -sp;
+    for (int i = 0; i < 3; i++) {
+        widths[i] = tm.Width(FONT_LEGEND, ITEMS[i].t, Length(ITEMS[i].t));
+        total += dotSz + 8 + (int)widths[i] + sp;
+    }
+    int lx = (l.width - (int)total) / 2;
+    for (int i = 0; i < 3; i++) {
+        dl.FillRound((float)lx, (float)(lCY - dotSz / 2), dotSz, dotSz, 4, ITEMS[i].c);
+        lx += dotSz + 8;
+        dl.Text(FONT_LEGEND, ITEMS[i].t, (float)lx, (float)(lCY - 10), widths[i], 20, DL_NEAR, DL_CENTER, CLR_TEXT_DIM);
+        lx += (int)widths[i] + sp;
+    }
+    dl.Text(FONT_HINT, hint, 0, (float)(lCY + dotSz / 2 + 6), (float)l.width, 20, DL_CENTER, DL_NEAR, CLR_TEXT_HINT);
+}
+
+void BuildMonthView(const CalendarLayout& l, const UiState& ui, const ShiftStore& shifts,
+                    const TextMetrics& metrics, DisplayList& dl, const MonthOverlay* overlay) {
+    dl.Clear();
+    dl.Section("background");
+    dl.GradientV(0, 0, (float)l.width, (float)l.height, CLR_BG_TOP, CLR_BG_BOT);
+    char buf[160];
+    char16_t text[160];
+    snprintf(buf, sizeof(buf), " %d", ui.viewYear);
+    int n = 0;
+    for (const char16_t* m = MONTH_NAMES[ui.viewMonth - 1]; *m; m++) text[n++] = *m;
+    Widen(buf, text + n, 160 - n);
+    BuildHeader(l, ui, text, dl);
+
+    // Day names and the line under them
+    dl.Section("grid");
+    const float gridW = (float)(l.cellW * 7);
+    for (int i = 0; i < 7; i++)
+        dl.Text(FONT_DAY_NAME, DAY_NAMES[i], (float)(l.gridLeft + i * l.cellW), (float)l.dayNames.top,
+                (float)l.cellW, (float)DAYNAMES_H, DL_CENTER, DL_CENTER, i >= 5 ? CLR_TEXT_WEEKEND : CLR_TEXT_DIM);
+    float sY = (float)(l.dayNames.top + DAYNAMES_H);
+    dl.Line((float)l.gridLeft, sY, l.gridLeft + gridW, sY, 1, CLR_GRID_LINE);
+
+    // One packed read for the whole month instead of a lookup per cell
+    uint64_t codes[2] = {};
+    shifts.ReadCodes(l.grid.first, l.grid.first + l.grid.days - 1, codes);
+    for (int day = 1; day <= l.grid.days; day++) {
+        int slot = day - 1;
+        ShiftType st = (ShiftType)((codes[slot / ShiftStore::SLOTS_PER_WORD] >> (2 * (slot % ShiftStore::SLOTS_PER_WORD))) & 3);
+        bool violation = overlay && (overlay->violations >> slot & 1);
+        bool holiday = overlay && (overlay->holidays >> slot & 1), match = overlay && (overlay->matches >> slot & 1);
+        BuildCell(l, ui, day, st, violation, holiday, match, dl);
+    }
+
+    // Month totals
+    dl.Section("stats");
+    ShiftCounts mc = shifts.CountMonth(ui.viewMonth, ui.viewYear);
+    if (overlay && overlay->hasHours) {
+        const PayTotals* hours = &overlay->hours;
+        snprintf(buf, sizeof(buf), "Ovaj mjesec:  Dnevnih: %d  |  Nocnih: %d  |  Slobodnih: %d  |  Radnih: %d  |  "
+                 "Sati: %d:%02d, nocu %d:%02d", mc.day, mc.night, mc.free, mc.Working(),
+                 hours->worked / 60, hours->worked % 60, hours->night / 60, hours->night % 60);
+    } else {
+        snprintf(buf, sizeof(buf), "Ovaj mjesec:   Dnevnih: %d   |   Nocnih: %d   |   Slobodnih: %d   |   Ukupno radnih: %d",
+                 mc.day, mc.night, mc.free, mc.Working());
+    }
+    float stTop = (float)l.stats.top;
+    dl.Text(FONT_STATS, Widen(buf, text, 160), (float)l.gridLeft, stTop, gridW, (float)STATS_H,
+            DL_CENTER, DL_CENTER, CLR_TEXT_DIM);
+    dl.Line((float)l.gridLeft, stTop + STATS_H, l.gridLeft + gridW, stTop + STATS_H, 1, CLR_GRID_LINE);
+
+    BuildLegend(l, u"Lijevi klik = postavi  |  Desni klik = obrisi  |  Scroll = mjesec  |  Pregled = godina / 5 godina  |  Ctrl+Z / Ctrl+Y = ponisti / vrati",
+                metrics, dl);
+}
@@ -0,0 +1,83 @@
+// ============================================================================
+//  MONTH VIEW - the calendar window as a display list: colors, strings and
+//  the drawing of header, day names, cells, totals and legend. Header and
+//  legend are shared with the overviews (overview_view.h).
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "display_list.h"
+#include "layout.h"
+#include "payroll.h"
+#include "shift_store.h"
+
+// ============================================================================
+//  COLORS
+// ============================================================================
+
+static const DlColor CLR_BG_TOP               = MakeColor(255, 12, 12, 28);
+static const DlColor CLR_BG_BOT               = MakeColor(255, 22, 22, 48);
+static const DlColor CLR_HEADER               = MakeColor(255, 18, 18, 40);
+static const DlColor CLR_CELL_BG              = MakeColor(255, 28, 30, 58);
+static const DlColor CLR_CELL_HOVER           = MakeColor(255, 40, 42, 75);
+static const DlColor CLR_CELL_TODAY_BORDER    = MakeColor(255, 100, 130, 255);
+static const DlColor CLR_TEXT                 = MakeColor(255, 210, 215, 235);
+static const DlColor CLR_TEXT_DIM             = MakeColor(255, 130, 135, 160);
+static const DlColor CLR_TEXT_WEEKEND         = MakeColor(255, 170, 140, 160);
+static const DlColor CLR_TEXT_HOLIDAY         = MakeColor(255, 240, 120, 140);
+static const DlColor CLR_TEXT_HINT            = MakeColor(255, 70, 72, 100);
+static const DlColor CLR_DAY_SHIFT            = MakeColor(255, 255, 160, 40);
+static const DlColor CLR_DAY_SHIFT_BG         = MakeColor(255, 60, 45, 15);
+static const DlColor CLR_NIGHT_SHIFT          = MakeColor(255, 80, 130, 255);
+static const DlColor CLR_NIGHT_SHIFT_BG       = MakeColor(255, 20, 28, 65);
+static const DlColor CLR_FREE_DAY             = MakeColor(255, 80, 200, 100);
+static const DlColor CLR_FREE_DAY_BG          = MakeColor(255, 18, 50, 25);
+static const DlColor CLR_BTN                  = MakeColor(255, 45, 48, 85);
+static const DlColor CLR_BTN_HOVER            = MakeColor(255, 65, 68, 110);
+static const DlColor CLR_BTN_COPY             = MakeColor(255, 55, 40, 90);
+static const DlColor CLR_BTN_COPY_HOVER       = MakeColor(255, 80, 55, 125);
+static const DlColor CLR_BTN_ROTATION         = MakeColor(255, 35, 60, 80);
+static const DlColor CLR_BTN_ROTATION_HOVER   = MakeColor(255, 45, 85, 110);
+static const DlColor CLR_BTN_CLEARMONTH       = MakeColor(255, 90, 30, 30);
+static const DlColor CLR_BTN_CLEARMONTH_HOVER = MakeColor(255, 120, 40, 40);
+static const DlColor CLR_BTN_OVERVIEW         = MakeColor(255, 40, 70, 70);
+static const DlColor CLR_BTN_OVERVIEW_HOVER   = MakeColor(255, 50, 95, 95);
+static const DlColor CLR_BTN_RESET            = MakeColor(255, 110, 20, 20);
+static const DlColor CLR_BTN_RESET_HOVER      = MakeColor(255, 150, 30, 30);
+static const DlColor CLR_SEPARATOR            = MakeColor(255, 50, 52, 80);
+static const DlColor CLR_GRID_LINE            = MakeColor(255, 35, 37, 65);
+static const DlColor CLR_RULE_VIOLATION       = MakeColor(255, 235, 70, 70);
+static const DlColor CLR_SEARCH_MATCH         = MakeColor(255, 250, 220, 60);
+
+// ============================================================================
+//  STRINGS
+// ============================================================================
+
+extern const char16_t* const MONTH_NAMES[12];
+extern const char16_t* const DAY_NAMES[7];
+
+// Cell background of a shift (the hover color only shows on empty days)
+DlColor ShiftBackground(ShiftType st, bool hover);
+
+// snprintf output (ASCII) as UTF-16; out holds n code units
+const char16_t* Widen(const char* s, char16_t* out, size_t n);
+
+// Background band, the buttons of ModeButtons(ui.viewMode) and the title
+void BuildHeader(const CalendarLayout& layout, const UiState& ui, const char16_t* title, DisplayList& out);
+// Shift color legend and a line of hints under it
+void BuildLegend(const CalendarLayout& layout, const char16_t* hint, const TextMetrics& metrics, DisplayList& out);
+
+// What the month view shows beside the shifts, when the caller tracks it
+struct MonthOverlay {
+    bool      hasHours = false;
+    PayTotals hours;              // the month's, for the totals line
+    uint32_t  violations = 0;     // bit d - 1: day d breaks a labour rule (framed red)
+    uint32_t  holidays = 0;       // bit d - 1: day d is a public holiday
+    uint32_t  matches = 0;        // bit d - 1: day d matches the search (yellow dot)
+};
+
+// Draws the whole window for the UI state into out (cleared first)
+void BuildMonthView(const CalendarLayout& layout, const UiState& ui, const ShiftStore& shifts,
+                    const TextMetrics& metrics, DisplayList& out, const MonthOverlay* overlay = nullptr);
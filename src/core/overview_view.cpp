@@ -0,0 +1,169 @@
+// ============================================================================
+//  OVERVIEW VIEW
+// ============================================================================
+
+#include "overview_view.h"
+#include <cstdio>
+#include "month_view.h"
+#include "shift_summary.h"
+
+static const int TILE_HEAD = 40;    // month name and totals above a tile's squares
+static const int YEAR_LABEL_W = 44;
+static const int STRIP_FOOT = 18;   // month totals under a year strip
+static const int MAX_WEEKS = 54;
+
+static const DlColor SQUARE_COLORS[4] = { CLR_CELL_BG, CLR_DAY_SHIFT, CLR_NIGHT_SHIFT, CLR_FREE_DAY };
+
+static int Min(int a, int b) { return a < b ? a : b; }
+
+// Monday of the week holding January 1st
+static int32_t FirstMonday(int y) {
+    int32_t jan1 = DaysFromCivil(y, 1, 1);
+    return jan1 - WeekdayFromDays(jan1);
+}
+
+OverviewLayout ComputeOverviewLayout(int width, int height, int mode, int viewYear) {
+    OverviewLayout l;
+    l.frame = ComputeLayout(width, height, 1, viewYear);
+    l.mode = mode;
+    l.area = MakeRect(10, HEADER_H + 8, width - 20, l.frame.legend.top - 4 - (HEADER_H + 8));
+    const int aw = l.area.right - l.area.left, ah = l.area.bottom - l.area.top;
+    if (mode == VIEW_YEARS5) {
+        l.firstYear = viewYear - 2;
+        l.years = 5;
+        int stripH = ah / 5;
+        l.square = Min((aw - YEAR_LABEL_W) / MAX_WEEKS, (stripH - STRIP_FOOT) / 7);
+        for (int k = 0; k < 5; k++) l.strips[k] = MakeRect(l.area.left, l.area.top + k * stripH, aw, stripH);
+        if (l.square < 2) l.square = 2;
+        // Centered: the label and 54 week columns
+        l.stripLeft = l.area.left + YEAR_LABEL_W + (aw - YEAR_LABEL_W - MAX_WEEKS * l.square) / 2;
+    } else {
+        l.firstYear = viewYear;
+        l.years = 1;
+        int tileW = aw / 4, tileH = ah / 3;
+        l.square = Min((tileW - 16) / 7, (tileH - TILE_HEAD - 4) / 6);
+        for (int i = 0; i < 12; i++)
+            l.tiles[i] = MakeRect(l.area.left + (i % 4) * tileW, l.area.top + (i / 4) * tileH, tileW, tileH);
+    }
+    if (l.square < 2) l.square = 2;
+    return l;
+}
+
+LayoutRect OverviewLayout::DayRect(int32_t day) const {
+    if (day < FirstDay() || day > LastDay()) return LayoutRect();
+    CivilDate c = CivilFromDays(day);
+    const int sq = square;
+    if (mode == VIEW_YEARS5) {
+        const LayoutRect& s = strips[c.y - firstYear];
+        int col = (day - FirstMonday(c.y)) / 7, row = WeekdayFromDays(day);
+        return MakeRect(stripLeft + col * sq, s.top + row * sq, sq - 2, sq - 2);
+    }
+    const LayoutRect& t = tiles[c.m - 1];
+    MonthGrid g = MakeMonthGrid(c.m, c.y);
+    int left = t.left + (t.right - t.left - 7 * sq) / 2;
+    return MakeRect(left + g.Col(c.d) * sq, t.top + TILE_HEAD + g.Row(c.d) * sq, sq - 2, sq - 2);
+}
+
+int32_t OverviewLayout::HitDay(int x, int y) const {
+    const int sq = square;
+    if (mode == VIEW_YEARS5) {
+        for (int k = 0; k < years; k++) {
+            if (!strips[k].Contains(x, y) || x < stripLeft || y >= strips[k].top + 7 * sq) continue;
+            int32_t day = FirstMonday(firstYear + k) + (x - stripLeft) / sq * 7 + (y - strips[k].top) / sq;
+            return CivilFromDays(day).y == firstYear + k ? day : -1;
+        }
+        return -1;
+    }
+    for (int i = 0; i < 12; i++) {
+        if (!tiles[i].Contains(x, y)) continue;
+        // Anywhere on a tile opens its month; on a square, that day
+        MonthGrid g = MakeMonthGrid(i + 1, firstYear);
+        int left = tiles[i].left + (tiles[i].right - tiles[i].left - 7 * sq) / 2, top = tiles[i].top + TILE_HEAD;
+        int d = (x >= left && y >= top) ? g.DayAt((y - top) / sq, (x - left) / sq) : 0;
+        return g.first + (d ? d - 1 : 0);
+    }
+    return -1;
+}
+
+static void Square(const OverviewLayout& l, const UiState& ui, int32_t day, ShiftType st, DisplayList& dl) {
+    LayoutRect r = l.DayRect(day);
+    float x = (float)r.left, y = (float)r.top, s = (float)(r.right - r.left);
+    dl.FillRect(x, y, s, s, SQUARE_COLORS[st]);
+    if (day == ui.today) dl.StrokeRound(x - 1, y - 1, s + 2, s + 2, 2, 1.5f, CLR_CELL_TODAY_BORDER);
+}
+
+static void BuildYear(const OverviewLayout& l, const UiState& ui, const ShiftStore& shifts, DisplayList& dl) {
+    MonthSummary months[12];
+    SummarizeMonths(shifts, 1, l.firstYear, 12, months);
+    char buf[64];
+    char16_t text[64];
+    for (int i = 0; i < 12; i++) {
+        const MonthSummary& ms = months[i];
+        const LayoutRect& t = l.tiles[i];
+        float x = (float)(t.left + 8), w = (float)(t.right - t.left - 16);
+        dl.Text(FONT_DAY_NAME, MONTH_NAMES[i], x, (float)t.top, w, 20, DL_NEAR, DL_CENTER, CLR_TEXT);
+        snprintf(buf, sizeof(buf), "D %d  N %d  S %d", ms.counts.day, ms.counts.night, ms.counts.free);
+        dl.Text(FONT_CELL_SHIFT, Widen(buf, text, 64), x, (float)t.top, w, 20, DL_FAR, DL_CENTER, CLR_TEXT_DIM);
+        for (int d = 1; d <= ms.days; d++) Square(l, ui, ms.first + d - 1, ms.Day(d), dl);
+    }
+}
+
+static void BuildYears(const OverviewLayout& l, const UiState& ui, const ShiftStore& shifts, DisplayList& dl) {
+    static const char16_t* const SHORT[12] = {
+        u"Jan", u"Feb", u"Mar", u"Apr", u"Maj", u"Jun", u"Jul", u"Aug", u"Sep", u"Okt", u"Nov", u"Dec"
+    };
+    MonthSummary months[12];
+    WeekSummary weeks[MAX_WEEKS];
+    char buf[32];
+    char16_t text[32];
+    const int sq = l.square;
+    for (int k = 0; k < l.years; k++) {
+        const int y = l.firstYear + k;
+        const LayoutRect& s = l.strips[k];
+        snprintf(buf, sizeof(buf), "%d", y);
+        dl.Text(FONT_DAY_NAME, Widen(buf, text, 32), (float)(l.stripLeft - YEAR_LABEL_W), (float)s.top,
+                YEAR_LABEL_W, (float)(7 * sq), DL_NEAR, DL_CENTER, CLR_TEXT);
+
+        // Squares from the week blocks, days of the neighbouring years left out
+        const int32_t monday = FirstMonday(y), jan1 = DaysFromCivil(y, 1, 1), dec31 = DaysFromCivil(y + 1, 1, 1) - 1;
+        const int count = (dec31 - monday) / 7 + 1;
+        SummarizeWeeks(shifts, monday, count, weeks);
+        for (int w = 0; w < count; w++)
+            for (int i = 0; i < 7; i++) {
+                int32_t day = weeks[w].monday + i;
+                if (day >= jan1 && day <= dec31) Square(l, ui, day, weeks[w].Day(i), dl);
+            }
+
+        // Month totals (working days) under the column of each month's 1st
+        SummarizeMonths(shifts, 1, y, 12, months);
+        float ty = (float)(s.top + 7 * sq + 2);
+        for (int m = 0; m < 12; m++) {
+            int x = l.stripLeft + (months[m].first - monday) / 7 * sq;
+            int next = m < 11 ? l.stripLeft + (months[m + 1].first - monday) / 7 * sq : l.stripLeft + MAX_WEEKS * sq;
+            snprintf(buf, sizeof(buf), " %d", months[m].counts.Working());
+            int n = 0;
+            for (const char16_t* c = SHORT[m]; *c; c++) text[n++] = *c;
+            Widen(buf, text + n, 32 - n);
+            dl.Text(FONT_CELL_SHIFT, text, (float)x, ty, (float)(next - x), (float)(STRIP_FOOT - 2),
+                    DL_NEAR, DL_CENTER, CLR_TEXT_DIM);
+        }
+    }
+}
+
+void BuildOverview(const OverviewLayout& l, const UiState& ui, const ShiftStore& shifts,
+                   const TextMetrics& metrics, DisplayList& dl) {
+    dl.Clear();
+    dl.Section("background");
+    dl.GradientV(0, 0, (float)l.frame.width, (float)l.frame.height, CLR_BG_TOP, CLR_BG_BOT);
+    char buf[32];
+    char16_t title[32];
+    if (l.years == 1) snprintf(buf, sizeof(buf), "%d", l.firstYear);
+    else snprintf(buf, sizeof(buf), "%d - %d", l.firstYear, l.firstYear + l.years - 1);
+    BuildHeader(l.frame, ui, Widen(buf, title, 32), dl);
+
+    dl.Section("grid");
+    if (l.mode == VIEW_YEARS5) BuildYears(l, ui, shifts, dl);
+    else BuildYear(l, ui, shifts, dl);
+
+    BuildLegend(l.frame, u"Klik = otvori mjesec  |  Scroll / strelice = godina  |  Esc = mjesec", metrics, dl);
+}
@@ -0,0 +1,41 @@
+// ============================================================================
+//  OVERVIEW VIEW - heat map of one year (12 month tiles) or five years (a
+//  strip of week columns per year), one colored square per day plus month
+//  totals. Built from shift_summary.h blocks, not per-day lookups.
+// ============================================================================
+
+#pragma once
+
+#include <cstdint>
+#include "display_list.h"
+#include "layout.h"
+#include "shift_store.h"
+
+struct OverviewLayout {
+    CalendarLayout frame;        // header, buttons and legend, as in the month view
+    int        mode = VIEW_YEAR;
+    int        firstYear = 0, years = 0;
+    LayoutRect area;             // between the header and the legend
+    int        square = 0;       // day square side, gap included
+
+    // VIEW_YEAR: month tiles, 4 x 3
+    LayoutRect tiles[12];
+    // VIEW_YEARS5: one row per year; week columns start at the Monday of
+    // the week of January 1st, left of them the year label
+    LayoutRect strips[5];
+    int        stripLeft = 0;
+
+    // Days shown: firstYear-01-01 .. the last shown year's 12-31
+    int32_t FirstDay() const { return DaysFromCivil(firstYear, 1, 1); }
+    int32_t LastDay() const { return DaysFromCivil(firstYear + years, 1, 1) - 1; }
+    // Square of a shown day (without the gap)
+    LayoutRect DayRect(int32_t day) const;
+    // Day under the point, -1 when none
+    int32_t HitDay(int x, int y) const;
+};
+
+// VIEW_YEAR shows viewYear, VIEW_YEARS5 viewYear - 2 .. viewYear + 2
+OverviewLayout ComputeOverviewLayout(int width, int height, int mode, int viewYear);
+
+void BuildOverview(const OverviewLayout& layout, const UiState& ui, const ShiftStore& shifts,
+                   const TextMetrics& metrics, DisplayList& out);
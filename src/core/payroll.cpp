@@ -0,0 +1,199 @@
+// ============================================================================
+//  PAYROLL
+// ============================================================================
+
+#include "payroll.h"
+#include <algorithm>
+#include <thread>
+
+static bool IsNightMinute(int minute, int start, int end) {
+    return start > end ? (minute >= start || minute < end) : (minute >= start && minute < end);
+}
+
+PayTable::PayTable(const PayrollModel& model) : m_holidays(model.holidays), m_weekLimit(model.weekLimit) {
+    for (int st = 0; st < 4; st++) {
+        const ShiftTimes& t = model.times[st];
+        bool hours = st != SHIFT_NONE && t.start != ALL_DAY && t.end != ALL_DAY;
+        int start = t.start, end = t.end <= t.start ? t.end + 1440 : t.end;
+        for (int wd = 0; wd < 7; wd++) {
+            for (int h = 0; h < 4; h++) {
+                PayTotals p;
+                // Minute by minute: a table of 112 entries, built once
+                for (int minute = start; hours && minute < end; minute++) {
+                    int next = minute >= 1440;   // past midnight: the next day
+                    p.worked++;
+                    if (IsNightMinute(minute % 1440, model.nightStart, model.nightEnd)) p.night++;
+                    if ((wd + next) % 7 >= 5) p.weekend++;
+                    if (h >> next & 1) p.holiday++;
+                }
+                p.worked = std::max(0, p.worked - (hours ? model.breaks[st] : 0));
+                m_day[st][wd][h] = p;
+            }
+        }
+    }
+}
+
+PayTotals PayTable::Sum(const ShiftStore& s, int32_t from, int32_t to) const {
+    PayTotals sum;
+    if (to < from || to - from >= MAX_RANGE) return sum;
+    // Thursdays in range; their weeks may reach 3 days past either end
+    int32_t firstThu = from + (3 - WeekdayFromDays(from) + 7) % 7;
+    int32_t lastThu = to - (WeekdayFromDays(to) - 3 + 7) % 7;
+    int32_t lo = std::min(from, firstThu - 3), hi = std::max(to, lastThu + 3);
+    uint64_t codes[(MAX_RANGE + 6) / ShiftStore::SLOTS_PER_WORD + 1];
+    s.ReadCodes(lo, hi, codes);
+
+    int32_t weekWorked = 0;
+    for (int32_t z = lo; z <= hi; z++) {
+        int slot = z - lo;
+        ShiftType st = (ShiftType)((codes[slot / ShiftStore::SLOTS_PER_WORD] >> (2 * (slot % ShiftStore::SLOTS_PER_WORD))) & 3);
+        PayTotals d = st == SHIFT_NONE ? PayTotals() : Day(st, z);
+        if (z >= from && z <= to) sum += d;
+        if (z >= firstThu - 3 && z <= lastThu + 3) {
+            weekWorked += d.worked;
+            if (WeekdayFromDays(z) == 6) {
+                sum.overtime += std::max(0, weekWorked - m_weekLimit);
+                weekWorked = 0;
+            }
+        }
+    }
+    return sum;
+}
+
+// ============================================================================
+//  LEDGER
+// ============================================================================
+
+void PayrollLedger::Attach(ShiftStore& store) {
+    Detach();
+    m_store = &store;
+    m_store->AddObserver(this);
+}
+
+void PayrollLedger::Detach() {
+    if (!m_store) return;
+    m_store->RemoveObserver(this);
+    m_store = nullptr;
+    m_months.clear();
+    m_weeks.clear();
+}
+
+void PayrollLedger::SetModel(const PayrollModel& model) {
+    m_table = PayTable(model);
+    m_months.clear();
+    m_weeks.clear();
+}
+
+// Totals of [from, to] without overtime, from the cache or the store
+PayTotals PayrollLedger::Linear(std::unordered_map<int32_t, PayTotals>& cache, int32_t key, int32_t from, int32_t to) {
+    auto it = cache.find(key);
+    if (it != cache.end()) return it->second;
+    PayTotals t;
+    if (m_store) {
+        uint64_t codes[2];   // a month at most
+        m_store->ReadCodes(from, to, codes);
+        for (int32_t z = from; z <= to; z++) {
+            int slot = z - from;
+            ShiftType st = (ShiftType)((codes[slot / ShiftStore::SLOTS_PER_WORD] >> (2 * (slot % ShiftStore::SLOTS_PER_WORD))) & 3);
+            if (st != SHIFT_NONE) t += m_table.Day(st, z);
+        }
+    }
+    m_recomputes++;
+    cache.emplace(key, t);
+    return t;
+}
+
+PayTotals PayrollLedger::Week(int32_t day) {
+    int32_t monday = day - WeekdayFromDays(day);
+    PayTotals t = Linear(m_weeks, monday, monday, monday + 6);
+    t.overtime = std::max(0, t.worked - m_table.WeekLimit());
+    return t;
+}
+
+PayTotals PayrollLedger::Month(int m, int y) {
+    int32_t first = MonthStart(m, y), last = first + DaysInMonth(m, y) - 1;
+    PayTotals t = Linear(m_months, y * 12 + m - 1, first, last);
+    for (int32_t thu = first + (3 - WeekdayFromDays(first) + 7) % 7; thu <= last; thu += 7)
+        t.overtime += Week(thu).overtime;
+    return t;
+}
+
+PayTotals PayrollLedger::Year(int y) {
+    PayTotals t;
+    for (int m = 1; m <= 12; m++) t += Month(m, y);
+    return t;
+}
+
+// Adds (sign 1) or removes (-1) a shift in the cached totals
+void PayrollLedger::Adjust(int32_t day, ShiftType st, int sign) {
+    if (st == SHIFT_NONE) return;
+    PayTotals d = m_table.Day(st, day);
+    CivilDate c = CivilFromDays(day);
+    auto month = m_months.find(c.y * 12 + c.m - 1);
+    auto week = m_weeks.find(day - WeekdayFromDays(day));
+    if (sign > 0) {
+        if (month != m_months.end()) month->second += d;
+        if (week != m_weeks.end()) week->second += d;
+    } else {
+        if (month != m_months.end()) month->second -= d;
+        if (week != m_weeks.end()) week->second -= d;
+    }
+}
+
+// Forgets the cached months and weeks overlapping [from, to]
+void PayrollLedger::Drop(int32_t from, int32_t to) {
+    for (auto it = m_months.begin(); it != m_months.end(); ) {
+        int m = it->first % 12 + 1, y = it->first / 12;
+        int32_t first = MonthStart(m, y);
+        if (first <= to && first + DaysInMonth(m, y) - 1 >= from) it = m_months.erase(it);
+        else ++it;
+    }
+    for (auto it = m_weeks.begin(); it != m_weeks.end(); ) {
+        if (it->first <= to && it->first + 6 >= from) it = m_weeks.erase(it);
+        else ++it;
+    }
+}
+
+void PayrollLedger::OnShiftsChanging(int32_t from, int32_t to) {
+    m_pendingTo = m_pendingFrom - 1;
+    if (m_months.empty() && m_weeks.empty()) return;
+    if (to - from >= MAX_DELTA_DAYS) { Drop(from, to); return; }
+    m_store->ReadCodes(from, to, m_pending);
+    m_pendingFrom = from;
+    m_pendingTo = to;
+}
+
+void PayrollLedger::OnShiftsChanged(int32_t from, int32_t to) {
+    if (from != m_pendingFrom || to != m_pendingTo) return;
+    m_pendingTo = m_pendingFrom - 1;
+    uint64_t now[MAX_DELTA_DAYS / ShiftStore::SLOTS_PER_WORD];
+    m_store->ReadCodes(from, to, now);
+    for (int32_t z = from; z <= to; z++) {
+        int slot = z - from, k = slot / ShiftStore::SLOTS_PER_WORD, shift = 2 * (slot % ShiftStore::SLOTS_PER_WORD);
+        ShiftType was = (ShiftType)((m_pending[k] >> shift) & 3), is = (ShiftType)((now[k] >> shift) & 3);
+        if (was == is) continue;
+        Adjust(z, was, -1);
+        Adjust(z, is, 1);
+    }
+}
+
+// ============================================================================
+//  TEAM
+// ============================================================================
+
+void PayrollYear(const Roster& roster, int y, const PayTable& table, std::vector<PayTotals>& out, unsigned threads) {
+    out.assign(roster.Size(), PayTotals());
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    // Below a few hundred employees a thread costs more than it saves
+    threads = (unsigned)std::min<size_t>(threads, roster.Size() / 256 + 1);
+    const int32_t jan1 = DaysFromCivil(y, 1, 1), dec31 = DaysFromCivil(y + 1, 1, 1) - 1;
+    auto run = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) out[i] = table.Sum(roster.Shifts(i), jan1, dec31);
+    };
+    std::vector<std::thread> pool;
+    size_t chunk = (roster.Size() + threads - 1) / threads;
+    for (unsigned t = 1; t < threads; t++)
+        pool.emplace_back(run, std::min(roster.Size(), t * chunk), std::min(roster.Size(), (t + 1) * chunk));
+    run(0, std::min(roster.Size(), chunk));
+    for (std::thread& th : pool) th.join();
+}
@@ -0,0 +1,125 @@
+// ============================================================================
+//  PAYROLL - working hours of the shifts: duration from the shift times
+//  (a night shift runs past midnight), night / weekend / holiday minutes
+//  and overtime over a weekly limit. PayrollLedger keeps month and ISO
+//  week totals of one store up to date edit by edit; PayrollYear() sums a
+//  whole team's year across threads.
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "export_format.h"
+#include "holidays.h"
+#include "roster.h"
+#include "shift_store.h"
+
+// Minutes; a shift counts toward the day it starts on, its premiums toward
+// the calendar day each minute falls on. Overtime is only set in week,
+// month and year totals.
+struct PayTotals {
+    int32_t worked = 0, night = 0, weekend = 0, holiday = 0, overtime = 0;
+
+    PayTotals& operator+=(const PayTotals& o) {
+        worked += o.worked; night += o.night; weekend += o.weekend; holiday += o.holiday; overtime += o.overtime;
+        return *this;
+    }
+    PayTotals& operator-=(const PayTotals& o) {
+        worked -= o.worked; night -= o.night; weekend -= o.weekend; holiday -= o.holiday; overtime -= o.overtime;
+        return *this;
+    }
+    bool operator==(const PayTotals& o) const {
+        return worked == o.worked && night == o.night && weekend == o.weekend && holiday == o.holiday &&
+               overtime == o.overtime;
+    }
+};
+
+struct PayrollModel {
+    // Per ShiftType, as for the export; ALL_DAY (a free day) has no hours
+    ShiftTimes times[4] = { { ALL_DAY, ALL_DAY }, { 7 * 60, 19 * 60 }, { 19 * 60, 7 * 60 }, { ALL_DAY, ALL_DAY } };
+    // Unpaid break per ShiftType, taken off the worked minutes only
+    int16_t    breaks[4] = { 0, 0, 0, 0 };
+    // Night premium window, minutes from midnight (22:00 - 06:00)
+    int16_t    nightStart = 22 * 60, nightEnd = 6 * 60;
+    // Worked minutes per ISO week before overtime
+    int32_t    weekLimit = 40 * 60;
+    // Public holidays (the built-in ones unless changed)
+    HolidayCalendar holidays;
+};
+
+// The model folded into a lookup per shift type, weekday and holiday flags
+class PayTable {
+public:
+    explicit PayTable(const PayrollModel& model = PayrollModel());
+
+    PayTotals Day(ShiftType st, int32_t day) const {
+        int h = m_holidays.IsHoliday(day) | m_holidays.IsHoliday(day + 1) << 1;
+        return m_day[st][WeekdayFromDays(day)][h];
+    }
+    bool    IsHoliday(int32_t day) const { return m_holidays.IsHoliday(day); }
+    int32_t WeekLimit() const { return m_weekLimit; }
+
+    // Totals of [from, to] (at most MAX_RANGE days) plus the overtime of the
+    // ISO weeks whose Thursday falls in it, so months add up to the year
+    static const int32_t MAX_RANGE = 372;
+    PayTotals Sum(const ShiftStore& s, int32_t from, int32_t to) const;
+
+private:
+    PayTotals            m_day[4][7][4];   // weekday, holiday today | tomorrow << 1
+    HolidayCalendar      m_holidays;
+    int32_t              m_weekLimit;
+};
+
+// Month and week totals of one store, cached and updated from the observer
+// calls: an edit of a few days adjusts the cached totals instead of summing
+// the month again.
+class PayrollLedger : public ShiftObserver {
+public:
+    explicit PayrollLedger(const PayrollModel& model = PayrollModel()) : m_table(model) {}
+    ~PayrollLedger() { Detach(); }
+
+    void Attach(ShiftStore& store);
+    void Detach();
+    // Drops the cached totals
+    void SetModel(const PayrollModel& model);
+
+    PayTotals Month(int m, int y);
+    // The ISO week holding day, overtime included
+    PayTotals Week(int32_t day);
+    PayTotals Year(int y);
+
+    // Months and weeks summed from the store so far
+    size_t Recomputes() const { return m_recomputes; }
+
+    void OnShiftsChanging(int32_t from, int32_t to) override;
+    void OnShiftsChanged(int32_t from, int32_t to) override;
+
+private:
+    // Edits up to this many days adjust the totals, longer ones drop them
+    static const int32_t MAX_DELTA_DAYS = 64;
+
+    PayTotals Linear(std::unordered_map<int32_t, PayTotals>& cache, int32_t key, int32_t from, int32_t to);
+    void      Adjust(int32_t day, ShiftType st, int sign);
+    void      Drop(int32_t from, int32_t to);
+
+    PayTable    m_table;
+    ShiftStore* m_store = nullptr;
+    // Without overtime; months by y * 12 + m - 1, weeks by their Monday
+    std::unordered_map<int32_t, PayTotals> m_months, m_weeks;
+    size_t      m_recomputes = 0;
+    // Codes of the range being edited, kept by OnShiftsChanging (a store
+    // that ends up changing nothing does not call OnShiftsChanged)
+    int32_t     m_pendingFrom = 0, m_pendingTo = -1;
+    uint64_t    m_pending[MAX_DELTA_DAYS / ShiftStore::SLOTS_PER_WORD];
+
+    PayrollLedger(const PayrollLedger&);
+    PayrollLedger& operator=(const PayrollLedger&);
+};
+
+// Year totals of every employee of the roster into out (one per index),
+// split across threads (0 = one per core)
+void PayrollYear(const Roster& roster, int y, const PayTable& table, std::vector<PayTotals>& out,
+                 unsigned threads = 0);
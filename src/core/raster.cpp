@@ -0,0 +1,324 @@
+// ============================================================================
+//  RASTER
+// ============================================================================
+
+#include "raster.h"
+#include <cmath>
+
+// ============================================================================
+//  FONT - 5x8 bitmap glyphs (rows top to bottom, bit 4 = left column, row 7
+//  holds descenders), scaled to the font size. Stands in for Segoe UI: the
+//  point is stable, readable output, not matching the GUI's text.
+// ============================================================================
+
+static const uint8_t GLYPHS_ASCII[95][8] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },  // ' '
+    { 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04, 0x00 },  // '!'
+    { 0x0a, 0x0a, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00 },  // '"'
+    { 0x0a, 0x0a, 0x1f, 0x0a, 0x1f, 0x0a, 0x0a, 0x00 },  // '#'
+    { 0x04, 0x0f, 0x14, 0x0e, 0x05, 0x1e, 0x04, 0x00 },  // '$'
+    { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03, 0x00 },  // '%'
+    { 0x0c, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0d, 0x00 },  // '&'
+    { 0x04, 0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 },  // "'"
+    { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02, 0x00 },  // '('
+    { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08, 0x00 },  // ')'
+    { 0x00, 0x04, 0x15, 0x0e, 0x15, 0x04, 0x00, 0x00 },  // '*'
+    { 0x00, 0x04, 0x04, 0x1f, 0x04, 0x04, 0x00, 0x00 },  // '+'
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x04, 0x08 },  // ','
+    { 0x00, 0x00, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x00 },  // '-'
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x0c, 0x00 },  // '.'
+    { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00, 0x00 },  // '/'
+    { 0x0e, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0e, 0x00 },  // '0'
+    { 0x04, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x0e, 0x00 },  // '1'
+    { 0x0e, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1f, 0x00 },  // '2'
+    { 0x1f, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0e, 0x00 },  // '3'
+    { 0x02, 0x06, 0x0a, 0x12, 0x1f, 0x02, 0x02, 0x00 },  // '4'
+    { 0x1f, 0x10, 0x1e, 0x01, 0x01, 0x11, 0x0e, 0x00 },  // '5'
+    { 0x06, 0x08, 0x10, 0x1e, 0x11, 0x11, 0x0e, 0x00 },  // '6'
+    { 0x1f, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08, 0x00 },  // '7'
+    { 0x0e, 0x11, 0x11, 0x0e, 0x11, 0x11, 0x0e, 0x00 },  // '8'
+    { 0x0e, 0x11, 0x11, 0x0f, 0x01, 0x02, 0x0c, 0x00 },  // '9'
+    { 0x00, 0x0c, 0x0c, 0x00, 0x0c, 0x0c, 0x00, 0x00 },  // ':'
+    { 0x00, 0x0c, 0x0c, 0x00, 0x0c, 0x04, 0x08, 0x00 },  // ';'
+    { 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02, 0x00 },  // '<'
+    { 0x00, 0x00, 0x1f, 0x00, 0x1f, 0x00, 0x00, 0x00 },  // '='
+    { 0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08, 0x00 },  // '>'
+    { 0x0e, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04, 0x00 },  // '?'
+    { 0x0e, 0x11, 0x01, 0x0d, 0x15, 0x15, 0x0e, 0x00 },  // '@'
+    { 0x0e, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11, 0x00 },  // 'A'
+    { 0x1e, 0x11, 0x11, 0x1e, 0x11, 0x11, 0x1e, 0x00 },  // 'B'
+    { 0x0e, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0e, 0x00 },  // 'C'
+    { 0x1c, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1c, 0x00 },  // 'D'
+    { 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x1f, 0x00 },  // 'E'
+    { 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x10, 0x00 },  // 'F'
+    { 0x0e, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0f, 0x00 },  // 'G'
+    { 0x11, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11, 0x00 },  // 'H'
+    { 0x0e, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e, 0x00 },  // 'I'
+    { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0c, 0x00 },  // 'J'
+    { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11, 0x00 },  // 'K'
+    { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1f, 0x00 },  // 'L'
+    { 0x11, 0x1b, 0x15, 0x15, 0x11, 0x11, 0x11, 0x00 },  // 'M'
+    { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11, 0x00 },  // 'N'
+    { 0x0e, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e, 0x00 },  // 'O'
+    { 0x1e, 0x11, 0x11, 0x1e, 0x10, 0x10, 0x10, 0x00 },  // 'P'
+    { 0x0e, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0d, 0x00 },  // 'Q'
+    { 0x1e, 0x11, 0x11, 0x1e, 0x14, 0x12, 0x11, 0x00 },  // 'R'
+    { 0x0f, 0x10, 0x10, 0x0e, 0x01, 0x01, 0x1e, 0x00 },  // 'S'
+    { 0x1f, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00 },  // 'T'
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e, 0x00 },  // 'U'
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0a, 0x04, 0x00 },  // 'V'
+    { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0a, 0x00 },  // 'W'
+    { 0x11, 0x11, 0x0a, 0x04, 0x0a, 0x11, 0x11, 0x00 },  // 'X'
+    { 0x11, 0x11, 0x11, 0x0a, 0x04, 0x04, 0x04, 0x00 },  // 'Y'
+    { 0x1f, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1f, 0x00 },  // 'Z'
+    { 0x0e, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0e, 0x00 },  // '['
+    { 0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00, 0x00 },  // '\\'
+    { 0x0e, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0e, 0x00 },  // ']'
+    { 0x04, 0x0a, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00 },  // '^'
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x00 },  // '_'
+    { 0x08, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00 },  // '`'
+    { 0x00, 0x00, 0x0e, 0x01, 0x0f, 0x11, 0x0f, 0x00 },  // 'a'
+    { 0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1e, 0x00 },  // 'b'
+    { 0x00, 0x00, 0x0e, 0x10, 0x10, 0x11, 0x0e, 0x00 },  // 'c'
+    { 0x01, 0x01, 0x0d, 0x13, 0x11, 0x11, 0x0f, 0x00 },  // 'd'
+    { 0x00, 0x00, 0x0e, 0x11, 0x1f, 0x10, 0x0e, 0x00 },  // 'e'
+    { 0x06, 0x09, 0x08, 0x1c, 0x08, 0x08, 0x08, 0x00 },  // 'f'
+    { 0x00, 0x00, 0x0f, 0x11, 0x11, 0x0f, 0x01, 0x0e },  // 'g'
+    { 0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x11, 0x00 },  // 'h'
+    { 0x04, 0x00, 0x0c, 0x04, 0x04, 0x04, 0x0e, 0x00 },  // 'i'
+    { 0x02, 0x00, 0x06, 0x02, 0x02, 0x02, 0x12, 0x0c },  // 'j'
+    { 0x10, 0x10, 0x12, 0x14, 0x18, 0x14, 0x12, 0x00 },  // 'k'
+    { 0x0c, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e, 0x00 },  // 'l'
+    { 0x00, 0x00, 0x1a, 0x15, 0x15, 0x11, 0x11, 0x00 },  // 'm'
+    { 0x00, 0x00, 0x16, 0x19, 0x11, 0x11, 0x11, 0x00 },  // 'n'
+    { 0x00, 0x00, 0x0e, 0x11, 0x11, 0x11, 0x0e, 0x00 },  // 'o'
+    { 0x00, 0x00, 0x1e, 0x11, 0x11, 0x1e, 0x10, 0x10 },  // 'p'
+    { 0x00, 0x00, 0x0f, 0x11, 0x11, 0x0f, 0x01, 0x01 },  // 'q'
+    { 0x00, 0x00, 0x16, 0x19, 0x10, 0x10, 0x10, 0x00 },  // 'r'
+    { 0x00, 0x00, 0x0f, 0x10, 0x0e, 0x01, 0x1e, 0x00 },  // 's'
+    { 0x08, 0x08, 0x1c, 0x08, 0x08, 0x09, 0x06, 0x00 },  // 't'
+    { 0x00, 0x00, 0x11, 0x11, 0x11, 0x13, 0x0d, 0x00 },  // 'u'
+    { 0x00, 0x00, 0x11, 0x11, 0x11, 0x0a, 0x04, 0x00 },  // 'v'
+    { 0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0a, 0x00 },  // 'w'
+    { 0x00, 0x00, 0x11, 0x0a, 0x04, 0x0a, 0x11, 0x00 },  // 'x'
+    { 0x00, 0x00, 0x11, 0x11, 0x11, 0x0f, 0x01, 0x0e },  // 'y'
+    { 0x00, 0x00, 0x1f, 0x02, 0x04, 0x08, 0x1f, 0x00 },  // 'z'
+    { 0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02, 0x00 },  // '{'
+    { 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00 },  // '|'
+    { 0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08, 0x00 },  // '}'
+    { 0x00, 0x00, 0x08, 0x15, 0x02, 0x00, 0x00, 0x00 },  // '~'
+};
+
+struct SymbolGlyph {
+    char16_t code;
+    uint8_t  rows[8];
+};
+static const SymbolGlyph GLYPHS_SYMBOL[] = {
+    { 0x25B6, { 0x10, 0x18, 0x1c, 0x1e, 0x1c, 0x18, 0x10, 0x00 } },
+    { 0x25C0, { 0x01, 0x03, 0x07, 0x0f, 0x07, 0x03, 0x01, 0x00 } },
+    { 0x2600, { 0x04, 0x15, 0x0e, 0x1b, 0x0e, 0x15, 0x04, 0x00 } },
+    { 0x263E, { 0x0e, 0x03, 0x01, 0x01, 0x01, 0x03, 0x0e, 0x00 } },
+    { 0x2714, { 0x00, 0x01, 0x03, 0x16, 0x1c, 0x08, 0x00, 0x00 } },
+    { 0x2716, { 0x00, 0x1b, 0x0e, 0x04, 0x0e, 0x1b, 0x00, 0x00 } },
+};
+
+static const uint8_t* Glyph(char16_t c) {
+    if (c >= 0x20 && c < 0x7f) return GLYPHS_ASCII[c - 0x20];
+    for (const SymbolGlyph& g : GLYPHS_SYMBOL)
+        if (g.code == c) return g.rows;
+    return GLYPHS_ASCII['?' - 0x20];
+}
+
+// Glyph grid unit, advance (5 columns + 1 space) and line box, in pixels
+static float Unit(const DlFontSpec& f) { return f.size * 0.1f; }
+static float Advance(const DlFontSpec& f) { return f.size * 0.6f; }
+static float LineHeight(const DlFontSpec& f) { return f.size * 1.2f; }
+
+float RasterMetrics::Width(DlFont font, const char16_t*, int len) const {
+    return len * Advance(DL_FONTS[font]);
+}
+
+// ============================================================================
+//  PIXELS
+// ============================================================================
+
+RasterImage::RasterImage(int width, int height, uint32_t fill)
+    : m_width(width), m_height(height), m_pixels((size_t)width * height, fill) {}
+
+// Source-over with coverage in [0, 1]; the image stays opaque
+static inline void Blend(uint32_t& dst, DlColor c, float coverage) {
+    if (coverage <= 0) return;
+    int a = (int)((c >> 24) * (coverage < 1 ? coverage : 1) + 0.5f);
+    if (a <= 0) return;
+    if (a >= 255) { dst = c | 0xff000000u; return; }
+    uint32_t out = 0xff000000u;
+    for (int sh = 0; sh <= 16; sh += 8) {
+        int s = (c >> sh) & 0xff, d = (dst >> sh) & 0xff;
+        out |= (uint32_t)((d * (255 - a) + s * a + 127) / 255) << sh;
+    }
+    dst = out;
+}
+
+static inline float Clamp01(float v) { return v < 0 ? 0 : v > 1 ? 1 : v; }
+
+// Length of [a0, a1) inside the pixel [p, p + 1)
+static inline float Overlap(float a0, float a1, int p) {
+    float lo = a0 > p ? a0 : (float)p, hi = a1 < p + 1 ? a1 : (float)(p + 1);
+    return hi > lo ? hi - lo : 0;
+}
+
+// Signed distance from (px, py) to the rounded rect, negative inside
+static float RoundRectDistance(float px, float py, float x, float y, float w, float h, float r) {
+    float hw = w / 2, hh = h / 2;
+    if (r > hw) r = hw;
+    if (r > hh) r = hh;
+    float qx = std::fabs(px - (x + hw)) - (hw - r), qy = std::fabs(py - (y + hh)) - (hh - r);
+    float ox = qx > 0 ? qx : 0, oy = qy > 0 ? qy : 0;
+    float in = qx > qy ? qx : qy;
+    return std::sqrt(ox * ox + oy * oy) + (in < 0 ? in : 0) - r;
+}
+
+static float SegmentDistance(float px, float py, const DlCmd& c) {
+    float len2 = c.w * c.w + c.h * c.h;
+    float t = len2 > 0 ? ((px - c.x) * c.w + (py - c.y) * c.h) / len2 : 0;
+    t = Clamp01(t);
+    float dx = px - (c.x + t * c.w), dy = py - (c.y + t * c.h);
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+// Subsamples per pixel side for text
+static const int TEXT_SS = 4;
+
+static bool GlyphHit(const uint8_t* rows, float ux, int row, bool bold) {
+    int col = (int)std::floor(ux);
+    if (row < 0 || row > 7) return false;
+    if (col >= 0 && col < 5 && (rows[row] >> (4 - col) & 1)) return true;
+    // Bold: every column also covers 0.6 units to its right
+    int prev = (int)std::floor(ux - 0.6f);
+    return bold && prev != col && prev >= 0 && prev < 5 && (rows[row] >> (4 - prev) & 1);
+}
+
+static void DrawText(const DisplayList& dl, const DlCmd& c, RasterImage& img, const LayoutRect& area) {
+    const DlFontSpec& f = DL_FONTS[c.font];
+    const char16_t* text = dl.Text(c);
+    float u = Unit(f), adv = Advance(f), lineH = LineHeight(f);
+    float tw = c.textLen * adv;
+    float x0 = c.hAlign == DL_NEAR ? c.x : c.hAlign == DL_CENTER ? c.x + (c.w - tw) / 2 : c.x + c.w - tw;
+    float y0 = c.vAlign == DL_NEAR ? c.y : c.vAlign == DL_CENTER ? c.y + (c.h - lineH) / 2 : c.y + c.h - lineH;
+    float gy = y0 + f.size * 0.2f;
+
+    // Text is clipped to its layout rect, like GDI+ DrawString
+    int left = (int)std::floor(c.x > x0 ? c.x : x0), right = (int)std::ceil(c.x + c.w < x0 + tw ? c.x + c.w : x0 + tw);
+    int top = (int)std::floor(c.y > gy ? c.y : gy), bottom = (int)std::ceil(c.y + c.h < gy + 8 * u ? c.y + c.h : gy + 8 * u);
+    if (left < area.left) left = area.left;
+    if (top < area.top) top = area.top;
+    if (right > area.right) right = area.right;
+    if (bottom > area.bottom) bottom = area.bottom;
+
+    for (int py = top; py < bottom; py++) {
+        uint32_t* row = img.Row(py);
+        for (int px = left; px < right; px++) {
+            int hits = 0;
+            for (int sy = 0; sy < TEXT_SS; sy++) {
+                float Y = py + (sy + 0.5f) / TEXT_SS;
+                if (Y < c.y || Y >= c.y + c.h) continue;
+                int gr = (int)std::floor((Y - gy) / u);
+                float shear = f.italic ? (7 - gr) * 0.25f : 0;
+                for (int sx = 0; sx < TEXT_SS; sx++) {
+                    float X = px + (sx + 0.5f) / TEXT_SS;
+                    if (X < c.x || X >= c.x + c.w) continue;
+                    int i = (int)std::floor((X - x0) / adv);
+                    if (i < 0 || i >= (int)c.textLen) continue;
+                    float ux = (X - x0 - i * adv) / u - shear;
+                    hits += GlyphHit(Glyph(text[i]), ux, gr, f.bold);
+                }
+            }
+            if (hits) Blend(row[px], c.color, (float)hits / (TEXT_SS * TEXT_SS));
+        }
+    }
+}
+
+// ============================================================================
+//  REPLAY
+// ============================================================================
+
+static void RasterizeRange(const DisplayList& dl, size_t first, size_t end, RasterImage& img, const LayoutRect& clip) {
+    LayoutRect canvas = MakeRect(0, 0, img.Width(), img.Height());
+    for (size_t i = first; i < end; i++) {
+        const DlCmd& c = dl[i];
+        LayoutRect b = dl.Bounds(c);
+        if (!b.Intersects(clip) || !b.Intersects(canvas)) continue;
+        LayoutRect a;
+        a.left = b.left > clip.left ? b.left : clip.left;
+        a.top = b.top > clip.top ? b.top : clip.top;
+        a.right = b.right < clip.right ? b.right : clip.right;
+        a.bottom = b.bottom < clip.bottom ? b.bottom : clip.bottom;
+        if (a.left < 0) a.left = 0;
+        if (a.top < 0) a.top = 0;
+        if (a.right > img.Width()) a.right = img.Width();
+        if (a.bottom > img.Height()) a.bottom = img.Height();
+
+        if (c.op == DL_TEXT) { DrawText(dl, c, img, a); continue; }
+        for (int py = a.top; py < a.bottom; py++) {
+            uint32_t* row = img.Row(py);
+            float cy = py + 0.5f;
+            DlColor color = c.color;
+            if (c.op == DL_GRADIENT_V) {
+                float t = c.h > 0 ? Clamp01((cy - c.y) / c.h) : 0;
+                color = 0xff000000u;
+                for (int sh = 0; sh <= 16; sh += 8) {
+                    float v0 = (float)((c.color >> sh) & 0xff), v1 = (float)((c.color2 >> sh) & 0xff);
+                    color |= (uint32_t)(v0 + (v1 - v0) * t + 0.5f) << sh;
+                }
+            }
+            float rowCover = Overlap(c.y, c.y + c.h, py);
+            for (int px = a.left; px < a.right; px++) {
+                float cx = px + 0.5f, cover = 0;
+                switch (c.op) {
+                case DL_FILL_RECT:
+                case DL_GRADIENT_V:
+                    cover = rowCover * Overlap(c.x, c.x + c.w, px);
+                    break;
+                case DL_FILL_ROUND:
+                    // Away from the corners and one pixel in from the edges: fully covered
+                    if (((cx >= c.x + c.r && cx <= c.x + c.w - c.r) || (cy >= c.y + c.r && cy <= c.y + c.h - c.r))
+                        && cx >= c.x + 1 && cx <= c.x + c.w - 1 && cy >= c.y + 1 && cy <= c.y + c.h - 1) {
+                        cover = 1;
+                        break;
+                    }
+                    cover = Clamp01(0.5f - RoundRectDistance(cx, cy, c.x, c.y, c.w, c.h, c.r));
+                    break;
+                case DL_STROKE_ROUND:
+                    cover = Clamp01(c.pen / 2 + 0.5f - std::fabs(RoundRectDistance(cx, cy, c.x, c.y, c.w, c.h, c.r)));
+                    break;
+                case DL_FILL_ROUND_TOP:
+                    cover = rowCover * Clamp01(0.5f - RoundRectDistance(cx, cy, c.x, c.y, c.w, 2 * c.r + c.h, c.r));
+                    break;
+                case DL_LINE:
+                    cover = Clamp01(c.pen / 2 + 0.5f - SegmentDistance(cx, cy, c));
+                    break;
+                }
+                Blend(row[px], color, cover);
+            }
+        }
+    }
+}
+
+void RasterizeDisplayList(const DisplayList& dl, RasterImage& img, const LayoutRect& clip) {
+    ReplaySections(dl, "raster", [&](size_t first, size_t end) { RasterizeRange(dl, first, end, img, clip); });
+}
+
+bool WritePpm(FILE* f, const RasterImage& img) {
+    if (fprintf(f, "P6\n%d %d\n255\n", img.Width(), img.Height()) < 0) return false;
+    std::vector<unsigned char> line((size_t)img.Width() * 3);
+    for (int y = 0; y < img.Height(); y++) {
+        const uint32_t* row = img.Row(y);
+        for (int x = 0; x < img.Width(); x++) {
+            line[x * 3] = (unsigned char)(row[x] >> 16);
+            line[x * 3 + 1] = (unsigned char)(row[x] >> 8);
+            line[x * 3 + 2] = (unsigned char)row[x];
+        }
+        if (fwrite(line.data(), 1, line.size(), f) != line.size()) return false;
+    }
+    return true;
+}
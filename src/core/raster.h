@@ -0,0 +1,44 @@
+// ============================================================================
+//  RASTER - software backend for display lists: anti-aliased fills, pens and
+//  a built-in bitmap font into a 32-bit image, written out as PPM. Lets the
+//  month view be benchmarked and compared pixel by pixel without Windows.
+// ============================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "display_list.h"
+
+// Opaque 0xAARRGGBB pixels, row by row
+class RasterImage {
+public:
+    RasterImage(int width, int height, uint32_t fill = 0xff000000u);
+
+    int       Width() const { return m_width; }
+    int       Height() const { return m_height; }
+    uint32_t  Pixel(int x, int y) const { return m_pixels[(size_t)y * m_width + x]; }
+    uint32_t* Row(int y) { return &m_pixels[(size_t)y * m_width]; }
+    const uint32_t* Row(int y) const { return &m_pixels[(size_t)y * m_width]; }
+    bool operator==(const RasterImage& o) const {
+        return m_width == o.m_width && m_height == o.m_height && m_pixels == o.m_pixels;
+    }
+
+private:
+    int                   m_width, m_height;
+    std::vector<uint32_t> m_pixels;
+};
+
+// Text widths of the built-in font
+class RasterMetrics : public TextMetrics {
+public:
+    float Width(DlFont font, const char16_t* text, int len) const override;
+};
+
+// Draws the commands that touch clip, clipped to it. A pixel gets the same
+// value whatever the clip, so repainting dirty rects matches a full redraw.
+void RasterizeDisplayList(const DisplayList& dl, RasterImage& img, const LayoutRect& clip);
+
+// Binary PPM (P6)
+bool WritePpm(FILE* f, const RasterImage& img);
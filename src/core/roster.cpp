@@ -0,0 +1,74 @@
+// ============================================================================
+//  ROSTER
+// ============================================================================
+
+#include "roster.h"
+#include <algorithm>
+
+static bool IdLess(const std::pair<uint32_t, uint32_t>& e, uint32_t id) { return e.first < id; }
+
+int Roster::Find(uint32_t id) const {
+    auto it = std::lower_bound(m_byId.begin(), m_byId.end(), id, IdLess);
+    return (it != m_byId.end() && it->first == id) ? (int)it->second : -1;
+}
+
+int Roster::Add(uint32_t id, const char* name) {
+    auto it = std::lower_bound(m_byId.begin(), m_byId.end(), id, IdLess);
+    if (it != m_byId.end() && it->first == id) {
+        Employee& e = m_staff[it->second];
+        if (name && e.name != name) {
+            e.name = name;
+            Notify(it->second);
+        }
+        return (int)it->second;
+    }
+    if (m_staff.size() >= MAX_EMPLOYEES) return -1;
+    uint32_t index = (uint32_t)m_staff.size();
+    m_byId.insert(it, std::make_pair(id, index));
+    m_staff.push_back(Employee());
+    m_staff.back().id = id;
+    if (name) m_staff.back().name = name;
+    m_shifts.emplace_back();
+    Notify(index);
+    return (int)index;
+}
+
+void Roster::Clear() {
+    m_staff.clear();
+    m_shifts.clear();
+    m_byId.clear();
+}
+
+size_t Roster::Count() const {
+    size_t n = 0;
+    for (const ShiftStore& s : m_shifts) n += s.Count();
+    return n;
+}
+
+ShiftCounts Roster::CountDay(int32_t day) const {
+    ShiftCounts c;
+    ForEachOnDay(day, [&](size_t, ShiftType st) { c.Add(st, 1); });
+    return c;
+}
+
+ShiftCounts Roster::CountByType(int32_t from, int32_t to) const {
+    ShiftCounts c;
+    for (const ShiftStore& s : m_shifts) c += s.CountByType(from, to);
+    return c;
+}
+
+size_t Roster::MemoryUsage() const {
+    size_t n = sizeof(*this) + m_staff.capacity() * sizeof(Employee)
+             + m_byId.capacity() * sizeof(m_byId[0]);
+    for (const Employee& e : m_staff) n += e.name.capacity();
+    for (const ShiftStore& s : m_shifts) n += s.MemoryUsage();
+    return n;
+}
+
+void Roster::AddObserver(RosterObserver* o) {
+    if (std::find(m_observers.begin(), m_observers.end(), o) == m_observers.end()) m_observers.push_back(o);
+}
+
+void Roster::RemoveObserver(RosterObserver* o) {
+    m_observers.erase(std::remove(m_observers.begin(), m_observers.end(), o), m_observers.end());
+}
@@ -0,0 +1,87 @@
+// ============================================================================
+//  ROSTER - shifts of a whole team, stored column by column
+//  Every employee owns one ShiftStore (a packed 2-bit day array), so a
+//  person's months and years are scanned sequentially; a per-day query
+//  computes the year word once and reads one word per employee.
+//  Employee id 0 is the default employee: the single-user data of files
+//  written before the roster (smjene_data.txt, binary version 1).
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+#include "shift_store.h"
+
+struct Employee {
+    uint32_t    id = 0;
+    std::string name;        // UTF-8, may be empty
+};
+
+// Notified when an employee is added or renamed (index into the roster)
+class RosterObserver {
+public:
+    virtual ~RosterObserver() {}
+    virtual void OnEmployeeChanged(size_t index) = 0;
+};
+
+class Roster {
+public:
+    static const uint32_t DEFAULT_ID = 0;
+    // Binary snapshots address employees with 16 bits
+    static const size_t   MAX_EMPLOYEES = 65535;
+
+    size_t Size() const { return m_staff.size(); }
+    const Employee& At(size_t i) const { return m_staff[i]; }
+    // Columns keep their address while employees are added
+    ShiftStore&       Shifts(size_t i) { return m_shifts[i]; }
+    const ShiftStore& Shifts(size_t i) const { return m_shifts[i]; }
+
+    // Index of the employee, -1 when unknown
+    int Find(uint32_t id) const;
+    // Index of the employee, added with no shifts when new; a non-null name
+    // replaces the current one. -1 once MAX_EMPLOYEES is reached.
+    int Add(uint32_t id, const char* name = nullptr);
+    ShiftStore& Default() { return m_shifts[(size_t)Add(DEFAULT_ID)]; }
+
+    // Removes every employee; observers of the columns must be detached first.
+    void Clear();
+
+    // Set days over all employees
+    size_t Count() const;
+
+    // Per day across the team: fn(size_t index, ShiftType st) for every
+    // employee with a shift on day, in roster order
+    template <class Fn> void ForEachOnDay(int32_t day, Fn&& fn) const {
+        CivilDate c = CivilFromDays(day);
+        int slot = day - DaysFromCivil(c.y, 1, 1);
+        int k = slot / ShiftStore::SLOTS_PER_WORD, shift = 2 * (slot % ShiftStore::SLOTS_PER_WORD);
+        for (size_t i = 0; i < m_shifts.size(); i++) {
+            const uint64_t* w = m_shifts[i].YearWords(c.y);
+            ShiftType st = w ? (ShiftType)((w[k] >> shift) & 3) : SHIFT_NONE;
+            if (st != SHIFT_NONE) fn(i, st);
+        }
+    }
+    ShiftCounts CountDay(int32_t day) const;
+    // Team totals over the inclusive day range (O(employees x log months))
+    ShiftCounts CountByType(int32_t from, int32_t to) const;
+
+    size_t MemoryUsage() const;
+
+    void AddObserver(RosterObserver* o);
+    void RemoveObserver(RosterObserver* o);
+
+private:
+    void Notify(size_t index) {
+        for (RosterObserver* o : m_observers) o->OnEmployeeChanged(index);
+    }
+
+    std::vector<Employee>   m_staff;
+    std::deque<ShiftStore>  m_shifts;    // m_shifts[i] belongs to m_staff[i]
+    std::vector<std::pair<uint32_t, uint32_t>> m_byId;   // (id, index), sorted by id
+    std::vector<RosterObserver*> m_observers;
+};
@@ -0,0 +1,40 @@
+// ============================================================================
+//  ROTATION
+// ============================================================================
+
+#include "rotation.h"
+#include <vector>
+
+bool ParseRotation(const char* text, int32_t anchor, Rotation& out) {
+    out.period = 0;
+    out.anchor = anchor;
+    bool any = false;
+    for (const char* p = text; *p; p++) {
+        ShiftType st;
+        switch (*p) {
+        case 'D': case 'd': st = SHIFT_DAY; break;
+        case 'N': case 'n': st = SHIFT_NIGHT; break;
+        case 'S': case 's': st = SHIFT_FREE; break;
+        case '-': st = SHIFT_NONE; break;
+        case ' ': case ',': case '\t': continue;
+        default: return false;
+        }
+        if (out.period == Rotation::MAX_PERIOD) return false;
+        out.cycle[out.period++] = st;
+        any |= st != SHIFT_NONE;
+    }
+    return any;
+}
+
+size_t ApplyRotation(ShiftStore& store, const Rotation& r, int32_t from, int32_t to, MergeMode mode) {
+    if (r.period <= 0) return 0;
+    // Packed word for every phase: the 32 codes starting there
+    std::vector<uint64_t> words((size_t)r.period);
+    for (int p = 0; p < r.period; p++) {
+        uint64_t w = 0;
+        for (int i = 0; i < ShiftStore::SLOTS_PER_WORD; i++)
+            w |= (uint64_t)r.cycle[(p + i) % r.period] << (2 * i);
+        words[(size_t)p] = w;
+    }
+    return store.FillWords(from, to, mode, [&](int32_t day) { return words[(size_t)r.Phase(day)]; });
+}
@@ -0,0 +1,30 @@
+// ============================================================================
+//  ROTATION - repeating shift cycle (e.g. D-D-N-N-S-S-S-S) anchored at a day
+//  and written over any date range with ShiftStore::FillWords()
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include "shift_store.h"
+
+struct Rotation {
+    static const int MAX_PERIOD = 128;
+
+    ShiftType cycle[MAX_PERIOD];
+    int       period = 0;
+    int32_t   anchor = 0;   // day number of cycle[0]
+
+    int Phase(int32_t day) const {
+        int p = (int)((day - anchor) % period);
+        return p < 0 ? p + period : p;
+    }
+    ShiftType At(int32_t day) const { return cycle[Phase(day)]; }
+};
+
+// "DDNNSSSS": D = dnevna, N = nocna, S = slobodan, - = bez promjene.
+// Spaces and commas are ignored, letters are case-insensitive.
+bool ParseRotation(const char* text, int32_t anchor, Rotation& out);
+
+// Writes the rotation over [from, to]; returns the number of days changed.
+size_t ApplyRotation(ShiftStore& store, const Rotation& r, int32_t from, int32_t to, MergeMode mode);
@@ -0,0 +1,361 @@
+// ============================================================================
+//  SCHEDULER
+// ============================================================================
+
+#include "scheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+// Penalty weights: a missing person weighs as much as a broken rule, an
+// uneven share of nights or weekends far less
+static const int64_t W_COVER = 100;
+static const int64_t W_RULE = 100;
+static const int64_t W_FAIR = 2;
+// Annealing temperature of the first and the last round
+static const double T_FIRST = 150.0, T_LAST = 0.3;
+
+static uint64_t SplitMix(uint64_t& x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static int RuleCount(uint8_t bits) { return (bits & 1) + (bits >> 1 & 1) + (bits >> 2 & 1) + (bits >> 3 & 1); }
+
+// Smallest sum of squares of n shares of total: the shares as even as can be
+static int64_t EvenSquares(int64_t total, int64_t n) {
+    int64_t q = total / n, r = total % n;
+    return r * (q + 1) * (q + 1) + (n - r) * q * q;
+}
+
+// ============================================================================
+//  ANNEALING STATE - one employee per row; each row has Reach() days of
+//  stored shifts before the plan and Reach() after it, read for the rules
+//  only
+// ============================================================================
+
+namespace {
+
+struct Problem {
+    const ShiftRules* rules;
+    int                  ctx;            // context days before the plan
+    int                  days;
+    int                  tail;           // context days after it
+    int                  stride;         // ctx + days + tail
+    size_t               employees;
+    std::vector<uint8_t> weekday;        // of row index j
+    std::vector<int>     needDay, needNight;   // by plan day
+};
+
+class Anneal {
+public:
+    Anneal(const Problem& p, std::vector<uint8_t> rows) : m_p(&p), m_rows(std::move(rows)) { Recount(); }
+
+    const ScheduleCost& Cost() const { return m_cost; }
+    const std::vector<uint8_t>& Rows() const { return m_rows; }
+
+    void Seed(uint64_t seed) { m_rng = SplitMix(seed) | 1; }
+
+    // moves random flips and swaps at temperature t
+    void Run(int moves, double t) {
+        const Problem& p = *m_p;
+        const int e = (int)p.employees;
+        for (int i = 0; i < moves; i++) {
+            int j = p.ctx + Below(p.days);
+            size_t a = (size_t)Below(e);
+            uint8_t* ra = &m_rows[a * (size_t)p.stride];
+            if (e > 1 && (Next() & 1)) {
+                // Swap two people's shifts of a day: the day stays covered
+                size_t b = (size_t)Below(e - 1);
+                if (b >= a) b++;
+                uint8_t* rb = &m_rows[b * (size_t)p.stride];
+                uint8_t sa = ra[j], sb = rb[j];
+                if (sa == sb) continue;
+                int64_t delta = Apply(a, j, sb) + Apply(b, j, sa);
+                if (!Accept(delta, t)) { Apply(b, j, sb); Apply(a, j, sa); }
+            } else {
+                uint8_t old = ra[j];
+                uint8_t to = (uint8_t)(1 + (old + Below(2)) % 3);   // one of the two other codes
+                int64_t delta = Apply(a, j, to);
+                if (!Accept(delta, t)) Apply(a, j, old);
+            }
+        }
+    }
+
+private:
+    uint64_t Next() {
+        m_rng ^= m_rng >> 12; m_rng ^= m_rng << 25; m_rng ^= m_rng >> 27;
+        return m_rng * 0x2545F4914F6CDD1Dull;
+    }
+    int Below(int n) { return (int)(((Next() >> 32) * (uint64_t)n) >> 32); }
+
+    bool Accept(int64_t delta, double t) {
+        if (delta <= 0) return true;
+        double u = (double)(Next() >> 11) * (1.0 / 9007199254740992.0);
+        return u < std::exp(-(double)delta / t);
+    }
+
+    // Broken rules of row days [lo, hi], scanned from their context
+    int RowRules(const uint8_t* row, int lo, int hi) const {
+        RuleScan scan(*m_p->rules);
+        int n = 0;
+        for (int j = std::max(0, lo - m_p->ctx); j <= hi; j++) {
+            uint8_t bits = scan.Step((ShiftType)row[j], m_p->weekday[(size_t)j]);
+            if (j >= lo) n += RuleCount(bits);
+        }
+        return n;
+    }
+
+    static int64_t CoverCost(int have, int need) { return W_COVER * (have > need ? have - need : need - have); }
+
+    // Sets row e, index j to code and returns the change of the total cost
+    int64_t Apply(size_t e, int j, uint8_t code) {
+        const Problem& p = *m_p;
+        uint8_t* row = &m_rows[e * (size_t)p.stride];
+        const uint8_t old = row[j];
+        const int hi = std::min(p.stride - 1, j + p.ctx);
+        int before = RowRules(row, j, hi);
+        row[j] = code;
+        int64_t rules = W_RULE * (RowRules(row, j, hi) - before);
+
+        const int d = j - p.ctx;
+        int64_t cover = -CoverCost(m_haveDay[(size_t)d], p.needDay[(size_t)d])
+                        - CoverCost(m_haveNight[(size_t)d], p.needNight[(size_t)d]);
+        m_haveDay[(size_t)d] += (code == SHIFT_DAY) - (old == SHIFT_DAY);
+        m_haveNight[(size_t)d] += (code == SHIFT_NIGHT) - (old == SHIFT_NIGHT);
+        cover += CoverCost(m_haveDay[(size_t)d], p.needDay[(size_t)d])
+               + CoverCost(m_haveNight[(size_t)d], p.needNight[(size_t)d]);
+
+        int64_t fair = 0;
+        int dn = (code == SHIFT_NIGHT) - (old == SHIFT_NIGHT);
+        if (dn) fair += Share(m_nights[e], m_totalNights, dn);
+        if (p.weekday[(size_t)j] >= 5) {
+            int dw = (code != SHIFT_FREE) - (old != SHIFT_FREE);
+            if (dw) fair += Share(m_weekends[e], m_totalWeekends, dw);
+        }
+        m_cost.rules += rules;
+        m_cost.cover += cover;
+        m_cost.fairness += fair;
+        return rules + cover + fair;
+    }
+
+    // Moves one person's count by delta; returns the change of the spread:
+    // the sum of squares over the even one
+    int64_t Share(int64_t& mine, int64_t& total, int delta) {
+        const int64_t n = (int64_t)m_p->employees;
+        int64_t before = mine * mine - EvenSquares(total, n);
+        mine += delta;
+        total += delta;
+        return W_FAIR * (mine * mine - EvenSquares(total, n) - before);
+    }
+
+    void Recount() {
+        const Problem& p = *m_p;
+        m_haveDay.assign((size_t)p.days, 0);
+        m_haveNight.assign((size_t)p.days, 0);
+        m_nights.assign(p.employees, 0);
+        m_weekends.assign(p.employees, 0);
+        m_totalNights = m_totalWeekends = 0;
+        m_cost = ScheduleCost();
+        for (size_t e = 0; e < p.employees; e++) {
+            const uint8_t* row = &m_rows[e * (size_t)p.stride];
+            m_cost.rules += W_RULE * RowRules(row, p.ctx, p.stride - 1);
+            for (int d = 0; d < p.days; d++) {
+                uint8_t c = row[p.ctx + d];
+                m_haveDay[(size_t)d] += c == SHIFT_DAY;
+                m_haveNight[(size_t)d] += c == SHIFT_NIGHT;
+                m_nights[e] += c == SHIFT_NIGHT;
+                m_weekends[e] += p.weekday[(size_t)(p.ctx + d)] >= 5 && c != SHIFT_FREE;
+            }
+            m_cost.fairness += W_FAIR * (m_nights[e] * m_nights[e] + m_weekends[e] * m_weekends[e]);
+            m_totalNights += m_nights[e];
+            m_totalWeekends += m_weekends[e];
+        }
+        m_cost.fairness -= W_FAIR * (EvenSquares(m_totalNights, (int64_t)p.employees) +
+                                     EvenSquares(m_totalWeekends, (int64_t)p.employees));
+        for (int d = 0; d < p.days; d++)
+            m_cost.cover += CoverCost(m_haveDay[(size_t)d], p.needDay[(size_t)d])
+                          + CoverCost(m_haveNight[(size_t)d], p.needNight[(size_t)d]);
+    }
+
+    const Problem*       m_p;
+    std::vector<uint8_t> m_rows;
+    std::vector<int>     m_haveDay, m_haveNight;
+    std::vector<int64_t> m_nights, m_weekends;
+    int64_t              m_totalNights = 0, m_totalWeekends = 0;
+    ScheduleCost         m_cost;
+    uint64_t             m_rng = 1;
+};
+
+bool SetUp(const Roster& roster, const std::vector<size_t>& employees, int32_t from, int32_t to,
+           const ScheduleOptions& opt, Problem& p, std::vector<uint8_t>& rows) {
+    if (employees.empty() || to < from || to - from >= MAX_SCHEDULE_DAYS) return false;
+    for (size_t i : employees) if (i >= roster.Size()) return false;
+    p.rules = &opt.rules;
+    p.ctx = p.tail = opt.rules.Reach();
+    p.days = to - from + 1;
+    p.stride = p.ctx + p.days + p.tail;
+    p.employees = employees.size();
+    p.weekday.resize((size_t)p.stride);
+    for (int j = 0; j < p.stride; j++) p.weekday[(size_t)j] = (uint8_t)WeekdayFromDays(from - p.ctx + j);
+    p.needDay.resize((size_t)p.days);
+    p.needNight.resize((size_t)p.days);
+    for (int d = 0; d < p.days; d++) {
+        const CoverTarget& c = opt.cover[p.weekday[(size_t)(p.ctx + d)]];
+        p.needDay[(size_t)d] = c.day;
+        p.needNight[(size_t)d] = c.night;
+    }
+    // The context: stored shifts before and after the plan (the plan days
+    // are filled in later)
+    rows.assign(p.employees * (size_t)p.stride, SHIFT_FREE);
+    std::vector<uint64_t> codes((size_t)p.stride / ShiftStore::SLOTS_PER_WORD + 1);
+    for (size_t e = 0; e < p.employees && p.ctx > 0; e++) {
+        roster.Shifts(employees[e]).ReadCodes(from - p.ctx, to + p.tail, codes.data());
+        for (int j = 0; j < p.stride; j++)
+            if (j < p.ctx || j >= p.ctx + p.days)
+                rows[e * (size_t)p.stride + (size_t)j] =
+                    (uint8_t)((codes[(size_t)j / ShiftStore::SLOTS_PER_WORD] >> (2 * (j % ShiftStore::SLOTS_PER_WORD))) & 3);
+    }
+    return true;
+}
+
+// A first plan, day by day: nights to whoever has had the fewest and is not
+// at a run limit, then days to whoever did not just work a night
+void Greedy(const Problem& p, std::vector<uint8_t>& rows) {
+    const ShiftRules& r = *p.rules;
+    std::vector<int> nights(p.employees, 0), worked(p.employees, 0), workRun(p.employees), nightRun(p.employees);
+    std::vector<size_t> order(p.employees);
+    std::vector<int64_t> key(p.employees);
+    for (int d = 0; d < p.days; d++) {
+        const int j = p.ctx + d;
+        for (size_t e = 0; e < p.employees; e++) {
+            const uint8_t* row = &rows[e * (size_t)p.stride];
+            int w = 0, n = 0;
+            while (w < j && (row[j - 1 - w] == SHIFT_DAY || row[j - 1 - w] == SHIFT_NIGHT)) w++;
+            while (n < j && row[j - 1 - n] == SHIFT_NIGHT) n++;
+            workRun[e] = w;
+            nightRun[e] = n;
+            order[e] = (e + (size_t)d) % p.employees;   // ties rotate day by day
+        }
+        auto pick = [&](ShiftType st, int need) {
+            for (size_t e = 0; e < p.employees; e++) {
+                const uint8_t prev = rows[e * (size_t)p.stride + (size_t)j - 1];
+                bool blocked = (r.maxWorkRun > 0 && workRun[e] >= r.maxWorkRun) ||
+                               (st == SHIFT_NIGHT && r.maxNightRun > 0 && nightRun[e] >= r.maxNightRun) ||
+                               (st == SHIFT_DAY && prev == SHIFT_NIGHT);
+                key[e] = (blocked ? 1000000 : 0) + (st == SHIFT_NIGHT ? nights[e] : worked[e]) * 100 +
+                         (rows[e * (size_t)p.stride + (size_t)j] != SHIFT_FREE ? 10000000 : 0);
+            }
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return key[a] < key[b]; });
+            for (int k = 0; k < need && k < (int)p.employees; k++) {
+                size_t e = order[(size_t)k];
+                if (rows[e * (size_t)p.stride + (size_t)j] != SHIFT_FREE) break;
+                rows[e * (size_t)p.stride + (size_t)j] = (uint8_t)st;
+                worked[e]++;
+                nights[e] += st == SHIFT_NIGHT;
+            }
+        };
+        pick(SHIFT_NIGHT, p.needNight[(size_t)d]);
+        pick(SHIFT_DAY, p.needDay[(size_t)d]);
+    }
+}
+
+void ToPlan(const Problem& p, const std::vector<uint8_t>& rows, SchedulePlan& plan) {
+    plan.codes.resize(p.employees * (size_t)p.days);
+    for (size_t e = 0; e < p.employees; e++)
+        std::copy(rows.begin() + (ptrdiff_t)(e * (size_t)p.stride + (size_t)p.ctx),
+                  rows.begin() + (ptrdiff_t)(e * (size_t)p.stride + (size_t)(p.ctx + p.days)),
+                  plan.codes.begin() + (ptrdiff_t)(e * (size_t)p.days));
+}
+
+} // namespace
+
+// ============================================================================
+//  SOLVER
+// ============================================================================
+
+bool SolveSchedule(const Roster& roster, const std::vector<size_t>& employees, int32_t from, int32_t to,
+                   const ScheduleOptions& opt, SchedulePlan& plan, ScheduleResult& result) {
+    auto start = std::chrono::steady_clock::now();
+    Problem p;
+    std::vector<uint8_t> rows;
+    if (!SetUp(roster, employees, from, to, opt, p, rows)) return false;
+    Greedy(p, rows);
+
+    // Worker i's stream depends on the seed, the round and i alone; the
+    // threads only share the workers out
+    const unsigned workers = std::max(1u, opt.workers);
+    unsigned threads = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, workers);
+    const int last = opt.maxRounds > 0 ? std::min(opt.rounds, opt.maxRounds) : opt.rounds;
+    Anneal current(p, std::move(rows)), best = current;
+    result = ScheduleResult();
+    result.seed = opt.seed;
+    result.workers = workers;
+    result.rounds = opt.rounds;
+    std::vector<Anneal> runs;
+    for (int round = 0; round < last; round++) {
+        double t = opt.rounds > 1 ? T_FIRST * std::pow(T_LAST / T_FIRST, (double)round / (opt.rounds - 1)) : T_LAST;
+        runs.assign(workers, current);
+        auto run = [&](unsigned first) {
+            for (unsigned i = first; i < workers; i += threads) {
+                runs[i].Seed(opt.seed ^ ((uint64_t)round << 32) ^ ((uint64_t)i * 0xD1B54A32D192ED03ull));
+                runs[i].Run(opt.movesPerRound, t);
+            }
+        };
+        std::vector<std::thread> pool;
+        for (unsigned i = 1; i < threads; i++) pool.emplace_back(run, i);
+        run(0);
+        for (std::thread& th : pool) th.join();
+
+        // The lowest cost goes on to the next round, the lower worker on a tie
+        size_t win = 0;
+        for (size_t i = 1; i < runs.size(); i++)
+            if (runs[i].Cost().Total() < runs[win].Cost().Total()) win = i;
+        current = runs[win];
+        if (current.Cost().Total() < best.Cost().Total()) best = current;
+        result.roundsRun++;
+        result.moves += (uint64_t)opt.movesPerRound * workers;
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (opt.budgetMs > 0 && ms >= opt.budgetMs) break;
+    }
+
+    plan.from = from;
+    plan.to = to;
+    plan.employees = employees;
+    ToPlan(p, best.Rows(), plan);
+    result.cost = best.Cost();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+ScheduleCost ScoreSchedule(const Roster& roster, const SchedulePlan& plan, const ScheduleOptions& opt) {
+    Problem p;
+    std::vector<uint8_t> rows;
+    if (!SetUp(roster, plan.employees, plan.from, plan.to, opt, p, rows) ||
+        plan.codes.size() != p.employees * (size_t)p.days)
+        return ScheduleCost();
+    for (size_t e = 0; e < p.employees; e++)
+        std::copy(plan.codes.begin() + (ptrdiff_t)(e * (size_t)p.days), plan.codes.begin() + (ptrdiff_t)((e + 1) * (size_t)p.days),
+                  rows.begin() + (ptrdiff_t)(e * (size_t)p.stride + (size_t)p.ctx));
+    return Anneal(p, std::move(rows)).Cost();
+}
+
+size_t WriteSchedule(Roster& roster, const SchedulePlan& plan) {
+    size_t changed = 0;
+    const int days = plan.Days();
+    for (size_t e = 0; e < plan.employees.size(); e++) {
+        changed += roster.Shifts(plan.employees[e]).FillWords(plan.from, plan.to, MERGE_OVERWRITE, [&](int32_t day) {
+            uint64_t w = 0;
+            for (int i = 0; i < ShiftStore::SLOTS_PER_WORD; i++) {
+                int d = day + i - plan.from;
+                if (d >= 0 && d < days) w |= (uint64_t)plan.At(e, d) << (2 * i);
+            }
+            return w;
+        });
+    }
+    return changed;
+}
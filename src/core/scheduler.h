@@ -0,0 +1,85 @@
+// ============================================================================
+//  SCHEDULER - fills a month or a quarter for a set of employees: so many
+//  people on the day and the night shift each day, the labour rules of
+//  shift_rules.h, and nights and weekends shared out evenly.
+//  Simulated annealing on every core: each round, a fixed number of workers
+//  anneal a copy of the last round's best plan, each with its own random
+//  stream, a little cooler than the round before; the best plan of all
+//  rounds is kept. The plan depends only on the seed, the worker count, the
+//  cooling schedule and the rounds run - not on the cores or the clock; the
+//  time budget only decides how many rounds run, and ScheduleResult holds
+//  what replays it.
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "roster.h"
+#include "shift_rules.h"
+
+// Employees wanted on each shift
+struct CoverTarget {
+    int day = 1;
+    int night = 1;
+};
+
+struct ScheduleOptions {
+    CoverTarget cover[7];              // by weekday, 0 = Monday
+    ShiftRules  rules;
+    uint64_t    seed = 1;
+    int         rounds = 48;           // the cooling schedule: each one cooler than the last
+    int         maxRounds = 0;         // rounds run at most (0: all of them)
+    int         movesPerRound = 25000;    // per worker
+    int         budgetMs = 2000;       // no new round starts after it (0: no limit)
+    unsigned    workers = 8;           // random streams per round
+    unsigned    threads = 0;           // cores running the workers (0: all); does not change the plan
+};
+
+// Penalty of a plan, lower is better
+struct ScheduleCost {
+    int64_t cover = 0;      // missing or extra people per day and shift
+    int64_t rules = 0;      // broken rules (RuleBits) per day
+    int64_t fairness = 0;   // nights and weekend shifts over an even share (0: even)
+
+    int64_t Total() const { return cover + rules + fairness; }
+};
+
+// The seed, workers and rounds replay the plan: the same options with
+// maxRounds = roundsRun and no time budget give the same plan again
+struct ScheduleResult {
+    ScheduleCost cost;
+    uint64_t     seed = 0;
+    unsigned     workers = 0;
+    int          rounds = 0;       // the cooling schedule
+    int          roundsRun = 0;
+    uint64_t     moves = 0;        // tried, over all workers
+    double       seconds = 0;
+};
+
+// A plan: the code of employee e on day from + d at [e * Days() + d]
+struct SchedulePlan {
+    int32_t                from = 0, to = -1;
+    std::vector<size_t>    employees;   // roster indices
+    std::vector<uint8_t>   codes;
+
+    int       Days() const { return to - from + 1; }
+    ShiftType At(size_t e, int d) const { return (ShiftType)codes[e * (size_t)Days() + (size_t)d]; }
+};
+
+static const int MAX_SCHEDULE_DAYS = 92;   // a quarter
+
+// Plans [from, to] (at most MAX_SCHEDULE_DAYS) for the given employees of
+// the roster; the stored shifts Reach() days before from and after to count
+// for the rules (and are left as they are). False when the
+// range or the employee list is not usable.
+bool SolveSchedule(const Roster& roster, const std::vector<size_t>& employees, int32_t from, int32_t to,
+                   const ScheduleOptions& opt, SchedulePlan& plan, ScheduleResult& result);
+
+// Penalty of a plan against opt, computed from scratch
+ScheduleCost ScoreSchedule(const Roster& roster, const SchedulePlan& plan, const ScheduleOptions& opt);
+
+// Writes the plan over the employees' shifts, one notification per
+// employee; returns the number of days changed
+size_t WriteSchedule(Roster& roster, const SchedulePlan& plan);
@@ -0,0 +1,181 @@
+// ============================================================================
+//  SHIFT HISTORY
+// ============================================================================
+
+#include "shift_history.h"
+#include <algorithm>
+
+static size_t CodeWords(int32_t from, int32_t to) {
+    return (size_t)(to - from) / ShiftStore::SLOTS_PER_WORD + 1;
+}
+
+static uint64_t CodeAt(const std::vector<uint64_t>& v, size_t i) {
+    return (v[i / ShiftStore::SLOTS_PER_WORD] >> (2 * (i % ShiftStore::SLOTS_PER_WORD))) & 3;
+}
+
+static void PutCode(std::vector<uint64_t>& v, size_t i, uint64_t code) {
+    size_t w = i / ShiftStore::SLOTS_PER_WORD;
+    if (w >= v.size()) v.resize(w + 1, 0);
+    v[w] |= code << (2 * (i % ShiftStore::SLOTS_PER_WORD));
+}
+
+// Appends the codes of src behind the len codes already in dst
+static void AppendCodes(std::vector<uint64_t>& dst, size_t len, const std::vector<uint64_t>& src, size_t n) {
+    for (size_t i = 0; i < n; i++) PutCode(dst, len + i, CodeAt(src, i));
+}
+
+size_t ShiftDiff::Days() const {
+    size_t n = 0;
+    for (const Range& r : ranges) n += (size_t)(r.to - r.from + 1);
+    return n;
+}
+
+size_t ShiftDiff::MemoryUsage() const {
+    size_t n = ranges.capacity() * sizeof(Range);
+    for (const Range& r : ranges) n += (r.before.capacity() + r.after.capacity()) * sizeof(uint64_t);
+    return n;
+}
+
+void ShiftHistory::Attach(ShiftStore& store) {
+    Detach();
+    m_store = &store;
+    store.AddObserver(this);
+}
+
+void ShiftHistory::Detach() {
+    if (!m_store) return;
+    m_store->RemoveObserver(this);
+    m_store = nullptr;
+    m_depth = 0;
+    m_implicit = false;
+    m_open = ShiftDiff();
+    ClearHistory();
+}
+
+void ShiftHistory::Begin() {
+    if (m_implicit) { m_implicit = false; m_depth = 1; Commit(); }
+    m_depth++;
+}
+
+bool ShiftHistory::Commit() {
+    if (m_depth == 0) return false;
+    if (--m_depth > 0) return true;
+    m_implicit = false;
+
+    // Keep only the ranges whose codes really changed
+    std::vector<ShiftDiff::Range>& rs = m_open.ranges;
+    for (ShiftDiff::Range& r : rs) {
+        r.after.assign(CodeWords(r.from, r.to), 0);
+        m_store->ReadCodes(r.from, r.to, r.after.data());
+    }
+    rs.erase(std::remove_if(rs.begin(), rs.end(),
+                            [](const ShiftDiff::Range& r) { return r.before == r.after; }),
+             rs.end());
+    if (rs.empty()) return false;
+
+    m_undo.push_back(ShiftDiff());
+    m_undo.back().ranges.swap(rs);
+    if (m_undo.size() > MAX_STEPS) m_undo.erase(m_undo.begin());
+    m_redo.clear();
+    m_open = ShiftDiff();
+    return true;
+}
+
+void ShiftHistory::Rollback() {
+    if (m_depth == 0) return;
+    m_depth--;
+    m_implicit = false;
+    Apply(m_open, false, nullptr, nullptr);
+    m_open = ShiftDiff();
+}
+
+bool ShiftHistory::Undo(int32_t* from, int32_t* to) {
+    if (m_undo.empty() || m_depth > 0) return false;
+    Apply(m_undo.back(), false, from, to);
+    m_redo.push_back(ShiftDiff());
+    m_redo.back().ranges.swap(m_undo.back().ranges);
+    m_undo.pop_back();
+    return true;
+}
+
+bool ShiftHistory::Redo(int32_t* from, int32_t* to) {
+    if (m_redo.empty() || m_depth > 0) return false;
+    Apply(m_redo.back(), true, from, to);
+    m_undo.push_back(ShiftDiff());
+    m_undo.back().ranges.swap(m_redo.back().ranges);
+    m_redo.pop_back();
+    return true;
+}
+
+void ShiftHistory::ClearHistory() {
+    m_undo.clear();
+    m_redo.clear();
+}
+
+size_t ShiftHistory::MemoryUsage() const {
+    size_t n = sizeof(*this) + m_open.MemoryUsage();
+    for (const ShiftDiff& d : m_undo) n += sizeof(d) + d.MemoryUsage();
+    for (const ShiftDiff& d : m_redo) n += sizeof(d) + d.MemoryUsage();
+    return n;
+}
+
+void ShiftHistory::OnShiftsChanging(int32_t from, int32_t to) {
+    if (m_replaying || !m_store) return;
+    if (m_depth == 0) { m_depth = 1; m_implicit = true; }
+    Capture(from, to);
+}
+
+void ShiftHistory::OnShiftsChanged(int32_t, int32_t) {
+    if (m_implicit && m_depth == 1) Commit();
+}
+
+// Records the old codes of the parts of [from, to] not captured yet
+void ShiftHistory::Capture(int32_t from, int32_t to) {
+    std::vector<ShiftDiff::Range>& rs = m_open.ranges;
+    int32_t z = from;
+    while (z <= to) {
+        auto it = std::lower_bound(rs.begin(), rs.end(), z,
+                                   [](const ShiftDiff::Range& r, int32_t day) { return r.to < day; });
+        if (it != rs.end() && it->from <= z) { z = it->to + 1; continue; }
+
+        int32_t end = (it != rs.end() && it->from - 1 < to) ? it->from - 1 : to;
+        ShiftDiff::Range piece;
+        piece.from = z;
+        piece.to = end;
+        piece.before.assign(CodeWords(z, end), 0);
+        m_store->ReadCodes(z, end, piece.before.data());
+
+        // Grow a neighbour instead of adding a range per touched day
+        if (it != rs.begin() && (it - 1)->to == z - 1) {
+            ShiftDiff::Range& prev = *(it - 1);
+            AppendCodes(prev.before, (size_t)(prev.to - prev.from + 1), piece.before, (size_t)(end - z + 1));
+            prev.to = end;
+            if (it != rs.end() && it->from == end + 1) {
+                AppendCodes(prev.before, (size_t)(prev.to - prev.from + 1), it->before, (size_t)(it->to - it->from + 1));
+                prev.to = it->to;
+                rs.erase(it);
+            }
+        } else if (it != rs.end() && it->from == end + 1) {
+            AppendCodes(piece.before, (size_t)(end - z + 1), it->before, (size_t)(it->to - it->from + 1));
+            piece.to = it->to;
+            *it = std::move(piece);
+        } else {
+            rs.insert(it, std::move(piece));
+        }
+        z = end + 1;
+    }
+}
+
+void ShiftHistory::Apply(const ShiftDiff& diff, bool redo, int32_t* from, int32_t* to) {
+    if (diff.ranges.empty()) return;
+    m_replaying = true;
+    for (const ShiftDiff::Range& r : diff.ranges) {
+        const std::vector<uint64_t>& codes = redo ? r.after : r.before;
+        m_store->FillWords(r.from, r.to, MERGE_REPLACE, [&](int32_t day) {
+            return PackedSlotsAt(codes.data(), codes.size(), (int64_t)(day - r.from));
+        });
+    }
+    m_replaying = false;
+    if (from) *from = diff.ranges.front().from;
+    if (to) *to = diff.ranges.back().to;
+}
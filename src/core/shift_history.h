@@ -0,0 +1,84 @@
+// ============================================================================
+//  SHIFT HISTORY - transactions and undo/redo for a ShiftStore
+//  Every step keeps only the old and new codes of the day ranges it touched
+//  (2 bits per day), so undoing a reset or a 12-month copy replays a small
+//  diff instead of restoring a copy of the whole store.
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "shift_store.h"
+
+struct ShiftDiff {
+    struct Range {
+        int32_t from, to;
+        std::vector<uint64_t> before, after;   // packed codes, slot 0 = from
+    };
+    std::vector<Range> ranges;   // sorted, disjoint
+
+    size_t Days() const;
+    size_t MemoryUsage() const;
+};
+
+class ShiftHistory : public ShiftObserver {
+public:
+    static const size_t MAX_STEPS = 100;
+
+    ShiftHistory() {}
+    ~ShiftHistory() { Detach(); }
+
+    void Attach(ShiftStore& store);
+    void Detach();
+
+    // Mutations between Begin() and Commit() become one undo step; outside of
+    // a transaction every store mutation is a step of its own. Nests.
+    void Begin();
+    bool Commit();     // false when nothing changed (no step recorded)
+    void Rollback();   // puts the old codes back
+    bool InTransaction() const { return m_depth > 0; }
+
+    // Apply the previous/next step; [from, to] receives the affected range.
+    bool CanUndo() const { return !m_undo.empty(); }
+    bool CanRedo() const { return !m_redo.empty(); }
+    bool Undo(int32_t* from = nullptr, int32_t* to = nullptr);
+    bool Redo(int32_t* from = nullptr, int32_t* to = nullptr);
+    void ClearHistory();
+
+    size_t UndoSteps() const { return m_undo.size(); }
+    size_t RedoSteps() const { return m_redo.size(); }
+    size_t MemoryUsage() const;
+
+    void OnShiftsChanging(int32_t from, int32_t to) override;
+    void OnShiftsChanged(int32_t from, int32_t to) override;
+
+private:
+    void Capture(int32_t from, int32_t to);
+    void Apply(const ShiftDiff& diff, bool redo, int32_t* from, int32_t* to);
+
+    ShiftStore*            m_store = nullptr;
+    int                    m_depth = 0;
+    bool                   m_implicit = false;   // transaction opened by a lone mutation
+    bool                   m_replaying = false;
+    ShiftDiff              m_open;
+    std::vector<ShiftDiff> m_undo, m_redo;
+
+    ShiftHistory(const ShiftHistory&);
+    ShiftHistory& operator=(const ShiftHistory&);
+};
+
+// Scoped transaction: rolls back unless Commit() was called.
+class ShiftTransaction {
+public:
+    explicit ShiftTransaction(ShiftHistory& h) : m_history(h) { h.Begin(); }
+    ~ShiftTransaction() { if (!m_done) m_history.Rollback(); }
+    bool Commit() { m_done = true; return m_history.Commit(); }
+
+private:
+    ShiftHistory& m_history;
+    bool          m_done = false;
+
+    ShiftTransaction(const ShiftTransaction&);
+    ShiftTransaction& operator=(const ShiftTransaction&);
+};
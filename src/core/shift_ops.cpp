@@ -0,0 +1,88 @@
+// ============================================================================
+//  SHIFT OPS
+// ============================================================================
+
+#include "shift_ops.h"
+#include <algorithm>
+#include <vector>
+#include "bits.h"
+
+// The codes of [from, to], from = slot 0
+static std::vector<uint64_t> Snapshot(const ShiftStore& s, int32_t from, int32_t to) {
+    std::vector<uint64_t> w((size_t)(to - from) / ShiftStore::SLOTS_PER_WORD + 1);
+    s.ReadCodes(from, to, w.data());
+    return w;
+}
+
+static bool AnySet(const std::vector<uint64_t>& w) {
+    for (uint64_t x : w) if (x) return true;
+    return false;
+}
+
+// Replaces [from, to] of dst with codes (slot 0 = from)
+static size_t PutCodes(ShiftStore& dst, int32_t from, int32_t to, const std::vector<uint64_t>& codes) {
+    if (!AnySet(codes)) return ClearRange(dst, from, to);
+    return dst.FillWords(from, to, MERGE_REPLACE, [&](int32_t day) {
+        return PackedSlotsAt(codes.data(), codes.size(), (int64_t)day - from);
+    });
+}
+
+int CopyMonthPattern(ShiftStore& store, int srcM, int srcY, int dstM, int dstY, bool overwrite) {
+    int n = std::min(DaysInMonth(srcM, srcY), DaysInMonth(dstM, dstY));
+    int32_t src = MonthStart(srcM, srcY);
+    return (int)CopyRange(store, src, src + n - 1, store, MonthStart(dstM, dstY), overwrite ? MERGE_OVERWRITE : MERGE_KEEP);
+}
+
+size_t ClearRange(ShiftStore& store, int32_t from, int32_t to) {
+    if (store.CountByType(from, to).Total() == 0) return 0;
+    return store.FillWords(from, to, MERGE_REPLACE, [](int32_t) { return 0ull; });
+}
+
+int ClearMonth(ShiftStore& store, int m, int y) {
+    int32_t first = MonthStart(m, y);
+    return (int)ClearRange(store, first, first + DaysInMonth(m, y) - 1);
+}
+
+size_t ClearAll(ShiftStore& store) {
+    size_t count = store.Count();
+    store.Clear();
+    return count;
+}
+
+size_t FillRange(ShiftStore& store, int32_t from, int32_t to, ShiftType st, MergeMode mode) {
+    if (st == SHIFT_NONE) return mode == MERGE_KEEP ? 0 : ClearRange(store, from, to);
+    const uint64_t pattern = SLOT_LOW_BITS * (uint64_t)st;
+    return store.FillWords(from, to, mode, [=](int32_t) { return pattern; });
+}
+
+size_t CopyRange(const ShiftStore& src, int32_t from, int32_t to, ShiftStore& dst, int32_t dstFrom, MergeMode mode) {
+    if (to < from) return 0;
+    // Read first: the spans may overlap in one store
+    std::vector<uint64_t> codes = Snapshot(src, from, to);
+    if (mode == MERGE_REPLACE) return PutCodes(dst, dstFrom, dstFrom + (to - from), codes);
+    if (!AnySet(codes)) return 0;
+    return dst.FillWords(dstFrom, dstFrom + (to - from), mode, [&](int32_t day) {
+        return PackedSlotsAt(codes.data(), codes.size(), (int64_t)day - dstFrom);
+    });
+}
+
+size_t ShiftRange(ShiftStore& store, int32_t from, int32_t to, int32_t days) {
+    if (to < from || days == 0 || store.CountByType(from, to).Total() == 0) return 0;
+    // One write over both spans: moved codes in the new span, the old span
+    // cleared, the days between them (a long move) left alone
+    const int32_t lo = std::min(from, from + days), hi = std::max(to, to + days);
+    std::vector<uint64_t> old = Snapshot(store, lo, hi);
+    return store.FillWords(lo, hi, MERGE_REPLACE, [&](int32_t day) {
+        int64_t slot = (int64_t)day - lo;
+        uint64_t target = SlotRangeMask(from + days - day, to + days - day);
+        uint64_t moved = PackedSlotsAt(old.data(), old.size(), slot - days) & target;
+        uint64_t kept = PackedSlotsAt(old.data(), old.size(), slot) & ~target & ~SlotRangeMask(from - day, to - day);
+        return moved | kept;
+    });
+}
+
+size_t SwapRanges(ShiftStore& a, ShiftStore& b, int32_t from, int32_t to) {
+    if (&a == &b || to < from) return 0;
+    std::vector<uint64_t> ca = Snapshot(a, from, to), cb = Snapshot(b, from, to);
+    return PutCodes(a, from, to, cb) + PutCodes(b, from, to, ca);
+}
@@ -0,0 +1,43 @@
+// ============================================================================
+//  SHIFT OPS - range edits behind the UI buttons (Kopiraj raspored, Obrisi
+//  mjesec, Reset) and the CLI; no windows.h
+//  Every range operation reads and writes 32 days per packed word through
+//  ShiftStore::FillWords, so it notifies observers once per store however
+//  long the range is.
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include "shift_store.h"
+
+// Copies the set days of month srcM/srcY onto dstM/dstY, up to the shorter
+// month. Without overwrite, days already set in the target stay.
+// Returns the number of days changed.
+int CopyMonthPattern(ShiftStore& store, int srcM, int srcY, int dstM, int dstY, bool overwrite);
+
+// Clears the inclusive day range / one month; returns the number of shifts removed.
+size_t ClearRange(ShiftStore& store, int32_t from, int32_t to);
+int ClearMonth(ShiftStore& store, int m, int y);
+
+// Sets every day of [from, to] to st (SHIFT_NONE clears); MERGE_KEEP only
+// fills empty days. Returns the number of days changed.
+size_t FillRange(ShiftStore& store, int32_t from, int32_t to, ShiftType st, MergeMode mode = MERGE_OVERWRITE);
+
+// Copies the days of src [from, to] to dst from dstFrom on, with the merge
+// rules of FillWords (MERGE_REPLACE copies empty days too). src and dst may
+// be the same store and the spans may overlap. Returns the days changed.
+size_t CopyRange(const ShiftStore& src, int32_t from, int32_t to, ShiftStore& dst, int32_t dstFrom,
+                 MergeMode mode = MERGE_OVERWRITE);
+
+// Moves the schedule of [from, to] by days (negative: earlier): the moved
+// span replaces what was there, the days it leaves are cleared and the rest
+// stay. Returns the days changed.
+size_t ShiftRange(ShiftStore& store, int32_t from, int32_t to, int32_t days);
+
+// Exchanges the days of [from, to] between two employees' stores; returns
+// the days changed in both
+size_t SwapRanges(ShiftStore& a, ShiftStore& b, int32_t from, int32_t to);
+
+// Clears everything; returns the number of shifts removed.
+size_t ClearAll(ShiftStore& store);
@@ -0,0 +1,142 @@
+// ============================================================================
+//  SHIFT RULES
+// ============================================================================
+
+#include "shift_rules.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+int ShiftRules::Reach() const {
+    // The week rule looks back to Monday, the rest rule one day
+    return std::max(std::max(maxWorkRun, maxNightRun), 6);
+}
+
+void CheckRules(const ShiftStore& s, const ShiftRules& rules, int32_t from, int32_t to,
+                std::vector<RuleViolation>& out) {
+    out.clear();
+    if (to < from) return;
+    const int32_t lo = from - rules.Reach();
+    // Read a block of days at a time
+    static const int BLOCK = 4096;
+    uint64_t codes[BLOCK / ShiftStore::SLOTS_PER_WORD];
+    RuleScan scan(rules);
+    int weekday = WeekdayFromDays(lo);
+    for (int32_t start = lo; start <= to; start += BLOCK) {
+        int32_t end = std::min(to, start + BLOCK - 1);
+        s.ReadCodes(start, end, codes);
+        for (int32_t z = start; z <= end; z++) {
+            int slot = z - start;
+            ShiftType st = (ShiftType)((codes[slot / ShiftStore::SLOTS_PER_WORD] >> (2 * (slot % ShiftStore::SLOTS_PER_WORD))) & 3);
+            uint8_t bits = scan.Step(st, weekday);
+            if (bits && z >= from) out.push_back(RuleViolation{ z, bits });
+            weekday = weekday == 6 ? 0 : weekday + 1;
+        }
+    }
+}
+
+// ============================================================================
+//  HISTORY
+// ============================================================================
+
+namespace {
+
+// Up to 16 stored years of one store; chunks read the days before them as
+// context, so they can be checked in any order
+struct RuleJob {
+    const ShiftStore*          store;
+    size_t                     owner;
+    int32_t                    from, to;
+    std::vector<RuleViolation> found;
+};
+
+const int CHUNK_YEARS = 16;
+
+void AddJobs(std::vector<RuleJob>& jobs, const ShiftStore& s, size_t owner) {
+    if (s.Empty()) return;
+    int last = s.FirstYear() + s.YearCount() - 1;
+    for (int y = s.FirstYear(); y <= last; y += CHUNK_YEARS) {
+        int y2 = std::min(last, y + CHUNK_YEARS - 1);
+        jobs.push_back(RuleJob{ &s, owner, DaysFromCivil(y, 1, 1), DaysFromCivil(y2 + 1, 1, 1) - 1, {} });
+    }
+}
+
+void RunJobs(std::vector<RuleJob>& jobs, const ShiftRules& rules, unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = (unsigned)std::min<size_t>(threads, jobs.size());
+    std::atomic<size_t> next{ 0 };
+    auto run = [&] {
+        for (size_t j; (j = next.fetch_add(1)) < jobs.size(); )
+            CheckRules(*jobs[j].store, rules, jobs[j].from, jobs[j].to, jobs[j].found);
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(run);
+    run();
+    for (std::thread& th : pool) th.join();
+}
+
+} // namespace
+
+void ValidateRoster(const Roster& roster, const ShiftRules& rules, std::vector<std::vector<RuleViolation>>& out,
+                    unsigned threads) {
+    std::vector<RuleJob> jobs;
+    for (size_t i = 0; i < roster.Size(); i++) AddJobs(jobs, roster.Shifts(i), i);
+    RunJobs(jobs, rules, threads);
+    // Jobs are in day order per employee
+    out.assign(roster.Size(), std::vector<RuleViolation>());
+    for (RuleJob& j : jobs) out[j.owner].insert(out[j.owner].end(), j.found.begin(), j.found.end());
+}
+
+void ValidateHistory(const ShiftStore& s, const ShiftRules& rules, std::vector<RuleViolation>& out,
+                     unsigned threads) {
+    std::vector<RuleJob> jobs;
+    AddJobs(jobs, s, 0);
+    RunJobs(jobs, rules, threads);
+    out.clear();
+    for (RuleJob& j : jobs) out.insert(out.end(), j.found.begin(), j.found.end());
+}
+
+// ============================================================================
+//  VALIDATOR
+// ============================================================================
+
+void RuleValidator::Attach(ShiftStore& store) {
+    Detach();
+    m_store = &store;
+    m_store->AddObserver(this);
+    SetRules(m_rules);
+}
+
+void RuleValidator::Detach() {
+    if (!m_store) return;
+    m_store->RemoveObserver(this);
+    m_store = nullptr;
+    m_marks.clear();
+}
+
+void RuleValidator::SetRules(const ShiftRules& rules) {
+    m_rules = rules;
+    m_marks.clear();
+    if (!m_store || m_store->Empty()) return;
+    int first = m_store->FirstYear();
+    Recheck(DaysFromCivil(first, 1, 1), DaysFromCivil(first + m_store->YearCount(), 1, 1) - 1);
+}
+
+void RuleValidator::Recheck(int32_t from, int32_t to) {
+    CheckRules(*m_store, m_rules, from, to, m_scratch);
+    auto after = m_marks.erase(m_marks.lower_bound(from), m_marks.upper_bound(to));
+    for (const RuleViolation& v : m_scratch) m_marks.emplace_hint(after, v.day, v.rules);
+}
+
+void RuleValidator::OnShiftsChanged(int32_t from, int32_t to) {
+    Recheck(from, to + m_rules.Reach());
+    m_checked += (size_t)(to + m_rules.Reach() - from + 1);
+}
+
+uint32_t RuleValidator::MonthMask(int m, int y) const {
+    int32_t first = MonthStart(m, y), last = first + DaysInMonth(m, y) - 1;
+    uint32_t mask = 0;
+    for (auto it = m_marks.lower_bound(first); it != m_marks.end() && it->first <= last; ++it)
+        mask |= 1u << (it->first - first);
+    return mask;
+}
@@ -0,0 +1,118 @@
+// ============================================================================
+//  SHIFT RULES - labour rules of a schedule: rest after a night shift,
+//  longest run of working days and of nights, free days per ISO week.
+//  Every rule looks only at a day and the days before it, so an edit of
+//  [from, to] can change the marks of [from, to + Reach()] and nothing
+//  else; RuleValidator rechecks just that window on every edit.
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+#include "roster.h"
+#include "shift_store.h"
+
+enum RuleBits {
+    RULE_REST       = 1,   // a day shift right after a night shift
+    RULE_WORK_RUN   = 2,   // working day (D or N) past maxWorkRun in a row
+    RULE_NIGHT_RUN  = 4,   // night past maxNightRun in a row
+    RULE_WEEK_FREE  = 8    // working day that leaves the ISO week under minFreePerWeek
+};
+
+struct ShiftRules {
+    bool rest = true;
+    int  maxWorkRun = 6;
+    int  maxNightRun = 4;
+    int  minFreePerWeek = 1;   // days without D or N, Monday to Sunday
+
+    // Days after an edit whose marks the edit can change
+    int Reach() const;
+};
+
+// Steps through consecutive days and tells which rules each one breaks;
+// started Reach() days before a day, it sees all the context that day needs
+class RuleScan {
+public:
+    explicit RuleScan(const ShiftRules& rules)
+        : m_rules(rules), m_weekWorkMax(rules.minFreePerWeek > 0 ? 7 - rules.minFreePerWeek : 7) {}
+
+    // RuleBits of the next day (weekday 0 = Monday)
+    uint8_t Step(ShiftType st, int weekday) {
+        bool working = st == SHIFT_DAY || st == SHIFT_NIGHT;
+        if (weekday == 0) m_weekWork = 0;
+        m_workRun = working ? m_workRun + 1 : 0;
+        m_nightRun = st == SHIFT_NIGHT ? m_nightRun + 1 : 0;
+        m_weekWork += working;
+        uint8_t bits = 0;
+        if (m_rules.rest && st == SHIFT_DAY && m_prev == SHIFT_NIGHT) bits |= RULE_REST;
+        if (m_rules.maxWorkRun > 0 && m_workRun > m_rules.maxWorkRun) bits |= RULE_WORK_RUN;
+        if (m_rules.maxNightRun > 0 && m_nightRun > m_rules.maxNightRun) bits |= RULE_NIGHT_RUN;
+        if (working && m_weekWork > m_weekWorkMax) bits |= RULE_WEEK_FREE;
+        m_prev = st;
+        return bits;
+    }
+
+private:
+    const ShiftRules& m_rules;
+    int       m_weekWorkMax;
+    int       m_workRun = 0, m_nightRun = 0, m_weekWork = 0;
+    ShiftType m_prev = SHIFT_NONE;
+};
+
+struct RuleViolation {
+    int32_t day;
+    uint8_t rules;   // RuleBits
+};
+
+// Violations on the days of [from, to], in day order (the days before from
+// are read as context)
+void CheckRules(const ShiftStore& s, const ShiftRules& rules, int32_t from, int32_t to,
+                std::vector<RuleViolation>& out);
+
+// Violations of the stored history of every employee (out[i] for index i),
+// checked in year chunks across threads (0 = one per core)
+void ValidateRoster(const Roster& roster, const ShiftRules& rules, std::vector<std::vector<RuleViolation>>& out,
+                    unsigned threads = 0);
+// The same for one store
+void ValidateHistory(const ShiftStore& s, const ShiftRules& rules, std::vector<RuleViolation>& out,
+                     unsigned threads = 0);
+
+// The violations of one store, kept current as it is edited
+class RuleValidator : public ShiftObserver {
+public:
+    explicit RuleValidator(const ShiftRules& rules = ShiftRules()) : m_rules(rules) {}
+    ~RuleValidator() { Detach(); }
+
+    // Checks the whole history once, then only the edited windows
+    void Attach(ShiftStore& store);
+    void Detach();
+    void SetRules(const ShiftRules& rules);
+    const ShiftRules& Rules() const { return m_rules; }
+
+    uint8_t At(int32_t day) const {
+        auto it = m_marks.find(day);
+        return it == m_marks.end() ? 0 : it->second;
+    }
+    // Bit d - 1 set when day d of the month breaks a rule
+    uint32_t MonthMask(int m, int y) const;
+    size_t   Count() const { return m_marks.size(); }
+    // Days rechecked by edits so far
+    size_t   Checked() const { return m_checked; }
+
+    void OnShiftsChanged(int32_t from, int32_t to) override;
+
+private:
+    void Recheck(int32_t from, int32_t to);
+
+    ShiftRules                 m_rules;
+    ShiftStore*                m_store = nullptr;
+    std::map<int32_t, uint8_t> m_marks;   // only the days that break a rule
+    std::vector<RuleViolation> m_scratch;
+    size_t                     m_checked = 0;
+
+    RuleValidator(const RuleValidator&);
+    RuleValidator& operator=(const RuleValidator&);
+};
@@ -0,0 +1,376 @@
+// ============================================================================
+//  SHIFT SEARCH
+// ============================================================================
+
+#include "shift_search.h"
+#include <algorithm>
+#include <cstring>
+#include "bits.h"
+
+// ============================================================================
+//  INDEX
+// ============================================================================
+
+// Bits 0, 7, 14, ... 63: every 7th day from bit 0
+static const uint64_t EVERY_7TH = 0x8102040810204081ull;
+
+void ShiftIndex::Build(const ShiftStore& s, int32_t from, int32_t to, const HolidayCalendar* holidays) {
+    m_from = from;
+    m_to = to;
+    m_words = to < from ? 0 : (size_t)(to - from) / 64 + 1;
+    m_bits.assign(12 * m_words, 0);
+    if (!m_words) return;
+
+    // Two packed words (32 days each) per bitset word
+    std::vector<uint64_t> codes(m_words * 2);
+    s.ReadCodes(from, to, codes.data());
+    const uint64_t tail = TailMask();
+    for (size_t k = 0; k < m_words; k++) {
+        const uint64_t lo = codes[2 * k], hi = codes[2 * k + 1];
+        const uint64_t valid = k + 1 == m_words ? tail : ~0ull;
+        for (unsigned st = 0; st < 4; st++)
+            m_bits[st * m_words + k] = (CompactSlots(SlotsEqual(lo, st)) | (uint64_t)CompactSlots(SlotsEqual(hi, st)) << 32) & valid;
+        const int32_t first = from + (int32_t)(k * 64);
+        const int w0 = WeekdayFromDays(first);
+        for (int wd = 0; wd < 7; wd++) m_bits[(4 + wd) * m_words + k] = (EVERY_7TH << ((wd - w0 + 7) % 7)) & valid;
+        if (holidays) m_bits[11 * m_words + k] = holidays->Bits(first) & valid;
+    }
+}
+
+uint64_t ShiftIndex::TailMask() const {
+    int used = (int)((m_to - m_from) % 64) + 1;
+    return used == 64 ? ~0ull : (1ull << used) - 1;
+}
+
+// ============================================================================
+//  PARSER
+// ============================================================================
+
+struct ShiftSearch::Parser {
+    static const int MAX_DEPTH = 32;
+
+    const char*        p;
+    std::vector<Node>& prog;
+    const char*        err = nullptr;
+    const char*        at = nullptr;
+    int                depth = 0;
+
+    void Fail(const char* why, const char* where) {
+        if (!err) { err = why; at = where; }
+    }
+    void Emit(Op op, uint8_t arg = 0, int32_t from = 0, int32_t to = 0) {
+        if (err) return;
+        if (prog.size() >= (size_t)MAX_NODES) { Fail("upit je predug", p); return; }
+        Node n;
+        n.op = op; n.arg = arg; n.from = from; n.to = to;
+        prog.push_back(n);
+    }
+    void Skip() { while (*p == ' ' || *p == '\t') p++; }
+    static bool IsLetter(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+    static bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+    // The word at p, lower case, without taking it
+    size_t Peek(char* w, size_t cap) {
+        Skip();
+        size_t n = 0;
+        while (IsLetter(p[n])) {
+            if (n + 1 < cap) w[n] = (char)(p[n] | 0x20);
+            n++;
+        }
+        w[n < cap ? n : cap - 1] = 0;
+        return n;
+    }
+    bool AcceptWord(const char* word) {
+        char w[16];
+        size_t n = Peek(w, sizeof(w));
+        if (n == 0 || strcmp(w, word) != 0) return false;
+        p += n;
+        return true;
+    }
+    void Expect(char c) {
+        Skip();
+        if (*p == c) p++;
+        else Fail(c == '(' ? "ocekivana zagrada (" : "ocekivana zagrada )", p);
+    }
+    bool StartsFactor() {
+        Skip();
+        char w[16];
+        if (IsLetter(*p)) return Peek(w, sizeof(w)) && strcmp(w, "ili") != 0;
+        return *p == '!' || *p == '(' || IsDigit(*p);
+    }
+
+    void Expr() {
+        Term();
+        while (!err) {
+            Skip();
+            if (*p == '|') p++;
+            else if (!AcceptWord("ili")) break;
+            Term();
+            Emit(OR);
+        }
+    }
+    // "a & b", "a i b" and "a b" alike
+    void Term() {
+        Factor();
+        while (!err) {
+            Skip();
+            if (*p == '&') p++;
+            else if (!AcceptWord("i") && !StartsFactor()) break;
+            Factor();
+            Emit(AND);
+        }
+    }
+    void Factor() {
+        Skip();
+        if (++depth > MAX_DEPTH) Fail("previse ugnijezdjen upit", p);
+        else if (*p == '!') { p++; Factor(); Emit(NOT); }
+        else if (AcceptWord("ne")) { Factor(); Emit(NOT); }
+        else if (*p == '(') { p++; Expr(); Expect(')'); }
+        else if (IsDigit(*p)) Dates();
+        else if (IsLetter(*p)) Word();
+        else Fail(*p ? "neocekivan znak" : "nedostaje izraz", p);
+        depth--;
+    }
+
+    void Word() {
+        static const char* const TYPES[] = { "prazan", "d", "n", "s" };
+        static const char* const TYPE_NAMES[] = { "", "dnevna", "nocna", "slobodan" };
+        static const char* const DAYS[] = { "pon", "uto", "sri", "cet", "pet", "sub", "ned" };
+        static const char* const MONTHS[] = { "jan", "feb", "mar", "apr", "maj", "jun",
+                                              "jul", "avg", "sep", "okt", "nov", "dec" };
+        static const char* const MONTH_NAMES[] = { "januar", "februar", "mart", "april", "maj", "juni",
+                                                   "juli", "august", "septembar", "oktobar", "novembar", "decembar" };
+        const char* start = p;
+        char w[16];
+        size_t n = Peek(w, sizeof(w));
+        p += n;
+        for (uint8_t i = 0; i < 4; i++)
+            if (!strcmp(w, TYPES[i]) || (i && !strcmp(w, TYPE_NAMES[i]))) { Emit(TYPE, i); return; }
+        for (uint8_t i = 0; i < 7; i++)
+            if (!strcmp(w, DAYS[i])) { Emit(WEEKDAY, i); return; }
+        for (uint8_t i = 0; i < 12; i++)
+            if (!strcmp(w, MONTHS[i]) || !strcmp(w, MONTH_NAMES[i])) { Emit(MONTH, (uint8_t)(i + 1)); return; }
+        if (!strcmp(w, "radni")) Emit(WORKING);
+        else if (!strcmp(w, "vikend")) { Emit(WEEKDAY, 5); Emit(WEEKDAY, 6); Emit(OR); }
+        else if (!strcmp(w, "praznik")) Emit(HOLIDAY);
+        else if (!strcmp(w, "prije") || !strcmp(w, "poslije")) {
+            Op op = w[1] == 'r' ? BEFORE : AFTER;
+            Expect('(');
+            Expr();
+            Expect(')');
+            Emit(op);
+        } else if (!strcmp(w, "mjesec")) {
+            Expect('(');
+            Expr();
+            Expect(')');
+            MonthCount();
+        } else {
+            Fail("nepoznata rijec", start);
+        }
+    }
+
+    // "> 12" after mjesec(...)
+    void MonthCount() {
+        Skip();
+        Cmp cmp;
+        if (p[0] == '>' && p[1] == '=') { cmp = GREATER_EQ; p += 2; }
+        else if (p[0] == '<' && p[1] == '=') { cmp = LESS_EQ; p += 2; }
+        else if (*p == '>') { cmp = GREATER; p++; }
+        else if (*p == '<') { cmp = LESS; p++; }
+        else if (*p == '=') { cmp = EQUAL; p++; }
+        else { Fail("ocekivano poredjenje (> < >= <= =)", p); return; }
+        Skip();
+        int count = 0;
+        const char* digits = p;
+        while (IsDigit(*p) && count <= 31) count = count * 10 + (*p++ - '0');
+        if (p == digits || count > 31 || IsDigit(*p)) { Fail("ocekivan broj dana (0-31)", digits); return; }
+        Emit(MONTH_COUNT, cmp, count);
+    }
+
+    // "YYYY", "YYYY-MM" or "YYYY-MM-DD": its first and last day
+    bool Date(int32_t& first, int32_t& last) {
+        const char* start = p;
+        int v[3] = { 0, 0, 0 }, parts = 0;
+        const int width[3] = { 4, 2, 2 };
+        for (; parts < 3; parts++) {
+            if (parts && !(*p == '-' && IsDigit(p[1]))) break;
+            if (parts) p++;
+            for (int i = 0; i < width[parts]; i++) {
+                if (!IsDigit(*p)) { Fail("neispravan datum (YYYY, YYYY-MM ili YYYY-MM-DD)", start); return false; }
+                v[parts] = v[parts] * 10 + (*p++ - '0');
+            }
+        }
+        if (IsDigit(*p) || IsLetter(*p) || v[0] < ShiftStore::MIN_YEAR || v[0] > ShiftStore::MAX_YEAR ||
+            (parts > 1 && (v[1] < 1 || v[1] > 12)) || (parts > 2 && (v[2] < 1 || v[2] > DaysInMonth(v[1], v[0])))) {
+            Fail("nepostojeci datum", start);
+            return false;
+        }
+        if (parts == 1) { first = DaysFromCivil(v[0], 1, 1); last = DaysFromCivil(v[0], 12, 31); }
+        else if (parts == 2) { first = MonthStart(v[1], v[0]); last = first + DaysInMonth(v[1], v[0]) - 1; }
+        else first = last = DaysFromCivil(v[0], v[1], v[2]);
+        return true;
+    }
+    void Dates() {
+        const char* start = p;
+        int32_t from, to, a, b;
+        if (!Date(from, to)) return;
+        if (p[0] == '.' && p[1] == '.') {
+            p += 2;
+            if (!Date(a, b)) return;
+            if (b < from) { Fail("kraj perioda je prije pocetka", start); return; }
+            to = b;
+        }
+        Emit(DATES, 0, from, to);
+    }
+};
+
+const char* ShiftSearch::Compile(const char* text, size_t* errorAt) {
+    m_prog.clear();
+    m_stack = 0;
+    Parser ps = { text, m_prog };
+    ps.Skip();
+    if (!*ps.p) ps.Fail("prazan upit", ps.p);
+    else {
+        ps.Expr();
+        ps.Skip();
+        if (*ps.p) ps.Fail(*ps.p == ')' ? "visak zagrade )" : "neocekivan tekst", ps.p);
+    }
+    if (ps.err) {
+        m_prog.clear();
+        if (errorAt) *errorAt = (size_t)(ps.at - text);
+        return ps.err;
+    }
+    // Stack depth of the program
+    int depth = 0;
+    for (const Node& n : m_prog) {
+        if (n.op == AND || n.op == OR) depth--;
+        else if (n.op < AND) m_stack = std::max(m_stack, ++depth);
+    }
+    return nullptr;
+}
+
+void ShiftSearch::Span(const ShiftStore& s, int32_t& from, int32_t& to) const {
+    if (s.YearCount()) {
+        from = std::min(from, DaysFromCivil(s.FirstYear(), 1, 1));
+        to = std::max(to, DaysFromCivil(s.FirstYear() + s.YearCount(), 1, 1) - 1);
+    }
+    int shifts = 0;   // prije/poslije: each one reads a day further out
+    for (const Node& n : m_prog) {
+        shifts += n.op == BEFORE || n.op == AFTER;
+        if (n.op != DATES) continue;
+        from = std::min(from, n.from);
+        to = std::max(to, n.to);
+    }
+    if (to < from) return;
+    from = std::max(from - shifts, DaysFromCivil(ShiftStore::MIN_YEAR, 1, 1));
+    to = std::min(to + shifts, DaysFromCivil(ShiftStore::MAX_YEAR, 12, 31));
+    CivilDate a = CivilFromDays(from), b = CivilFromDays(to);
+    from = MonthStart(a.m, a.y);
+    to = MonthStart(b.m, b.y) + DaysInMonth(b.m, b.y) - 1;
+}
+
+// ============================================================================
+//  EVALUATION
+// ============================================================================
+
+// Calls fn(k, mask) for the words k of a bitset of words words that hold
+// bits of [a, b] (clipped to the bitset), mask = those bits of word k
+template <class Fn>
+static void ForBits(size_t words, int64_t a, int64_t b, Fn&& fn) {
+    a = std::max<int64_t>(a, 0);
+    b = std::min<int64_t>(b, (int64_t)words * 64 - 1);
+    for (int64_t k = a / 64; a <= b && k <= b / 64; k++) {
+        int lo = k == a / 64 ? (int)(a % 64) : 0, hi = k == b / 64 ? (int)(b % 64) : 63;
+        fn((size_t)k, (hi == 63 ? ~0ull : (1ull << (hi + 1)) - 1) & ~((1ull << lo) - 1));
+    }
+}
+
+// cmp in the order of ShiftSearch::Cmp: <, <=, =, >=, >
+static bool Compare(int count, int cmp, int want) {
+    switch (cmp) {
+    case 0:  return count < want;
+    case 1:  return count <= want;
+    case 2:  return count == want;
+    case 3:  return count >= want;
+    default: return count > want;
+    }
+}
+
+void ShiftSearch::Evaluate(const ShiftIndex& index, std::vector<uint64_t>& out) const {
+    const size_t n = index.Words();
+    out.assign(n, 0);
+    if (!n || m_prog.empty()) return;
+    const int32_t base = index.From();
+    const uint64_t tail = index.TailMask();
+    const CivilDate first = CivilFromDays(index.From()), last = CivilFromDays(index.To());
+
+    std::vector<uint64_t> stack((size_t)m_stack * n);
+    size_t sp = 0;   // bitsets on the stack
+    for (const Node& node : m_prog) {
+        if (node.op < AND) sp++;
+        uint64_t* x = stack.data() + (sp - 1) * n;   // the top
+        switch (node.op) {
+        case TYPE:    std::copy(index.Type((ShiftType)node.arg), index.Type((ShiftType)node.arg) + n, x); break;
+        case WEEKDAY: std::copy(index.Weekday(node.arg), index.Weekday(node.arg) + n, x); break;
+        case HOLIDAY: std::copy(index.Holidays(), index.Holidays() + n, x); break;
+        case WORKING:
+            for (size_t k = 0; k < n; k++) x[k] = index.Type(SHIFT_DAY)[k] | index.Type(SHIFT_NIGHT)[k];
+            break;
+        case MONTH:
+            std::fill(x, x + n, 0);
+            for (int yr = first.y; yr <= last.y; yr++) {
+                int64_t m1 = (int64_t)MonthStart(node.arg, yr) - base;
+                ForBits(n, m1, m1 + DaysInMonth(node.arg, yr) - 1, [&](size_t k, uint64_t mask) { x[k] |= mask; });
+            }
+            break;
+        case DATES:
+            std::fill(x, x + n, 0);
+            ForBits(n, (int64_t)node.from - base, (int64_t)node.to - base, [&](size_t k, uint64_t mask) { x[k] |= mask; });
+            break;
+        case AND:
+        case OR: {
+            uint64_t* under = x - n;
+            if (node.op == AND) for (size_t k = 0; k < n; k++) under[k] &= x[k];
+            else for (size_t k = 0; k < n; k++) under[k] |= x[k];
+            sp--;
+            break;
+        }
+        case NOT:
+            for (size_t k = 0; k < n; k++) x[k] = ~x[k];
+            x[n - 1] &= tail;
+            break;
+        case BEFORE:   // bit i = bit i + 1
+            for (size_t k = 0; k < n; k++) x[k] = (x[k] >> 1) | (k + 1 < n ? x[k + 1] << 63 : 0);
+            break;
+        case AFTER:    // bit i = bit i - 1
+            for (size_t k = n; k-- > 0; ) x[k] = (x[k] << 1) | (k ? x[k - 1] >> 63 : 0);
+            x[n - 1] &= tail;
+            break;
+        case MONTH_COUNT:
+            // In place, month by month: a month's bits are counted before they are replaced
+            for (int yr = first.y, m = first.m; yr < last.y || (yr == last.y && m <= last.m); ) {
+                int64_t a = (int64_t)MonthStart(m, yr) - base, b = a + DaysInMonth(m, yr) - 1;
+                int count = 0;
+                ForBits(n, a, b, [&](size_t k, uint64_t mask) { count += PopCount64(x[k] & mask); });
+                bool keep = Compare(count, node.arg, node.from);
+                ForBits(n, a, b, [&](size_t k, uint64_t mask) { x[k] = keep ? x[k] | mask : x[k] & ~mask; });
+                if (++m > 12) { m = 1; yr++; }
+            }
+            x[n - 1] &= tail;
+            break;
+        }
+    }
+    std::copy(stack.data(), stack.data() + n, out.begin());
+}
+
+uint32_t SearchMonth(const ShiftSearch& search, const ShiftStore& s, const HolidayCalendar* holidays, int m, int y) {
+    if (search.Empty()) return 0;
+    const int32_t first = MonthStart(m, y);
+    int32_t from = first, to = first + DaysInMonth(m, y) - 1;
+    search.Span(s, from, to);
+    ShiftIndex index;
+    index.Build(s, from, to, holidays);
+    std::vector<uint64_t> hits;
+    search.Evaluate(index, hits);
+    return (uint32_t)(BitsAt(hits.data(), hits.size(), first - from) & ((1ull << DaysInMonth(m, y)) - 1));
+}
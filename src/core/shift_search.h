@@ -0,0 +1,82 @@
+// ============================================================================
+//  SHIFT SEARCH - questions about the schedule as bit operations. ShiftIndex
+//  turns a day range of a store into bitsets (one per shift type, weekday
+//  and the holidays, one bit per day); a ShiftSearch expression compiles to
+//  a small stack program over them and runs 64 days per operation.
+//
+//  Expressions (case does not matter):
+//      D N S prazan radni          shift type (radni = D or N)
+//      pon uto sri cet pet sub ned vikend praznik
+//      jan ... dec (or januar ... decembar)      that month of every year
+//      2025   2025-03   2025-03-01   2025-01..2025-06   a date range
+//      a b  a i b  a & b           both            a ili b  a | b    either
+//      ne a  !a                    not             ( a )
+//      prije(a)  poslije(a)        the day before / after an a day
+//      mjesec(a) > 12              days of the months with more than 12 a
+//                                  days (also <, >=, <=, =)
+//  e.g. "N sub 2025", "S (prije(praznik) ili poslije(praznik))",
+//  "N mjesec(N) > 12".
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "holidays.h"
+#include "shift_store.h"
+
+class ShiftIndex {
+public:
+    // Bitsets of [from, to]; no holidays without a calendar
+    void Build(const ShiftStore& s, int32_t from, int32_t to, const HolidayCalendar* holidays = nullptr);
+
+    int32_t From() const { return m_from; }
+    int32_t To() const { return m_to; }
+    size_t  Words() const { return m_words; }
+    // Bit i of word i / 64: day From() + i
+    const uint64_t* Type(ShiftType st) const { return m_bits.data() + (size_t)st * m_words; }
+    const uint64_t* Weekday(int wd) const { return m_bits.data() + (size_t)(4 + wd) * m_words; }   // 0 = Monday
+    const uint64_t* Holidays() const { return m_bits.data() + 11 * m_words; }
+    // The last word's bits past To()
+    uint64_t TailMask() const;
+
+private:
+    std::vector<uint64_t> m_bits;   // 4 types, 7 weekdays, holidays
+    int32_t               m_from = 0, m_to = -1;
+    size_t                m_words = 0;
+};
+
+class ShiftSearch {
+public:
+    static const int MAX_NODES = 128;
+
+    // Returns nullptr, or the reason the text is not an expression (and
+    // the offset of the fault in *errorAt)
+    const char* Compile(const char* text, size_t* errorAt = nullptr);
+    bool Empty() const { return m_prog.empty(); }
+
+    // The days to index so every day of [from, to] is answered: the
+    // store's years and the dates the expression names, a day more on each
+    // side per prije/poslije, whole months
+    void Span(const ShiftStore& s, int32_t& from, int32_t& to) const;
+
+    // Matching days of the index: bit i = day index.From() + i
+    void Evaluate(const ShiftIndex& index, std::vector<uint64_t>& out) const;
+
+private:
+    enum Op : uint8_t { TYPE, WORKING, WEEKDAY, HOLIDAY, MONTH, DATES, AND, OR, NOT, BEFORE, AFTER, MONTH_COUNT };
+    enum Cmp : uint8_t { LESS, LESS_EQ, EQUAL, GREATER_EQ, GREATER };
+    struct Node {
+        Op      op;
+        uint8_t arg = 0;          // type, weekday, month, Cmp
+        int32_t from = 0, to = 0; // DATES; MONTH_COUNT: the count in from
+    };
+    struct Parser;
+
+    std::vector<Node> m_prog;    // postfix: operands before their operator
+    int               m_stack = 0;   // bitsets on the stack at most
+};
+
+// Bit d - 1: day d of month m/y matches the search (for the grid)
+uint32_t SearchMonth(const ShiftSearch& search, const ShiftStore& s, const HolidayCalendar* holidays, int m, int y);
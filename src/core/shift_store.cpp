@@ -0,0 +1,243 @@
+// ============================================================================
+//  SHIFT STORE
+// ============================================================================
+
+#include "shift_store.h"
+#include <algorithm>
+#include "count_kernels.h"
+
+// Spans of at least this many whole words go through the SIMD kernels
+static const int KERNEL_MIN_WORDS = 8;
+
+static void CountMaskedWord(uint64_t w, ShiftCounts& c) {
+    uint64_t lo = w & SLOT_LOW_BITS, hi = (w >> 1) & SLOT_LOW_BITS;
+    c.day   += PopCount64(lo & ~hi);
+    c.night += PopCount64(hi & ~lo);
+    c.free  += PopCount64(lo & hi);
+}
+
+ShiftCounts CountPackedSlots(const uint64_t* words, int from, int to) {
+    ShiftCounts c;
+    if (from >= to) return c;
+    const int per = ShiftStore::SLOTS_PER_WORD;
+    int first = from / per, last = (to - 1) / per;
+    if (last - first - 1 >= KERNEL_MIN_WORDS) {
+        CountMaskedWord(words[first] & SlotRangeMask(from - first * per, per - 1), c);
+        c += CountPackedWords(words + first + 1, (size_t)(last - first - 1));
+        CountMaskedWord(words[last] & SlotRangeMask(0, to - 1 - last * per), c);
+        return c;
+    }
+    for (int k = first; k <= last; k++)
+        CountMaskedWord(words[k] & SlotRangeMask(from - k * per, to - 1 - k * per), c);
+    return c;
+}
+
+uint64_t* ShiftStore::GrowToYear(int y) {
+    if (y < MIN_YEAR || y > MAX_YEAR) return nullptr;
+    Materialize();
+    int first = m_yearCount == 0 ? y : std::min(y, m_firstYear);
+    int last = m_yearCount == 0 ? y : std::max(y, m_firstYear + m_yearCount - 1);
+    if (m_yearCount == 0 || first != m_firstYear || last != m_firstYear + m_yearCount - 1) {
+        size_t before = m_yearCount == 0 ? 0 : (size_t)(m_firstYear - first);
+        m_words.insert(m_words.begin(), before * WORDS_PER_YEAR, 0);
+        m_words.resize((size_t)(last - first + 1) * WORDS_PER_YEAR, 0);
+        m_monthCounts.insert(m_monthCounts.begin(), before * 12, ShiftCounts());
+        m_monthCounts.resize((size_t)(last - first + 1) * 12);
+        bool appended = before == 0 && m_yearCount > 0;
+        size_t oldMonths = (size_t)m_yearCount * 12;
+        m_firstYear = first;
+        m_yearCount = last - first + 1;
+        // Loading in date order appends year after year; keep that linear
+        if (appended) ExtendFenwick(oldMonths);
+        else RebuildFenwick();
+    }
+    return &m_words[(size_t)(y - m_firstYear) * WORDS_PER_YEAR];
+}
+
+void ShiftStore::RebuildCounts() {
+    m_monthCounts.assign((size_t)m_yearCount * 12, ShiftCounts());
+    for (int i = 0; i < m_yearCount; i++) {
+        const uint64_t* w = Words() + (size_t)i * WORDS_PER_YEAR;
+        const int* start = MONTH_START[IsLeapYear(m_firstYear + i)];
+        for (int m = 0; m < 12; m++)
+            m_monthCounts[(size_t)i * 12 + m] = CountPackedSlots(w, start[m], start[m + 1]);
+    }
+    RebuildFenwick();
+}
+
+void ShiftStore::RebuildFenwick() {
+    size_t n = m_monthCounts.size();
+    m_fenwick.assign(n + 1, ShiftCounts());
+    for (size_t i = 1; i <= n; i++) {
+        m_fenwick[i] += m_monthCounts[i - 1];
+        size_t j = i + (i & (0 - i));
+        if (j <= n) m_fenwick[j] += m_fenwick[i];
+    }
+}
+
+// New trailing months are empty: each new node only sums old months
+void ShiftStore::ExtendFenwick(size_t oldMonths) {
+    size_t n = m_monthCounts.size();
+    m_fenwick.resize(n + 1);
+    for (size_t j = oldMonths + 1; j <= n; j++) {
+        size_t lo = j - (j & (0 - j));
+        ShiftCounts c;
+        if (lo < oldMonths) {
+            c = MonthPrefix((int)oldMonths);
+            c -= MonthPrefix((int)lo);
+        }
+        m_fenwick[j] = c;
+    }
+}
+
+void ShiftStore::AddToMonth(int i, const ShiftCounts& delta) {
+    m_monthCounts[i] += delta;
+    for (size_t j = (size_t)i + 1; j < m_fenwick.size(); j += j & (0 - j))
+        m_fenwick[j] += delta;
+}
+
+bool ShiftStore::PrepareRange(int32_t& from, int32_t& to) {
+    from = std::max(from, DaysFromCivil(MIN_YEAR, 1, 1));
+    to = std::min(to, DaysFromCivil(MAX_YEAR, 12, 31));
+    if (from > to) return false;
+    GrowToYear(CivilFromDays(from).y);
+    GrowToYear(CivilFromDays(to).y);
+    return true;
+}
+
+void ShiftStore::FinishRange(int32_t from, int32_t to, size_t changed) {
+    if (changed == 0) return;
+    CivilDate a = CivilFromDays(from), b = CivilFromDays(to);
+    int first = MonthIndex(a.m, a.y), last = MonthIndex(b.m, b.y);
+    // Point updates for a few months, one linear rebuild for long ranges
+    bool rebuild = last - first > 24;
+    for (int i = first; i <= last; i++) {
+        int y = m_firstYear + i / 12;
+        const int* start = MONTH_START[IsLeapYear(y)];
+        ShiftCounts now = CountPackedSlots(YearWords(y), start[i % 12], start[i % 12 + 1]);
+        ShiftCounts delta = now;
+        delta -= m_monthCounts[i];
+        m_count += (size_t)delta.Total();
+        if (rebuild) m_monthCounts[i] = now;
+        else AddToMonth(i, delta);
+    }
+    if (rebuild) RebuildFenwick();
+    Notify(from, to);
+}
+
+ShiftCounts ShiftStore::MonthPrefix(int i) const {
+    ShiftCounts c;
+    for (size_t j = (size_t)i; j > 0; j -= j & (0 - j))
+        c += m_fenwick[j];
+    return c;
+}
+
+ShiftCounts ShiftStore::CountMonths(int first, int last) const {
+    if (first < 0 || last < first) return ShiftCounts();
+    ShiftCounts c = MonthPrefix(last + 1);
+    c -= MonthPrefix(first);
+    return c;
+}
+
+ShiftCounts ShiftStore::CountByType(int32_t from, int32_t to) const {
+    if (m_yearCount == 0) return ShiftCounts();
+    from = std::max(from, DaysFromCivil(m_firstYear, 1, 1));
+    to = std::min(to, DaysFromCivil(m_firstYear + m_yearCount, 1, 1) - 1);
+    if (from > to) return ShiftCounts();
+
+    // Whole months from the index, the partial first and last month from the words
+    auto partial = [this](int y, int32_t f, int32_t t) {
+        int32_t jan1 = DaysFromCivil(y, 1, 1);
+        return CountPackedSlots(YearWords(y), f - jan1, t - jan1 + 1);
+    };
+    CivilDate a = CivilFromDays(from), b = CivilFromDays(to);
+    int ia = MonthIndex(a.m, a.y), ib = MonthIndex(b.m, b.y);
+    if (ia == ib) return partial(a.y, from, to);
+    ShiftCounts c = partial(a.y, from, MonthStart(a.m, a.y) + DaysInMonth(a.m, a.y) - 1);
+    c += CountMonths(ia + 1, ib - 1);
+    c += partial(b.y, MonthStart(b.m, b.y), to);
+    return c;
+}
+
+void ShiftStore::AttachView(int firstYear, int yearCount, const uint64_t* words) {
+    Clear();
+    m_firstYear = firstYear;
+    m_yearCount = yearCount;
+    m_view = words;
+    RebuildCounts();
+    m_count = (size_t)CountPackedWords(words, (size_t)yearCount * WORDS_PER_YEAR).Total();
+}
+
+void ShiftStore::Materialize() {
+    if (!m_view) return;
+    m_words.assign(m_view, m_view + (size_t)m_yearCount * WORDS_PER_YEAR);
+    m_view = nullptr;
+}
+
+ShiftType ShiftStore::SetSlot(int y, int slot, ShiftType st) {
+    ShiftType old = GetSlot(y, slot);
+    if (old == st) return old;
+
+    uint64_t* w = GrowToYear(y);
+    if (!w) return old;
+    int32_t day = DaysFromCivil(y, 1, 1) + slot;
+    if (!m_observers.list.empty()) NotifyChanging(day, day);
+    int shift = 2 * (slot % SLOTS_PER_WORD);
+    uint64_t& word = w[slot / SLOTS_PER_WORD];
+    word = (word & ~(3ull << shift)) | ((uint64_t)st << shift);
+
+    if (old == SHIFT_NONE) m_count++;
+    else if (st == SHIFT_NONE) m_count--;
+    ShiftCounts delta;
+    delta.Add(old, -1);
+    delta.Add(st, +1);
+    AddToMonth(MonthIndex(MonthFromDayOfYear(slot, y), y), delta);
+    if (!m_observers.list.empty()) Notify(day, day);
+    return old;
+}
+
+void ShiftStore::ReadCodes(int32_t from, int32_t to, uint64_t* out) const {
+    size_t n = (size_t)(to - from) / SLOTS_PER_WORD + 1;
+    for (size_t i = 0; i < n; i++) out[i] = 0;
+    // Year by year, up to 32 slots per step (an output word or the year's end)
+    for (int32_t z = from; z <= to; ) {
+        int y = CivilFromDays(z).y;
+        int32_t jan1 = DaysFromCivil(y, 1, 1), end = DaysFromCivil(y + 1, 1, 1) - 1;
+        if (end > to) end = to;
+        const uint64_t* w = YearWords(y);
+        for (; w && z <= end; ) {
+            size_t i = (size_t)(z - from);
+            int at = (int)(i % SLOTS_PER_WORD), take = SLOTS_PER_WORD - at;
+            if (take > end - z + 1) take = end - z + 1;
+            uint64_t codes = PackedSlotsAt(w, WORDS_PER_YEAR, z - jan1) & SlotRangeMask(0, take - 1);
+            out[i / SLOTS_PER_WORD] |= codes << (2 * at);
+            z += take;
+        }
+        z = end + 1;
+    }
+}
+
+void ShiftStore::Clear() {
+    int32_t from = DaysFromCivil(m_firstYear, 1, 1);
+    int32_t to = DaysFromCivil(m_firstYear + m_yearCount, 1, 1) - 1;
+    bool hadShifts = m_count > 0;
+    if (hadShifts) NotifyChanging(from, to);
+    std::vector<uint64_t>().swap(m_words);
+    std::vector<ShiftCounts>().swap(m_monthCounts);
+    std::vector<ShiftCounts>().swap(m_fenwick);
+    m_view = nullptr;
+    m_firstYear = 0;
+    m_yearCount = 0;
+    m_count = 0;
+    if (hadShifts) Notify(from, to);
+}
+
+void ShiftStore::AddObserver(ShiftObserver* o) {
+    if (std::find(m_observers.list.begin(), m_observers.list.end(), o) == m_observers.list.end())
+        m_observers.list.push_back(o);
+}
+
+void ShiftStore::RemoveObserver(ShiftObserver* o) {
+    m_observers.list.erase(std::remove(m_observers.list.begin(), m_observers.list.end(), o),
+                           m_observers.list.end());
+}
@@ -0,0 +1,216 @@
+// ============================================================================
+//  SHIFT STORE - compact, date-indexed storage of shift codes
+//  Every day is a 2-bit code; one year is 12 x 64-bit words (366 slots,
+//  slot = day of year). Years are kept contiguous from FirstYear() on.
+//  Per-month counts are kept up to date on every mutation, with a Fenwick
+//  tree over them for year and date-range statistics.
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bits.h"
+#include "calendar.h"
+
+enum ShiftType { SHIFT_NONE = 0, SHIFT_DAY = 1, SHIFT_NIGHT = 2, SHIFT_FREE = 3 };
+
+// Bulk writes: replace set days, or only fill empty ones ("Prepisi postojece smjene");
+// MERGE_REPLACE writes every code, SHIFT_NONE included (clears the day)
+enum MergeMode { MERGE_OVERWRITE, MERGE_KEEP, MERGE_REPLACE };
+
+// Number of days per shift type
+struct ShiftCounts {
+    int32_t day = 0, night = 0, free = 0;
+
+    int32_t Working() const { return day + night; }
+    int32_t Total() const { return day + night + free; }
+    int32_t Of(ShiftType st) const {
+        return st == SHIFT_DAY ? day : st == SHIFT_NIGHT ? night : st == SHIFT_FREE ? free : 0;
+    }
+    void Add(ShiftType st, int32_t n) {
+        if (st == SHIFT_DAY) day += n;
+        else if (st == SHIFT_NIGHT) night += n;
+        else if (st == SHIFT_FREE) free += n;
+    }
+    ShiftCounts& operator+=(const ShiftCounts& o) { day += o.day; night += o.night; free += o.free; return *this; }
+    ShiftCounts& operator-=(const ShiftCounts& o) { day -= o.day; night -= o.night; free -= o.free; return *this; }
+};
+
+// Counts of the slots [from, to) of packed shift words; long spans use the
+// SIMD kernels of count_kernels.h
+ShiftCounts CountPackedSlots(const uint64_t* words, int from, int to);
+
+// Notified before and after a mutation with the inclusive day range whose
+// codes may change; the store still holds the old codes in OnShiftsChanging.
+class ShiftObserver {
+public:
+    virtual ~ShiftObserver() {}
+    virtual void OnShiftsChanging(int32_t, int32_t) {}
+    virtual void OnShiftsChanged(int32_t from, int32_t to) = 0;
+};
+
+class ShiftStore {
+public:
+    static const int SLOTS_PER_WORD = 32;
+    static const int WORDS_PER_YEAR = 12;
+    static const int MIN_YEAR = 1;
+    static const int MAX_YEAR = 9999;
+
+    ShiftType Get(int32_t day) const {
+        CivilDate c = CivilFromDays(day);
+        return GetSlot(c.y, day - DaysFromCivil(c.y, 1, 1));
+    }
+    ShiftType Get(int d, int m, int y) const { return GetSlot(y, DayOfYear(d, m, y)); }
+
+    // Returns the previous code of the day.
+    ShiftType Set(int32_t day, ShiftType st) {
+        CivilDate c = CivilFromDays(day);
+        return SetSlot(c.y, day - DaysFromCivil(c.y, 1, 1), st);
+    }
+    ShiftType Set(int d, int m, int y, ShiftType st) { return SetSlot(y, DayOfYear(d, m, y), st); }
+
+    // Bulk write over the inclusive day range, one packed word at a time.
+    // wordAt(int32_t day) returns the 32 codes starting at day, packed like
+    // YearWords(); SHIFT_NONE codes leave their day alone unless the mode is
+    // MERGE_REPLACE. Notifies once.
+    // Returns the number of days changed.
+    template <class Fn> size_t FillWords(int32_t from, int32_t to, MergeMode mode, Fn&& wordAt) {
+        if (!PrepareRange(from, to)) return 0;
+        NotifyChanging(from, to);
+        CivilDate a = CivilFromDays(from), b = CivilFromDays(to);
+        size_t changed = 0;
+        for (int y = a.y; y <= b.y; y++) {
+            uint64_t* w = &m_words[(size_t)(y - m_firstYear) * WORDS_PER_YEAR];
+            int32_t jan1 = DaysFromCivil(y, 1, 1);
+            int first = y == a.y ? from - jan1 : 0;
+            int last = y == b.y ? to - jan1 : DaysInYear(y) - 1;
+            for (int k = first / SLOTS_PER_WORD; k <= last / SLOTS_PER_WORD; k++) {
+                uint64_t pat = wordAt(jan1 + k * SLOTS_PER_WORD);
+                uint64_t put = (mode == MERGE_REPLACE ? ~0ull : SpreadSlots(OccupiedSlots(pat)))
+                             & SlotRangeMask(first - k * SLOTS_PER_WORD, last - k * SLOTS_PER_WORD);
+                if (mode == MERGE_KEEP) put &= ~SpreadSlots(OccupiedSlots(w[k]));
+                uint64_t nw = (w[k] & ~put) | (pat & put);
+                changed += (size_t)PopCount64(OccupiedSlots(nw ^ w[k]));
+                w[k] = nw;
+            }
+        }
+        FinishRange(from, to, changed);
+        return changed;
+    }
+
+    // Packs the codes of [from, to] into out (2 bits per day, from = slot 0),
+    // which must hold (to - from) / 32 + 1 words.
+    void   ReadCodes(int32_t from, int32_t to, uint64_t* out) const;
+
+    void   Clear();
+    bool   Empty() const { return m_count == 0; }
+    size_t Count() const { return m_count; }
+
+    // Covered year range; YearCount() == 0 when nothing was ever stored.
+    int FirstYear() const { return m_firstYear; }
+    int YearCount() const { return m_yearCount; }
+    const uint64_t* YearWords(int y) const {
+        int i = y - m_firstYear;
+        return (i >= 0 && i < m_yearCount) ? Words() + (size_t)i * WORDS_PER_YEAR : nullptr;
+    }
+
+    // Read-only view over words laid out like YearWords() and owned by the
+    // caller (a mapped file); the first mutation copies them into the store.
+    void AttachView(int firstYear, int yearCount, const uint64_t* words);
+    bool IsView() const { return m_view != nullptr; }
+    void Materialize();
+
+    // Statistics: O(1) per month, O(log months) per year or date range.
+    // Ranges are inclusive and may extend past the stored years.
+    ShiftCounts CountMonth(int m, int y) const {
+        int i = MonthIndex(m, y);
+        return i >= 0 ? m_monthCounts[i] : ShiftCounts();
+    }
+    ShiftCounts CountYear(int y) const { return CountMonths(MonthIndex(1, y), MonthIndex(12, y)); }
+    ShiftCounts CountByType(int32_t from, int32_t to) const;
+
+    size_t MemoryUsage() const {
+        return sizeof(*this) + m_words.capacity() * sizeof(uint64_t)
+             + (m_monthCounts.capacity() + m_fenwick.capacity()) * sizeof(ShiftCounts);
+    }
+
+    // Observers are not copied along with the store.
+    void AddObserver(ShiftObserver* o);
+    void RemoveObserver(ShiftObserver* o);
+
+    // Calls fn(int32_t day, ShiftType st) for every set day, in date order.
+    template <class Fn> void ForEach(Fn&& fn) const {
+        if (m_yearCount)
+            ForEach(DaysFromCivil(m_firstYear, 1, 1), DaysFromCivil(m_firstYear + m_yearCount, 1, 1) - 1, fn);
+    }
+    // Same, limited to the inclusive day range
+    template <class Fn> void ForEach(int32_t from, int32_t to, Fn&& fn) const {
+        if (m_yearCount == 0 || from > to) return;
+        int firstYear = CivilFromDays(from).y, lastYear = CivilFromDays(to).y;
+        if (firstYear < m_firstYear) firstYear = m_firstYear;
+        if (lastYear > m_firstYear + m_yearCount - 1) lastYear = m_firstYear + m_yearCount - 1;
+        for (int y = firstYear; y <= lastYear; y++) {
+            const uint64_t* w = Words() + (size_t)(y - m_firstYear) * WORDS_PER_YEAR;
+            int32_t jan1 = DaysFromCivil(y, 1, 1);
+            int first = from > jan1 ? from - jan1 : 0;
+            int last = to - jan1 < DaysInYear(y) - 1 ? to - jan1 : DaysInYear(y) - 1;
+            for (int k = first / SLOTS_PER_WORD; k <= last / SLOTS_PER_WORD; k++) {
+                uint64_t word = w[k] & SlotRangeMask(first - k * SLOTS_PER_WORD, last - k * SLOTS_PER_WORD);
+                for (uint64_t v = word; v; ) {
+                    int bit = CountTrailingZeros64(v) & ~1;
+                    fn(jan1 + k * SLOTS_PER_WORD + bit / 2, (ShiftType)((v >> bit) & 3));
+                    v &= ~(3ull << bit);
+                }
+            }
+        }
+    }
+
+private:
+    ShiftType GetSlot(int y, int slot) const {
+        const uint64_t* w = YearWords(y);
+        if (!w) return SHIFT_NONE;
+        return (ShiftType)((w[slot / SLOTS_PER_WORD] >> (2 * (slot % SLOTS_PER_WORD))) & 3);
+    }
+    const uint64_t* Words() const { return m_view ? m_view : m_words.data(); }
+    ShiftType SetSlot(int y, int slot, ShiftType st);
+    uint64_t* GrowToYear(int y);
+
+    // Index into m_monthCounts, -1 outside the stored years
+    int MonthIndex(int m, int y) const {
+        int i = y - m_firstYear;
+        return (i >= 0 && i < m_yearCount) ? i * 12 + m - 1 : -1;
+    }
+    ShiftCounts MonthPrefix(int i) const;            // months [0, i)
+    ShiftCounts CountMonths(int first, int last) const;  // inclusive month indices
+    void RebuildCounts();
+    void RebuildFenwick();
+    void ExtendFenwick(size_t oldMonths);
+    void AddToMonth(int i, const ShiftCounts& delta);
+    // FillWords(): clamp + grow before, recount + notify after
+    bool PrepareRange(int32_t& from, int32_t& to);
+    void FinishRange(int32_t from, int32_t to, size_t changed);
+    void NotifyChanging(int32_t from, int32_t to) {
+        for (ShiftObserver* o : m_observers.list) o->OnShiftsChanging(from, to);
+    }
+    void Notify(int32_t from, int32_t to) {
+        for (ShiftObserver* o : m_observers.list) o->OnShiftsChanged(from, to);
+    }
+
+    struct ObserverList {
+        std::vector<ShiftObserver*> list;
+        ObserverList() {}
+        ObserverList(const ObserverList&) {}
+        ObserverList& operator=(const ObserverList&) { return *this; }
+    };
+
+    int                   m_firstYear = 0;
+    int                   m_yearCount = 0;
+    std::vector<uint64_t> m_words;
+    const uint64_t*       m_view = nullptr;
+    size_t                m_count = 0;
+    std::vector<ShiftCounts> m_monthCounts;  // per month index
+    std::vector<ShiftCounts> m_fenwick;      // Fenwick tree over m_monthCounts, [0] unused
+    ObserverList          m_observers;
+};
@@ -0,0 +1,33 @@
+// ============================================================================
+//  SHIFT SUMMARY
+// ============================================================================
+
+#include "shift_summary.h"
+
+void SummarizeMonths(const ShiftStore& s, int m, int y, int count, MonthSummary* out) {
+    for (int i = 0; i < count; i++) {
+        MonthSummary& r = out[i];
+        r.y = y; r.m = m;
+        r.days = DaysInMonth(m, y);
+        r.first = MonthStart(m, y);
+        r.counts = s.CountMonth(m, y);
+        s.ReadCodes(r.first, r.first + r.days - 1, &r.codes);
+        if (++m > 12) { m = 1; y++; }
+    }
+}
+
+void SummarizeWeeks(const ShiftStore& s, int32_t day, int count, WeekSummary* out) {
+    int32_t monday = day - WeekdayFromDays(day);
+    // Four weeks (28 slots) per packed read
+    for (int i = 0; i < count; i += 4) {
+        int n = count - i < 4 ? count - i : 4;
+        uint64_t w = 0;
+        s.ReadCodes(monday, monday + n * 7 - 1, &w);
+        for (int k = 0; k < n; k++, monday += 7) {
+            WeekSummary& r = out[i + k];
+            r.monday = monday;
+            r.codes = (uint16_t)((w >> (14 * k)) & 0x3fff);
+            r.counts = CountPackedSlots(&w, 7 * k, 7 * k + 7);
+        }
+    }
+}
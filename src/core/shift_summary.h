@@ -0,0 +1,35 @@
+// ============================================================================
+//  SHIFT SUMMARY - month and week blocks for overviews: totals plus the
+//  packed day codes of the block, read a word at a time from the store
+//  (month totals come from its counters), never day by day.
+// ============================================================================
+
+#pragma once
+
+#include <cstdint>
+#include "shift_store.h"
+
+struct MonthSummary {
+    int         y = 0, m = 0;
+    int         days = 0;
+    int32_t     first = 0;     // day number of the 1st
+    ShiftCounts counts;
+    uint64_t    codes = 0;     // day d in slot d - 1
+
+    ShiftType Day(int d) const { return (ShiftType)((codes >> (2 * (d - 1))) & 3); }
+};
+
+// Seven days from a Monday
+struct WeekSummary {
+    int32_t     monday = 0;
+    ShiftCounts counts;
+    uint16_t    codes = 0;     // Monday in slot 0
+
+    ShiftType Day(int i) const { return (ShiftType)((codes >> (2 * i)) & 3); }
+};
+
+// count consecutive months starting at m/y
+void SummarizeMonths(const ShiftStore& s, int m, int y, int count, MonthSummary* out);
+
+// count consecutive weeks starting at the Monday of the week holding day
+void SummarizeWeeks(const ShiftStore& s, int32_t day, int count, WeekSummary* out);
@@ -0,0 +1,302 @@
+// ============================================================================
+//  TEXT FORMAT
+// ============================================================================
+
+#include "text_format.h"
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const size_t CHUNK_SIZE = 64 * 1024;
+static const size_t MAX_LINE   = 256;
+
+// Fixed-width decimal, no snprintf: the text writers are per-day hot loops
+static void PutDigits(char* p, int v, int width) {
+    for (int i = width - 1; i >= 0; i--) { p[i] = (char)('0' + v % 10); v /= 10; }
+}
+
+int FormatDate(char* buf, int32_t day) {
+    CivilDate c = CivilFromDays(day);
+    PutDigits(buf, c.y, 4);
+    buf[4] = '-';
+    PutDigits(buf + 5, c.m, 2);
+    buf[7] = '-';
+    PutDigits(buf + 8, c.d, 2);
+    return 10;
+}
+
+int FormatShiftLine(char* buf, int32_t day, ShiftType st, uint32_t employee) {
+    FormatDate(buf, day);
+    buf[10] = ' ';
+    buf[11] = (char)('0' + (int)st);
+    int n = 12;
+    if (employee != Roster::DEFAULT_ID) {
+        buf[n++] = ' ';
+        buf[n++] = '@';
+        n = (int)(std::to_chars(buf + n, buf + n + 10, employee).ptr - buf);
+    }
+    buf[n++] = '\n';
+    buf[n] = 0;
+    return n;
+}
+
+// Parses exactly `width` digits at p
+static bool ParseFixed(const char* p, int width, int& out) {
+    std::from_chars_result r = std::from_chars(p, p + width, out);
+    return r.ec == std::errc() && r.ptr == p + width && *p != '-';
+}
+
+static bool IsBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+const char* ParseDate(const char* b, const char* e, int32_t& day) {
+    int y, m, d;
+    if (e - b < 10 || b[4] != '-' || b[7] != '-' ||
+        !ParseFixed(b, 4, y) || !ParseFixed(b + 5, 2, m) || !ParseFixed(b + 8, 2, d))
+        return "neispravan datum (ocekivano YYYY-MM-DD)";
+    if (m < 1 || m > 12 || d < 1 || d > DaysInMonth(m, y) ||
+        y < ShiftStore::MIN_YEAR || y > ShiftStore::MAX_YEAR)
+        return "nepostojeci datum";
+    day = DaysFromCivil(y, m, d);
+    return nullptr;
+}
+
+const char* ParseShiftLine(const char* b, const char* e, bool allowClear, ShiftRecord& rec) {
+    while (e > b && IsBlank(e[-1])) e--;
+    while (b < e && IsBlank(*b)) b++;
+    if (b == e || *b == '#') return "";
+
+    // "YYYY-MM-DD V [@employee]"
+    int32_t day;
+    int v;
+    if (const char* err = ParseDate(b, e, day)) return err;
+
+    const char* p = b + 10;
+    if (p == e || !IsBlank(*p)) return "nedostaje oznaka smjene";
+    while (p < e && IsBlank(*p)) p++;
+    std::from_chars_result r = std::from_chars(p, e, v);
+    if (r.ec != std::errc() || (r.ptr != e && !IsBlank(*r.ptr))) return "neispravna oznaka smjene";
+    if (v < (allowClear ? 0 : 1) || v > 3) return "nepoznata oznaka smjene";
+
+    uint32_t employee = Roster::DEFAULT_ID;
+    p = r.ptr;
+    while (p < e && IsBlank(*p)) p++;
+    if (p < e) {
+        r = *p == '@' ? std::from_chars(p + 1, e, employee) : std::from_chars_result{ p, std::errc::invalid_argument };
+        if (r.ec != std::errc() || r.ptr != e) return "neispravna oznaka radnika";
+    }
+
+    rec.day = day;
+    rec.type = (ShiftType)v;
+    rec.employee = employee;
+    return nullptr;
+}
+
+uint32_t ReadTextGeneration(FILE* f) {
+    char buf[64];
+    uint32_t gen = 0;
+    if (fgets(buf, sizeof(buf), f) && strncmp(buf, "#gen ", 5) == 0)
+        gen = (uint32_t)strtoul(buf + 5, nullptr, 10);
+    rewind(f);
+    return gen;
+}
+
+bool WriteEmployeeLine(FILE* f, const Employee& e) {
+    return fprintf(f, "%s %u %s\n", EMPLOYEE_TAG, e.id, e.name.c_str()) > 0;
+}
+
+// "#employee <id> <name>": fills id and the trimmed name, false when malformed
+static bool ParseEmployeeLine(const char* b, const char* e, uint32_t& id, std::string& name) {
+    while (e > b && IsBlank(e[-1])) e--;
+    const char* p = b + strlen(EMPLOYEE_TAG);
+    if (p >= e || !IsBlank(*p)) return false;
+    while (p < e && IsBlank(*p)) p++;
+    std::from_chars_result r = std::from_chars(p, e, id);
+    if (r.ec != std::errc() || (r.ptr != e && !IsBlank(*r.ptr))) return false;
+    p = r.ptr;
+    while (p < e && IsBlank(*p)) p++;
+    name.assign(p, e);
+    return true;
+}
+
+// Exact marker line, trailing blanks allowed
+static bool IsMarker(const char* b, const char* e, const char* marker) {
+    while (e > b && IsBlank(e[-1])) e--;
+    size_t n = strlen(marker);
+    return (size_t)(e - b) == n && memcmp(b, marker, n) == 0;
+}
+
+namespace {
+
+// Applies records to a roster, or to a single store (default employee only)
+struct LineSink {
+    ShiftStore*      store;
+    Roster*          roster;
+    bool             allowClear;
+    TextParseReport& report;
+    std::vector<ShiftRecord> batch;   // records since an unmatched BATCH_BEGIN
+    size_t           batchLine = 0;
+
+    LineSink(ShiftStore* s, Roster* r, bool clear, TextParseReport& rep)
+        : store(s), roster(r), allowClear(clear), report(rep) {}
+
+    void Error(size_t line, const char* err) {
+        if (report.errorCount < (size_t)TextParseReport::MAX_ERRORS)
+            report.errors[report.errorCount] = TextParseReport::Error{ line, err };
+        report.errorCount++;
+    }
+
+    void Apply(const ShiftRecord& r) {
+        if (roster) {
+            int i = roster->Add(r.employee);
+            if (i >= 0) roster->Shifts((size_t)i).Set(r.day, r.type);
+        } else if (r.employee == Roster::DEFAULT_ID) {
+            store->Set(r.day, r.type);
+        }
+    }
+
+    void Line(const char* b, const char* e) {
+        size_t line = ++report.lines;
+        if (b < e && *b == '#' && (size_t)(e - b) > strlen(EMPLOYEE_TAG) &&
+            memcmp(b, EMPLOYEE_TAG, strlen(EMPLOYEE_TAG)) == 0) {
+            uint32_t id;
+            std::string name;
+            if (e - b > (ptrdiff_t)MAX_LINE || !ParseEmployeeLine(b, e, id, name))
+                Error(line, "neispravna oznaka radnika");
+            else if (roster && roster->Add(id, name.c_str()) < 0)
+                Error(line, "previse radnika");
+            return;
+        }
+        if (b < e && e - b < 16 && *b == '#') {
+            if (IsMarker(b, e, BATCH_BEGIN)) {
+                if (batchLine) Error(batchLine, "nedovrsena grupa izmjena");
+                batch.clear();
+                batchLine = line;
+                return;
+            }
+            if (IsMarker(b, e, BATCH_END) && batchLine) {
+                for (const ShiftRecord& r : batch) Apply(r);
+                report.records += batch.size();
+                batch.clear();
+                batchLine = 0;
+                return;
+            }
+        }
+        ShiftRecord rec;
+        const char* err = (e - b > (ptrdiff_t)MAX_LINE) ? "predugacka linija"
+                                                        : ParseShiftLine(b, e, allowClear, rec);
+        if (!err) {
+            if (batchLine) { batch.push_back(rec); return; }
+            Apply(rec);
+            report.records++;
+        } else if (*err) {
+            Error(line, err);
+        }
+    }
+
+    // A batch cut off by a crash is dropped as a whole
+    size_t Finish() {
+        if (batchLine) Error(batchLine, "nedovrsena grupa izmjena");
+        batch.clear();
+        batchLine = 0;
+        return report.records;
+    }
+
+    // Handles every complete line in [b, e); returns the start of the unfinished tail
+    const char* Lines(const char* b, const char* e) {
+        while (const char* nl = (const char*)memchr(b, '\n', (size_t)(e - b))) {
+            Line(b, nl);
+            b = nl + 1;
+        }
+        return b;
+    }
+};
+
+} // namespace
+
+static size_t ParseInto(LineSink& sink, const char* data, size_t len) {
+    const char* tail = sink.Lines(data, data + len);
+    if (tail < data + len) sink.Line(tail, data + len);
+    return sink.Finish();
+}
+
+size_t ParseShiftText(const char* data, size_t len, ShiftStore& store, bool allowClear,
+                      TextParseReport* report) {
+    TextParseReport local;
+    LineSink sink(&store, nullptr, allowClear, report ? *report : local);
+    return ParseInto(sink, data, len);
+}
+
+size_t ParseShiftText(const char* data, size_t len, Roster& roster, bool allowClear,
+                      TextParseReport* report) {
+    TextParseReport local;
+    LineSink sink(nullptr, &roster, allowClear, report ? *report : local);
+    return ParseInto(sink, data, len);
+}
+
+static size_t ReadInto(LineSink& sink, FILE* f) {
+    std::vector<char> buf(CHUNK_SIZE + MAX_LINE + 1);
+    size_t carry = 0;
+    bool overlong = false;    // inside a line that no longer fits the carry buffer
+
+    for (;;) {
+        size_t n = fread(buf.data() + carry, 1, CHUNK_SIZE, f);
+        if (n == 0) break;
+        const char* b = buf.data();
+        const char* e = b + carry + n;
+        if (overlong) {
+            const char* nl = (const char*)memchr(b, '\n', (size_t)(e - b));
+            if (!nl) { carry = 0; continue; }
+            b = nl + 1;
+            overlong = false;
+        }
+        const char* tail = sink.Lines(b, e);
+        carry = (size_t)(e - tail);
+        if (carry > MAX_LINE) {
+            // Report it now (as too long) and skip to its end
+            sink.Line(tail, tail + MAX_LINE + 1);
+            carry = 0;
+            overlong = true;
+        } else {
+            memmove(buf.data(), tail, carry);
+        }
+    }
+    if (carry && !overlong) sink.Line(buf.data(), buf.data() + carry);
+    return sink.Finish();
+}
+
+size_t ReadShiftText(FILE* f, ShiftStore& store, bool allowClear, TextParseReport* report) {
+    TextParseReport local;
+    LineSink sink(&store, nullptr, allowClear, report ? *report : local);
+    return ReadInto(sink, f);
+}
+
+size_t ReadShiftText(FILE* f, Roster& roster, bool allowClear, TextParseReport* report) {
+    TextParseReport local;
+    LineSink sink(nullptr, &roster, allowClear, report ? *report : local);
+    return ReadInto(sink, f);
+}
+
+bool WriteShiftText(FILE* f, const ShiftStore& store, uint32_t generation) {
+    if (generation) fprintf(f, "#gen %u\n", generation);
+    char line[16];
+    store.ForEach([&](int32_t day, ShiftType st) {
+        fwrite(line, 1, (size_t)FormatShiftLine(line, day, st), f);
+    });
+    return ferror(f) == 0;
+}
+
+bool WriteShiftText(FILE* f, const Roster& roster, uint32_t generation) {
+    if (generation) fprintf(f, "#gen %u\n", generation);
+    for (size_t i = 0; i < roster.Size(); i++)
+        if (roster.At(i).id != Roster::DEFAULT_ID || !roster.At(i).name.empty()) WriteEmployeeLine(f, roster.At(i));
+    char line[32];
+    for (size_t i = 0; i < roster.Size(); i++) {
+        uint32_t id = roster.At(i).id;
+        roster.Shifts(i).ForEach([&](int32_t day, ShiftType st) {
+            fwrite(line, 1, (size_t)FormatShiftLine(line, day, st, id), f);
+        });
+    }
+    return ferror(f) == 0;
+}
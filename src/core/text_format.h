@@ -0,0 +1,70 @@
+// ============================================================================
+//  TEXT FORMAT - "YYYY-MM-DD V" lines (smjene_data.txt and the journal)
+//  Records of other employees than the default one end in " @<id>" and the
+//  employee is declared once by a "#employee <id> <name>" line.
+//  Chunked streaming parser: no per-line allocation, dates are validated
+//  against the calendar and malformed lines are reported by line number.
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include "roster.h"
+#include "shift_store.h"
+
+struct ShiftRecord {
+    int32_t   day;
+    ShiftType type;
+    uint32_t  employee = Roster::DEFAULT_ID;
+};
+
+struct TextParseReport {
+    static const int MAX_ERRORS = 16;
+    struct Error { size_t line; const char* reason; };
+
+    size_t lines = 0;        // lines seen, including comments and blank lines
+    size_t records = 0;      // records applied
+    size_t errorCount = 0;   // all malformed lines ...
+    Error  errors[MAX_ERRORS];   // ... of which the first MAX_ERRORS are kept
+};
+
+// Writes one "YYYY-MM-DD V\n" record into buf (at least 16 chars, 32 with an
+// employee other than the default one), returns its length.
+int  FormatShiftLine(char* buf, int32_t day, ShiftType st, uint32_t employee = Roster::DEFAULT_ID);
+// Writes "YYYY-MM-DD" (10 chars, not terminated), returns 10.
+int  FormatDate(char* buf, int32_t day);
+
+// Parses "YYYY-MM-DD" at the start of [b, e). Returns nullptr on success or
+// the reason the date is malformed / does not exist.
+const char* ParseDate(const char* b, const char* e, int32_t& day);
+
+// Parses one line (without the newline). Returns nullptr and fills rec for a
+// record, "" for a blank/comment line, or the reason the line is malformed.
+// allowClear: value 0 (erase the day) is accepted, as in journal records.
+const char* ParseShiftLine(const char* b, const char* e, bool allowClear, ShiftRecord& rec);
+
+// Peeks an optional leading "#gen N" line (0 when absent) and rewinds f.
+uint32_t ReadTextGeneration(FILE* f);
+
+// Records between BATCH_BEGIN and BATCH_END lines are applied together, or
+// not at all when the end marker is missing (reported as an error).
+static const char* const BATCH_BEGIN = "#begin";
+static const char* const BATCH_END   = "#end";
+static const char* const EMPLOYEE_TAG = "#employee";
+
+// Writes "#employee <id> <name>\n" to f
+bool WriteEmployeeLine(FILE* f, const Employee& e);
+
+// Reads lines into store in 64 KB chunks; other lines starting with '#' are comments.
+// A single store takes the default employee's records and skips the others.
+size_t ReadShiftText(FILE* f, ShiftStore& store, bool allowClear, TextParseReport* report = nullptr);
+size_t ReadShiftText(FILE* f, Roster& roster, bool allowClear, TextParseReport* report = nullptr);
+size_t ParseShiftText(const char* data, size_t len, ShiftStore& store, bool allowClear,
+                      TextParseReport* report = nullptr);
+size_t ParseShiftText(const char* data, size_t len, Roster& roster, bool allowClear,
+                      TextParseReport* report = nullptr);
+bool   WriteShiftText(FILE* f, const ShiftStore& store, uint32_t generation = 0);
+// The default employee is declared only when named, so a single-user roster
+// gives the legacy file.
+bool   WriteShiftText(FILE* f, const Roster& roster, uint32_t generation = 0);
@@ -0,0 +1,159 @@
+// ============================================================================
+//  TRACE
+// ============================================================================
+
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+std::atomic<bool> g_traceOn{ false };
+
+namespace {
+
+// One ring entry, written as a seqlock: seq is index + 1 once the fields
+// hold event number index (0: never written) and WRITING while a writer
+// owns them
+struct Slot {
+    std::atomic<uint64_t>    seq{ 0 };
+    std::atomic<const char*> cat{ nullptr }, name{ nullptr };
+    std::atomic<uint64_t>    start{ 0 }, dur{ 0 };
+    std::atomic<uint32_t>    thread{ 0 };
+};
+
+const uint64_t WRITING = ~0ull;
+
+std::unique_ptr<Slot[]> s_slots;   // allocated once, never freed while tracing may run
+size_t                  s_mask = 0;
+std::atomic<uint64_t>   s_next{ 0 };
+std::atomic<uint32_t>   s_threads{ 0 };
+uint64_t                s_origin = 0;
+
+} // namespace
+
+uint64_t TraceNow() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void TraceStart(size_t capacity) {
+    if (!s_slots) {
+        size_t n = 1024;
+        while (n < capacity) n <<= 1;
+        s_slots.reset(new Slot[n]);
+        s_mask = n - 1;
+        s_origin = TraceNow();
+    }
+    g_traceOn.store(true, std::memory_order_release);
+}
+
+void TraceStop() {
+    g_traceOn.store(false, std::memory_order_release);
+}
+
+const char* TraceStartFromEnv() {
+    const char* path = getenv("SMJENE_TRACE");
+    if (!path || !*path) return nullptr;
+    TraceStart();
+    return path;
+}
+
+void TraceRecord(const char* cat, const char* name, uint64_t start, uint64_t end) {
+    Slot* slots = s_slots.get();
+    if (!slots) return;
+    static thread_local uint32_t thread = s_threads.fetch_add(1, std::memory_order_relaxed) + 1;
+    uint64_t i = s_next.fetch_add(1, std::memory_order_relaxed);
+    Slot& s = slots[i & s_mask];
+    // Claim the slot from an older event; it is dropped when another writer
+    // owns the slot or a newer event already lapped it, so the fields under
+    // a published seq are never written by anyone else
+    uint64_t seq = s.seq.load(std::memory_order_relaxed);
+    do {
+        if (seq >= i + 1) return;   // WRITING included
+    } while (!s.seq.compare_exchange_weak(seq, WRITING, std::memory_order_relaxed));
+    std::atomic_thread_fence(std::memory_order_release);
+    s.cat.store(cat, std::memory_order_relaxed);
+    s.name.store(name, std::memory_order_relaxed);
+    s.start.store(start, std::memory_order_relaxed);
+    s.dur.store(end - start, std::memory_order_relaxed);
+    s.thread.store(thread, std::memory_order_relaxed);
+    s.seq.store(i + 1, std::memory_order_release);
+}
+
+uint64_t TraceEvents(std::vector<TraceEvent>& out) {
+    out.clear();
+    Slot* slots = s_slots.get();
+    if (!slots) return 0;
+    uint64_t n = s_next.load(std::memory_order_acquire);
+    uint64_t first = n > s_mask + 1 ? n - (s_mask + 1) : 0;
+    out.reserve((size_t)(n - first));
+    for (uint64_t i = first; i < n; i++) {
+        Slot& s = slots[i & s_mask];
+        if (s.seq.load(std::memory_order_acquire) != i + 1) continue;   // being written or overwritten
+        TraceEvent e;
+        e.cat = s.cat.load(std::memory_order_relaxed);
+        e.name = s.name.load(std::memory_order_relaxed);
+        e.start = s.start.load(std::memory_order_relaxed);
+        e.dur = s.dur.load(std::memory_order_relaxed);
+        e.thread = s.thread.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s.seq.load(std::memory_order_relaxed) == i + 1) out.push_back(e);
+    }
+    return n;
+}
+
+bool WriteChromeTrace(FILE* f) {
+    std::vector<TraceEvent> events;
+    TraceEvents(events);
+    bool ok = fputs("{\"traceEvents\":[\n", f) >= 0;
+    for (size_t i = 0; i < events.size(); i++) {
+        const TraceEvent& e = events[i];
+        double ts = (double)(e.start - s_origin) / 1000.0;
+        ok = fprintf(f, "{\"cat\":\"%s\",\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}%s\n",
+                     e.cat, e.name, ts, (double)e.dur / 1000.0, e.thread, i + 1 < events.size() ? "," : "") > 0 && ok;
+    }
+    ok = fputs("],\"displayTimeUnit\":\"ms\"}\n", f) >= 0 && ok;
+    return ok;
+}
+
+std::vector<TraceStat> TraceSummary() {
+    std::vector<TraceEvent> events;
+    TraceEvents(events);
+    // Grouped by the literals' text, a handful of trace points
+    std::vector<TraceStat> stats;
+    std::vector<std::vector<uint64_t>> durations;
+    for (const TraceEvent& e : events) {
+        size_t k = 0;
+        while (k < stats.size() && (strcmp(stats[k].cat, e.cat) != 0 || strcmp(stats[k].name, e.name) != 0)) k++;
+        if (k == stats.size()) {
+            stats.push_back(TraceStat{ e.cat, e.name, 0, 0, 0, 0 });
+            durations.emplace_back();
+        }
+        durations[k].push_back(e.dur);
+    }
+    for (size_t k = 0; k < stats.size(); k++) {
+        std::vector<uint64_t>& d = durations[k];
+        std::sort(d.begin(), d.end());
+        TraceStat& s = stats[k];
+        s.count = d.size();
+        s.p50 = d[(d.size() * 50 + 99) / 100 - 1];
+        s.p99 = d[(d.size() * 99 + 99) / 100 - 1];
+        s.max = d.back();
+    }
+    return stats;
+}
+
+void WriteTraceSummary(FILE* f) {
+    std::vector<TraceEvent> events;
+    uint64_t total = TraceEvents(events);
+    fprintf(f, "trace: %zu events", events.size());
+    if (total > events.size()) fprintf(f, " (%llu older overwritten)", (unsigned long long)(total - events.size()));
+    fprintf(f, "\n%-28s %8s %10s %10s %10s\n", "trace point", "count", "p50 ms", "p99 ms", "max ms");
+    char key[64];
+    for (const TraceStat& s : TraceSummary()) {
+        snprintf(key, sizeof(key), "%s/%s", s.cat, s.name);
+        fprintf(f, "%-28s %8zu %10.3f %10.3f %10.3f\n", key, s.count, s.p50 / 1e6, s.p99 / 1e6, s.max / 1e6);
+    }
+}
@@ -0,0 +1,73 @@
+// ============================================================================
+//  TRACE - scoped latency trace points (paint, input, load, save) recorded
+//  into a lock-free ring buffer and dumped as Chrome trace_event JSON
+//  (chrome://tracing, ui.perfetto.dev) with p50/p99 per trace point.
+//  Off unless TraceStart() ran: a TRACE_SCOPE then costs one relaxed load.
+// ============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+struct TraceEvent {
+    const char* cat;     // category and name: string literals, no escaping needed
+    const char* name;
+    uint64_t    start;   // TraceNow() ns
+    uint64_t    dur;
+    uint32_t    thread;  // small per-thread number, 1 = first thread traced
+};
+
+extern std::atomic<bool> g_traceOn;
+inline bool TraceEnabled() { return g_traceOn.load(std::memory_order_relaxed); }
+
+// Starts recording into a ring of capacity events (rounded up to a power of
+// two); the oldest are overwritten once it is full. Later calls only resume.
+void TraceStart(size_t capacity = 1 << 16);
+void TraceStop();
+// Starts recording when SMJENE_TRACE is set; returns its value (the output
+// file) or nullptr
+const char* TraceStartFromEnv();
+
+// Monotonic nanoseconds
+uint64_t TraceNow();
+void     TraceRecord(const char* cat, const char* name, uint64_t start, uint64_t end);
+
+class TraceScope {
+public:
+    TraceScope(const char* cat, const char* name)
+        : m_cat(cat), m_name(name), m_start(TraceEnabled() ? TraceNow() : 0) {}
+    ~TraceScope() { if (m_start) TraceRecord(m_cat, m_name, m_start, TraceNow()); }
+
+private:
+    const char* m_cat;
+    const char* m_name;
+    uint64_t    m_start;
+
+    TraceScope(const TraceScope&);
+    TraceScope& operator=(const TraceScope&);
+};
+
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT2(a, b)
+#define TRACE_SCOPE(cat, name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(cat, name)
+
+// The events still in the ring, oldest first; returns the number recorded
+// in total (overwritten ones included)
+uint64_t TraceEvents(std::vector<TraceEvent>& out);
+
+// {"traceEvents":[...]}, "X" (complete) events in microseconds
+bool WriteChromeTrace(FILE* f);
+
+struct TraceStat {
+    const char* cat;
+    const char* name;
+    size_t      count;
+    uint64_t    p50, p99, max;   // ns, nearest rank
+};
+// Per cat/name, in the order first seen
+std::vector<TraceStat> TraceSummary();
+void WriteTraceSummary(FILE* f);
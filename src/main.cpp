@@ -15,19 +15,38 @@
 #include <windows.h>
 #include <gdiplus.h>
 #include <commctrl.h>
+#include <commdlg.h>
 #include <string>
-#include <map>
 #include <fstream>
 #include <sstream>
 #include <ctime>
 #include <vector>
 #include <algorithm>
 
+#include "core/calendar_view.h"
+#include "core/data_file.h"
+#include "core/file_util.h"
+#include "core/holidays.h"
+#include "core/import_format.h"
+#include "core/layout.h"
+#include "core/month_view.h"
+#include "core/overview_view.h"
+#include "core/payroll.h"
+#include "core/roster.h"
+#include "core/rotation.h"
+#include "core/shift_history.h"
+#include "core/shift_ops.h"
+#include "core/shift_rules.h"
+#include "core/shift_search.h"
+#include "core/shift_store.h"
+#include "core/trace.h"
+
 #pragma comment(lib, "gdiplus.lib")
 #pragma comment(lib, "gdi32.lib")
 #pragma comment(lib, "user32.lib")
 #pragma comment(lib, "shell32.lib")
 #pragma comment(lib, "comctl32.lib")
+#pragma comment(lib, "comdlg32.lib")
 
 using namespace Gdiplus;
 
@@ -35,8 +54,6 @@ using namespace Gdiplus;
 //  ENUMS & IDS
 // ============================================================================
 
-enum ShiftType { SHIFT_NONE = 0, SHIFT_DAY = 1, SHIFT_NIGHT = 2, SHIFT_FREE = 3 };
-
 #define IDM_DAY_SHIFT   1001
 #define IDM_NIGHT_SHIFT 1002
 #define IDM_FREE_DAY    1003
@@ -51,59 +68,28 @@ enum ShiftType { SHIFT_NONE = 0, SHIFT_DAY = 1, SHIFT_NIGHT = 2, SHIFT_FREE = 3
 #define IDC_BTN_ALL       2032
 #define IDC_BTN_NONE      2033
 #define IDC_CHK_OVERWRITE 2040
+#define IDC_ROT_PATTERN   2050
+#define IDC_ROT_DAY       2051
+#define IDC_IMPORT_INFO   2060
+#define IDC_SEARCH_TEXT   2070
+#define IDC_SEARCH_CLEAR  2071
 
-static const int HEADER_H    = 75;
-static const int DAYNAMES_H  = 38;
-static const int LEGEND_H    = 65;
-static const int STATS_H     = 38;
-static const int CELL_PAD    = 3;
 static const int MIN_W       = 850;
 static const int MIN_H       = 680;
 
-// ============================================================================
-//  COLORS
-// ============================================================================
-
-static const Color CLR_BG_TOP(255, 12, 12, 28);
-static const Color CLR_BG_BOT(255, 22, 22, 48);
-static const Color CLR_HEADER(255, 18, 18, 40);
-static const Color CLR_CELL_BG(255, 28, 30, 58);
-static const Color CLR_CELL_HOVER(255, 40, 42, 75);
-static const Color CLR_CELL_TODAY_BORDER(255, 100, 130, 255);
-static const Color CLR_TEXT(255, 210, 215, 235);
-static const Color CLR_TEXT_DIM(255, 130, 135, 160);
-static const Color CLR_TEXT_WEEKEND(255, 170, 140, 160);
-static const Color CLR_DAY_SHIFT(255, 255, 160, 40);
-static const Color CLR_DAY_SHIFT_BG(255, 60, 45, 15);
-static const Color CLR_NIGHT_SHIFT(255, 80, 130, 255);
-static const Color CLR_NIGHT_SHIFT_BG(255, 20, 28, 65);
-static const Color CLR_FREE_DAY(255, 80, 200, 100);
-static const Color CLR_FREE_DAY_BG(255, 18, 50, 25);
-static const Color CLR_BTN(255, 45, 48, 85);
-static const Color CLR_BTN_HOVER(255, 65, 68, 110);
-static const Color CLR_BTN_COPY(255, 55, 40, 90);
-static const Color CLR_BTN_COPY_HOVER(255, 80, 55, 125);
-static const Color CLR_BTN_CLEARMONTH(255, 90, 30, 30);
-static const Color CLR_BTN_CLEARMONTH_HOVER(255, 120, 40, 40);
-static const Color CLR_SEPARATOR(255, 50, 52, 80);
-static const Color CLR_GRID_LINE(255, 35, 37, 65);
-
 // ============================================================================
 //  STRINGS
 // ============================================================================
 
-static const wchar_t* MONTH_NAMES[] = {
-    L"Januar", L"Februar", L"Mart", L"April",
-    L"Maj", L"Juni", L"Juli", L"August",
-    L"Septembar", L"Oktobar", L"Novembar", L"Decembar"
-};
 static const wchar_t* MONTH_NAMES_SHORT[] = {
     L"Jan", L"Feb", L"Mar", L"Apr", L"Maj", L"Jun",
     L"Jul", L"Aug", L"Sep", L"Okt", L"Nov", L"Dec"
 };
-static const wchar_t* DAY_NAMES[] = {
-    L"PON", L"UTO", L"SRI", L"CET", L"PET", L"SUB", L"NED"
-};
+
+// Core strings are UTF-16, the same code units as wchar_t here
+static_assert(sizeof(wchar_t) == sizeof(char16_t), "wchar_t must be UTF-16");
+static const wchar_t* UiText(const char16_t* s) { return reinterpret_cast<const wchar_t*>(s); }
+static const wchar_t* MonthName(int m) { return UiText(MONTH_NAMES[m - 1]); }
 
 // ============================================================================
 //  GLOBALS
@@ -111,67 +97,68 @@ static const wchar_t* DAY_NAMES[] = {
 
 static HWND                           g_hWnd = NULL;
 static ULONG_PTR                      g_gdipToken = 0;
+static int                            g_viewMode  = VIEW_MONTH;
 static int                            g_viewMonth = 0;
 static int                            g_viewYear  = 0;
 static int                            g_todayDay = 0, g_todayMonth = 0, g_todayYear = 0;
 static int                            g_hoverDay = -1;
 static int                            g_hoverBtn = -1;
-static std::map<std::wstring, int>    g_shifts;
+static Roster                         g_roster;
+static ShiftStore*                    g_shifts = nullptr;   // the default employee's column
+static ShiftDataFile                  g_data;
+static ShiftHistory                   g_history;
 static std::wstring                   g_dataPath;
-
-// Layout rects
-static RECT g_prevBtn = {0}, g_nextBtn = {0}, g_todayBtn = {0};
-static RECT g_copyBtn = {0}, g_clearMonthBtn = {0}, g_resetBtn = {0};
-static int  g_gridTop = 0, g_gridLeft = 0;
-static int  g_cellW = 0, g_cellH = 0;
-static int  g_gridStartDow = 0;
-static int  g_daysInView = 0;
+static std::wstring                   g_tracePath;   // --trace / SMJENE_TRACE, empty when not tracing
+
+// Layout of the current client size and month (UpdateLayout); the header
+// and legend rects also serve the overviews
+static CalendarLayout g_layout;
+// Layout of the year / 5-year overview, when one is shown
+static OverviewLayout g_overview;
+// Display list of the view, rebuilt when the UI or the shown shifts change
+static CalendarView   g_view;
+// Month hours of the totals line, kept up to date edit by edit
+static PayrollLedger  g_payroll;
+// Days that break a labour rule, framed in the grid; rechecked edit by edit
+static RuleValidator  g_rules;
+// Built-in holidays plus smjene_praznici.txt: colored in the grid, paid in the hours
+static HolidayCalendar g_holidays;
+static TextParseReport g_holidayReport;
+// Ctrl+F: days matching the expression get a dot; empty when no search is on
+static ShiftSearch    g_search;
 
 // Copy dialog state
 static HWND g_hCopyDlg = NULL;
 static int  g_copyTargetYear = 0;
 static bool g_dlgResult = false;
 
-// ============================================================================
-//  UTILITY
-// ============================================================================
+// Rotation dialog state
+static HWND g_hRotDlg = NULL;
+static int  g_rotTargetYear = 0;
 
-static int DaysInMonth(int m, int y) {
-    static const int d[] = {31,28,31,30,31,30,31,31,30,31,30,31};
-    if (m < 1 || m > 12) return 30;
-    int days = d[m - 1];
-    if (m == 2 && ((y % 4 == 0 && y % 100 != 0) || y % 400 == 0)) days = 29;
-    return days;
-}
+// Search dialog state: the last expression, shown again next time
+static HWND    g_hSearchDlg = NULL;
+static wchar_t g_searchText[256] = L"N sub";
 
-static int DayOfWeek(int d, int m, int y) {
-    struct tm t = {};
-    t.tm_year = y - 1900; t.tm_mon = m - 1; t.tm_mday = d;
-    mktime(&t);
-    return (t.tm_wday + 6) % 7;
-}
+// Import dialog state: the parsed file, applied on UVEZI
+static HWND                     g_hImportDlg = NULL;
+static std::vector<ShiftRecord> g_importRecords;
+static ImportReport             g_importReport;
 
-static std::wstring DateKey(int d, int m, int y) {
-    wchar_t buf[20];
-    wsprintfW(buf, L"%04d-%02d-%02d", y, m, d);
-    return buf;
-}
+// ============================================================================
+//  UTILITY
+// ============================================================================
 
 static ShiftType GetShift(int d, int m, int y) {
-    auto it = g_shifts.find(DateKey(d, m, y));
-    return (it != g_shifts.end()) ? (ShiftType)it->second : SHIFT_NONE;
+    return g_shifts->Get(d, m, y);
 }
 
 static void SetShift(int d, int m, int y, ShiftType st) {
-    if (st == SHIFT_NONE) g_shifts.erase(DateKey(d, m, y));
-    else g_shifts[DateKey(d, m, y)] = (int)st;
+    g_shifts->Set(d, m, y, st);
 }
 
 static int CountShiftsInMonth(int m, int y) {
-    int count = 0;
-    for (int d = 1; d <= DaysInMonth(m, y); d++)
-        if (GetShift(d, m, y) != SHIFT_NONE) count++;
-    return count;
+    return g_shifts->CountMonth(m, y).Total();
 }
 
 // ============================================================================
@@ -183,55 +170,60 @@ static void GetDataPath() {
     GetModuleFileNameW(NULL, path, MAX_PATH);
     wchar_t* s = wcsrchr(path, L'\\');
     if (s) *(s + 1) = 0;
-    wcscat(path, L"smjene_data.txt");
+    wcscat(path, L"smjene_data");   // + .bin (snapshot) / .journal / .txt (legacy)
     g_dataPath = path;
 }
 
-static void LoadData() {
-    g_shifts.clear();
-    FILE* f = _wfopen(g_dataPath.c_str(), L"r");
-    if (!f) return;
-    char buf[64];
-    while (fgets(buf, sizeof(buf), f)) {
-        if (strlen(buf) < 12) continue;
-        // Parse "YYYY-MM-DD V"
-        buf[10] = 0;
-        int val = atoi(buf + 11);
-        if (val >= 1 && val <= 3) {
-            wchar_t wkey[16];
-            MultiByteToWideChar(CP_ACP, 0, buf, 10, wkey, 16);
-            wkey[10] = 0;
-            g_shifts[wkey] = val;
-        }
+static void LoadHolidays() {
+    std::wstring path = g_dataPath.substr(0, g_dataPath.size() - wcslen(L"smjene_data")) + L"smjene_praznici.txt";
+    if (FILE* f = OpenPath(path, "rb")) {
+        g_holidays.Load(f, &g_holidayReport);
+        fclose(f);
     }
-    fclose(f);
+    PayrollModel model;
+    model.holidays = g_holidays;
+    g_payroll.SetModel(model);
 }
 
-static void SaveData() {
-    FILE* f = _wfopen(g_dataPath.c_str(), L"w");
-    if (!f) return;
-    for (auto& p : g_shifts) {
-        char key[16];
-        WideCharToMultiByte(CP_ACP, 0, p.first.c_str(), -1, key, 16, NULL, NULL);
-        fprintf(f, "%s %d\n", key, p.second);
-    }
-    fclose(f);
+static void LoadData() {
+    TRACE_SCOPE("app", "load");
+    g_data.Open(g_dataPath, g_roster);
+    g_data.StartWriter();   // edits never wait for the disk; Close() flushes
+    g_shifts = &g_roster.Default();
+    g_history.Attach(*g_shifts);
+    g_shifts->AddObserver(&g_view);
+    LoadHolidays();
+    g_payroll.Attach(*g_shifts);
+    g_view.SetPayroll(&g_payroll);
+    g_view.SetHolidays(&g_holidays);
+    g_rules.Attach(*g_shifts);
+    g_view.SetRules(&g_rules);
 }
 
-// ============================================================================
-//  COPY LOGIC
-// ============================================================================
+static void AppendLoadErrors(wchar_t* msg, const wchar_t* file, const TextParseReport& r) {
+    int shown = (int)(r.errorCount < 5 ? r.errorCount : 5);
+    for (int i = 0; i < shown; i++)
+        wsprintfW(msg + wcslen(msg), L"%s, linija %d: %S\n", file, (int)r.errors[i].line, r.errors[i].reason);
+    if (r.errorCount > (size_t)shown)
+        wsprintfW(msg + wcslen(msg), L"... (ukupno %d neispravnih linija)\n", (int)r.errorCount);
+}
 
-static void CopyMonthPattern(int srcM, int srcY, int dstM, int dstY, bool overwrite) {
-    int srcDays = DaysInMonth(srcM, srcY);
-    int dstDays = DaysInMonth(dstM, dstY);
-    int n = (srcDays < dstDays) ? srcDays : dstDays;
-    for (int d = 1; d <= n; d++) {
-        ShiftType ss = GetShift(d, srcM, srcY);
-        if (ss == SHIFT_NONE) continue;
-        if (!overwrite && GetShift(d, dstM, dstY) != SHIFT_NONE) continue;
-        SetShift(d, dstM, dstY, ss);
-    }
+static void ReportLoadErrors() {
+    const TextParseReport& lr = g_data.LegacyReport();
+    const TextParseReport& jr = g_data.JournalReport();
+    if (lr.errorCount == 0 && jr.errorCount == 0 && g_holidayReport.errorCount == 0) return;
+    wchar_t msg[2048] = L"Neke linije nisu ucitane i bice izostavljene:\n\n";
+    AppendLoadErrors(msg, L"smjene_data.txt", lr);
+    AppendLoadErrors(msg, L"smjene_data.journal", jr);
+    AppendLoadErrors(msg, L"smjene_praznici.txt", g_holidayReport);
+    MessageBoxW(g_hWnd, msg, L"Greska u podacima", MB_OK | MB_ICONWARNING);
+}
+
+// Queues the edits made since the last call for the journal (written by
+// the writer thread once the clicks pause)
+static void SaveData() {
+    TRACE_SCOPE("app", "save");
+    g_data.Commit();
 }
 
 // ============================================================================
@@ -310,16 +302,18 @@ static LRESULT CALLBACK CopyDlgWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARA
             wchar_t confirmMsg[512];
             wsprintfW(confirmMsg,
                 L"Kopiram raspored iz %s %d (%d smjena)\nna %d odabranih mjeseci u %d. godini.\n\n%s\n\nNastaviti?",
-                MONTH_NAMES[g_viewMonth - 1], g_viewYear, srcCount,
+                MonthName(g_viewMonth), g_viewYear, srcCount,
                 checkedCount, g_copyTargetYear,
                 overwrite ? L"Postojece smjene CE biti prepisane!" :
                             L"Postojece smjene NECE biti prepisane.");
 
             if (MessageBoxW(hWnd, confirmMsg, L"Potvrda kopiranja", MB_YESNO | MB_ICONQUESTION) == IDYES) {
+                ShiftTransaction tx(g_history);
                 for (int i = 0; i < 12; i++) {
                     if (months[i])
-                        CopyMonthPattern(g_viewMonth, g_viewYear, i + 1, g_copyTargetYear, overwrite);
+                        CopyMonthPattern(*g_shifts, g_viewMonth, g_viewYear, i + 1, g_copyTargetYear, overwrite);
                 }
+                tx.Commit();
                 SaveData();
                 wchar_t doneMsg[100];
                 wsprintfW(doneMsg, L"Raspored uspjesno kopiran na %d mjeseci!", checkedCount);
@@ -428,7 +422,7 @@ static void ShowCopyDialog() {
 
     // Source label
     wchar_t srcLbl[100];
-    wsprintfW(srcLbl, L"Izvor: %s %d (%d smjena)", MONTH_NAMES[g_viewMonth - 1], g_viewYear, srcCount);
+    wsprintfW(srcLbl, L"Izvor: %s %d (%d smjena)", MonthName(g_viewMonth), g_viewYear, srcCount);
     h = CreateWindowW(L"STATIC", srcLbl, WS_CHILD | WS_VISIBLE, x, y, 300, 20, g_hCopyDlg, NULL, NULL, NULL);
     SendMessage(h, WM_SETFONT, (WPARAM)hFontBold, TRUE);
     y += 30;
@@ -509,11 +503,374 @@ static void ShowCopyDialog() {
     UpdateWindow(g_hCopyDlg);
 }
 
+// ============================================================================
+//  ROTATION DIALOG - cycle from a day of the current month to the end of a year
+// ============================================================================
+
+static LRESULT CALLBACK RotDlgWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    switch (msg) {
+    case WM_COMMAND: {
+        int id = LOWORD(wParam);
+        int notif = HIWORD(wParam);
+
+        if ((id == IDC_YEAR_UP || id == IDC_YEAR_DOWN) && notif == BN_CLICKED) {
+            int yr = g_rotTargetYear + (id == IDC_YEAR_UP ? 1 : -1);
+            if (yr < g_viewYear) yr = g_viewYear;
+            if (yr > g_viewYear + 50) yr = g_viewYear + 50;
+            g_rotTargetYear = yr;
+            wchar_t ys[10];
+            wsprintfW(ys, L"%d", yr);
+            SetDlgItemTextW(hWnd, IDC_YEAR_EDIT, ys);
+            return 0;
+        }
+
+        if (id == IDC_BTN_OK && notif == BN_CLICKED) {
+            wchar_t wpat[Rotation::MAX_PERIOD * 2 + 1];
+            char pat[Rotation::MAX_PERIOD * 2 + 1];
+            GetDlgItemTextW(hWnd, IDC_ROT_PATTERN, wpat, Rotation::MAX_PERIOD * 2 + 1);
+            int n = 0;
+            for (; wpat[n]; n++) pat[n] = wpat[n] < 128 ? (char)wpat[n] : '?';
+            pat[n] = 0;
+
+            int startDay = (int)GetDlgItemInt(hWnd, IDC_ROT_DAY, NULL, FALSE);
+            if (startDay < 1 || startDay > DaysInMonth(g_viewMonth, g_viewYear)) {
+                MessageBoxW(hWnd, L"Neispravan dan pocetka rotacije!", L"Greska", MB_OK | MB_ICONWARNING);
+                return 0;
+            }
+            Rotation rot;
+            int32_t from = DaysFromCivil(g_viewYear, g_viewMonth, startDay);
+            if (!ParseRotation(pat, from, rot)) {
+                MessageBoxW(hWnd,
+                    L"Neispravna rotacija!\n\nKoristite D (dnevna), N (nocna), S (slobodan) i - (bez promjene),\nnpr. DDNNSSSS.",
+                    L"Greska", MB_OK | MB_ICONWARNING);
+                return 0;
+            }
+
+            bool overwrite = (IsDlgButtonChecked(hWnd, IDC_CHK_OVERWRITE) == BST_CHECKED);
+            wchar_t confirmMsg[512];
+            wsprintfW(confirmMsg,
+                L"Rotacija od %d. %s %d do 31. Decembar %d\n(ciklus od %d dana).\n\n%s\n\nNastaviti?",
+                startDay, MonthName(g_viewMonth), g_viewYear, g_rotTargetYear, rot.period,
+                overwrite ? L"Postojece smjene CE biti prepisane!" :
+                            L"Postojece smjene NECE biti prepisane.");
+
+            if (MessageBoxW(hWnd, confirmMsg, L"Potvrda rotacije", MB_YESNO | MB_ICONQUESTION) == IDYES) {
+                size_t changed = ApplyRotation(*g_shifts, rot, from, DaysFromCivil(g_rotTargetYear, 12, 31),
+                                               overwrite ? MERGE_OVERWRITE : MERGE_KEEP);
+                SaveData();
+                wchar_t doneMsg[100];
+                wsprintfW(doneMsg, L"Rotacija upisana (%d dana promijenjeno).", (int)changed);
+                MessageBoxW(hWnd, doneMsg, L"Gotovo", MB_OK | MB_ICONINFORMATION);
+                EnableWindow(g_hWnd, TRUE);
+                DestroyWindow(hWnd);
+            }
+            return 0;
+        }
+
+        if ((id == IDC_BTN_CANCEL && notif == BN_CLICKED) || id == IDCANCEL) {
+            EnableWindow(g_hWnd, TRUE);
+            DestroyWindow(hWnd);
+            return 0;
+        }
+        break;
+    }
+
+    case WM_CLOSE:
+        EnableWindow(g_hWnd, TRUE);
+        DestroyWindow(hWnd);
+        return 0;
+
+    case WM_DESTROY:
+        g_hRotDlg = NULL;
+        SetForegroundWindow(g_hWnd);
+        InvalidateRect(g_hWnd, NULL, FALSE);
+        return 0;
+    }
+
+    return DefWindowProcW(hWnd, msg, wParam, lParam);
+}
+
+static void ShowRotationDialog() {
+    if (g_hRotDlg && IsWindow(g_hRotDlg)) {
+        SetForegroundWindow(g_hRotDlg);
+        return;
+    }
+
+    static bool registered = false;
+    if (!registered) {
+        WNDCLASSEXW wc = {};
+        wc.cbSize = sizeof(wc);
+        wc.style = CS_HREDRAW | CS_VREDRAW;
+        wc.lpfnWndProc = RotDlgWndProc;
+        wc.hInstance = GetModuleHandle(NULL);
+        wc.hCursor = LoadCursor(NULL, IDC_ARROW);
+        wc.hbrBackground = (HBRUSH)GetStockObject(WHITE_BRUSH);
+        wc.lpszClassName = L"SmjeneRotDlgClass";
+        RegisterClassExW(&wc);
+        registered = true;
+    }
+
+    g_rotTargetYear = g_viewYear;
+
+    int dlgClientW = 330, dlgClientH = 250;
+    RECT rcDlg = {0, 0, dlgClientW, dlgClientH};
+    AdjustWindowRectEx(&rcDlg, WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU, FALSE, WS_EX_DLGMODALFRAME);
+    int dlgW = rcDlg.right - rcDlg.left;
+    int dlgH = rcDlg.bottom - rcDlg.top;
+
+    RECT rcP; GetWindowRect(g_hWnd, &rcP);
+    int px = rcP.left + (rcP.right - rcP.left - dlgW) / 2;
+    int py = rcP.top + (rcP.bottom - rcP.top - dlgH) / 2;
+
+    g_hRotDlg = CreateWindowExW(
+        WS_EX_DLGMODALFRAME,
+        L"SmjeneRotDlgClass",
+        L"Rotacija Smjena",
+        WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU,
+        px, py, dlgW, dlgH,
+        g_hWnd, NULL, GetModuleHandle(NULL), NULL);
+
+    if (!g_hRotDlg) return;
+
+    HFONT hFont     = MakeFont(15);
+    HFONT hFontBold = MakeFont(15, true);
+    HFONT hFontSm   = MakeFont(13);
+
+    int y = 10, x = 15;
+    HWND h;
+
+    // Pattern
+    h = CreateWindowW(L"STATIC", L"Ciklus (D = dnevna, N = nocna, S = slobodan, - = bez promjene):",
+        WS_CHILD | WS_VISIBLE, x, y, 300, 36, g_hRotDlg, NULL, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFontSm, TRUE);
+    y += 38;
+    h = CreateWindowW(L"EDIT", L"DDNNSSSS", WS_CHILD | WS_VISIBLE | WS_BORDER | ES_UPPERCASE | ES_AUTOHSCROLL,
+        x, y, 300, 24, g_hRotDlg, (HMENU)IDC_ROT_PATTERN, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFontBold, TRUE);
+    SendMessage(h, EM_LIMITTEXT, Rotation::MAX_PERIOD * 2, 0);
+    y += 34;
+
+    // Start day in the current month
+    wchar_t lb[100];
+    wsprintfW(lb, L"Pocetak: dan u mjesecu %s %d:", MonthName(g_viewMonth), g_viewYear);
+    h = CreateWindowW(L"STATIC", lb, WS_CHILD | WS_VISIBLE, x, y+3, 230, 20, g_hRotDlg, NULL, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFont, TRUE);
+    h = CreateWindowW(L"EDIT", L"1", WS_CHILD | WS_VISIBLE | WS_BORDER | ES_CENTER | ES_NUMBER,
+        x+240, y, 50, 24, g_hRotDlg, (HMENU)IDC_ROT_DAY, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFontBold, TRUE);
+    y += 32;
+
+    // End year
+    h = CreateWindowW(L"STATIC", L"Do kraja godine:", WS_CHILD | WS_VISIBLE, x, y+3, 100, 20, g_hRotDlg, NULL, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFont, TRUE);
+
+    wchar_t ys[10]; wsprintfW(ys, L"%d", g_rotTargetYear);
+    h = CreateWindowW(L"EDIT", ys, WS_CHILD | WS_VISIBLE | WS_BORDER | ES_CENTER | ES_READONLY,
+        x+105, y, 65, 24, g_hRotDlg, (HMENU)IDC_YEAR_EDIT, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFontBold, TRUE);
+
+    h = CreateWindowW(L"BUTTON", L"<", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
+        x+175, y, 30, 24, g_hRotDlg, (HMENU)IDC_YEAR_DOWN, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFont, TRUE);
+
+    h = CreateWindowW(L"BUTTON", L">", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
+        x+210, y, 30, 24, g_hRotDlg, (HMENU)IDC_YEAR_UP, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFont, TRUE);
+    y += 34;
+
+    // Overwrite
+    h = CreateWindowW(L"BUTTON", L"Prepisi postojece smjene",
+        WS_CHILD | WS_VISIBLE | BS_AUTOCHECKBOX,
+        x, y, 280, 20, g_hRotDlg, (HMENU)IDC_CHK_OVERWRITE, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFont, TRUE);
+    y += 40;
+
+    // OK / Cancel
+    h = CreateWindowW(L"BUTTON", L"POPUNI", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON | BS_DEFPUSHBUTTON,
+        x+80, y, 90, 32, g_hRotDlg, (HMENU)IDC_BTN_OK, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFontBold, TRUE);
+
+    h = CreateWindowW(L"BUTTON", L"Odustani", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
+        x+180, y, 90, 32, g_hRotDlg, (HMENU)IDC_BTN_CANCEL, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFont, TRUE);
+
+    EnableWindow(g_hWnd, FALSE);
+    ShowWindow(g_hRotDlg, SW_SHOW);
+    UpdateWindow(g_hRotDlg);
+}
+
+// ============================================================================
+//  IMPORT DIALOG - CSV / iCalendar file into the calendar (Ctrl+I)
+// ============================================================================
+
+static void CloseImportDialog(HWND hWnd) {
+    g_importRecords.clear();
+    g_importRecords.shrink_to_fit();
+    EnableWindow(g_hWnd, TRUE);
+    DestroyWindow(hWnd);
+}
+
+static LRESULT CALLBACK ImportDlgWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    switch (msg) {
+    case WM_COMMAND: {
+        int id = LOWORD(wParam);
+        int notif = HIWORD(wParam);
+
+        if (id == IDC_BTN_OK && notif == BN_CLICKED) {
+            ImportOptions opt;
+            opt.mode = IsDlgButtonChecked(hWnd, IDC_CHK_OVERWRITE) == BST_CHECKED ? MERGE_OVERWRITE : MERGE_KEEP;
+            opt.fileEmployees = false;   // the calendar shows the default employee
+
+            // The whole file is one undo step and one journal batch
+            ImportReport& r = g_importReport;
+            ShiftTransaction tx(g_history);
+            ApplyImport(g_roster, g_importRecords, opt, r);
+            tx.Commit();
+            SaveData();
+            wchar_t doneMsg[256];
+            wsprintfW(doneMsg, L"Uvoz zavrsen.\n\nDodano: %d\nPrepisano: %d\nPreskoceno: %d\nOdbijeno: %d\n\nPonistavanje: Ctrl+Z",
+                (int)r.added, (int)r.overwritten, (int)r.skipped, (int)r.rejected);
+            MessageBoxW(hWnd, doneMsg, L"Gotovo", MB_OK | MB_ICONINFORMATION);
+            CloseImportDialog(hWnd);
+            return 0;
+        }
+
+        if ((id == IDC_BTN_CANCEL && notif == BN_CLICKED) || id == IDCANCEL) {
+            CloseImportDialog(hWnd);
+            return 0;
+        }
+        break;
+    }
+
+    case WM_CLOSE:
+        CloseImportDialog(hWnd);
+        return 0;
+
+    case WM_DESTROY:
+        g_hImportDlg = NULL;
+        SetForegroundWindow(g_hWnd);
+        InvalidateRect(g_hWnd, NULL, FALSE);
+        return 0;
+    }
+
+    return DefWindowProcW(hWnd, msg, wParam, lParam);
+}
+
+// Picks and parses the file, then asks how to merge it
+static void ShowImportDialog() {
+    if (g_hImportDlg && IsWindow(g_hImportDlg)) {
+        SetForegroundWindow(g_hImportDlg);
+        return;
+    }
+
+    wchar_t path[MAX_PATH] = {0};
+    OPENFILENAMEW ofn = {};
+    ofn.lStructSize = sizeof(ofn);
+    ofn.hwndOwner = g_hWnd;
+    ofn.lpstrFilter = L"Tabela ili kalendar (*.csv;*.ics)\0*.csv;*.ics\0Sve datoteke (*.*)\0*.*\0";
+    ofn.lpstrFile = path;
+    ofn.nMaxFile = MAX_PATH;
+    ofn.lpstrTitle = L"Uvoz smjena";
+    ofn.Flags = OFN_FILEMUSTEXIST | OFN_PATHMUSTEXIST | OFN_HIDEREADONLY;
+    if (!GetOpenFileNameW(&ofn)) return;
+
+    size_t n = wcslen(path);
+    bool ics = n > 4 && _wcsicmp(path + n - 4, L".ics") == 0;
+    const wchar_t* name = wcsrchr(path, L'\\') ? wcsrchr(path, L'\\') + 1 : path;
+    FILE* f = OpenPath(path, "rb");
+    if (!f) {
+        MessageBoxW(g_hWnd, L"Datoteku nije moguce otvoriti.", L"Greska", MB_OK | MB_ICONWARNING);
+        return;
+    }
+    ImportOptions opt;
+    opt.fileEmployees = false;
+    g_importRecords.clear();
+    g_importReport = ImportReport();
+    ReadImport(f, ics ? IMPORT_ICS : IMPORT_CSV, opt, g_importRecords, g_importReport);
+    fclose(f);
+    if (g_importRecords.empty()) {
+        wchar_t msg[1024] = L"Datoteka nema smjena za uvoz.\n\n";
+        AppendLoadErrors(msg, name, g_importReport.parse);
+        MessageBoxW(g_hWnd, msg, L"Uvoz smjena", MB_OK | MB_ICONWARNING);
+        return;
+    }
+
+    static bool registered = false;
+    if (!registered) {
+        WNDCLASSEXW wc = {};
+        wc.cbSize = sizeof(wc);
+        wc.style = CS_HREDRAW | CS_VREDRAW;
+        wc.lpfnWndProc = ImportDlgWndProc;
+        wc.hInstance = GetModuleHandle(NULL);
+        wc.hCursor = LoadCursor(NULL, IDC_ARROW);
+        wc.hbrBackground = (HBRUSH)GetStockObject(WHITE_BRUSH);
+        wc.lpszClassName = L"SmjeneImportDlgClass";
+        RegisterClassExW(&wc);
+        registered = true;
+    }
+
+    int dlgClientW = 330, dlgClientH = 200;
+    RECT rcDlg = {0, 0, dlgClientW, dlgClientH};
+    AdjustWindowRectEx(&rcDlg, WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU, FALSE, WS_EX_DLGMODALFRAME);
+    int dlgW = rcDlg.right - rcDlg.left;
+    int dlgH = rcDlg.bottom - rcDlg.top;
+
+    RECT rcP; GetWindowRect(g_hWnd, &rcP);
+    int px = rcP.left + (rcP.right - rcP.left - dlgW) / 2;
+    int py = rcP.top + (rcP.bottom - rcP.top - dlgH) / 2;
+
+    g_hImportDlg = CreateWindowExW(
+        WS_EX_DLGMODALFRAME,
+        L"SmjeneImportDlgClass",
+        L"Uvoz Smjena",
+        WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU,
+        px, py, dlgW, dlgH,
+        g_hWnd, NULL, GetModuleHandle(NULL), NULL);
+
+    if (!g_hImportDlg) return;
+
+    HFONT hFont     = MakeFont(15);
+    HFONT hFontBold = MakeFont(15, true);
+    HFONT hFontSm   = MakeFont(13);
+
+    int y = 10, x = 15;
+    HWND h;
+
+    // File summary
+    wchar_t info[512];
+    wsprintfW(info, L"%s\n\nSmjena za uvoz: %d\nNeispravnih redova: %d",
+        name, (int)g_importRecords.size(), (int)g_importReport.rejected);
+    h = CreateWindowW(L"STATIC", info, WS_CHILD | WS_VISIBLE | SS_NOPREFIX,
+        x, y, 300, 76, g_hImportDlg, (HMENU)IDC_IMPORT_INFO, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFontSm, TRUE);
+    y += 84;
+
+    // Overwrite
+    h = CreateWindowW(L"BUTTON", L"Prepisi postojece smjene",
+        WS_CHILD | WS_VISIBLE | BS_AUTOCHECKBOX,
+        x, y, 280, 20, g_hImportDlg, (HMENU)IDC_CHK_OVERWRITE, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFont, TRUE);
+    y += 40;
+
+    // OK / Cancel
+    h = CreateWindowW(L"BUTTON", L"UVEZI", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON | BS_DEFPUSHBUTTON,
+        x+80, y, 90, 32, g_hImportDlg, (HMENU)IDC_BTN_OK, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFontBold, TRUE);
+
+    h = CreateWindowW(L"BUTTON", L"Odustani", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
+        x+180, y, 90, 32, g_hImportDlg, (HMENU)IDC_BTN_CANCEL, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFont, TRUE);
+
+    EnableWindow(g_hWnd, FALSE);
+    ShowWindow(g_hImportDlg, SW_SHOW);
+    UpdateWindow(g_hImportDlg);
+}
+
 // ============================================================================
 //  CLEAR MONTH
 // ============================================================================
 
-static void ClearMonth() {
+static void ClearViewMonth() {
     int count = CountShiftsInMonth(g_viewMonth, g_viewYear);
     if (count == 0) {
         MessageBoxW(g_hWnd, L"Ovaj mjesec nema unesenih smjena.", L"Info", MB_OK | MB_ICONINFORMATION);
@@ -521,13 +878,13 @@ static void ClearMonth() {
     }
 
     wchar_t msg[256];
-    wsprintfW(msg, L"Obrisati sve smjene iz %s %d?\n\n(%d smjena ce biti obrisano)\n\nOva akcija se ne moze ponistiti!",
-        MONTH_NAMES[g_viewMonth - 1], g_viewYear, count);
+    wsprintfW(msg, L"Obrisati sve smjene iz %s %d?\n\n(%d smjena ce biti obrisano)\n\nPonistavanje: Ctrl+Z",
+        MonthName(g_viewMonth), g_viewYear, count);
 
     if (MessageBoxW(g_hWnd, msg, L"Brisanje mjeseca", MB_YESNO | MB_ICONWARNING) == IDYES) {
-        int days = DaysInMonth(g_viewMonth, g_viewYear);
-        for (int d = 1; d <= days; d++)
-            SetShift(d, g_viewMonth, g_viewYear, SHIFT_NONE);
+        ShiftTransaction tx(g_history);
+        ClearMonth(*g_shifts, g_viewMonth, g_viewYear);
+        tx.Commit();
         SaveData();
         InvalidateRect(g_hWnd, NULL, FALSE);
     }
@@ -538,27 +895,27 @@ static void ClearMonth() {
 // ============================================================================
 
 static void ResetAll() {
-    if (g_shifts.empty()) {
+    if (g_shifts->Empty()) {
         MessageBoxW(g_hWnd, L"Nema unesenih podataka za brisanje.", L"Info", MB_OK | MB_ICONINFORMATION);
         return;
     }
 
-    int totalShifts = (int)g_shifts.size();
+    int totalShifts = (int)g_shifts->Count();
 
     wchar_t msg[300];
     wsprintfW(msg,
         L"UPOZORENJE!\n\n"
         L"Obrisati SVE smjene iz SVIH mjeseci i godina?\n\n"
         L"Ukupno %d unesenih smjena ce biti obrisano.\n\n"
-        L"Ova akcija se NE MOZE ponistiti!",
+        L"Ponistavanje: Ctrl+Z (dok je program otvoren).",
         totalShifts);
 
     if (MessageBoxW(g_hWnd, msg, L"RESET - Brisanje svega", MB_YESNO | MB_ICONWARNING) == IDYES) {
         // Double confirm for safety
         if (MessageBoxW(g_hWnd,
-            L"Da li ste SIGURNI?\n\nSvi podaci ce biti trajno obrisani!",
+            L"Da li ste SIGURNI?\n\nSvi podaci ce biti obrisani!\nNakon zatvaranja programa brisanje se vise ne moze ponistiti.",
             L"Posljednja potvrda", MB_YESNO | MB_ICONERROR) == IDYES) {
-            g_shifts.clear();
+            ClearAll(*g_shifts);
             SaveData();
             InvalidateRect(g_hWnd, NULL, FALSE);
             MessageBoxW(g_hWnd, L"Svi podaci su uspjesno obrisani.", L"Reset zavrsen", MB_OK | MB_ICONINFORMATION);
@@ -567,268 +924,405 @@ static void ResetAll() {
 }
 
 // ============================================================================
-//  GDI+ HELPERS
+//  GDI+ BACKEND - replays the view's display list. Fonts, formats, the
+//  brush, the pen and the path are created once and reused for every command.
 // ============================================================================
 
-static GraphicsPath* RoundRect(float x, float y, float w, float h, float r) {
-    GraphicsPath* p = new GraphicsPath();
-    if (r < 1) { p->AddRectangle(RectF(x, y, w, h)); return p; }
+struct GdiplusResources {
+    FontFamily   family{L"Segoe UI"};
+    Font*        fonts[FONT_COUNT];
+    StringFormat formats[3][3];     // [hAlign][vAlign]
+    SolidBrush   brush{Color()};
+    Pen          pen{Color()};
+    GraphicsPath path;
+
+    GdiplusResources() {
+        for (int i = 0; i < FONT_COUNT; i++)
+            fonts[i] = new Font(&family, DL_FONTS[i].size,
+                (DL_FONTS[i].bold ? FontStyleBold : 0) | (DL_FONTS[i].italic ? FontStyleItalic : 0), UnitPixel);
+        for (int h = 0; h < 3; h++)
+            for (int v = 0; v < 3; v++) {
+                formats[h][v].SetAlignment((StringAlignment)h);
+                formats[h][v].SetLineAlignment((StringAlignment)v);
+            }
+    }
+    ~GdiplusResources() { for (Font* f : fonts) delete f; }
+};
+
+// Lives between GdiplusStartup and GdiplusShutdown
+static GdiplusResources* g_gdi = nullptr;
+
+static Color ToColor(DlColor c) { return Color((BYTE)(c >> 24), (BYTE)(c >> 16), (BYTE)(c >> 8), (BYTE)c); }
+
+class GdiplusMetrics : public TextMetrics {
+public:
+    explicit GdiplusMetrics(Graphics& g) : m_g(g) {}
+    float Width(DlFont font, const char16_t* text, int len) const override {
+        RectF b;
+        m_g.MeasureString(UiText(text), len, g_gdi->fonts[font], PointF(0, 0), &b);
+        return b.Width;
+    }
+private:
+    Graphics& m_g;
+};
+
+static void RoundRectPath(GraphicsPath& p, float x, float y, float w, float h, float r) {
+    p.Reset();
+    if (r < 1) { p.AddRectangle(RectF(x, y, w, h)); return; }
+    float d = r * 2;
+    p.AddArc(x, y, d, d, 180, 90);
+    p.AddArc(x + w - d, y, d, d, 270, 90);
+    p.AddArc(x + w - d, y + h - d, d, d, 0, 90);
+    p.AddArc(x, y + h - d, d, d, 90, 90);
+    p.CloseFigure();
+}
+
+// Top band of a rounded rect: the accent bar over a cell with a shift
+static void RoundTopPath(GraphicsPath& p, float x, float y, float w, float h, float r) {
     float d = r * 2;
-    p->AddArc(x, y, d, d, 180, 90);
-    p->AddArc(x + w - d, y, d, d, 270, 90);
-    p->AddArc(x + w - d, y + h - d, d, d, 0, 90);
-    p->AddArc(x, y + h - d, d, d, 90, 90);
-    p->CloseFigure();
-    return p;
+    p.Reset();
+    p.AddArc(x, y, d, d, 180, 90);
+    p.AddArc(x + w - d, y, d, d, 270, 90);
+    p.AddLine(x + w, y + r, x + w, y + h);
+    p.AddLine(x + w, y + h, x, y + h);
+    p.AddLine(x, y + h, x, y + r);
+    p.CloseFigure();
+}
+
+static void ReplayRange(Graphics& g, const DisplayList& dl, size_t first, size_t end, const LayoutRect& clip) {
+    GdiplusResources& r = *g_gdi;
+    for (size_t i = first; i < end; i++) {
+        const DlCmd& c = dl[i];
+        if (!dl.Bounds(c).Intersects(clip)) continue;
+        switch (c.op) {
+        case DL_FILL_RECT:
+            r.brush.SetColor(ToColor(c.color));
+            g.FillRectangle(&r.brush, c.x, c.y, c.w, c.h);
+            break;
+        case DL_GRADIENT_V: {
+            LinearGradientBrush b(PointF(c.x, c.y), PointF(c.x, c.y + c.h), ToColor(c.color), ToColor(c.color2));
+            g.FillRectangle(&b, c.x, c.y, c.w, c.h);
+            break;
+        }
+        case DL_FILL_ROUND:
+            r.brush.SetColor(ToColor(c.color));
+            RoundRectPath(r.path, c.x, c.y, c.w, c.h, c.r);
+            g.FillPath(&r.brush, &r.path);
+            break;
+        case DL_STROKE_ROUND:
+            r.pen.SetColor(ToColor(c.color)); r.pen.SetWidth(c.pen);
+            RoundRectPath(r.path, c.x, c.y, c.w, c.h, c.r);
+            g.DrawPath(&r.pen, &r.path);
+            break;
+        case DL_FILL_ROUND_TOP:
+            r.brush.SetColor(ToColor(c.color));
+            RoundTopPath(r.path, c.x, c.y, c.w, c.h, c.r);
+            g.FillPath(&r.brush, &r.path);
+            break;
+        case DL_LINE:
+            r.pen.SetColor(ToColor(c.color)); r.pen.SetWidth(c.pen);
+            g.DrawLine(&r.pen, c.x, c.y, c.x + c.w, c.y + c.h);
+            break;
+        case DL_TEXT:
+            r.brush.SetColor(ToColor(c.color));
+            g.DrawString(UiText(dl.Text(c)), (int)c.textLen, r.fonts[c.font], RectF(c.x, c.y, c.w, c.h),
+                         &r.formats[c.hAlign][c.vAlign], &r.brush);
+            break;
+        }
+    }
+}
+
+static void ReplayDisplayList(Graphics& g, const DisplayList& dl, const LayoutRect& clip) {
+    ReplaySections(dl, "paint", [&](size_t first, size_t end) { ReplayRange(g, dl, first, end, clip); });
+}
+
+// ============================================================================
+//  HIT TESTING
+// ============================================================================
+
+static int HitTestDay(int mx, int my) { return g_viewMode == VIEW_MONTH ? g_layout.HitDay(mx, my) : -1; }
+static int HitTestButton(int mx, int my) { return g_layout.HitButton(mx, my, ModeButtons(g_viewMode)); }
+// Day number (since 1970) under the point in an overview, -1 when none
+static int32_t HitTestOverviewDay(int mx, int my) { return g_viewMode == VIEW_MONTH ? -1 : g_overview.HitDay(mx, my); }
+
+// ============================================================================
+//  REPAINT
+// ============================================================================
+
+// Layout of the current client size and viewed month; hit tests use it, so
+// it is refreshed whenever either changes, not only when painting
+static void UpdateLayout() {
+    RECT rc; GetClientRect(g_hWnd,&rc);
+    g_layout = ComputeLayout(rc.right, rc.bottom, g_viewMonth, g_viewYear);
+    if (g_viewMode != VIEW_MONTH) g_overview = ComputeOverviewLayout(rc.right, rc.bottom, g_viewMode, g_viewYear);
+}
+
+static UiState CurrentUi() {
+    UiState u;
+    u.width = g_layout.width; u.height = g_layout.height;
+    u.viewMode = g_viewMode;
+    u.viewMonth = g_viewMonth; u.viewYear = g_viewYear;
+    u.today = DaysFromCivil(g_todayYear, g_todayMonth, g_todayDay);
+    u.hoverDay = g_hoverDay; u.hoverBtn = g_hoverBtn;
+    return u;
+}
+
+static void Invalidate(const DirtyRects& d) {
+    if (d.full) { InvalidateRect(g_hWnd,NULL,FALSE); return; }
+    for (int i = 0; i < d.count; i++) {
+        RECT r = { d.rects[i].left, d.rects[i].top, d.rects[i].right, d.rects[i].bottom };
+        InvalidateRect(g_hWnd,&r,FALSE);
+    }
 }
 
-static void FillRR(Graphics& g, Brush* b, float x, float y, float w, float h, float r) {
-    GraphicsPath* p = RoundRect(x, y, w, h, r); g.FillPath(b, p); delete p;
+// Days of the viewed month got new shifts: their cells, the cells whose rule
+// marks they can change and the month totals; every cell while a search is
+// on (a match can depend on the whole month)
+static void InvalidateDays(int32_t from, int32_t to) {
+    if (!g_search.Empty()) { from = g_layout.grid.first; to = from + g_layout.grid.days - 1; }
+    Invalidate(DirtyForDays(g_layout, from, to + g_rules.Rules().Reach()));
 }
-static void DrawRR(Graphics& g, Pen* pen, float x, float y, float w, float h, float r) {
-    GraphicsPath* p = RoundRect(x, y, w, h, r); g.DrawPath(pen, p); delete p;
+
+static void InvalidateDay(int day) {
+    int32_t z = DaysFromCivil(g_viewYear, g_viewMonth, day);
+    InvalidateDays(z, z);
 }
 
 // ============================================================================
 //  MAIN DRAWING
 // ============================================================================
 
-static void DrawCalendar(HDC hdc, int W, int H) {
+static LayoutRect ToLayout(const RECT& r) {
+    LayoutRect l; l.left=r.left; l.top=r.top; l.right=r.right; l.bottom=r.bottom; return l;
+}
+
+// Paints the parts of the view that intersect clip
+static void DrawCalendar(HDC hdc, const RECT& clipRc) {
+    const LayoutRect clip = ToLayout(clipRc);
     Graphics g(hdc);
+    g.SetClip(Rect(clip.left, clip.top, clip.right-clip.left, clip.bottom-clip.top));
     g.SetSmoothingMode(SmoothingModeAntiAlias);
     g.SetTextRenderingHint(TextRenderingHintClearTypeGridFit);
+    GdiplusMetrics metrics(g);
+    ReplayDisplayList(g, g_view.Get(g_layout, CurrentUi(), *g_shifts, metrics), clip);
+}
 
-    // BG
-    LinearGradientBrush bgBr(Point(0,0), Point(0,H), CLR_BG_TOP, CLR_BG_BOT);
-    g.FillRectangle(&bgBr, 0, 0, W, H);
-
-    // Header
-    SolidBrush hdrBr(CLR_HEADER);
-    g.FillRectangle(&hdrBr, 0, 0, W, HEADER_H);
-    Pen sepPen(CLR_SEPARATOR, 1.0f);
-    g.DrawLine(&sepPen, 0, HEADER_H, W, HEADER_H);
-
-    FontFamily ff(L"Segoe UI");
-    Font fTitle(&ff, 22, FontStyleBold, UnitPixel);
-    Font fBtn(&ff, 18, FontStyleBold, UnitPixel);
-    Font fBtnSm(&ff, 11, FontStyleBold, UnitPixel);
-    Font fDay(&ff, 12, FontStyleBold, UnitPixel);
-    Font fCellN(&ff, 14, FontStyleBold, UnitPixel);
-    Font fCellS(&ff, 11, FontStyleRegular, UnitPixel);
-    Font fLeg(&ff, 12, FontStyleRegular, UnitPixel);
-    Font fStat(&ff, 13, FontStyleRegular, UnitPixel);
-
-    SolidBrush txBr(CLR_TEXT), dimBr(CLR_TEXT_DIM);
-
-    int bY = 16, bH = 42, bR = 8;
-
-    // Prev
-    int pX = 15, pW = 42;
-    g_prevBtn = {pX, bY, pX+pW, bY+bH};
-    { SolidBrush b(g_hoverBtn==0?CLR_BTN_HOVER:CLR_BTN); FillRR(g,&b,(float)pX,(float)bY,(float)pW,(float)bH,(float)bR);
-      StringFormat sf; sf.SetAlignment(StringAlignmentCenter); sf.SetLineAlignment(StringAlignmentCenter);
-      g.DrawString(L"\x25C0",1,&fBtn,RectF((float)pX,(float)bY,(float)pW,(float)bH),&sf,&txBr); }
-
-    // Next
-    int nX = pX+pW+6, nW = 42;
-    g_nextBtn = {nX, bY, nX+nW, bY+bH};
-    { SolidBrush b(g_hoverBtn==1?CLR_BTN_HOVER:CLR_BTN); FillRR(g,&b,(float)nX,(float)bY,(float)nW,(float)bH,(float)bR);
-      StringFormat sf; sf.SetAlignment(StringAlignmentCenter); sf.SetLineAlignment(StringAlignmentCenter);
-      g.DrawString(L"\x25B6",1,&fBtn,RectF((float)nX,(float)bY,(float)nW,(float)bH),&sf,&txBr); }
-
-    // Reset All (rightmost)
-    int rsW = 60, rsX = W-rsW-15;
-    g_resetBtn = {rsX, bY, rsX+rsW, bY+bH};
-    { SolidBrush b(g_hoverBtn==5?Color(255,150,30,30):Color(255,110,20,20));
-      FillRR(g,&b,(float)rsX,(float)bY,(float)rsW,(float)bH,(float)bR);
-      StringFormat sf; sf.SetAlignment(StringAlignmentCenter); sf.SetLineAlignment(StringAlignmentCenter);
-      g.DrawString(L"Reset",5,&fBtnSm,RectF((float)rsX,(float)bY,(float)rsW,(float)bH),&sf,&txBr); }
-
-    // Clear month
-    int clW = 65, clX = rsX-clW-6;
-    g_clearMonthBtn = {clX, bY, clX+clW, bY+bH};
-    { SolidBrush b(g_hoverBtn==4?CLR_BTN_CLEARMONTH_HOVER:CLR_BTN_CLEARMONTH);
-      FillRR(g,&b,(float)clX,(float)bY,(float)clW,(float)bH,(float)bR);
-      StringFormat sf; sf.SetAlignment(StringAlignmentCenter); sf.SetLineAlignment(StringAlignmentCenter);
-      g.DrawString(L"Brisi",5,&fBtnSm,RectF((float)clX,(float)bY,(float)clW,(float)bH),&sf,&txBr); }
-
-    // Copy
-    int cpW = 80, cpX = clX-cpW-8;
-    g_copyBtn = {cpX, bY, cpX+cpW, bY+bH};
-    { SolidBrush b(g_hoverBtn==3?CLR_BTN_COPY_HOVER:CLR_BTN_COPY);
-      FillRR(g,&b,(float)cpX,(float)bY,(float)cpW,(float)bH,(float)bR);
-      StringFormat sf; sf.SetAlignment(StringAlignmentCenter); sf.SetLineAlignment(StringAlignmentCenter);
-      g.DrawString(L"Kopiraj",7,&fBtnSm,RectF((float)cpX,(float)bY,(float)cpW,(float)bH),&sf,&txBr); }
-
-    // Danas
-    int dW = 72, dX = cpX-dW-8;
-    g_todayBtn = {dX, bY, dX+dW, bY+bH};
-    { SolidBrush b(g_hoverBtn==2?CLR_BTN_HOVER:CLR_BTN);
-      FillRR(g,&b,(float)dX,(float)bY,(float)dW,(float)bH,(float)bR);
-      StringFormat sf; sf.SetAlignment(StringAlignmentCenter); sf.SetLineAlignment(StringAlignmentCenter);
-      g.DrawString(L"DANAS",5,&fBtnSm,RectF((float)dX,(float)bY,(float)dW,(float)bH),&sf,&txBr); }
-
-    // Title
-    { wchar_t t[100]; wsprintfW(t, L"%s %d", MONTH_NAMES[g_viewMonth-1], g_viewYear);
-      StringFormat sf; sf.SetAlignment(StringAlignmentCenter); sf.SetLineAlignment(StringAlignmentCenter);
-      g.DrawString(t,(int)wcslen(t),&fTitle,RectF((float)(nX+nW+10),(float)bY,(float)(dX-10-nX-nW-10),(float)bH),&sf,&txBr); }
-
-    // Day names
-    int dnTop = HEADER_H + 5;
-    g_cellW = (W - 20) / 7;
-    g_gridLeft = (W - g_cellW * 7) / 2;
-    for (int i = 0; i < 7; i++) {
-        StringFormat sf; sf.SetAlignment(StringAlignmentCenter); sf.SetLineAlignment(StringAlignmentCenter);
-        SolidBrush* br = (i>=5) ? new SolidBrush(CLR_TEXT_WEEKEND) : new SolidBrush(CLR_TEXT_DIM);
-        g.DrawString(DAY_NAMES[i],(int)wcslen(DAY_NAMES[i]),&fDay,
-            RectF((float)(g_gridLeft+i*g_cellW),(float)dnTop,(float)g_cellW,(float)DAYNAMES_H),&sf,br);
-        delete br;
-    }
-
-    int sY = dnTop + DAYNAMES_H;
-    Pen gPen(CLR_GRID_LINE, 1.0f);
-    g.DrawLine(&gPen, g_gridLeft, sY, g_gridLeft + g_cellW*7, sY);
-
-    // Grid
-    g_gridTop = sY + 4;
-    int gBot = H - LEGEND_H - STATS_H;
-    g_cellH = (gBot - g_gridTop) / 6;
-    g_gridStartDow = DayOfWeek(1, g_viewMonth, g_viewYear);
-    g_daysInView = DaysInMonth(g_viewMonth, g_viewYear);
-
-    for (int day = 1; day <= g_daysInView; day++) {
-        int idx = (day-1) + g_gridStartDow;
-        int row = idx/7, col = idx%7;
-        float cx = (float)(g_gridLeft + col*g_cellW + CELL_PAD);
-        float cy = (float)(g_gridTop + row*g_cellH + CELL_PAD);
-        float cw = (float)(g_cellW - CELL_PAD*2);
-        float ch = (float)(g_cellH - CELL_PAD*2);
-
-        ShiftType st = GetShift(day, g_viewMonth, g_viewYear);
-        bool isToday = (day==g_todayDay && g_viewMonth==g_todayMonth && g_viewYear==g_todayYear);
-        bool isHover = (day==g_hoverDay);
-        bool isWE = (col>=5);
-
-        Color cellBg = isHover ? CLR_CELL_HOVER : CLR_CELL_BG;
-        if (st==SHIFT_DAY) cellBg=CLR_DAY_SHIFT_BG;
-        if (st==SHIFT_NIGHT) cellBg=CLR_NIGHT_SHIFT_BG;
-        if (st==SHIFT_FREE) cellBg=CLR_FREE_DAY_BG;
-
-        SolidBrush cBr(cellBg);
-        FillRR(g, &cBr, cx, cy, cw, ch, 8.0f);
-
-        if (isToday) { Pen tp(CLR_CELL_TODAY_BORDER, 2.5f); DrawRR(g, &tp, cx, cy, cw, ch, 8.0f); }
-
-        // Accent bar
-        if (st != SHIFT_NONE) {
-            Color ac = CLR_DAY_SHIFT;
-            if (st==SHIFT_NIGHT) ac=CLR_NIGHT_SHIFT;
-            if (st==SHIFT_FREE) ac=CLR_FREE_DAY;
-            GraphicsPath* bp = new GraphicsPath();
-            float r2=8.0f;
-            bp->AddArc(cx, cy, r2*2, r2*2, 180, 90);
-            bp->AddArc(cx+cw-r2*2, cy, r2*2, r2*2, 270, 90);
-            bp->AddLine(cx+cw, cy+r2, cx+cw, cy+5);
-            bp->AddLine(cx+cw, cy+5, cx, cy+5);
-            bp->AddLine(cx, cy+5, cx, cy+r2);
-            bp->CloseFigure();
-            SolidBrush ab(ac); g.FillPath(&ab, bp); delete bp;
-        }
+// ============================================================================
+//  NAVIGATION
+// ============================================================================
 
-        // Day num
-        wchar_t ds[4]; wsprintfW(ds, L"%d", day);
-        StringFormat sfN; sfN.SetAlignment(StringAlignmentNear); sfN.SetLineAlignment(StringAlignmentNear);
-        Color nc = isWE ? CLR_TEXT_WEEKEND : CLR_TEXT;
-        if (isToday) nc = CLR_CELL_TODAY_BORDER;
-        SolidBrush nb(nc);
-        g.DrawString(ds,(int)wcslen(ds),&fCellN,RectF(cx+8,cy+8,cw-16,20),&sfN,&nb);
-
-        if (isToday) {
-            StringFormat sfT; sfT.SetAlignment(StringAlignmentFar); sfT.SetLineAlignment(StringAlignmentNear);
-            Font ft(&ff, 9, FontStyleBold, UnitPixel); SolidBrush tb(CLR_CELL_TODAY_BORDER);
-            g.DrawString(L"DANAS",5,&ft,RectF(cx+8,cy+8,cw-16,18),&sfT,&tb);
-        }
+static void GoToPrevMonth() { g_viewMonth--; if(g_viewMonth<1){g_viewMonth=12;g_viewYear--;} UpdateLayout(); InvalidateRect(g_hWnd,NULL,FALSE); }
+static void GoToNextMonth() { g_viewMonth++; if(g_viewMonth>12){g_viewMonth=1;g_viewYear++;} UpdateLayout(); InvalidateRect(g_hWnd,NULL,FALSE); }
+static void GoToDay(int32_t day) {
+    CivilDate c = CivilFromDays(day);
+    g_viewMonth=c.m; g_viewYear=c.y;
+    UpdateLayout();
+}
 
-        if (st != SHIFT_NONE) {
-            const wchar_t* lb = L"";
-            Color lc = CLR_TEXT;
-            if (st==SHIFT_DAY)   { lb=L"\x2600 DNEVNA";  lc=CLR_DAY_SHIFT; }
-            if (st==SHIFT_NIGHT) { lb=L"\x263E NOCNA";    lc=CLR_NIGHT_SHIFT; }
-            if (st==SHIFT_FREE)  { lb=L"\x2714 SLOBODAN"; lc=CLR_FREE_DAY; }
-            StringFormat sfS; sfS.SetAlignment(StringAlignmentCenter); sfS.SetLineAlignment(StringAlignmentCenter);
-            SolidBrush sb(lc);
-            g.DrawString(lb,(int)wcslen(lb),&fCellS,RectF(cx,cy+ch*0.35f,cw,ch*0.55f),&sfS,&sb);
-        }
+// Ctrl+Z / Ctrl+Y; shows the changed month when it is not on screen
+static void UndoRedo(bool redo) {
+    int32_t from = 0, to = 0;
+    if (!(redo ? g_history.Redo(&from, &to) : g_history.Undo(&from, &to))) { MessageBeep(MB_OK); return; }
+    SaveData();
+    if (g_viewMode != VIEW_MONTH) {
+        if (to < g_overview.FirstDay() || from > g_overview.LastDay()) GoToDay(from);
+        InvalidateRect(g_hWnd,NULL,FALSE);
+    } else if (to < g_layout.grid.first || from >= g_layout.grid.first + g_layout.grid.days) {
+        GoToDay(from);
+        InvalidateRect(g_hWnd,NULL,FALSE);
+    } else {
+        InvalidateDays(from, to);
     }
+}
+
+static void GoToToday() { g_viewMonth=g_todayMonth; g_viewYear=g_todayYear; UpdateLayout(); InvalidateRect(g_hWnd,NULL,FALSE); }
 
-    // Stats
-    int stTop = gBot + 2;
-    int dc=0, nc2=0, fc=0;
-    for (int d=1; d<=g_daysInView; d++) {
-        ShiftType s=GetShift(d,g_viewMonth,g_viewYear);
-        if(s==SHIFT_DAY)dc++; if(s==SHIFT_NIGHT)nc2++; if(s==SHIFT_FREE)fc++;
-    }
-    { wchar_t st[200];
-      wsprintfW(st, L"Ovaj mjesec:   Dnevnih: %d   |   Nocnih: %d   |   Slobodnih: %d   |   Ukupno radnih: %d",
-          dc, nc2, fc, dc+nc2);
-      StringFormat sf; sf.SetAlignment(StringAlignmentCenter); sf.SetLineAlignment(StringAlignmentCenter);
-      g.DrawString(st,(int)wcslen(st),&fStat,RectF((float)g_gridLeft,(float)stTop,(float)(g_cellW*7),(float)STATS_H),&sf,&dimBr);
-    }
-    g.DrawLine(&gPen, g_gridLeft, stTop+STATS_H, g_gridLeft+g_cellW*7, stTop+STATS_H);
-
-    // Legend
-    int lTop = stTop + STATS_H + 5;
-    int lCY = lTop + (LEGEND_H-10)/2;
-    int dotSz = 16, sp = 20;
-    struct LI { Color c; const wchar_t* t; };
-    LI items[] = {{CLR_DAY_SHIFT,L"Dnevna"},{CLR_NIGHT_SHIFT,L"Nocna"},{CLR_FREE_DAY,L"Slobodan"}};
-    int tw = 0;
-    for (int i=0;i<3;i++) { RectF b; g.MeasureString(items[i].t,(int)wcslen(items[i].t),&fLeg,PointF(0,0),&b); tw+=dotSz+8+(int)b.Width+sp; }
-    tw -= sp;
-    int lx = (W-tw)/2;
-    for (int i=0;i<3;i++) {
-        SolidBrush db(items[i].c); FillRR(g,&db,(float)lx,(float)(lCY-dotSz/2),(float)dotSz,(float)dotSz,4.0f);
-        lx+=dotSz+8;
-        RectF b; g.MeasureString(items[i].t,(int)wcslen(items[i].t),&fLeg,PointF(0,0),&b);
-        g.DrawString(items[i].t,(int)wcslen(items[i].t),&fLeg,RectF((float)lx,(float)(lCY-b.Height/2),b.Width,b.Height),nullptr,&dimBr);
-        lx+=(int)b.Width+sp;
-    }
-    { Font fi(&ff,10,FontStyleItalic,UnitPixel); SolidBrush ib(Color(255,70,72,100));
-      StringFormat sf; sf.SetAlignment(StringAlignmentCenter);
-      g.DrawString(L"Lijevi klik = postavi  |  Desni klik = obrisi  |  Scroll = mjesec",65,&fi,
-          RectF(0,(float)(lCY+dotSz/2+6),(float)W,20),&sf,&ib); }
+// Arrows, wheel and keys step a month, or a year in the overviews
+static void StepYear(int d) { g_viewYear+=d; UpdateLayout(); InvalidateRect(g_hWnd,NULL,FALSE); }
+static void GoBack()    { if (g_viewMode==VIEW_MONTH) GoToPrevMonth(); else StepYear(-1); }
+static void GoForward() { if (g_viewMode==VIEW_MONTH) GoToNextMonth(); else StepYear(1); }
+
+// Month -> year -> 5 years -> month ("Pregled"); Esc and a click on a day return to the month
+static void SetViewMode(int mode) {
+    g_viewMode=mode; g_hoverDay=-1;
+    UpdateLayout(); InvalidateRect(g_hWnd,NULL,FALSE);
 }
 
 // ============================================================================
-//  HIT TESTING
+//  SEARCH DIALOG - days matching an expression of shift_search.h (Ctrl+F)
 // ============================================================================
 
-static int HitTestDay(int mx, int my) {
-    if (my < g_gridTop || g_cellW==0 || g_cellH==0) return -1;
-    int col=(mx-g_gridLeft)/g_cellW, row=(my-g_gridTop)/g_cellH;
-    if (col<0||col>6||row<0||row>5) return -1;
-    int day = row*7+col-g_gridStartDow+1;
-    return (day>=1 && day<=g_daysInView) ? day : -1;
+static void ClearSearch() {
+    g_search = ShiftSearch();
+    g_view.SetSearch(nullptr);
+    InvalidateRect(g_hWnd,NULL,FALSE);
 }
 
-static int HitTestButton(int mx, int my) {
-    POINT pt={mx,my};
-    if (PtInRect(&g_prevBtn,pt)) return 0;
-    if (PtInRect(&g_nextBtn,pt)) return 1;
-    if (PtInRect(&g_todayBtn,pt)) return 2;
-    if (PtInRect(&g_copyBtn,pt)) return 3;
-    if (PtInRect(&g_clearMonthBtn,pt)) return 4;
-    if (PtInRect(&g_resetBtn,pt)) return 5;
-    return -1;
+// Compiles the dialog's expression and shows the first month with a match
+// from the viewed one on (or the first of all); false keeps the dialog open
+static bool RunSearch(HWND hWnd) {
+    wchar_t wtext[256];
+    char text[256];
+    GetDlgItemTextW(hWnd, IDC_SEARCH_TEXT, wtext, 256);
+    int n = 0;
+    for (; wtext[n]; n++) text[n] = wtext[n] < 128 ? (char)wtext[n] : '?';
+    text[n] = 0;
+
+    ShiftSearch search;
+    size_t at = 0;
+    if (const char* err = search.Compile(text, &at)) {
+        wchar_t msg[300];
+        wsprintfW(msg, L"Neispravan upit: %S (znak %d).", err, (int)at + 1);
+        MessageBoxW(hWnd, msg, L"Greska", MB_OK | MB_ICONWARNING);
+        return false;
+    }
+    int32_t from = MonthStart(g_viewMonth, g_viewYear), to = from;
+    search.Span(*g_shifts, from, to);
+    ShiftIndex index;
+    index.Build(*g_shifts, from, to, &g_holidays);
+    std::vector<uint64_t> hits;
+    search.Evaluate(index, hits);
+    int64_t first = -1, start = MonthStart(g_viewMonth, g_viewYear) - from;
+    for (int64_t i = 0; i < (int64_t)hits.size() * 64; i++) {
+        if (!(hits[(size_t)(i / 64)] >> (i % 64) & 1)) continue;
+        if (first < 0) first = i;
+        if (i >= start) { first = i; break; }
+    }
+    if (first < 0) {
+        MessageBoxW(hWnd, L"Nijedan dan ne odgovara upitu.", L"Pretraga", MB_OK | MB_ICONINFORMATION);
+        return false;
+    }
+
+    wcscpy(g_searchText, wtext);
+    g_search = search;
+    g_view.SetSearch(&g_search);
+    if (g_viewMode != VIEW_MONTH) g_viewMode = VIEW_MONTH;
+    GoToDay(from + (int32_t)first);
+    InvalidateRect(g_hWnd,NULL,FALSE);
+    return true;
 }
 
-// ============================================================================
-//  NAVIGATION
-// ============================================================================
+static LRESULT CALLBACK SearchDlgWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    switch (msg) {
+    case WM_COMMAND: {
+        int id = LOWORD(wParam);
+        int notif = HIWORD(wParam);
+        if (id == IDC_BTN_OK && notif == BN_CLICKED) {
+            if (RunSearch(hWnd)) { EnableWindow(g_hWnd, TRUE); DestroyWindow(hWnd); }
+            return 0;
+        }
+        if (id == IDC_SEARCH_CLEAR && notif == BN_CLICKED) {
+            ClearSearch();
+            EnableWindow(g_hWnd, TRUE);
+            DestroyWindow(hWnd);
+            return 0;
+        }
+        if ((id == IDC_BTN_CANCEL && notif == BN_CLICKED) || id == IDCANCEL) {
+            EnableWindow(g_hWnd, TRUE);
+            DestroyWindow(hWnd);
+            return 0;
+        }
+        break;
+    }
+
+    case WM_CLOSE:
+        EnableWindow(g_hWnd, TRUE);
+        DestroyWindow(hWnd);
+        return 0;
+
+    case WM_DESTROY:
+        g_hSearchDlg = NULL;
+        SetForegroundWindow(g_hWnd);
+        return 0;
+    }
+
+    return DefWindowProcW(hWnd, msg, wParam, lParam);
+}
+
+static void ShowSearchDialog() {
+    if (g_hSearchDlg && IsWindow(g_hSearchDlg)) {
+        SetForegroundWindow(g_hSearchDlg);
+        return;
+    }
+
+    static bool registered = false;
+    if (!registered) {
+        WNDCLASSEXW wc = {};
+        wc.cbSize = sizeof(wc);
+        wc.style = CS_HREDRAW | CS_VREDRAW;
+        wc.lpfnWndProc = SearchDlgWndProc;
+        wc.hInstance = GetModuleHandle(NULL);
+        wc.hCursor = LoadCursor(NULL, IDC_ARROW);
+        wc.hbrBackground = (HBRUSH)GetStockObject(WHITE_BRUSH);
+        wc.lpszClassName = L"SmjeneSearchDlgClass";
+        RegisterClassExW(&wc);
+        registered = true;
+    }
+
+    int dlgClientW = 430, dlgClientH = 250;
+    RECT rcDlg = {0, 0, dlgClientW, dlgClientH};
+    AdjustWindowRectEx(&rcDlg, WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU, FALSE, WS_EX_DLGMODALFRAME);
+    int dlgW = rcDlg.right - rcDlg.left;
+    int dlgH = rcDlg.bottom - rcDlg.top;
 
-static void GoToPrevMonth() { g_viewMonth--; if(g_viewMonth<1){g_viewMonth=12;g_viewYear--;} InvalidateRect(g_hWnd,NULL,FALSE); }
-static void GoToNextMonth() { g_viewMonth++; if(g_viewMonth>12){g_viewMonth=1;g_viewYear++;} InvalidateRect(g_hWnd,NULL,FALSE); }
-static void GoToToday() { g_viewMonth=g_todayMonth; g_viewYear=g_todayYear; InvalidateRect(g_hWnd,NULL,FALSE); }
+    RECT rcP; GetWindowRect(g_hWnd, &rcP);
+    int px = rcP.left + (rcP.right - rcP.left - dlgW) / 2;
+    int py = rcP.top + (rcP.bottom - rcP.top - dlgH) / 2;
+
+    g_hSearchDlg = CreateWindowExW(
+        WS_EX_DLGMODALFRAME,
+        L"SmjeneSearchDlgClass",
+        L"Pretraga Smjena",
+        WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU,
+        px, py, dlgW, dlgH,
+        g_hWnd, NULL, GetModuleHandle(NULL), NULL);
+
+    if (!g_hSearchDlg) return;
+
+    HFONT hFont     = MakeFont(15);
+    HFONT hFontBold = MakeFont(15, true);
+    HFONT hFontSm   = MakeFont(13);
+
+    int y = 10, x = 15;
+    HWND h;
+
+    h = CreateWindowW(L"STATIC", L"Upit (dani koji odgovaraju dobijaju zutu tacku):",
+        WS_CHILD | WS_VISIBLE, x, y, 400, 20, g_hSearchDlg, NULL, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFont, TRUE);
+    y += 24;
+    h = CreateWindowW(L"EDIT", g_searchText, WS_CHILD | WS_VISIBLE | WS_BORDER | ES_AUTOHSCROLL,
+        x, y, 400, 24, g_hSearchDlg, (HMENU)IDC_SEARCH_TEXT, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFontBold, TRUE);
+    SendMessage(h, EM_LIMITTEXT, 255, 0);
+    y += 34;
+
+    h = CreateWindowW(L"STATIC",
+        L"D N S prazan radni  |  pon ... ned vikend praznik  |  jan ... dec\n"
+        L"2025, 2025-03, 2025-03-01, 2025-01..2025-06\n"
+        L"i (ili razmak), ili, ne, ( ), prije(...), poslije(...), mjesec(...) > 12\n\n"
+        L"Npr.:  N sub 2025     S (prije(praznik) ili poslije(praznik))\n"
+        L"          N mjesec(N) > 12",
+        WS_CHILD | WS_VISIBLE, x, y, 400, 100, g_hSearchDlg, NULL, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFontSm, TRUE);
+    y += 112;
+
+    h = CreateWindowW(L"BUTTON", L"TRAZI", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON | BS_DEFPUSHBUTTON,
+        x+70, y, 90, 32, g_hSearchDlg, (HMENU)IDC_BTN_OK, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFontBold, TRUE);
+
+    h = CreateWindowW(L"BUTTON", L"Ukloni", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
+        x+170, y, 90, 32, g_hSearchDlg, (HMENU)IDC_SEARCH_CLEAR, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFont, TRUE);
+
+    h = CreateWindowW(L"BUTTON", L"Odustani", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
+        x+270, y, 90, 32, g_hSearchDlg, (HMENU)IDC_BTN_CANCEL, NULL, NULL);
+    SendMessage(h, WM_SETFONT, (WPARAM)hFont, TRUE);
+
+    EnableWindow(g_hWnd, FALSE);
+    ShowWindow(g_hSearchDlg, SW_SHOW);
+    UpdateWindow(g_hSearchDlg);
+    SetFocus(GetDlgItem(g_hSearchDlg, IDC_SEARCH_TEXT));
+}
 
 // ============================================================================
 //  CONTEXT MENU
@@ -844,11 +1338,12 @@ static void ShowShiftMenu(int day, int x, int y) {
     AppendMenuW(hM, MF_STRING, IDM_CLEAR, L"  \x2716  Obrisi");
     POINT pt={x,y}; ClientToScreen(g_hWnd,&pt);
     int cmd = TrackPopupMenu(hM, TPM_RETURNCMD|TPM_RIGHTBUTTON, pt.x, pt.y, 0, g_hWnd, NULL);
+    TRACE_SCOPE("input", "menu");
     if (cmd==IDM_DAY_SHIFT)   SetShift(day,g_viewMonth,g_viewYear,SHIFT_DAY);
     if (cmd==IDM_NIGHT_SHIFT) SetShift(day,g_viewMonth,g_viewYear,SHIFT_NIGHT);
     if (cmd==IDM_FREE_DAY)    SetShift(day,g_viewMonth,g_viewYear,SHIFT_FREE);
     if (cmd==IDM_CLEAR)       SetShift(day,g_viewMonth,g_viewYear,SHIFT_NONE);
-    if (cmd) { SaveData(); InvalidateRect(g_hWnd,NULL,FALSE); }
+    if (cmd) { SaveData(); InvalidateDay(day); }
     DestroyMenu(hM);
 }
 
@@ -856,24 +1351,26 @@ static void ShowShiftMenu(int day, int x, int y) {
 //  MAIN WNDPROC
 // ============================================================================
 
-static LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+static LRESULT CALLBACK MainWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
-    case WM_CREATE: g_hWnd=hWnd; return 0;
+    case WM_CREATE: g_hWnd=hWnd; UpdateLayout(); return 0;
 
     case WM_PAINT: {
+        TRACE_SCOPE("paint", "frame");
         PAINTSTRUCT ps; HDC hdc=BeginPaint(hWnd,&ps);
-        RECT rc; GetClientRect(hWnd,&rc);
+        UpdateLayout();
+        const RECT& pr=ps.rcPaint;
         HDC mem=CreateCompatibleDC(hdc);
-        HBITMAP bm=CreateCompatibleBitmap(hdc,rc.right,rc.bottom);
+        HBITMAP bm=CreateCompatibleBitmap(hdc,g_layout.width,g_layout.height);
         HBITMAP old=(HBITMAP)SelectObject(mem,bm);
-        DrawCalendar(mem,rc.right,rc.bottom);
-        BitBlt(hdc,0,0,rc.right,rc.bottom,mem,0,0,SRCCOPY);
+        DrawCalendar(mem,pr);
+        BitBlt(hdc,pr.left,pr.top,pr.right-pr.left,pr.bottom-pr.top,mem,pr.left,pr.top,SRCCOPY);
         SelectObject(mem,old); DeleteObject(bm); DeleteDC(mem);
         EndPaint(hWnd,&ps); return 0;
     }
 
     case WM_ERASEBKGND: return 1;
-    case WM_SIZE: InvalidateRect(hWnd,NULL,FALSE); return 0;
+    case WM_SIZE: UpdateLayout(); InvalidateRect(hWnd,NULL,FALSE); return 0;
 
     case WM_GETMINMAXINFO: {
         MINMAXINFO* m=(MINMAXINFO*)lParam;
@@ -884,26 +1381,38 @@ static LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lPara
         int mx=(int)(short)LOWORD(lParam), my=(int)(short)HIWORD(lParam);
         int nh=HitTestDay(mx,my), nb=HitTestButton(mx,my);
         if (nh!=g_hoverDay||nb!=g_hoverBtn) {
+            UiState before=CurrentUi();
             g_hoverDay=nh; g_hoverBtn=nb;
-            InvalidateRect(hWnd,NULL,FALSE);
+            Invalidate(DiffUi(g_layout,before,CurrentUi()));
             SetCursor(LoadCursor(NULL,(nh>0||nb>=0)?IDC_HAND:IDC_ARROW));
         }
+        // Overview squares do not hover, but they are clickable
+        if (g_viewMode!=VIEW_MONTH && nb<0)
+            SetCursor(LoadCursor(NULL,HitTestOverviewDay(mx,my)>=0?IDC_HAND:IDC_ARROW));
         TRACKMOUSEEVENT tme={sizeof(tme),TME_LEAVE,hWnd,0}; TrackMouseEvent(&tme);
         return 0;
     }
 
-    case WM_MOUSELEAVE:
-        g_hoverDay=-1; g_hoverBtn=-1; InvalidateRect(hWnd,NULL,FALSE); return 0;
+    case WM_MOUSELEAVE: {
+        UiState before=CurrentUi();
+        g_hoverDay=-1; g_hoverBtn=-1;
+        Invalidate(DiffUi(g_layout,before,CurrentUi()));
+        return 0;
+    }
 
     case WM_LBUTTONDOWN: {
         int mx=(int)(short)LOWORD(lParam), my=(int)(short)HIWORD(lParam);
         int btn=HitTestButton(mx,my);
-        if (btn==0) { GoToPrevMonth(); return 0; }
-        if (btn==1) { GoToNextMonth(); return 0; }
+        if (btn==0) { GoBack(); return 0; }
+        if (btn==1) { GoForward(); return 0; }
         if (btn==2) { GoToToday(); return 0; }
         if (btn==3) { ShowCopyDialog(); return 0; }
-        if (btn==4) { ClearMonth(); return 0; }
+        if (btn==4) { ClearViewMonth(); return 0; }
         if (btn==5) { ResetAll(); return 0; }
+        if (btn==6) { ShowRotationDialog(); return 0; }
+        if (btn==7) { SetViewMode((g_viewMode+1)%VIEW_MODES); return 0; }
+        int32_t z=HitTestOverviewDay(mx,my);
+        if (z>=0) { GoToDay(z); SetViewMode(VIEW_MONTH); return 0; }
         int day=HitTestDay(mx,my);
         if (day>0) ShowShiftMenu(day,mx,my);
         return 0;
@@ -914,40 +1423,107 @@ static LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lPara
         int day=HitTestDay(mx,my);
         if (day>0 && GetShift(day,g_viewMonth,g_viewYear)!=SHIFT_NONE) {
             SetShift(day,g_viewMonth,g_viewYear,SHIFT_NONE);
-            SaveData(); InvalidateRect(hWnd,NULL,FALSE);
+            SaveData(); InvalidateDay(day);
         }
         return 0;
     }
 
     case WM_MOUSEWHEEL: {
-        if (GET_WHEEL_DELTA_WPARAM(wParam)>0) GoToPrevMonth(); else GoToNextMonth();
+        if (GET_WHEEL_DELTA_WPARAM(wParam)>0) GoBack(); else GoForward();
         return 0;
     }
 
     case WM_KEYDOWN:
-        if (wParam==VK_LEFT) GoToPrevMonth();
-        else if (wParam==VK_RIGHT) GoToNextMonth();
+        if (wParam==VK_LEFT) GoBack();
+        else if (wParam==VK_RIGHT) GoForward();
         else if (wParam==VK_HOME) GoToToday();
+        else if (wParam==VK_ESCAPE && g_viewMode!=VIEW_MONTH) SetViewMode(VIEW_MONTH);
+        else if (wParam==VK_ESCAPE && !g_search.Empty()) ClearSearch();
+        else if (GetKeyState(VK_CONTROL) & 0x8000) {
+            bool shift = (GetKeyState(VK_SHIFT) & 0x8000) != 0;
+            if (wParam=='Z') UndoRedo(shift);
+            else if (wParam=='Y') UndoRedo(true);
+            else if (wParam=='I') ShowImportDialog();
+            else if (wParam=='F') ShowSearchDialog();
+        }
         return 0;
 
-    case WM_DESTROY: SaveData(); PostQuitMessage(0); return 0;
+    case WM_DESTROY:
+        SaveData();
+        if (!g_data.Close())
+            MessageBoxW(NULL, L"Posljednje izmjene nisu snimljene: greska pri pisanju na disk.", L"Greska",
+                        MB_OK | MB_ICONERROR);
+        PostQuitMessage(0);
+        return 0;
     }
     return DefWindowProcW(hWnd,msg,wParam,lParam);
 }
 
+// Trace point of an input message, nullptr for the rest. A click that opens
+// a menu or dialog includes the time it is open; the menu choice is traced
+// on its own as input/menu.
+static const char* InputTraceName(UINT msg) {
+    switch (msg) {
+    case WM_MOUSEMOVE:   return "move";
+    case WM_MOUSELEAVE:  return "leave";
+    case WM_LBUTTONDOWN: return "click";
+    case WM_RBUTTONDOWN: return "right-click";
+    case WM_MOUSEWHEEL:  return "wheel";
+    case WM_KEYDOWN:     return "key";
+    }
+    return nullptr;
+}
+
+static LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    const char* input = TraceEnabled() ? InputTraceName(msg) : nullptr;
+    if (!input) return MainWndProc(hWnd,msg,wParam,lParam);
+    TraceScope scope("input", input);
+    return MainWndProc(hWnd,msg,wParam,lParam);
+}
+
+// ============================================================================
+//  TRACING - "--trace [file]" or SMJENE_TRACE=file; on exit the Chrome trace
+//  (chrome://tracing) goes to the file and p50/p99 per trace point to
+//  file + ".summary.txt"
+// ============================================================================
+
+static void StartTrace() {
+    int argc = 0;
+    LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+    for (int i = 1; argv && i < argc; i++) {
+        if (wcscmp(argv[i], L"--trace") != 0) continue;
+        if (i + 1 < argc && argv[i + 1][0] != L'-') g_tracePath = argv[i + 1];
+        else {
+            g_tracePath = g_dataPath;
+            g_tracePath.replace(g_tracePath.size() - wcslen(L"smjene_data"), std::wstring::npos, L"smjene_trace.json");
+        }
+        TraceStart();
+    }
+    if (argv) LocalFree(argv);
+    if (const char* env = g_tracePath.empty() ? TraceStartFromEnv() : nullptr) g_tracePath = PathFromUtf8(env);
+}
+
+static void WriteTrace() {
+    if (g_tracePath.empty()) return;
+    TraceStop();
+    if (FILE* f = OpenPath(g_tracePath, "wb")) { WriteChromeTrace(f); fclose(f); }
+    if (FILE* f = OpenPath(g_tracePath + L".summary.txt", "wb")) { WriteTraceSummary(f); fclose(f); }
+}
+
 // ============================================================================
 //  ENTRY POINT
 // ============================================================================
 
 int WINAPI wWinMain(HINSTANCE hInst, HINSTANCE, LPWSTR, int nShow) {
     GdiplusStartupInput si; GdiplusStartup(&g_gdipToken,&si,NULL);
+    g_gdi = new GdiplusResources();
     INITCOMMONCONTROLSEX ic={sizeof(ic),ICC_WIN95_CLASSES}; InitCommonControlsEx(&ic);
 
     time_t now=time(NULL); struct tm* t=localtime(&now);
     g_todayDay=t->tm_mday; g_todayMonth=t->tm_mon+1; g_todayYear=t->tm_year+1900;
     g_viewMonth=g_todayMonth; g_viewYear=g_todayYear;
 
-    GetDataPath(); LoadData();
+    GetDataPath(); StartTrace(); LoadData();
 
     WNDCLASSEXW wc={}; wc.cbSize=sizeof(wc); wc.style=CS_HREDRAW|CS_VREDRAW;
     wc.lpfnWndProc=WndProc; wc.hInstance=hInst; wc.hCursor=LoadCursor(NULL,IDC_ARROW);
@@ -961,9 +1537,12 @@ int WINAPI wWinMain(HINSTANCE hInst, HINSTANCE, LPWSTR, int nShow) {
         WS_OVERLAPPEDWINDOW,(sw-ww)/2,(sh-wh)/2,ww,wh,NULL,NULL,hInst,NULL);
     if (!hw) return 1;
     ShowWindow(hw,nShow); UpdateWindow(hw);
+    ReportLoadErrors();
 
     MSG msg;
     while (GetMessageW(&msg,NULL,0,0)) { TranslateMessage(&msg); DispatchMessageW(&msg); }
+    WriteTrace();
+    delete g_gdi; g_gdi = nullptr;
     GdiplusShutdown(g_gdipToken);
     return (int)msg.wParam;
 }